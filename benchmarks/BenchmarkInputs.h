@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file BenchmarkInputs.h
+ *  @brief  Deterministic synthetic inputs for the MoveTk benchmarks
+ */
+
+#ifndef MOVETK_BENCHMARKINPUTS_H
+#define MOVETK_BENCHMARKINPUTS_H
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <numbers>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "movetk/geom/ObjectCreation.h"
+#include "movetk/utils/GeometryBackendTraits.h"
+
+namespace movetk::benchmarks {
+
+using Kernel = GeometryKernel::MovetkGeometryKernel;
+using Norm = GeometryKernel::Norm;
+using NT = typename Kernel::NT;
+using Point = typename Kernel::MovetkPoint;
+using Polyline = std::vector<Point>;
+
+/**
+ * @brief Shapes of the synthetic polylines. All shapes advance about one unit per vertex.
+ */
+enum class Shape {
+	// Unit steps in uniformly random directions
+	RandomWalk,
+	// Alternating up and down strokes, the worst case for most simplification algorithms
+	Zigzag,
+	// Smoothly turning path with Gaussian position noise, resembling a GPS trace of a vehicle
+	RoadTrace
+};
+
+constexpr std::array<Shape, 3> ALL_SHAPES = {Shape::RandomWalk, Shape::Zigzag, Shape::RoadTrace};
+
+constexpr const char* shape_name(Shape shape) {
+	switch (shape) {
+		case Shape::RandomWalk:
+			return "random_walk";
+		case Shape::Zigzag:
+			return "zigzag";
+		case Shape::RoadTrace:
+			return "road_trace";
+	}
+	return "";
+}
+
+/**
+ * @brief Generates a polyline of the given shape. The same arguments always produce the same polyline.
+ * @param shape The shape
+ * @param num_points The number of vertices
+ * @param seed Seed of the random generator
+ */
+inline Polyline make_polyline(Shape shape, std::size_t num_points, std::uint32_t seed = 1) {
+	std::mt19937 generator(seed);
+	geom::MakePoint<Kernel> make_point;
+	Polyline polyline;
+	polyline.reserve(num_points);
+	double x = 0, y = 0;
+	switch (shape) {
+		case Shape::RandomWalk: {
+			std::uniform_real_distribution<double> direction(0, 2 * std::numbers::pi);
+			for (std::size_t i = 0; i < num_points; ++i) {
+				polyline.push_back(make_point({static_cast<NT>(x), static_cast<NT>(y)}));
+				const auto angle = direction(generator);
+				x += std::cos(angle);
+				y += std::sin(angle);
+			}
+			break;
+		}
+		case Shape::Zigzag: {
+			std::uniform_real_distribution<double> amplitude(2, 4);
+			for (std::size_t i = 0; i < num_points; ++i) {
+				const auto sign = i % 2 == 0 ? 1 : -1;
+				polyline.push_back(make_point({static_cast<NT>(i), static_cast<NT>(sign * amplitude(generator))}));
+			}
+			break;
+		}
+		case Shape::RoadTrace: {
+			std::normal_distribution<double> turn(0, 0.05), noise(0, 0.1);
+			double heading = 0;
+			for (std::size_t i = 0; i < num_points; ++i) {
+				polyline.push_back(make_point({static_cast<NT>(x + noise(generator)), static_cast<NT>(y + noise(generator))}));
+				heading += turn(generator);
+				x += std::cos(heading);
+				y += std::sin(heading);
+			}
+			break;
+		}
+	}
+	return polyline;
+}
+
+/**
+ * @brief Returns a copy of the polyline with Gaussian noise added to the vertices,
+ * used as the second input of the similarity measures.
+ * @param polyline The polyline
+ * @param sigma Standard deviation of the noise
+ * @param seed Seed of the random generator
+ */
+inline Polyline perturb(const Polyline& polyline, double sigma, std::uint32_t seed = 2) {
+	std::mt19937 generator(seed);
+	std::normal_distribution<double> noise(0, sigma);
+	geom::MakePoint<Kernel> make_point;
+	Polyline result;
+	result.reserve(polyline.size());
+	for (const auto& point : polyline) {
+		result.push_back(make_point({static_cast<NT>(point[0] + noise(generator)),
+		                             static_cast<NT>(point[1] + noise(generator))}));
+	}
+	return result;
+}
+
+/**
+ * @brief Generates timestamped probes along a polyline of the given shape, sampled every second.
+ * About one percent of the probes is displaced far from the polyline, to act as outliers.
+ * @param shape The shape
+ * @param num_probes The number of probes
+ * @param seed Seed of the random generator
+ * @return Probes as (point, timestamp) tuples, the layout of the cartesian ProbeTraits
+ */
+inline std::vector<std::tuple<Point, std::size_t>> make_probes(Shape shape, std::size_t num_probes, std::uint32_t seed = 1) {
+	const auto polyline = make_polyline(shape, num_probes, seed);
+	std::mt19937 generator(seed + 1);
+	std::bernoulli_distribution is_outlier(0.01);
+	geom::MakePoint<Kernel> make_point;
+	std::vector<std::tuple<Point, std::size_t>> probes;
+	probes.reserve(num_probes);
+	for (std::size_t i = 0; i < num_probes; ++i) {
+		const auto& point = polyline[i];
+		if (is_outlier(generator)) {
+			probes.emplace_back(make_point({point[0] + 25, point[1] - 25}), i);
+		} else {
+			probes.emplace_back(point, i);
+		}
+	}
+	return probes;
+}
+
+/**
+ * @brief Generates a csv file with a header in the c2d raw probe format
+ * (PROBE_ID,SAMPLE_DATE,LAT,LON,HEADING,SPEED,PROBE_DATA_PROVIDER).
+ * Probes of the vehicles are interleaved in time order, as in a raw probe feed.
+ * @param num_probes The number of probes
+ * @param num_vehicles The number of distinct probe ids
+ * @param seed Seed of the random generator
+ */
+inline std::string make_c2d_csv(std::size_t num_probes, std::size_t num_vehicles, std::uint32_t seed = 1) {
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> start_offset(-0.2, 0.2);
+	std::normal_distribution<double> step(0, 0.0002);
+	std::uniform_real_distribution<double> heading(0, 360), speed(0, 120);
+	std::vector<std::pair<double, double>> positions(num_vehicles);
+	for (auto& [lat, lon] : positions) {
+		lat = 34.05 + start_offset(generator);
+		lon = -118.25 + start_offset(generator);
+	}
+
+	std::string csv = "PROBE_ID,SAMPLE_DATE,LAT,LON,HEADING,SPEED,PROBE_DATA_PROVIDER\n";
+	csv.reserve(num_probes * 100);
+	// 2018-09-18 00:00:00 UTC
+	constexpr std::time_t START = 1537228800;
+	char line[160];
+	for (std::size_t i = 0; i < num_probes; ++i) {
+		const auto vehicle = i % num_vehicles;
+		auto& [lat, lon] = positions[vehicle];
+		lat += step(generator);
+		lon += step(generator);
+		const std::time_t ts = START + static_cast<std::time_t>(i / num_vehicles) * 5;
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::gmtime(&ts));
+		std::snprintf(line,
+		              sizeof(line),
+		              "5ba036d622000bf9%015zx,%s,%.7f,%.7f,%.1f,%.1f,CONSUMER%zu\n",
+		              vehicle,
+		              date,
+		              lat,
+		              lon,
+		              heading(generator),
+		              speed(generator),
+		              vehicle % 4);
+		csv += line;
+	}
+	return csv;
+}
+
+/**
+ * @brief Registers a benchmark once for every shape, named <name>/<shape>/<size>,
+ * with the size ranging over powers of two between the given bounds.
+ * @tparam Function Callable taking the benchmark state and the shape
+ * @param name Name of the benchmark
+ * @param function The benchmark
+ * @param min_size The smallest input size
+ * @param max_size The largest input size
+ */
+template <class Function>
+void register_for_shapes(const std::string& name, Function function, std::int64_t min_size, std::int64_t max_size) {
+	for (const auto shape : ALL_SHAPES) {
+		benchmark::RegisterBenchmark((name + "/" + shape_name(shape)).c_str(), function, shape)
+		    ->RangeMultiplier(2)
+		    ->Range(min_size, max_size)
+		    ->Complexity();
+	}
+}
+
+}  // namespace movetk::benchmarks
+
+#endif  // MOVETK_BENCHMARKINPUTS_H
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "BenchmarkInputs.h"
+#include "HereTrajectoryTraits.h"
+#include "movetk/io/DictionaryEncodedProbeReader.h"
+#include "movetk/io/ProbeReader.h"
+#include "movetk/io/SortedProbeReader.h"
+#include "movetk/io/SplitByField.h"
+#include "movetk/io/Splitter.h"
+#include "movetk/io/TrajectoryReader.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using TrajectoryTraits = here::c2d::raw::TabularTrajectoryTraits;
+using ProbeTraits = typename TrajectoryTraits::ProbeTraits;
+constexpr int PROBE_ID = ProbeTraits::ProbeColumns::PROBE_ID;
+
+// Vehicles of the synthetic probe feeds, each contributing about this many probes
+constexpr std::size_t PROBES_PER_VEHICLE = 100;
+
+std::size_t num_vehicles(std::size_t num_probes) { return std::max<std::size_t>(1, num_probes / PROBES_PER_VEHICLE); }
+
+void csv_parse(benchmark::State& state) {
+	const auto csv = make_c2d_csv(state.range(0), num_vehicles(state.range(0)));
+	std::size_t rows = 0;
+	for (auto _ : state) {
+		std::istringstream stream(csv);
+		here::c2d::raw::ProbeCsv table(stream, ',', true);
+		rows = 0;
+		for (const auto& row : table) {
+			benchmark::DoNotOptimize(row);
+			++rows;
+		}
+	}
+	state.counters["rows"] = static_cast<double>(rows);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(csv.size()));
+	state.SetComplexityN(state.range(0));
+}
+
+// Groups the probes by probe id and counts the trajectories and their points, recycling the trajectories
+template <class ProbeReader>
+std::pair<std::size_t, std::size_t> read_trajectories(ProbeReader& probe_reader) {
+	using ProbeInputIterator = decltype(probe_reader.begin());
+	movetk::io::SortedProbeReader<ProbeInputIterator, PROBE_ID> sorted_probe_reader(probe_reader.begin(),
+	                                                                                probe_reader.end());
+	using SortedProbeInputIterator = decltype(sorted_probe_reader.begin());
+	movetk::io::TrajectoryReader<TrajectoryTraits, SortedProbeInputIterator> trajectory_reader(
+	    sorted_probe_reader.begin(),
+	    sorted_probe_reader.end());
+	std::size_t trajectories = 0, points = 0;
+	for (auto it = trajectory_reader.begin(); it != trajectory_reader.end(); ++it) {
+		++trajectories;
+		points += it->size();
+		trajectory_reader.recycle(std::move(*it));
+	}
+	return {trajectories, points};
+}
+
+void trajectory_reader(benchmark::State& state) {
+	const auto csv = make_c2d_csv(state.range(0), num_vehicles(state.range(0)));
+	std::pair<std::size_t, std::size_t> counts;
+	for (auto _ : state) {
+		auto probe_reader = movetk::io::ProbeReaderFactory::create_from_string<ProbeTraits>(csv.c_str());
+		counts = read_trajectories(*probe_reader);
+		benchmark::DoNotOptimize(counts);
+	}
+	state.counters["trajectories"] = static_cast<double>(counts.first);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(csv.size()));
+	state.SetComplexityN(state.range(0));
+}
+
+// Groups the probes by probe id, comparing the ids as strings or as dictionary codes
+template <bool Encoded>
+void probe_grouping(benchmark::State& state) {
+	const auto csv = make_c2d_csv(state.range(0), num_vehicles(state.range(0)));
+	std::size_t groups = 0;
+	auto count_groups = [](auto start, auto beyond) {
+		using ProbeInputIterator = decltype(start);
+		using ProbePoint = typename std::iterator_traits<ProbeInputIterator>::value_type;
+		movetk::io::SortedProbeReader<ProbeInputIterator, PROBE_ID> sorted_probe_reader(start, beyond);
+		using SortedProbeInputIterator = decltype(sorted_probe_reader.begin());
+		movetk::io::Splitter<movetk::io::SplitByField<PROBE_ID, ProbePoint>, SortedProbeInputIterator> splitter(
+		    sorted_probe_reader.begin(),
+		    sorted_probe_reader.end());
+		return static_cast<std::size_t>(std::distance(splitter.begin(), splitter.end()));
+	};
+	for (auto _ : state) {
+		auto probe_reader = movetk::io::ProbeReaderFactory::create_from_string<ProbeTraits>(csv.c_str());
+		if constexpr (Encoded) {
+			using ProbeInputIterator = decltype(probe_reader->begin());
+			movetk::io::DictionaryEncodedProbeReader<ProbeInputIterator, PROBE_ID> encoded_reader(probe_reader->begin(),
+			                                                                                     probe_reader->end());
+			groups = count_groups(encoded_reader.begin(), encoded_reader.end());
+		} else {
+			groups = count_groups(probe_reader->begin(), probe_reader->end());
+		}
+		benchmark::DoNotOptimize(groups);
+	}
+	state.counters["groups"] = static_cast<double>(groups);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+void trajectory_reader_file(benchmark::State& state, const std::string& file_name) {
+	std::pair<std::size_t, std::size_t> counts;
+	for (auto _ : state) {
+		auto probe_reader = movetk::io::ProbeReaderFactory::create<ProbeTraits>(file_name);
+		counts = read_trajectories(*probe_reader);
+		benchmark::DoNotOptimize(counts);
+	}
+	state.counters["trajectories"] = static_cast<double>(counts.first);
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(counts.second));
+}
+
+const bool registered = [] {
+	benchmark::RegisterBenchmark("CsvParse/c2d_raw", csv_parse)->RangeMultiplier(4)->Range(1 << 10, 1 << 18)->Complexity();
+	benchmark::RegisterBenchmark("TrajectoryReader/c2d_raw", trajectory_reader)
+	    ->RangeMultiplier(4)
+	    ->Range(1 << 10, 1 << 18)
+	    ->Complexity();
+	benchmark::RegisterBenchmark("ProbeGrouping/string_ids", probe_grouping<false>)
+	    ->RangeMultiplier(4)
+	    ->Range(1 << 10, 1 << 18)
+	    ->Complexity();
+	benchmark::RegisterBenchmark("ProbeGrouping/encoded_ids", probe_grouping<true>)
+	    ->RangeMultiplier(4)
+	    ->Range(1 << 10, 1 << 18)
+	    ->Complexity();
+	// Real probe data in the c2d raw format, as .csv or .csv.gz file
+	if (const char* file_name = std::getenv("MOVETK_BENCHMARK_DATA"); file_name != nullptr) {
+		benchmark::RegisterBenchmark("TrajectoryReader/file", trajectory_reader_file, std::string(file_name))
+		    ->Unit(benchmark::kMillisecond);
+	}
+	return true;
+}();
+}  // namespace
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkInputs.h"
+#include "movetk/AlgorithmTraits.h"
+#include "movetk/OutlierDetection.h"
+#include "movetk/io/CartesianProbeTraits.h"
+#include "movetk/outlierdetection/OutlierDetectionPredicates.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using CartesianProbeTraits = movetk::io::ProbeTraits<Kernel>;
+using Trajectory = std::vector<typename CartesianProbeTraits::ProbePoint>;
+using OutlierDetectionTraits = movetk::outlierdetection::OutlierDetectionTraits<CartesianProbeTraits, Kernel, Norm>;
+using LinearSpeedBoundedTest = movetk::outlierdetection::TEST<movetk::outlierdetection::linear_speed_bounded_test_tag,
+                                                              movetk::algo::cartesian_coordinates_tag,
+                                                              OutlierDetectionTraits>;
+template <class Tag>
+using OutlierDetector = movetk::outlierdetection::OutlierDetection<Kernel, LinearSpeedBoundedTest, Tag>;
+
+// Speed bound of the linear speed bounded test. The probes move about one unit per second.
+constexpr NT MAX_SPEED = 1.5;
+
+template <class Detector>
+void run_detector(benchmark::State& state, Detector& detector, const Trajectory& trajectory) {
+	std::vector<Trajectory::const_iterator> result;
+	for (auto _ : state) {
+		result.clear();
+		detector(trajectory.cbegin(), trajectory.cend(), std::back_inserter(result));
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.counters["inliers"] = static_cast<double>(result.size());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+void greedy(benchmark::State& state, Shape shape) {
+	const Trajectory trajectory = make_probes(shape, state.range(0));
+	OutlierDetector<movetk::outlierdetection::greedy_outlier_detector_tag> detector(MAX_SPEED);
+	run_detector(state, detector, trajectory);
+}
+
+void zheng(benchmark::State& state, Shape shape) {
+	const Trajectory trajectory = make_probes(shape, state.range(0));
+	OutlierDetector<movetk::outlierdetection::zheng_outlier_detector_tag> detector(MAX_SPEED, 3);
+	run_detector(state, detector, trajectory);
+}
+
+void smart_greedy(benchmark::State& state, Shape shape) {
+	const Trajectory trajectory = make_probes(shape, state.range(0));
+	OutlierDetector<movetk::outlierdetection::smart_greedy_outlier_detector_tag> detector(MAX_SPEED);
+	std::vector<std::vector<Trajectory::const_iterator>> sequences;
+	std::ptrdiff_t num_maximal = 0;
+	for (auto _ : state) {
+		sequences.clear();
+		num_maximal = std::distance(sequences.cbegin(), detector(trajectory.cbegin(), trajectory.cend(), sequences));
+	}
+	state.counters["sequences"] = static_cast<double>(num_maximal);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+using Probe = typename CartesianProbeTraits::ProbePoint;
+using OnlineDetector = movetk::outlierdetection::OnlineOutlierDetector<std::size_t, Probe, LinearSpeedBoundedTest>;
+constexpr std::size_t ONLINE_PROBES = 1 << 18;
+
+// Interleaved probes of the vehicles, as in a real-time feed
+std::vector<std::pair<std::size_t, Probe>> make_stream(std::size_t num_vehicles) {
+	std::vector<Trajectory> trajectories;
+	for (std::size_t v = 0; v < num_vehicles; ++v) {
+		trajectories.push_back(
+		    make_probes(Shape::RoadTrace, ONLINE_PROBES / num_vehicles, static_cast<std::uint32_t>(v + 1)));
+	}
+	std::vector<std::pair<std::size_t, Probe>> stream;
+	stream.reserve(ONLINE_PROBES);
+	for (std::size_t i = 0; i < ONLINE_PROBES; ++i) {
+		stream.emplace_back(i % num_vehicles, trajectories[i % num_vehicles][i / num_vehicles]);
+	}
+	return stream;
+}
+
+void online(benchmark::State& state, std::size_t num_threads) {
+	using movetk::outlierdetection::OutlierDecision;
+	const auto stream = make_stream(static_cast<std::size_t>(state.range(0)));
+	movetk::utils::ThreadPool pool(num_threads);
+	std::vector<std::size_t> rejected;
+	for (auto _ : state) {
+		OnlineDetector detector(MAX_SPEED);
+		// Counted per shard, since the shards of a batch are processed concurrently
+		rejected.assign(detector.num_shards(), 0);
+		auto count = [&](std::size_t id, const Probe&, OutlierDecision decision) {
+			rejected[detector.shard_index(id)] += decision == OutlierDecision::Rejected;
+		};
+		if (num_threads == 1) {
+			for (const auto& [id, probe] : stream) {
+				detector.push(id, probe, count);
+			}
+		} else {
+			const auto batch = static_cast<std::ptrdiff_t>(stream.size() / 64);
+			for (auto first = stream.begin(); first != stream.end(); first += batch) {
+				detector.push(first, first + batch, count, pool);
+			}
+		}
+		detector.flush(count);
+	}
+	state.counters["rejected"] = static_cast<double>(std::accumulate(rejected.begin(), rejected.end(), std::size_t(0)));
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(stream.size()));
+}
+
+// The output sensitive detector is not included: it tests probes against themselves, which fails the
+// time difference assertion of the linear speed bounded test.
+const bool registered = [] {
+	register_for_shapes("OutlierDetection/greedy", greedy, 256, 65536);
+	register_for_shapes("OutlierDetection/zheng", zheng, 256, 65536);
+	register_for_shapes("OutlierDetection/smart_greedy", smart_greedy, 64, 65536);
+	for (const std::size_t num_threads : {1, 4}) {
+		benchmark::RegisterBenchmark(("OutlierDetection/online/threads:" + std::to_string(num_threads)).c_str(),
+		                             online,
+		                             num_threads)
+		    ->RangeMultiplier(16)
+		    ->Range(16, 65536)
+		    ->UseRealTime();
+	}
+	return true;
+}();
+}  // namespace
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#include "BenchmarkInputs.h"
+#include "movetk/segmentation/SegmentationTraits.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using SegmentationTraits = movetk::segmentation::SegmentationTraits<NT, Kernel, 2>;
+
+void location_segmentation(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	// Segments fit in a disk of radius 5, spanning tens of unit steps
+	SegmentationTraits::LocationSegmentation segmentation(5);
+	std::vector<Polyline::const_iterator> segments;
+	for (auto _ : state) {
+		segments.clear();
+		segmentation(polyline.cbegin(), polyline.cend(), std::back_inserter(segments));
+		benchmark::DoNotOptimize(segments.data());
+	}
+	state.counters["segments"] = static_cast<double>(segments.size());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+void speed_segmentation(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0) + 1);
+	// Speeds between consecutive vertices, sampled every second
+	std::vector<NT> speeds;
+	speeds.reserve(polyline.size() - 1);
+	for (std::size_t i = 1; i < polyline.size(); ++i) {
+		const auto v = polyline[i] - polyline[i - 1];
+		speeds.push_back(std::sqrt(v * v));
+	}
+	SegmentationTraits::SpeedSegmentation segmentation(0.5);
+	std::vector<std::vector<NT>::const_iterator> segments;
+	for (auto _ : state) {
+		segments.clear();
+		segmentation(speeds.cbegin(), speeds.cend(), std::back_inserter(segments));
+		benchmark::DoNotOptimize(segments.data());
+	}
+	state.counters["segments"] = static_cast<double>(segments.size());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+const bool registered = [] {
+	register_for_shapes("MonotoneSegmentation/location", location_segmentation, 256, 65536);
+	register_for_shapes("MonotoneSegmentation/speed", speed_segmentation, 256, 65536);
+	return true;
+}();
+}  // namespace
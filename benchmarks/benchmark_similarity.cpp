@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkInputs.h"
+#include "movetk/metric/DistanceInterface.h"
+#include "movetk/metric/Distances.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using SqDistance = movetk::metric::squared_distance_d<Kernel, Norm>;
+
+void strong_frechet(benchmark::State& state, Shape shape) {
+	const auto a = make_polyline(shape, state.range(0));
+	const auto b = perturb(a, 0.5);
+	movetk::metric::StrongFrechet<Kernel, SqDistance> strong_frechet;
+	strong_frechet.setMode(decltype(strong_frechet)::Mode::DoubleAndSearch);
+	strong_frechet.setTolerance(0.0001);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(strong_frechet(a.begin(), a.end(), b.begin(), b.end()));
+	}
+	state.SetComplexityN(state.range(0));
+}
+
+void discrete_frechet(benchmark::State& state, Shape shape) {
+	const auto a = make_polyline(shape, state.range(0));
+	const auto b = perturb(a, 0.5);
+	movetk::metric::Discrete_Frechet<Kernel, Norm> discrete_frechet;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(discrete_frechet(a.begin(), a.end(), b.begin(), b.end()));
+	}
+	state.SetComplexityN(state.range(0));
+}
+
+// The discrete Frechet distance of the geometry backend, for comparison
+void backend_discrete_frechet(benchmark::State& state, Shape shape) {
+	const auto a = make_polyline(shape, state.range(0));
+	const auto b = perturb(a, 0.5);
+	movetk::metric::ComputeDiscreteFrechetDistance<Kernel, Norm> discrete_frechet;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(discrete_frechet(a.begin(), a.end(), b.begin(), b.end()));
+	}
+	state.SetComplexityN(state.range(0));
+}
+
+void weak_frechet(benchmark::State& state, Shape shape) {
+	const auto a = make_polyline(shape, state.range(0));
+	const auto b = perturb(a, 0.5);
+	movetk::metric::WeakFrechet<Kernel, SqDistance> weak_frechet;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(weak_frechet(a.begin(), a.end(), b.begin(), b.end()));
+	}
+	state.SetComplexityN(state.range(0));
+}
+
+// The measures are quadratic in the size of the polylines
+const bool registered = [] {
+	register_for_shapes("StrongFrechet", strong_frechet, 16, 512);
+	register_for_shapes("DiscreteFrechet", discrete_frechet, 16, 1024);
+	register_for_shapes("BackendDiscreteFrechet", backend_discrete_frechet, 16, 1024);
+	register_for_shapes("WeakFrechet", weak_frechet, 16, 512);
+	return true;
+}();
+}  // namespace
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+#include <vector>
+
+#include "BenchmarkInputs.h"
+#include "movetk/Simplification.h"
+#include "movetk/metric/Distances.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using SqDistance = movetk::metric::squared_distance_d<Kernel, Norm>;
+using Simplified = std::vector<Polyline::const_iterator>;
+
+// Tolerance of the simplifications, relative to the unit steps of the inputs
+constexpr NT EPSILON = 2;
+
+template <class Simplification>
+void run_simplification(benchmark::State& state, Simplification& simplification, const Polyline& polyline) {
+	Simplified result;
+	for (auto _ : state) {
+		result.clear();
+		simplification(polyline.cbegin(), polyline.cend(), std::back_inserter(result));
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.counters["output_size"] = static_cast<double>(result.size());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+void douglas_peucker(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	movetk::simplification::DouglasPeucker<Kernel, movetk::simplification::FindFarthest<Kernel, Norm>> simplification(
+	    EPSILON);
+	run_simplification(state, simplification, polyline);
+}
+
+void imai_iri(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	using Wedge = movetk::geom::Wedge<Kernel, Norm>;
+	movetk::simplification::ImaiIri<Kernel, movetk::simplification::ChanChin<Kernel, Wedge>> simplification(EPSILON);
+	run_simplification(state, simplification, polyline);
+}
+
+void agarwal(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	movetk::simplification::Agarwal<Kernel, SqDistance> simplification;
+	simplification.setEpsilon(EPSILON);
+	simplification.setTolerance(0.0001);
+	run_simplification(state, simplification, polyline);
+}
+
+const bool registered = [] {
+	register_for_shapes("DouglasPeucker", douglas_peucker, 64, 16384);
+	register_for_shapes("ImaiIri", imai_iri, 64, 2048);
+	register_for_shapes("Agarwal", agarwal, 64, 2048);
+	return true;
+}();
+}  // namespace
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "BenchmarkInputs.h"
+#include "movetk/Statistics.h"
+#include "movetk/ds/ColumnarTrajectory.h"
+#include "movetk/ds/TrajectoryCollection.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace {
+using namespace movetk::benchmarks;
+using SpeedStatistic = movetk::statistics::TrajectorySpeedStatistic<Kernel>;
+using Statistic = SpeedStatistic::Statistic;
+using Collection = movetk::ds::TrajectoryCollection<NT, NT, std::time_t>;
+
+const std::vector<Statistic> ALL_STATISTICS = {Statistic::Min,
+                                               Statistic::Max,
+                                               Statistic::Mean,
+                                               Statistic::Variance,
+                                               Statistic::Median};
+
+std::vector<std::time_t> make_times(std::size_t num_points) {
+	std::vector<std::time_t> times(num_points);
+	for (std::size_t i = 0; i < num_points; ++i) {
+		times[i] = static_cast<std::time_t>(i);
+	}
+	return times;
+}
+
+void speed(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	const auto times = make_times(polyline.size());
+	SpeedStatistic statistic;
+	for (auto _ : state) {
+		auto result = statistic(polyline.cbegin(), polyline.cend(), times.cbegin(), times.cend(), ALL_STATISTICS);
+		benchmark::DoNotOptimize(result.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+void length(benchmark::State& state, Shape shape) {
+	const auto polyline = make_polyline(shape, state.range(0));
+	std::vector<NT> xs, ys;
+	for (const auto& point : polyline) {
+		xs.push_back(point[0]);
+		ys.push_back(point[1]);
+	}
+	movetk::statistics::TrajectoryLength<Kernel> trajectory_length;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(trajectory_length(xs.cbegin(), xs.cend(), ys.cbegin(), ys.cend()));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+
+// A fleet of trips of 64 to 1024 points
+void collection(benchmark::State& state, std::size_t num_threads) {
+	Collection trips;
+	std::size_t num_points = 0;
+	for (std::size_t t = 0; t < static_cast<std::size_t>(state.range(0)); ++t) {
+		const auto polyline = make_polyline(Shape::RoadTrace, 64 << (t % 5), static_cast<std::uint32_t>(t + 1));
+		std::tuple<std::vector<NT>, std::vector<NT>, std::vector<std::time_t>> columns;
+		for (const auto& point : polyline) {
+			std::get<0>(columns).push_back(point[0]);
+			std::get<1>(columns).push_back(point[1]);
+		}
+		std::get<2>(columns) = make_times(polyline.size());
+		trips.push_back(movetk::ds::ColumnarTrajectory<NT, NT, std::time_t>(columns));
+		num_points += polyline.size();
+	}
+	movetk::utils::ThreadPool pool(num_threads);
+	SpeedStatistic statistic;
+	for (auto _ : state) {
+		auto columns = statistic.for_collection<0, 1, 2>(trips, ALL_STATISTICS, num_threads == 1 ? nullptr : &pool);
+		benchmark::DoNotOptimize(columns.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(num_points));
+}
+
+const bool registered = [] {
+	register_for_shapes("Statistics/speed", speed, 256, 65536);
+	register_for_shapes("Statistics/length", length, 256, 65536);
+	for (const std::size_t num_threads : {1, 4}) {
+		benchmark::RegisterBenchmark(("Statistics/speed_collection/threads:" + std::to_string(num_threads)).c_str(),
+		                             collection,
+		                             num_threads)
+		    ->RangeMultiplier(8)
+		    ->Range(64, 4096)
+		    ->UseRealTime();
+	}
+	return true;
+}();
+}  // namespace
@@ -9,6 +9,19 @@ CreateImportTarget(Boost)
 
 find_package(Threads REQUIRED)
 
+find_package(ZLIB REQUIRED)
+
+if(MOVETK_WITH_ZSTD)
+    find_path(ZSTD_INCLUDE_DIR zstd.h REQUIRED)
+    find_library(ZSTD_LIBRARY NAMES zstd REQUIRED)
+    if(NOT TARGET zstd::zstd)
+        add_library(zstd::zstd UNKNOWN IMPORTED)
+        set_target_properties(zstd::zstd PROPERTIES
+            IMPORTED_LOCATION ${ZSTD_LIBRARY}
+            INTERFACE_INCLUDE_DIRECTORIES ${ZSTD_INCLUDE_DIR})
+    endif()
+endif()
+
 find_package(GeographicLib REQUIRED COMPONENTS SHARED)
 CreateImportTarget(GeographicLib)
 
@@ -64,4 +64,35 @@ if(MOVETK_DOWNLOAD_THIRDPARTY)
             CreateImportTarget(Catch2)
         endif()
     endif()
+
+    if(MOVETK_BUILD_BENCHMARKS)
+        find_package(benchmark QUIET)
+        if(NOT benchmark_FOUND)
+            message(STATUS "Adding external Google Benchmark")
+            FetchContent_Declare(
+                benchmark
+                GIT_REPOSITORY "https://github.com/google/benchmark.git"
+                GIT_TAG v1.7.1
+            )
+            # Check if population has already been performed
+            FetchContent_GetProperties(benchmark)
+            if(NOT benchmark_POPULATED)
+                # Fetch the content using previously declared details
+                FetchContent_Populate(benchmark)
+                execute_process(
+                    COMMAND ${CMAKE_COMMAND} -S ${benchmark_SOURCE_DIR} -B ${benchmark_BINARY_DIR} -G${CMAKE_GENERATOR}
+                        -DCMAKE_BUILD_TYPE=Release
+                        -DBENCHMARK_ENABLE_TESTING=OFF
+                        -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+                        -DBENCHMARK_ENABLE_INSTALL=ON
+                        -DCMAKE_INSTALL_PREFIX=${benchmark_BINARY_DIR}/installed
+                )
+                execute_process(
+                    COMMAND ${CMAKE_COMMAND} --build ${benchmark_BINARY_DIR} --config Release --target install
+                )
+            endif()
+            list(PREPEND CMAKE_PREFIX_PATH ${benchmark_BINARY_DIR}/installed)
+            find_package(benchmark CONFIG REQUIRED)
+        endif()
+    endif()
 endif()
\ No newline at end of file
@@ -101,15 +101,18 @@ void run(int argc, char** argv) {
 		// Show speed statistics:
 		using SpeedStat = movetk::statistics::TrajectorySpeedStatistic<GeomKernel, Distance>;
 		SpeedStat speedStat;
-		auto compute_stat = [&pointIterators, &ts, &speedStat](auto stat_type) {
-			return speedStat(pointIterators.first, pointIterators.second, ts.begin(), ts.end(), stat_type);
-		};
 		using Stat = typename SpeedStat::Statistic;
-		std::cout << "Trajectory average speed:" << compute_stat(Stat::Mean) << std::endl;
-		std::cout << "Trajectory median speed:" << compute_stat(Stat::Median) << std::endl;
-		std::cout << "Trajectory min speed:" << compute_stat(Stat::Min) << std::endl;
-		std::cout << "Trajectory max speed:" << compute_stat(Stat::Max) << std::endl;
-		std::cout << "Trajectory variance of speed:" << compute_stat(Stat::Variance) << std::endl;
+		// All statistics are computed in a single pass over the trajectory
+		const auto speeds = speedStat(pointIterators.first,
+		                              pointIterators.second,
+		                              ts.begin(),
+		                              ts.end(),
+		                              {Stat::Mean, Stat::Median, Stat::Min, Stat::Max, Stat::Variance});
+		std::cout << "Trajectory average speed:" << speeds[0] << std::endl;
+		std::cout << "Trajectory median speed:" << speeds[1] << std::endl;
+		std::cout << "Trajectory min speed:" << speeds[2] << std::endl;
+		std::cout << "Trajectory max speed:" << speeds[3] << std::endl;
+		std::cout << "Trajectory variance of speed:" << speeds[4] << std::endl;
 
 		// Show time mode
 		movetk::statistics::ComputeDominantDifference timeMode;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "Timer.h"
+#include "movetk/io/BlockCompression.h"
+#include "movetk/io/SyntheticTrajectoryGenerator.h"
+#include "movetk/utils/ThreadPool.h"
+
+/**
+ * Example: Generate synthetic vehicle trajectories in the c2d raw probe format, for load testing
+ *          the readers, splitters and outlier detection. The output is the same for any number of threads.
+ *          .bgz files are written as BGZF and .zst files as seekable zstd, which are decompressed in parallel.
+ *
+ * Usage: generate_trajectories <output.csv|output.csv.gz|output.csv.bgz|output.csv.zst> [num_trajectories] [seed]
+ *        [urban|highway|constant]
+ */
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0]
+		          << " <output.csv|output.csv.gz|output.csv.bgz|output.csv.zst> [num_trajectories] [seed] [urban|highway|constant]\n";
+		return 1;
+	}
+	const std::string file_name = argv[1];
+	const std::size_t num_trajectories = argc > 2 ? std::stoull(argv[2]) : 1000;
+
+	movetk::io::SyntheticTrajectoryOptions options;
+	if (argc > 3) {
+		options.seed = std::stoull(argv[3]);
+	}
+	if (argc > 4) {
+		const std::string profile = argv[4];
+		if (profile == "highway") {
+			options.speed_profile = movetk::io::SpeedProfile::Highway;
+			options.max_speed = 33;
+		} else if (profile == "constant") {
+			options.speed_profile = movetk::io::SpeedProfile::Constant;
+		}
+	}
+	movetk::io::SyntheticTrajectoryGenerator generator(options);
+	movetk::utils::ThreadPool pool;
+
+	std::cerr << "Generating " << num_trajectories << " trajectories with " << pool.size() << " threads\n";
+	Timer timer;
+	timer.start();
+	try {
+		if (file_name.ends_with(".gz")) {
+			std::ofstream out(file_name, std::ios_base::out | std::ios_base::binary);
+			generator.write_gzip_csv(out, num_trajectories, &pool);
+			out.close();
+			if (!out) {
+				throw std::runtime_error("Failed to write output");
+			}
+		} else {
+			auto out = movetk::io::open_compressed(file_name, pool.size());
+			generator.write_csv(*out, num_trajectories, &pool);
+			out->close();
+		}
+	} catch (const std::exception &e) {
+		std::cerr << "Cannot write " << file_name << ": " << e.what() << "\n";
+		return 1;
+	}
+	timer.stop();
+	std::cerr << "Time: " << timer << "\n";
+	return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Timer.h"
+#include "movetk/io/BlockCompression.h"
+
+/**
+ * Example: Re-encode a (gzipped) probe file as BGZF (.gz or .bgz) or as seekable zstd (.zst),
+ *          which ProbeReaderFactory decompresses in parallel.
+ *
+ * Usage: recompress_probes <input.csv|input.csv.gz|input.csv.zst> <output.csv.bgz|output.csv.gz|output.csv.zst>
+ *        [num_threads]
+ */
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] << " <input> <output.bgz|output.gz|output.zst> [num_threads]\n";
+		return 1;
+	}
+	const std::size_t num_threads = argc > 3 ? std::stoull(argv[3]) : std::thread::hardware_concurrency();
+
+	Timer timer;
+	timer.start();
+	auto in = movetk::io::open_decompressed(argv[1], num_threads);
+	auto out = movetk::io::open_compressed(argv[2], num_threads);
+	std::vector<char> buffer(1 << 20);
+	std::size_t size = 0;
+	while (in->read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in->gcount() > 0) {
+		out->write(buffer.data(), in->gcount());
+		size += static_cast<std::size_t>(in->gcount());
+	}
+	// Writes the trailer of the format
+	try {
+		out->close();
+	} catch (const std::exception &e) {
+		std::cerr << "Cannot write " << argv[2] << ": " << e.what() << "\n";
+		return 1;
+	}
+	timer.stop();
+	std::cerr << "Recompressed " << size << " bytes in " << timer << "\n";
+	return 0;
+}
@@ -22,13 +22,15 @@
 //
 
 #include <GeographicLib/Geohash.hpp>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 
-#include "movetk/ds/Tree.h"
+#include "movetk/ds/GeohashIndex.h"
+#include "movetk/ds/PolygonGridIndex.h"
 #include "movetk/geom/CGALTraits.h"
 #include "movetk/utils/Iterators.h"
 
@@ -45,27 +47,6 @@ struct MyTraits {
 	using Polygon = typename MovetkGeometryKernel::MovetkPolygon;
 };
 
-template <class T>
-class Values {
-private:
-	string id;
-	std::vector<T> values;
-
-public:
-	typedef typename std::vector<T>::const_iterator Iterator;
-
-	Values(string &identifier) : id(identifier) {}
-
-	void operator()(T &value) { values.push_back(value); }
-
-	string &operator()() { return id; }
-
-	Iterator begin() { return cbegin(values); }
-
-	Iterator end() { return cend(values); }
-};
-
-
 template <class GeometryTraits, class OutputIterator>
 void make_polygons(string &PolygonFile, OutputIterator iter) {
 	cerr << "Reading in Polygons from: " << PolygonFile << endl;
@@ -208,7 +189,7 @@ bool parse_input(int argc, char **argv, string &PolygonsFile, string &CentroidsF
 	return 0;
 }
 
-template <class GeometryTraits, class Node>
+template <class GeometryTraits, class Index>
 struct Probe {
 	typedef typename GeometryTraits::MovetkGeometryKernel::NT NT;
 	movetk::utils::cast<NT> cast;
@@ -216,37 +197,25 @@ struct Probe {
 	size_t lat_idx = 1, lon_idx = 2, x_idx = 3, y_idx = 4;
 	NT Lat, Lon;
 	string geohash, id;
-	size_t PolygonId = 0;
 	int MatchedPolygonId = -1;
-	movetk::geom::MakePoint<typename GeometryTraits::MovetkGeometryKernel> make_point;
 
-	template <class InputIterator, class PolygonsIterator>
-	bool operator()(movetk::ds::Tree<Node> &tree,
-	                size_t &resolution,
-	                InputIterator first,
-	                PolygonsIterator pfirst,
-	                PolygonsIterator pbeyond) {
+	template <class InputIterator, class PolygonIndex>
+	bool operator()(Index &tree, size_t &resolution, InputIterator first, const PolygonIndex &polygon_index) {
 		Lat = cast(*(first + lat_idx));
 		Lon = cast(*(first + lon_idx));
 		point[0] = cast(*(first + x_idx));
 		point[1] = cast(*(first + y_idx));
-		PolygonId = 0;
 		MatchedPolygonId = -1;
-		typename GeometryTraits::Point P = make_point(std::cbegin(point), std::cend(point));
-		Geohash::Forward(Lat, Lon, resolution + 1, geohash);
+		// One character finer than the polygon geohashes, within the maximum length of the index
+		Geohash::Forward(Lat, Lon, std::min(resolution + 1, Index::MAX_LENGTH), geohash);
 		// cerr<<"Lat: "<<Lat<<", Lon: "<<Lon<<", Resolution:"<<resolution + 1<<", geohash: "<<geohash<<"\n";
-		typename Node::reference MatchedChild = tree.find(begin(geohash), end(geohash));
+		tree.find(begin(geohash), end(geohash));
 		if (tree.get_match_size() == resolution) {
-			PolygonsIterator it = pfirst;
-			while (it != pbeyond) {
-				if (movetk::backends::cgal::CGAL_Algorithms::point_in_polygon(P, *it)) {
-					MatchedPolygonId = PolygonId;
-					// std::cerr<<"Matched Polygon is: "<< MatchedPolygonId << std::endl;
-					return true;
-				}
-				PolygonId++;
-				// std::cerr<<"Polygon Id:"<<PolygonId<<std::endl;
-				it++;
+			const auto PolygonId = polygon_index.locate(point[0], point[1]);
+			if (PolygonId != PolygonIndex::npos) {
+				MatchedPolygonId = static_cast<int>(PolygonId);
+				// std::cerr<<"Matched Polygon is: "<< MatchedPolygonId << std::endl;
+				return true;
 			}
 		}
 		return false;
@@ -272,16 +241,16 @@ int main(int argc, char **argv) {
 		return 0;
 
 	typedef MyTraits<long double, 2> GeometryTraits;
-	typedef movetk::ds::TrieNode<const char, Values<string>> Node;
+	typedef movetk::ds::GeohashIndex<string> Index;
 
 
-	movetk::ds::Tree<Node> tree(std::make_unique<Node>('a'));
+	Index tree;
 	std::vector<typename GeometryTraits::Polygon> polygons;
 	std::vector<std::pair<std::string, size_t>> leaves;
 	std::vector<string> tokens;
 	std::vector<bool> intersection_flags;
 	std::vector<int> polygon_ids;
-	// std::vector<Probe<GeometryTraits, Node> > trajectory;
+	// std::vector<Probe<GeometryTraits, Index> > trajectory;
 	size_t id_idx = 0, LineCount = 0;
 
 	make_polygons<GeometryTraits>(PolygonFile, std::back_inserter(polygons));
@@ -292,6 +261,9 @@ int main(int argc, char **argv) {
 		cerr << "\n";
 	}
 
+	movetk::ds::PolygonGridIndex<typename GeometryTraits::MovetkGeometryKernel> polygon_index(std::cbegin(polygons),
+	                                                                                        std::cend(polygons));
+
 	build_index<GeometryTraits>(tree, CentroidsFile, resolution);
 	tree.find(std::back_inserter(leaves));
 	cerr << "Branch Id, Number of Elements" << endl;
@@ -304,12 +276,12 @@ int main(int argc, char **argv) {
 		// cerr<<line<<std::endl;
 		movetk::utils::split(line, std::back_inserter(tokens));
 		assert(tokens.size() >= 5);
-		Probe<GeometryTraits, Node> probe;
+		Probe<GeometryTraits, Index> probe;
 		CurrentId = tokens[id_idx];
 
 		if (PreviousId == "" || (PreviousId == CurrentId)) {
 			intersection_flags.push_back(
-			    probe(tree, resolution, std::begin(tokens), std::begin(polygons), std::end(polygons)));
+			    probe(tree, resolution, std::begin(tokens), polygon_index));
 			polygon_ids.push_back(probe());
 
 			// trajectory.push_back(probe);
@@ -338,7 +310,7 @@ int main(int argc, char **argv) {
 			polygon_ids.clear();
 			// trajectory.clear();
 			intersection_flags.push_back(
-			    probe(tree, resolution, std::begin(tokens), std::begin(polygons), std::end(polygons)));
+			    probe(tree, resolution, std::begin(tokens), polygon_index));
 			polygon_ids.push_back(probe());
 			// trajectory.push_back(probe);
 		}
@@ -49,7 +49,8 @@ public:
 		          << "\t-tr,--trajectory\t\tTrajectories file\n"
 		          << "\t--head\t\t\tSpecify this when the input file has header\n"
 		          << "\t-idx,--indexes\t\tPosition of columns in the input\n"
-		          << "\t-t,--speed_threshold\t\tThreshold\n";
+		          << "\t-t,--speed_threshold\t\tThreshold\n"
+		          << "\t-s,--seed\t\tSeed of the random generator, for reproducible output\n";
 	}
 
 	bool operator()(int argc, char **argv) {
@@ -94,15 +95,16 @@ public:
 
 private:
 	static const int MinArgs = 4;
-	static const int MaxArgs = 9;
+	static const int MaxArgs = 11;
 	bool header = false, stream = true;
 	typedef std::tuple<std::string, std::string, bool> earg;
 	std::vector<earg> eargs{std::make_tuple("--head", "--head", false),
 	                        std::make_tuple("-tr", "--trajectory", true),
 	                        std::make_tuple("-idx", "--indexes", true),
-	                        std::make_tuple("-t", "--speed_threshold", true)};
+	                        std::make_tuple("-t", "--speed_threshold", true),
+	                        std::make_tuple("-s", "--seed", true)};
 
-	std::map<std::string, std::string> params{{"-tr", ""}, {"-t", ""}, {"-idx", ""}, {"--head", ""}};
+	std::map<std::string, std::string> params{{"-tr", ""}, {"-t", ""}, {"-idx", ""}, {"--head", ""}, {"-s", ""}};
 
 	void set_flags(std::string arg) {
 		if (arg == "--head")
@@ -231,7 +233,9 @@ int main(int argc, char **argv) {
 	auto pit = std::cbegin(trajectory);
 	MovetkGeometryKernel::NT lat0 = std::get<ProbeTraits::ProbeColumns::LAT>(*pit);
 	MovetkGeometryKernel::NT lon0 = std::get<ProbeTraits::ProbeColumns::LON>(*pit);
-	Interpolator interpolator(lat0, lon0);
+	key = "-s";
+	std::string seed = parse.get_parameter(key);
+	Interpolator interpolator = seed.empty() ? Interpolator(lat0, lon0) : Interpolator(lat0, lon0, 0.9999, std::stoull(seed));
 	std::cout << "SAMPLE_DATE, LAT, LON, HEADING, SPEED\n";
 	while (++pit != std::cend(trajectory)) {
 		std::vector<typename ProbeTraits::ProbePoint> interpolated_pts;
@@ -21,16 +21,21 @@
 // Created by Mitra, Aniket on 08/11/2020.
 //
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "HereTrajectoryTraits.h"
 #include "movetk/Statistics.h"
-#include "movetk/io/GeoJSON.h"
+#include "movetk/io/GeoJSONWriter.h"
 #include "movetk/io/ProbeReader.h"
 #include "movetk/io/TrajectoryReader.h"
 #include "movetk/utils/GeometryBackendTraits.h"
+#include "movetk/utils/ThreadPool.h"
 #include "test_data.h"
 
 constexpr int LON_Idx = here::c2d::raw::ProbeColumns::LON;
@@ -147,12 +152,9 @@ public:
 	typename MovetkGeometryKernel::NT get_time_mode() { return time_mode; }
 };
 
-template <class Trajectory_t, class PropertyIterator>
-void write_geojson(Trajectory_t &trajectory, PropertyIterator first, PropertyIterator beyond, std::ofstream &ofjson) {
-	// write GeoJSON
-	movetk::io::GeoJSONGeometry geom;
-	movetk::io::GeoJSONProperties prop;
-	movetk::io::GeoJSONFeature feat;
+template <class Trajectory_t>
+void write_geojson(Trajectory_t &trajectory, std::size_t count, movetk::io::GeoJSONFeatureWriter &writer) {
+	ComputeStatistics statistics(trajectory, count);
 
 	auto lats = trajectory.template get<LAT_Idx>();
 	auto lons = trajectory.template get<LON_Idx>();
@@ -163,15 +165,13 @@ void write_geojson(Trajectory_t &trajectory, PropertyIterator first, PropertyIte
 		return static_cast<int>(val.ts());
 	});
 
-	rapidjson::Document geometry = geom(std::begin(lats), std::end(lats), std::begin(lons), std::begin(timestamps));
-
-	rapidjson::Document properties = prop(first, beyond);
-	rapidjson::Document feature = feat(geometry, properties);
-	rapidjson::StringBuffer strbuf;
-	rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
-	feature.Accept(writer);
-	ofjson << strbuf.GetString();
-	strbuf.Clear();
+	// Streamed into the writer's buffer, without building a document
+	writer.line_string(std::begin(lats),
+	                   std::end(lats),
+	                   std::begin(lons),
+	                   std::begin(timestamps),
+	                   statistics.begin(),
+	                   statistics.end());
 }
 
 int main(int argc, char **argv) {
@@ -194,31 +194,45 @@ int main(int argc, char **argv) {
 	auto tr =
 	    movetk::io::TrajectoryReader<TrajectoryTraits, ProbeInputIterator>(probe_reader->begin(), probe_reader->end());
 
-	std::ofstream ofjson("output_trajectories.geojson");
-	ofjson.setf(std::ios::fixed);
-
-	ofjson << "{\"type\":\"FeatureCollection\",\"features\":[";
+	// Write one feature per line with --ndjson
+	const bool line_delimited = argc > 2 && std::string(argv[2]) == "--ndjson";
+	std::ofstream ofjson(line_delimited ? "output_trajectories.geojsonl" : "output_trajectories.geojson");
+	movetk::io::GeoJSONFeatureCollectionWriter writer(
+	    ofjson,
+	    7,
+	    line_delimited ? movetk::io::GeoJSONLayout::LineDelimited : movetk::io::GeoJSONLayout::FeatureCollection);
+
+	// Batches of trajectories are serialized in parallel, in the order they are read
+	constexpr std::size_t BATCH_SIZE = 1024;
+	movetk::utils::ThreadPool pool;
+	using Trajectory = std::decay_t<decltype(*tr.begin())>;
+	std::vector<std::pair<Trajectory, std::size_t>> batch;
+	auto write_batch = [&]() {
+		writer.write(
+		    batch.begin(),
+		    batch.end(),
+		    [](auto &item, movetk::io::GeoJSONFeatureWriter &feature_writer) {
+			    write_geojson(item.first, item.second, feature_writer);
+		    },
+		    &pool);
+		batch.clear();
+	};
 
 	std::size_t count = 0;
-	for (auto tit = tr.begin(); tit != tr.end();) {
+	for (auto tit = tr.begin(); tit != tr.end(); ++tit) {
 		auto trajectory = *tit;
 		if (trajectory.size() == 1) {
-			++tit;
 			continue;
 		}
-
-		ComputeStatistics statistics(trajectory, count);
-		auto property_iterator_first = statistics.begin();
-		auto property_iterator_beyond = statistics.end();
-		write_geojson(trajectory, property_iterator_first, property_iterator_beyond, ofjson);
-		if (++tit == tr.end())
-			continue;
-		else
-			ofjson << ",";
-
-		count++;
+		batch.emplace_back(std::move(trajectory), count++);
+		if (batch.size() == BATCH_SIZE) {
+			write_batch();
+		}
+	}
+	write_batch();
+	writer.close();
+	if (!line_delimited) {
+		ofjson << std::endl;
 	}
-
-	ofjson << "]}" << std::endl;
 	return 0;
 }
\ No newline at end of file
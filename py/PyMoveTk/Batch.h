@@ -0,0 +1,167 @@
+#ifndef PYMOVETK_BATCH_H
+#define PYMOVETK_BATCH_H
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "movetk/geom/GeometryInterface.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace PyMoveTk {
+/**
+ * \brief Random access iterator over the rows of n x 2 contiguous coordinates, constructing points of the kernel
+ * on dereference. Only the pointer to the x-coordinate of the current row is stored, the y-coordinate is read
+ * from the next element, so the end iterator points one past the coordinates and no pointer leaves the buffer.
+ * \tparam MovetkGeometryKernel The kernel
+ * \tparam Coordinate Type of the coordinates
+ */
+template <typename MovetkGeometryKernel, typename Coordinate>
+class InterleavedPointIterator {
+public:
+	using NT = typename MovetkGeometryKernel::NT;
+	using value_type = typename MovetkGeometryKernel::MovetkPoint;
+	using reference = value_type;
+	using difference_type = std::ptrdiff_t;
+	using iterator_category = std::random_access_iterator_tag;
+	using iterator_concept = std::random_access_iterator_tag;
+
+	InterleavedPointIterator() = default;
+	explicit InterleavedPointIterator(const Coordinate *row) : m_row(row) {}
+
+	value_type operator*() const {
+		return movetk::geom::MakePoint<MovetkGeometryKernel>()({static_cast<NT>(m_row[0]), static_cast<NT>(m_row[1])});
+	}
+	value_type operator[](difference_type n) const { return *(*this + n); }
+
+	InterleavedPointIterator &operator++() {
+		m_row += 2;
+		return *this;
+	}
+	InterleavedPointIterator operator++(int) {
+		auto old = *this;
+		++*this;
+		return old;
+	}
+	InterleavedPointIterator &operator--() {
+		m_row -= 2;
+		return *this;
+	}
+	InterleavedPointIterator operator--(int) {
+		auto old = *this;
+		--*this;
+		return old;
+	}
+	InterleavedPointIterator &operator+=(difference_type n) {
+		m_row += 2 * n;
+		return *this;
+	}
+	InterleavedPointIterator &operator-=(difference_type n) { return *this += -n; }
+	friend InterleavedPointIterator operator+(InterleavedPointIterator it, difference_type n) { return it += n; }
+	friend InterleavedPointIterator operator+(difference_type n, InterleavedPointIterator it) { return it += n; }
+	friend InterleavedPointIterator operator-(InterleavedPointIterator it, difference_type n) { return it -= n; }
+	friend difference_type operator-(const InterleavedPointIterator &a, const InterleavedPointIterator &b) {
+		return (a.m_row - b.m_row) / 2;
+	}
+	friend bool operator==(const InterleavedPointIterator &a, const InterleavedPointIterator &b) {
+		return a.m_row == b.m_row;
+	}
+	friend auto operator<=>(const InterleavedPointIterator &a, const InterleavedPointIterator &b) {
+		return a.m_row <=> b.m_row;
+	}
+
+private:
+	const Coordinate *m_row = nullptr;
+};
+
+/**
+ * \brief Polyline view of n points stored as n x 2 contiguous float64 coordinates, such as the buffer of a
+ * C-contiguous NumPy array of shape (n, 2). Points are constructed on access, converting the coordinates
+ * to the number type of the kernel, so the coordinates are not copied. The view does not own the coordinates.
+ * An empty view may have null coordinates.
+ * \tparam MovetkGeometryKernel The kernel
+ */
+template <typename MovetkGeometryKernel>
+struct PointArray {
+	using Coordinate = double;
+	using const_iterator = InterleavedPointIterator<MovetkGeometryKernel, Coordinate>;
+
+	const Coordinate *coordinates = nullptr;
+	std::size_t num_points = 0;
+
+	const_iterator begin() const { return const_iterator(num_points == 0 ? nullptr : coordinates); }
+	const_iterator end() const { return const_iterator(num_points == 0 ? nullptr : coordinates + 2 * num_points); }
+	std::size_t size() const { return num_points; }
+};
+
+namespace detail {
+/**
+ * \brief Returns the number of threads to use, where 0 selects the hardware concurrency
+ */
+inline std::size_t thread_count(std::size_t num_threads) {
+	return num_threads == 0 ? std::thread::hardware_concurrency() : num_threads;
+}
+}  // namespace detail
+
+/**
+ * \brief Evaluates a measure between all pairs of polylines on a pool of threads.
+ * Does not touch Python objects, so it can run with the GIL released.
+ * \param rows Polylines of the rows of the matrix
+ * \param columns Polylines of the columns of the matrix. If null, the rows are used as columns
+ * and the measure is assumed to be symmetric, so only the upper triangle is evaluated.
+ * \param measure Callable taking two polylines, called concurrently
+ * \param result Output of the row-major matrix
+ * \param num_threads Number of threads, 0 for the hardware concurrency
+ */
+template <typename Polyline, typename Measure, typename Result>
+void pairwise(const std::vector<Polyline> &rows,
+              const std::vector<Polyline> *columns,
+              Measure &&measure,
+              Result *result,
+              std::size_t num_threads) {
+	movetk::utils::ThreadPool pool(detail::thread_count(num_threads));
+	if (columns == nullptr) {
+		const auto n = rows.size();
+		auto evaluate_row = [&](std::size_t i) {
+			for (auto j = i; j < n; ++j) {
+				result[i * n + j] = result[j * n + i] = measure(rows[i], rows[j]);
+			}
+		};
+		// Row i of the upper triangle has n - i cells, so rows k and n - 1 - k are evaluated together,
+		// which gives every task n + 1 cells.
+		pool.parallel_for(0, (n + 1) / 2, [&](std::size_t k) {
+			evaluate_row(k);
+			if (n - 1 - k != k) {
+				evaluate_row(n - 1 - k);
+			}
+		});
+	} else {
+		const auto m = columns->size();
+		pool.parallel_for(0, rows.size(), [&](std::size_t i) {
+			for (std::size_t j = 0; j < m; ++j) {
+				result[i * m + j] = measure(rows[i], (*columns)[j]);
+			}
+		});
+	}
+}
+
+/**
+ * \brief Simplifies all polylines on a pool of threads.
+ * Does not touch Python objects, so it can run with the GIL released.
+ * \param polylines The polylines
+ * \param simplify Callable taking a polyline and returning the indices of the simplification, called concurrently
+ * \param num_threads Number of threads, 0 for the hardware concurrency
+ * \return The indices of the simplification of every polyline
+ */
+template <typename Polyline, typename Simplify>
+std::vector<std::vector<std::size_t>> simplify_all(const std::vector<Polyline> &polylines,
+                                                   Simplify &&simplify,
+                                                   std::size_t num_threads) {
+	std::vector<std::vector<std::size_t>> indices(polylines.size());
+	movetk::utils::ThreadPool pool(detail::thread_count(num_threads));
+	pool.parallel_for(0, polylines.size(), [&](std::size_t i) { indices[i] = simplify(polylines[i]); });
+	return indices;
+}
+}  // namespace PyMoveTk
+#endif
@@ -1,7 +1,208 @@
 #ifndef PYMOVETK_DISTANCES_H
 #define PYMOVETK_DISTANCES_H
+#include <movetk/Similarity.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <vector>
+
+#include "Batch.h"
+#include "Geometry.h"
 
 namespace PyMoveTk {
-    
-}
-#endif
\ No newline at end of file
+/**
+ * \brief Distances and similarity measures on NumPy arrays of shape (n, 2).
+ * C-contiguous float64 arrays are read in place, the GIL is released during the computation,
+ * and the *_matrix variants evaluate all pairs of a list of arrays on a pool of C++ threads.
+ * Registered after the SimilarityModule, so the Polyline overloads take precedence.
+ */
+template <typename GeometryKernel, typename Norm>
+struct DistancesModule {
+	using MoveTkKernel = typename GeometryKernel::MovetkGeometryKernel;
+	using UsedGeometryModule = GeometryModule<MoveTkKernel, Norm>;
+	using CoordinateArray = typename UsedGeometryModule::CoordinateArray;
+	using NT = typename GeometryKernel::NT;
+	using SqDistance = movetk::metric::squared_distance_d<MoveTkKernel, Norm>;
+
+private:
+	/**
+	 * \brief Applies a measure to two arrays with the GIL released
+	 */
+	template <typename Measure>
+	static auto apply(const CoordinateArray& a, const CoordinateArray& b, Measure&& measure) {
+		const auto polyline_a = UsedGeometryModule::as_point_array(a);
+		const auto polyline_b = UsedGeometryModule::as_point_array(b);
+		pybind11::gil_scoped_release release;
+		return measure(polyline_a, polyline_b);
+	}
+
+	/**
+	 * \brief Applies a measure to all pairs of arrays of rows and columns, with the GIL released
+	 * \param rows Sequence of arrays
+	 * \param columns Sequence of arrays, or None to use the rows, assuming a symmetric measure
+	 * \param num_threads Number of threads, 0 for the hardware concurrency
+	 * \param measure The measure
+	 * \return NumPy array of shape (len(rows), len(columns))
+	 */
+	template <typename Result, typename Measure>
+	static pybind11::array_t<Result> apply_pairwise(const pybind11::sequence& rows,
+	                                                const pybind11::object& columns,
+	                                                std::size_t num_threads,
+	                                                Measure&& measure) {
+		std::vector<CoordinateArray> row_arrays, column_arrays;
+		const auto row_polylines = UsedGeometryModule::as_point_arrays(rows, row_arrays);
+		std::vector<PointArray<MoveTkKernel>> column_polylines;
+		if (!columns.is_none()) {
+			column_polylines = UsedGeometryModule::as_point_arrays(columns.cast<pybind11::sequence>(), column_arrays);
+		}
+		const auto num_columns = columns.is_none() ? row_polylines.size() : column_polylines.size();
+		pybind11::array_t<Result> result({static_cast<pybind11::ssize_t>(row_polylines.size()),
+		                                  static_cast<pybind11::ssize_t>(num_columns)});
+		auto* output = result.mutable_data();
+		{
+			pybind11::gil_scoped_release release;
+			pairwise(row_polylines, columns.is_none() ? nullptr : &column_polylines, measure, output, num_threads);
+		}
+		return result;
+	}
+
+public:
+	static void register_distances(pybind11::module& mod) {
+		namespace py = pybind11;
+		using namespace pybind11::literals;
+		auto discrete_hausdorff = [](const auto& p0, const auto& p1) -> NT {
+			movetk::metric::Discrete_Hausdorff<MoveTkKernel, Norm> measure;
+			return measure(p0.begin(), p0.end(), p1.begin(), p1.end());
+		};
+		auto discrete_frechet = [](const auto& p0, const auto& p1) -> NT {
+			movetk::metric::Discrete_Frechet<MoveTkKernel, Norm> measure;
+			return measure(p0.begin(), p0.end(), p1.begin(), p1.end());
+		};
+		mod.def(
+		       "compute_discrete_hausdorff",
+		       [=](const CoordinateArray& p0, const CoordinateArray& p1) { return apply(p0, p1, discrete_hausdorff); },
+		       "Compute the discrete Hausdorff distance between arrays of shape (n, 2)",
+		       "polyline0"_a,
+		       "polyline1"_a)
+		    .def(
+		        "discrete_hausdorff_matrix",
+		        [=](const py::sequence& rows, const py::object& columns, std::size_t num_threads) {
+			        return apply_pairwise<NT>(rows, columns, num_threads, discrete_hausdorff);
+		        },
+		        "Compute the discrete Hausdorff distance between all pairs of arrays of shape (n, 2) in parallel. "
+		        "Without columns, the distances between all pairs of rows are computed.",
+		        "rows"_a,
+		        "columns"_a = py::none(),
+		        "num_threads"_a = 0)
+		    .def(
+		        "compute_discrete_frechet",
+		        [=](const CoordinateArray& p0, const CoordinateArray& p1) { return apply(p0, p1, discrete_frechet); },
+		        "Compute the discrete Frechet distance between arrays of shape (n, 2)",
+		        "polyline0"_a,
+		        "polyline1"_a)
+		    .def(
+		        "discrete_frechet_matrix",
+		        [=](const py::sequence& rows, const py::object& columns, std::size_t num_threads) {
+			        return apply_pairwise<NT>(rows, columns, num_threads, discrete_frechet);
+		        },
+		        "Compute the discrete Frechet distance between all pairs of arrays of shape (n, 2) in parallel. "
+		        "Without columns, the distances between all pairs of rows are computed.",
+		        "rows"_a,
+		        "columns"_a = py::none(),
+		        "num_threads"_a = 0);
+	}
+
+	static void register_strong_frechet(pybind11::module& mod) {
+		namespace py = pybind11;
+		using namespace pybind11::literals;
+		using StrongFrechet = movetk::metric::StrongFrechet<MoveTkKernel, SqDistance>;
+		auto strong_frechet = [](NT tolerance) {
+			return [tolerance](const auto& p0, const auto& p1) -> NT {
+				StrongFrechet measure;
+				measure.setMode(StrongFrechet::Mode::DoubleAndSearch);
+				measure.setTolerance(tolerance);
+				return measure(p0.begin(), p0.end(), p1.begin(), p1.end());
+			};
+		};
+		mod.def(
+		       "decide_strong_frechet",
+		       [](const CoordinateArray& p0, const CoordinateArray& p1, NT epsilon) {
+			       return apply(p0, p1, [epsilon](const auto& a, const auto& b) {
+				       return StrongFrechet().decide(a.begin(), a.end(), b.begin(), b.end(), epsilon);
+			       });
+		       },
+		       "Decide whether the strong Frechet distance between arrays of shape (n, 2) is at most epsilon.",
+		       "polyline0"_a,
+		       "polyline1"_a,
+		       "epsilon"_a)
+		    .def(
+		        "compute_strong_frechet",
+		        [=](const CoordinateArray& p0, const CoordinateArray& p1, NT tolerance) {
+			        return apply(p0, p1, strong_frechet(tolerance));
+		        },
+		        "Compute the strong Frechet distance between arrays of shape (n, 2) by double and search, up to the "
+		        "given tolerance.",
+		        "polyline0"_a,
+		        "polyline1"_a,
+		        "tolerance"_a)
+		    .def(
+		        "strong_frechet_matrix",
+		        [=](const py::sequence& rows, const py::object& columns, NT tolerance, std::size_t num_threads) {
+			        return apply_pairwise<NT>(rows, columns, num_threads, strong_frechet(tolerance));
+		        },
+		        "Compute the strong Frechet distance between all pairs of arrays of shape (n, 2) in parallel, up to the "
+		        "given tolerance. Without columns, the distances between all pairs of rows are computed.",
+		        "rows"_a,
+		        "columns"_a = py::none(),
+		        "tolerance"_a = 1e-3,
+		        "num_threads"_a = 0);
+	}
+
+	static void register_lcss(pybind11::module& mod) {
+		namespace py = pybind11;
+		using namespace pybind11::literals;
+		auto lcss = [](NT epsilon, std::size_t delta) {
+			return [epsilon, delta](const auto& p0, const auto& p1) -> std::size_t {
+				movetk::similarity::LongestCommonSubSequence<GeometryKernel, Norm> measure(epsilon, delta);
+				return measure(p0.begin(), p0.end(), p1.begin(), p1.end());
+			};
+		};
+		mod.def(
+		       "compute_lcss",
+		       [=](const CoordinateArray& p0, const CoordinateArray& p1, NT epsilon, std::size_t delta) {
+			       return apply(p0, p1, lcss(epsilon, delta));
+		       },
+		       "Compute longest common subsequence of arrays of shape (n, 2). Epsilon specifies the maximum distance, "
+		       "while delta gives the maximum allowed index distance",
+		       "polyline0"_a,
+		       "polyline1"_a,
+		       "epsilon"_a,
+		       "delta"_a)
+		    .def(
+		        "lcss_matrix",
+		        [=](const py::sequence& rows,
+		            const py::object& columns,
+		            NT epsilon,
+		            std::size_t delta,
+		            std::size_t num_threads) {
+			        return apply_pairwise<std::size_t>(rows, columns, num_threads, lcss(epsilon, delta));
+		        },
+		        "Compute the longest common subsequence of all pairs of arrays of shape (n, 2) in parallel. Without "
+		        "columns, all pairs of rows are compared. Epsilon and delta are keyword-only, since they follow the "
+		        "optional columns.",
+		        "rows"_a,
+		        "columns"_a = py::none(),
+		        py::kw_only(),
+		        "epsilon"_a,
+		        "delta"_a,
+		        "num_threads"_a = 0);
+	}
+
+	static void register_module(pybind11::module& mod) {
+		register_distances(mod);
+		register_strong_frechet(mod);
+		register_lcss(mod);
+	}
+};
+}  // namespace PyMoveTk
+#endif
@@ -4,6 +4,12 @@
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Batch.h"
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/metric/DistanceInterface.h"
 #include "movetk/utils/Iterators.h"
@@ -46,6 +52,46 @@ struct GeometryModule {
 	using Polyline = detail::Polyline<Point>;
 	using Wedge = typename movetk::geom::Wedge<MovetkGeometryKernel, Norm>;
 	using CoordinateIterator = movetk::utils::movetk_basic_iterator<const NT>;
+	// Arrays of coordinates, converted by NumPy only when they are not C-contiguous float64 arrays
+	using CoordinateArray = pybind11::array_t<typename PointArray<MovetkGeometryKernel>::Coordinate,
+	                                          pybind11::array::c_style | pybind11::array::forcecast>;
+
+	/**
+	 * \brief Returns a view of the points of an array of shape (n, 2), without copying
+	 * \param array The array, which should outlive the view
+	 */
+	static PointArray<MovetkGeometryKernel> as_point_array(const CoordinateArray &array) {
+		if (array.ndim() != 2 || array.shape(1) != 2) {
+			throw std::invalid_argument("Expected an array of shape (n, 2)");
+		}
+		return {array.data(), static_cast<std::size_t>(array.shape(0))};
+	}
+
+	/**
+	 * \brief Returns views of the points of a sequence of arrays of shape (n, 2)
+	 * \param sequence The sequence of arrays
+	 * \param arrays Storage keeping the arrays alive, including those converted by NumPy
+	 */
+	static std::vector<PointArray<MovetkGeometryKernel>> as_point_arrays(const pybind11::sequence &sequence,
+	                                                                    std::vector<CoordinateArray> &arrays) {
+		arrays.reserve(sequence.size());
+		std::vector<PointArray<MovetkGeometryKernel>> views;
+		views.reserve(sequence.size());
+		for (const auto &item : sequence) {
+			arrays.push_back(pybind11::cast<CoordinateArray>(item));
+			views.push_back(as_point_array(arrays.back()));
+		}
+		return views;
+	}
+
+	/**
+	 * \brief Returns indices as a NumPy array of int64
+	 */
+	static pybind11::array_t<std::int64_t> to_index_array(const std::vector<std::size_t> &indices) {
+		pybind11::array_t<std::int64_t> array(static_cast<pybind11::ssize_t>(indices.size()));
+		std::copy(indices.begin(), indices.end(), array.mutable_data());
+		return array;
+	}
 
 	static void register_point(pybind11::module &mod) {
 		namespace py = pybind11;
@@ -147,11 +193,9 @@ struct GeometryModule {
 		py::class_<Vector>(mod, "Vector")
 		    .def(py::init<>())
 		    .def("norm",
-		         [](Vector &v) -> NT {
+		         [](const Vector &v) -> NT {
 			         typename MovetkGeometryKernel::Norm norm;
-			         norm(v);
-			         NT result = norm ^ 1;
-			         return result;
+			         return norm.evaluate(v) ^ 1;
 		         })
 		    /**
 		     * @param  m A MovetkPoint
@@ -199,6 +243,7 @@ struct GeometryModule {
 				    throw std::invalid_argument("Expected dimension 1 of array to be of size 2");
 			    }
 			    Polyline pl;
+			    pl.reserve(access.shape(0));
 			    NT coords[2]{0, 0};
 			    for (py::ssize_t i = 0; i < access.shape(0); ++i) {
 				    for (py::ssize_t j = 0; j < 2; ++j) {
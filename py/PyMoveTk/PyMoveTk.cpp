@@ -33,6 +33,7 @@
 #include <movetk/utils/GeometryBackendTraits.h>
 #include <pybind11/pybind11.h>
 
+#include "Distances.h"
 #include "Geometry.h"
 #include "Similarity.h"
 #include "Simplification.h"
@@ -53,6 +54,7 @@ void setup_movetk_modules(pybind11::module& parent_module) {
 
 	auto distances_module = parent_module.def_submodule("distances", "Distances and similarity measures for polylines");
 	PyMoveTk::SimilarityModule<Backend, typename Backend::Norm>::register_module(distances_module);
+	PyMoveTk::DistancesModule<Backend, typename Backend::Norm>::register_module(distances_module);
 }
 }  // namespace PyMoveTk
 
@@ -35,7 +35,7 @@ struct SimilarityModule {
 		using namespace pybind11::literals;
 		mod.def(
 		       "compute_discrete_hausdorff",
-		       [](const Polyline& p0, const Polyline& p1) -> std::size_t {
+		       [](const Polyline& p0, const Polyline& p1) -> NT {
 			       movetk::metric::Discrete_Hausdorff<MoveTkKernel, Norm> discrete_hausdorff;
 			       return discrete_hausdorff(p0.begin(), p0.end(), p1.begin(), p1.end());
 		       },
@@ -44,11 +44,11 @@ struct SimilarityModule {
 		       "polyline1"_a)
 		    .def(
 		        "compute_discrete_frechet",
-		        [](const Polyline& p0, const Polyline& p1) -> std::size_t {
+		        [](const Polyline& p0, const Polyline& p1) -> NT {
 			        movetk::metric::Discrete_Frechet<MoveTkKernel, Norm> discrete_frechet;
 			        return discrete_frechet(p0.begin(), p0.end(), p1.begin(), p1.end());
 		        },
-		        "Compute the discrete Hausdorff distance",
+		        "Compute the discrete Frechet distance",
 		        "polyline0"_a,
 		        "polyline1"_a)
 		    .def(
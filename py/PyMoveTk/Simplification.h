@@ -1,7 +1,12 @@
 #ifndef PYMOVETK_SIMPLIFICATION_H
 #define PYMOVETK_SIMPLIFICATION_H
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <string>
+#include <vector>
+
+#include "Batch.h"
 #include "Geometry.h"
 #include "movetk/Simplification.h"
 
@@ -12,6 +17,7 @@ struct SimplificationModule {
 	using UsedGeometryModule = GeometryModule<typename GeometryKernel::MovetkGeometryKernel, Norm>;
 	using NT = typename GeometryKernel::NT;
 	using Polyline = typename UsedGeometryModule::Polyline;
+	using CoordinateArray = typename UsedGeometryModule::CoordinateArray;
 
 private:
 	// TODO: move down
@@ -31,6 +37,77 @@ private:
 		reconstruct_from_iterators(result, output);
 		return output;
 	}
+	/**
+	 * \brief Returns the indices of the points of the simplification of a polyline view
+	 */
+	template <typename ALGORITHM>
+	static std::vector<std::size_t> simplification_indices(ALGORITHM&& algorithm,
+	                                                       const PointArray<MovetkKernel>& polyline) {
+		std::vector<typename PointArray<MovetkKernel>::const_iterator> result;
+		algorithm(polyline.begin(), polyline.end(), std::back_inserter(result));
+		std::vector<std::size_t> indices;
+		indices.reserve(result.size());
+		for (const auto& el : result) {
+			indices.push_back(static_cast<std::size_t>(el - polyline.begin()));
+		}
+		return indices;
+	}
+
+	/**
+	 * \brief Registers name(array, epsilon), returning the indices of the simplification of an array of shape (n, 2),
+	 * and name_batch(arrays, epsilon, num_threads), simplifying a list of arrays in parallel.
+	 * The arrays are read in place when they are C-contiguous float64, and the GIL is released while simplifying.
+	 * \param make_algorithm Callable creating the algorithm for an epsilon
+	 */
+	template <typename MAKE_ALGORITHM>
+	static void register_array_simplification(pybind11::module& mod, const std::string& name, MAKE_ALGORITHM make_algorithm) {
+		namespace py = pybind11;
+		using namespace pybind11::literals;
+		mod.def(
+		    name.c_str(),
+		    [make_algorithm](const CoordinateArray& array, NT epsilon) {
+			    const auto polyline = UsedGeometryModule::as_point_array(array);
+			    std::vector<std::size_t> indices;
+			    {
+				    py::gil_scoped_release release;
+				    indices = simplification_indices(make_algorithm(epsilon), polyline);
+			    }
+			    return UsedGeometryModule::to_index_array(indices);
+		    },
+		    "Simplify an array of shape (n, 2), returning the indices of the retained points",
+		    "polyline"_a,
+		    "epsilon"_a);
+		mod.def(
+		    (name + "_batch").c_str(),
+		    [make_algorithm](const py::sequence& arrays, NT epsilon, std::size_t num_threads) {
+			    std::vector<CoordinateArray> storage;
+			    const auto polylines = UsedGeometryModule::as_point_arrays(arrays, storage);
+			    std::vector<std::vector<std::size_t>> indices;
+			    {
+				    py::gil_scoped_release release;
+				    indices = simplify_all(
+				        polylines,
+				        [&](const PointArray<MovetkKernel>& polyline) {
+					        return simplification_indices(make_algorithm(epsilon), polyline);
+				        },
+				        num_threads);
+			    }
+			    py::list result;
+			    for (const auto& el : indices) {
+				    result.append(UsedGeometryModule::to_index_array(el));
+			    }
+			    return result;
+		    },
+		    "Simplify a list of arrays of shape (n, 2) in parallel, returning the indices of the retained points "
+		    "of every array",
+		    "polylines"_a,
+		    "epsilon"_a,
+		    "num_threads"_a = 0);
+	}
+
+	using ImaiIriAlgorithm =
+	    movetk::simplification::ImaiIri<MovetkKernel,
+	                                    movetk::simplification::ChanChin<MovetkKernel, typename UsedGeometryModule::Wedge>>;
 
 public:
 	static void register_douglas_peucker(pybind11::module& mod) {
@@ -63,10 +140,24 @@ public:
 		});
 	}
 
+	static void register_array_simplifications(pybind11::module& mod) {
+		register_array_simplification(mod, "douglas_peucker", [](NT epsilon) {
+			using FindFarthest = movetk::simplification::FindFarthest<MovetkKernel, Norm>;
+			return movetk::simplification::DouglasPeucker<MovetkKernel, FindFarthest>(epsilon);
+		});
+		register_array_simplification(mod, "imai_iri", [](NT epsilon) { return ImaiIriAlgorithm(epsilon); });
+		register_array_simplification(mod, "agarwal", [](NT epsilon) {
+			using SqDistance = movetk::metric::squared_distance_d<MovetkKernel, Norm>;
+			return movetk::simplification::Agarwal<MovetkKernel, SqDistance>(epsilon);
+		});
+	}
+
 	static void register_module(pybind11::module& mod) {
 		register_douglas_peucker(mod);
 		register_imai_iri(mod);
 		register_agarwal(mod);
+		// After the Polyline overloads, so that those take precedence
+		register_array_simplifications(mod);
 	}
 };
 }  // namespace PyMoveTk
@@ -282,11 +282,9 @@ PYBIND11_MODULE(movetk_geometry, m)
     py::class_<MovetkGeometryKernel::MovetkVector>(m, "vector")
         .def(py::init<>())
         .def(py::self *= float())
-        .def("norm", ([](typename MovetkGeometryKernel::MovetkVector &v) -> typename MovetkGeometryKernel::NT {
+        .def("norm", ([](const typename MovetkGeometryKernel::MovetkVector &v) -> typename MovetkGeometryKernel::NT {
                  typename GeometryKernel::Norm norm;
-                 norm(v);
-                 MovetkGeometryKernel::NT result = norm ^ 1;
-                 return result;
+                 return norm.evaluate(v) ^ 1;
              }))
         .def("__mul__", ([](typename MovetkGeometryKernel::MovetkVector &v1,
                             typename MovetkGeometryKernel::MovetkVector &v2) -> typename MovetkGeometryKernel::NT {
@@ -1,6 +1,7 @@
 import unittest
 
 from TestAgarwal import TestAgarwal
+from TestArrayBindings import TestArrayBindings
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
@@ -0,0 +1,78 @@
+#
+# Copyright (C) 2018-2022 TU Eindhoven
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+# License-Filename: LICENSE
+#
+import unittest
+
+import numpy as np
+
+from PyMoveTk.geometry import Polyline
+from PyMoveTk.distances import compute_discrete_frechet, compute_discrete_hausdorff, compute_strong_frechet, \
+    compute_lcss, discrete_frechet_matrix, discrete_hausdorff_matrix, strong_frechet_matrix, lcss_matrix
+from PyMoveTk.simplification import douglas_peucker, douglas_peucker_batch, imai_iri_batch, agarwal, agarwal_batch
+
+
+def random_walks(count, seed=1):
+    generator = np.random.default_rng(seed)
+    return [np.cumsum(generator.normal(size=(20 + 3 * i, 2)), axis=0) for i in range(count)]
+
+
+class TestArrayBindings(unittest.TestCase):
+    def test_arrays_match_polylines(self):
+        a, b = random_walks(2)
+        self.assertAlmostEqual(compute_discrete_frechet(a, b), compute_discrete_frechet(Polyline(a), Polyline(b)))
+        self.assertAlmostEqual(compute_discrete_hausdorff(a, b), compute_discrete_hausdorff(Polyline(a), Polyline(b)))
+        self.assertEqual(compute_lcss(a, b, 1.0, 5), compute_lcss(Polyline(a), Polyline(b), 1.0, 5))
+        # Non-contiguous and integer arrays are converted
+        self.assertAlmostEqual(compute_discrete_frechet(np.asfortranarray(a), b), compute_discrete_frechet(a, b))
+        self.assertAlmostEqual(compute_discrete_frechet(np.zeros((3, 2), dtype=np.int32), np.zeros((4, 2))), 0)
+        with self.assertRaises(ValueError):
+            compute_discrete_frechet(np.zeros((3, 3)), b)
+
+    def test_distance_matrices(self):
+        walks = random_walks(6)
+        for matrix, single in [(discrete_frechet_matrix, compute_discrete_frechet),
+                               (discrete_hausdorff_matrix, compute_discrete_hausdorff)]:
+            symmetric = matrix(walks, num_threads=3)
+            rectangular = matrix(walks[:2], walks, num_threads=2)
+            self.assertEqual(symmetric.shape, (6, 6))
+            self.assertEqual(rectangular.shape, (2, 6))
+            for i in range(6):
+                for j in range(6):
+                    self.assertAlmostEqual(symmetric[i, j], single(walks[i], walks[j]))
+            np.testing.assert_allclose(rectangular, symmetric[:2])
+            # An odd number of rows has a middle row without a partner
+            np.testing.assert_allclose(matrix(walks[:5], num_threads=2), symmetric[:5, :5])
+        strong = strong_frechet_matrix(walks, tolerance=1e-4)
+        for i in range(6):
+            self.assertAlmostEqual(strong[i, 0], compute_strong_frechet(walks[i], walks[0], 1e-4), delta=1e-3)
+        lcss = lcss_matrix(walks, epsilon=1.0, delta=5)
+        self.assertEqual(lcss[1, 2], compute_lcss(walks[1], walks[2], 1.0, 5))
+        np.testing.assert_array_equal(lcss_matrix(walks[:2], walks, epsilon=1.0, delta=5), lcss[:2])
+
+    def test_simplification(self):
+        walks = random_walks(5)
+        for batch, single in [(douglas_peucker_batch, douglas_peucker), (agarwal_batch, agarwal)]:
+            indices = batch(walks, 2.0, num_threads=2)
+            self.assertEqual(len(indices), len(walks))
+            for walk, walk_indices in zip(walks, indices):
+                np.testing.assert_array_equal(walk_indices, single(walk, 2.0))
+                self.assertEqual(walk_indices[0], 0)
+                self.assertEqual(walk_indices[-1], len(walk) - 1)
+                # Same points as the Polyline overload
+                self.assertEqual(len(walk_indices), len(single(Polyline(walk), 2.0)))
+        self.assertEqual(len(imai_iri_batch(walks, 2.0)), len(walks))
@@ -519,7 +519,7 @@ struct DiscreteFrechetDistance {
 	                               InputIterator polyline_b_beyond) const {
 		typename Kernel::Boost_PolyLine_ poly1, poly2;
 
-		for (auto it = polyline_a_beyond; it != polyline_a_beyond; ++it) {
+		for (auto it = polyline_a_first; it != polyline_a_beyond; ++it) {
 			poly1.push_back(it->get());
 		}
 		for (auto it = polyline_b_first; it != polyline_b_beyond; ++it) {
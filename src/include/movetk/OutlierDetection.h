@@ -32,6 +32,7 @@
 
 
 #include "movetk/outlierdetection/GreedyOutlierDetector.h"
+#include "movetk/outlierdetection/OnlineOutlierDetector.h"
 #include "movetk/outlierdetection/OutputSensitiveOutlierDetector.h"
 #include "movetk/outlierdetection/SmartGreedyOutlierDetector.h"
 #include "movetk/outlierdetection/ZhengOutlierDetector.h"
@@ -29,12 +29,20 @@
 
 #include <movetk/utils/TrajectoryUtils.h>
 
-#include <boost/iterator/zip_iterator.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <vector>
 
+#include "movetk/ds/TrajectoryCollection.h"
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/io/TrajectoryTraits.h"
+#include "movetk/utils/ThreadPool.h"
 
 namespace movetk::statistics {
 /**
@@ -69,20 +77,18 @@ public:
 		if (firstCoordBegin == firstCoordEnd || secondCoordBegin == secondCoordEnd)
 			return 0;
 
-		auto firstCoordPair = std::make_pair(firstCoordBegin, firstCoordEnd);
-		auto secondCoordPair = std::make_pair(secondCoordBegin, secondCoordEnd);
-
-
-		// Point iterator begin and end
-		auto beginEndPair = movetk::utils::point_iterators_from_coordinates<GeometryKernel, CoordinateIterator>(
-		    std::array<decltype(firstCoordPair), 2>{firstCoordPair, secondCoordPair});
-
-		std::vector<NT> distances;
-		movetk::utils::get_distances<GeometryKernel>(beginEndPair.first,
-		                                             beginEndPair.second,
-		                                             std::back_inserter(distances));
-		// Defaults to summing everything
-		return std::accumulate(distances.begin(), distances.end(), (NT)0.0);
+		// Sum the distances between consecutive points in a single pass
+		movetk::geom::MakePoint<GeometryKernel> make_point;
+		PointDistanceFunc distance;
+		auto previous = make_point({static_cast<NT>(*firstCoordBegin), static_cast<NT>(*secondCoordBegin)});
+		NT length = 0;
+		for (++firstCoordBegin, ++secondCoordBegin; firstCoordBegin != firstCoordEnd && secondCoordBegin != secondCoordEnd;
+		     ++firstCoordBegin, ++secondCoordBegin) {
+			auto point = make_point({static_cast<NT>(*firstCoordBegin), static_cast<NT>(*secondCoordBegin)});
+			length += distance(previous, point);
+			previous = std::move(point);
+		}
+		return length;
 	}
 };
 
@@ -116,8 +122,171 @@ public:
 		return *(minMaxIts.second) - *(minMaxIts.first);
 	}
 };
+/**
+ * @brief Single pass accumulator of the minimum, maximum, mean and variance of a sequence of values,
+ * and optionally of its quantiles.
+ * @details The values are summarized in blocks of BLOCK_SIZE values, which are merged into the running mean
+ * and sum of squared differences with the update of Chan et al., a blocked form of Welford's algorithm
+ * that avoids a division per value. Quantiles need all values, so they are only available when the values
+ * are kept; the values are then stored in a buffer that is reused after reset().
+ * @tparam NT The floating point value type
+ */
+template <class NT>
+class RunningStatistics {
+public:
+	static constexpr std::size_t BLOCK_SIZE = 64;
+
+	/**
+	 * @brief Construct the accumulator
+	 * @param keep_values Whether to keep the values, as needed for quantiles
+	 */
+	explicit RunningStatistics(bool keep_values = false) : m_keep_values(keep_values) {}
+
+	/**
+	 * @brief Removes all values, keeping the capacity of the buffer of the values
+	 * @param keep_values Whether to keep the values, as needed for quantiles
+	 */
+	void reset(bool keep_values) {
+		m_keep_values = keep_values;
+		m_values.clear();
+		m_block_size = 0;
+		m_moments = Moments();
+	}
+
+	/**
+	 * @brief Reserves the buffer of the values, if they are kept
+	 * @param count The expected number of values
+	 */
+	void reserve(std::size_t count) {
+		if (m_keep_values) {
+			m_values.reserve(count);
+		}
+	}
+
+	/**
+	 * @brief Adds a value
+	 * @param value The value
+	 */
+	void push(NT value) {
+		m_block[m_block_size++] = value;
+		if (m_block_size == BLOCK_SIZE) {
+			m_moments = moments();
+			m_block_size = 0;
+		}
+		if (m_keep_values) {
+			m_values.push_back(value);
+		}
+	}
+
+	/**
+	 * @brief Returns the number of values
+	 */
+	std::size_t count() const { return m_moments.count + m_block_size; }
+
+	/**
+	 * @brief Returns the minimum value, 0 if there are no values
+	 */
+	NT min() const { return count() == 0 ? 0 : moments().min; }
+
+	/**
+	 * @brief Returns the maximum value, 0 if there are no values
+	 */
+	NT max() const { return count() == 0 ? 0 : moments().max; }
+
+	/**
+	 * @brief Returns the mean of the values, 0 if there are no values
+	 */
+	NT mean() const { return moments().mean; }
+
+	/**
+	 * @brief Returns the population variance of the values, 0 if there are no values
+	 */
+	NT variance() const {
+		const auto result = moments();
+		return result.count == 0 ? 0 : result.m2 / static_cast<NT>(result.count);
+	}
+
+	/**
+	 * @brief Returns a quantile of the values, interpolating linearly between the closest ranks.
+	 * Requires that the values are kept.
+	 * @details Selects the ranks with std::nth_element, reordering the buffer of the values.
+	 * @complexity O(n), with n the number of values
+	 * @param q The quantile, in [0, 1]
+	 * @return The quantile, 0 if there are no values
+	 */
+	NT quantile(double q) {
+		assert(m_keep_values && 0 <= q && q <= 1);
+		if (m_values.empty()) {
+			return 0;
+		}
+		const double position = q * static_cast<double>(m_values.size() - 1);
+		const auto rank = static_cast<std::size_t>(std::floor(position));
+		const auto fraction = static_cast<NT>(position - static_cast<double>(rank));
+		const auto lower = m_values.begin() + static_cast<std::ptrdiff_t>(rank);
+		std::nth_element(m_values.begin(), lower, m_values.end());
+		if (fraction == 0) {
+			return *lower;
+		}
+		// After the selection, the next rank is the minimum of the values beyond the lower one
+		const NT upper = *std::min_element(std::next(lower), m_values.end());
+		return (1 - fraction) * *lower + fraction * upper;
+	}
+
+	/**
+	 * @brief Returns the median of the values, the mean of the two middle values for an even number of values.
+	 * Requires that the values are kept.
+	 */
+	NT median() { return quantile(0.5); }
+
+private:
+	struct Moments {
+		std::size_t count = 0;
+		NT min = std::numeric_limits<NT>::max();
+		NT max = std::numeric_limits<NT>::lowest();
+		NT mean = 0;
+		// Sum of squared differences to the mean
+		NT m2 = 0;
+	};
+
+	// Returns the moments of the merged blocks combined with those of the current block
+	Moments moments() const {
+		Moments result = m_moments;
+		if (m_block_size == 0) {
+			return result;
+		}
+		NT sum = 0;
+		for (std::size_t i = 0; i < m_block_size; ++i) {
+			sum += m_block[i];
+			result.min = std::min(result.min, m_block[i]);
+			result.max = std::max(result.max, m_block[i]);
+		}
+		const auto block_count = static_cast<NT>(m_block_size);
+		const NT block_mean = sum / block_count;
+		NT block_m2 = 0;
+		for (std::size_t i = 0; i < m_block_size; ++i) {
+			block_m2 += (m_block[i] - block_mean) * (m_block[i] - block_mean);
+		}
+		const auto merged_count = static_cast<NT>(m_moments.count);
+		const auto total = merged_count + block_count;
+		const NT delta = block_mean - m_moments.mean;
+		result.count += m_block_size;
+		result.mean += delta * block_count / total;
+		result.m2 += block_m2 + delta * delta * merged_count * block_count / total;
+		return result;
+	}
+
+	bool m_keep_values;
+	std::vector<NT> m_values;
+	std::array<NT, BLOCK_SIZE> m_block;
+	std::size_t m_block_size = 0;
+	Moments m_moments;
+};
+
 /**
  * @brief Computs statistics for the constant speed between probes
+ * @details All requested statistics are computed in a single pass over the points and timestamps with a
+ * RunningStatistics accumulator, without intermediate vectors of distances, durations or speeds. Only the
+ * median needs the speeds, which are then kept in a single buffer.
  * @tparam GeometryKernel The kernel to use
  * @tparam PointDistanceFunc Point distance to use
 */
@@ -158,69 +327,11 @@ public:
 		assert(std::distance(pointsBegin, pointsEnd) == std::distance(timeBegin, timeEnd));
 
 		using Speed = Speed_t<typename TimeIterator::value_type>;
-		using Duration = Duration_t<typename TimeIterator::value_type>;
-		std::vector<Speed> speeds;
+		RunningStatistics<Speed> statistics(requires_values(requiredStatistics));
+		accumulate(pointsBegin, pointsEnd, timeBegin, timeEnd, statistics);
 		std::vector<Speed> output(requiredStatistics.size(), 0);
-		// We cannot derive speeds for empty or single point trajectories, so return zero values.
-		if (std::distance(pointsBegin, pointsEnd) <= 1 || std::distance(timeBegin, timeEnd) <= 1)
-			return output;
-
-		// Compute speeds
-		{
-			std::vector<Dist_t> distances;
-			auto backInsert = std::back_inserter(distances);
-			movetk::utils::get_distances<GeometryKernel, decltype(pointsBegin), decltype(backInsert), PointDistanceFunc>(
-			    pointsBegin,
-			    pointsEnd,
-			    backInsert,
-			    true);
-			std::vector<Duration> timeDiffs;
-			movetk::utils::get_time_diffs(timeBegin, timeEnd, std::back_inserter(timeDiffs), true);
-
-			movetk::utils::get_speeds<GeometryKernel>(timeDiffs.begin(),
-			                                          timeDiffs.end(),
-			                                          distances.begin(),
-			                                          std::back_inserter(speeds));
-		}
-
-		// Calculate the statistics
-		for (int i = 0; i < requiredStatistics.size(); ++i) {
-			switch (requiredStatistics[i]) {
-				case Statistic::Median: {
-					std::nth_element(speeds.begin(), speeds.begin() + speeds.size() / 2, speeds.end());
-					// Odd size
-					if (speeds.size() & 1) {
-						output[i] = speeds[speeds.size() / 2];
-					} else {
-						// Even size
-						output[i] = 0.5 * (speeds[speeds.size() / 2] + speeds[speeds.size() / 2 - 1]);
-					}
-					break;
-				}
-				case Statistic::Mean: {
-					// Compute the average
-					output[i] =
-					    std::accumulate(speeds.begin(), speeds.end(), static_cast<Speed>(0)) / static_cast<Speed>(speeds.size());
-					break;
-				}
-				case Statistic::Min: {
-					output[i] = *std::min_element(speeds.begin(), speeds.end());
-					break;
-				}
-				case Statistic::Variance: {
-					auto totalNum = static_cast<Speed>(speeds.size());
-					auto mean = std::accumulate(speeds.begin(), speeds.end(), static_cast<Speed>(0)) / totalNum;
-					// Lambda for accumulating squares of differences to mean.
-					auto sqDiff = [&mean](auto accum, auto newVal) { return accum + (newVal - mean) * (newVal - mean); };
-					output[i] = std::accumulate(speeds.begin(), speeds.end(), static_cast<Speed>(0), sqDiff) / totalNum;
-					break;
-				}
-				case Statistic::Max: {
-					output[i] = *std::max_element(speeds.begin(), speeds.end());
-					break;
-				}
-				default: break;
-			}
+		for (std::size_t i = 0; i < requiredStatistics.size(); ++i) {
+			output[i] = evaluate(statistics, requiredStatistics[i]);
 		}
 		return output;
 	}
@@ -248,6 +359,105 @@ public:
 		    this->operator()(pointsBegin, pointsEnd, timeBegin, timeEnd, std::vector<Statistic>{requiredStatistic});
 		return stats[0];
 	}
+
+	/**
+	 * @brief Adds the speeds between consecutive probes of a trajectory to an accumulator, in a single pass
+	 * over the points and timestamps. The speed between probes with the same timestamp is taken to be 0.
+	 * @tparam PointIterator The iterator type of the point range
+	 * @tparam TimeIterator The iterator type of the time range
+	 * @tparam Speed The speed type of the accumulator
+	 * @param pointsBegin Start of the range of points
+	 * @param pointsEnd End of the range of points
+	 * @param timeBegin Start of the range of timestamps
+	 * @param timeEnd End of the range of timestamps
+	 * @param statistics The accumulator
+	 */
+	template <utils::InputIterator<typename GeometryKernel::MovetkPoint> PointIterator,
+	          std::input_iterator TimeIterator,
+	          class Speed>
+	void accumulate(PointIterator pointsBegin,
+	                PointIterator pointsEnd,
+	                TimeIterator timeBegin,
+	                TimeIterator timeEnd,
+	                RunningStatistics<Speed>& statistics) const {
+		if (pointsBegin == pointsEnd || timeBegin == timeEnd) {
+			return;
+		}
+		if constexpr (std::sized_sentinel_for<PointIterator, PointIterator>) {
+			statistics.reserve(statistics.count() + static_cast<std::size_t>(std::distance(pointsBegin, pointsEnd)) - 1);
+		}
+		PointDistanceFunc distance;
+		Point_t previousPoint = *pointsBegin;
+		auto previousTime = *timeBegin;
+		for (++pointsBegin, ++timeBegin; pointsBegin != pointsEnd && timeBegin != timeEnd; ++pointsBegin, ++timeBegin) {
+			Point_t point = *pointsBegin;
+			auto time = *timeBegin;
+			const auto timeDiff = time - previousTime;
+			statistics.push(timeDiff == 0 ? static_cast<Speed>(0) : static_cast<Speed>(distance(previousPoint, point) / timeDiff));
+			previousPoint = std::move(point);
+			previousTime = time;
+		}
+	}
+
+	/**
+	 * @brief Computes the requested statistics for the speed between probes for every trajectory of a
+	 * collection, optionally in parallel.
+	 * @tparam XIdx Index of the field with the first coordinate
+	 * @tparam YIdx Index of the field with the second coordinate
+	 * @tparam TimeIdx Index of the field with the timestamps
+	 * @param collection The trajectories
+	 * @param requiredStatistics The requested statistics
+	 * @param thread_pool Optional thread pool to distribute the trajectories over
+	 * @return A column per requested statistic, in the order of requiredStatistics, with a row per trajectory
+	 */
+	template <std::size_t XIdx, std::size_t YIdx, std::size_t TimeIdx, class... FIELDS>
+	auto for_collection(const ds::TrajectoryCollection<FIELDS...>& collection,
+	                    const std::vector<Statistic>& requiredStatistics,
+	                    utils::ThreadPool* thread_pool = nullptr) const {
+		using Collection = ds::TrajectoryCollection<FIELDS...>;
+		using Speed = Speed_t<typename Collection::template FieldType<TimeIdx>>;
+		std::vector<std::vector<Speed>> columns(requiredStatistics.size(), std::vector<Speed>(collection.size(), 0));
+		const bool keepValues = requires_values(requiredStatistics);
+		collection.for_each_range(
+		    [&](std::size_t first, std::size_t beyond) {
+			    // One accumulator per block of trajectories, so the buffer for the median is reused within the block
+			    RunningStatistics<Speed> statistics;
+			    for (auto i = first; i < beyond; ++i) {
+				    statistics.reset(keepValues);
+				    const auto view = collection[i];
+				    const auto times = view.template get<TimeIdx>();
+				    accumulate(view.template points_begin<GeometryKernel, XIdx, YIdx>(),
+				               view.template points_end<GeometryKernel, XIdx, YIdx>(),
+				               times.begin(),
+				               times.end(),
+				               statistics);
+				    for (std::size_t k = 0; k < requiredStatistics.size(); ++k) {
+					    columns[k][i] = evaluate(statistics, requiredStatistics[k]);
+				    }
+			    }
+		    },
+		    thread_pool);
+		return columns;
+	}
+
+private:
+	static bool requires_values(const std::vector<Statistic>& requiredStatistics) {
+		return std::find(requiredStatistics.begin(), requiredStatistics.end(), Statistic::Median) !=
+		       requiredStatistics.end();
+	}
+
+	// Returns a statistic of the accumulated speeds, 0 if there are no speeds
+	template <class Speed>
+	static Speed evaluate(RunningStatistics<Speed>& statistics, Statistic statistic) {
+		switch (statistic) {
+			case Statistic::Median: return statistics.median();
+			case Statistic::Mean: return statistics.mean();
+			case Statistic::Max: return statistics.max();
+			case Statistic::Min: return statistics.min();
+			case Statistic::Variance: return statistics.variance();
+			default: return 0;
+		}
+	}
 };
 
 /**
@@ -31,6 +31,7 @@
 #include <cassert>
 #include <iostream>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "movetk/io/TrajectoryTraits.h"
@@ -66,7 +67,7 @@ public:
 	 * @brief Constructs a columnar trajectory from a std::tuple of lists of the fields
 	 * @param points The data points
 	 */
-	explicit ColumnarTrajectory(std::tuple<std::vector<FIELDS>...> points) : _points(points) {}
+	explicit ColumnarTrajectory(std::tuple<std::vector<FIELDS>...> points) : _points(std::move(points)) {}
 
 	ColumnarTrajectory() = default;
 
@@ -104,6 +105,16 @@ public:
 	 */
 	const std::tuple<std::vector<FIELDS>...>& data() const { return _points; }
 
+	/**
+	 * @brief Moves the data out of the data structure, leaving it empty, for example to reuse its storage
+	 * @return The data
+	 */
+	std::tuple<std::vector<FIELDS>...> release() {
+		std::tuple<std::vector<FIELDS>...> points;
+		std::swap(points, _points);
+		return points;
+	}
+
 	/**
 	 * @brief Updates a single field (column), replacing all values with the supplied values
 	 * @param new_field_values The new field values.
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file GeohashIndex.h
+ *  @brief  Flat prefix index over geohashes
+ */
+
+#ifndef MOVETK_DS_GEOHASHINDEX_H
+#define MOVETK_DS_GEOHASHINDEX_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "movetk/utils/Requirements.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::ds {
+
+/*!
+ * @brief Prefix index over geohashes with the insert/find semantics of Tree<TrieNode>,
+ * stored as a sorted array of 64-bit codes.
+ * @details Every geohash of at most MAX_LENGTH characters is packed into a single 64-bit code:
+ * 5 bits per character, left aligned, followed by the length in the lowest 4 bits. Sorting the
+ * codes sorts the geohashes lexicographically, so the longest prefix of a query shared with any
+ * indexed geohash is shared with one of its two neighbours in the sorted array, which is found
+ * with a single binary search. The values of all geohashes are stored contiguously, grouped per geohash.
+ *
+ * Geohashes are inserted in any order and the index is built on the first lookup after an insertion,
+ * or explicitly with build(). The const lookups require a built index and can be called concurrently.
+ * @tparam Value The type of values stored with the geohashes
+ */
+template <class Value>
+class GeohashIndex {
+public:
+	/*!
+	 * @brief The maximum number of characters of an indexed geohash
+	 */
+	static constexpr std::size_t MAX_LENGTH = 12;
+
+	using ValueIterator = typename std::vector<Value>::const_iterator;
+
+	/*!
+	 * @brief Result of a prefix lookup, valid until the index is built again
+	 */
+	struct Match {
+		// Number of characters of the query that are a prefix of an indexed geohash
+		std::size_t size = 0;
+		// Values of the indexed geohash that equals the matched prefix, empty if there is none
+		ValueIterator first;
+		ValueIterator beyond;
+
+		ValueIterator v_begin() const { return first; }
+		ValueIterator v_end() const { return beyond; }
+	};
+
+private:
+	using Code = std::uint64_t;
+
+	static constexpr int BITS_PER_CHARACTER = 5;
+	static constexpr int LENGTH_BITS = 4;
+	static constexpr Code LENGTH_MASK = (Code(1) << LENGTH_BITS) - 1;
+	static constexpr const char *ALPHABET = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+	static constexpr std::array<std::int8_t, 256> make_decoding_table() {
+		std::array<std::int8_t, 256> table{};
+		for (auto &entry : table) {
+			entry = -1;
+		}
+		for (int i = 0; i < 32; ++i) {
+			table[static_cast<unsigned char>(ALPHABET[i])] = static_cast<std::int8_t>(i);
+		}
+		return table;
+	}
+	static constexpr std::array<std::int8_t, 256> DECODING_TABLE = make_decoding_table();
+
+	// Sorted unique codes of the indexed geohashes
+	std::vector<Code> m_codes;
+	// Values of m_codes[i] are m_values[m_offsets[i]], ..., m_values[m_offsets[i + 1] - 1]
+	std::vector<std::size_t> m_offsets;
+	std::vector<Value> m_values;
+	// Insertions since the last build
+	std::vector<std::pair<Code, Value>> m_pending;
+	std::size_t m_match_size = 0;
+
+	template <std::random_access_iterator InputIterator>
+	static Code encode(InputIterator first, InputIterator beyond) {
+		const auto length = static_cast<std::size_t>(std::distance(first, beyond));
+		if (length > MAX_LENGTH) {
+			throw std::invalid_argument("Geohash longer than GeohashIndex::MAX_LENGTH characters");
+		}
+		Code code = 0;
+		int shift = 64 - BITS_PER_CHARACTER;
+		for (std::size_t i = 0; i < length; ++i, ++first, shift -= BITS_PER_CHARACTER) {
+			const auto symbol = DECODING_TABLE[static_cast<unsigned char>(*first)];
+			if (symbol < 0) {
+				throw std::invalid_argument("Invalid geohash character");
+			}
+			code |= static_cast<Code>(symbol) << shift;
+		}
+		return code | length;
+	}
+
+	static std::size_t length_of(Code code) { return code & LENGTH_MASK; }
+
+	static std::string decode(Code code) {
+		std::string geohash(length_of(code), ' ');
+		int shift = 64 - BITS_PER_CHARACTER;
+		for (auto &c : geohash) {
+			c = ALPHABET[(code >> shift) & 31];
+			shift -= BITS_PER_CHARACTER;
+		}
+		return geohash;
+	}
+
+	// Length of the longest common prefix of two geohashes
+	static std::size_t common_prefix(Code a, Code b) {
+		const Code difference = (a ^ b) & ~LENGTH_MASK;
+		const std::size_t shared =
+		    difference == 0 ? MAX_LENGTH : static_cast<std::size_t>(std::countl_zero(difference)) / BITS_PER_CHARACTER;
+		return std::min({shared, length_of(a), length_of(b)});
+	}
+
+	// The code of the first size characters of the geohash
+	static Code prefix(Code code, std::size_t size) {
+		if (size == 0) {
+			return 0;
+		}
+		const Code mask = ~Code(0) << (64 - BITS_PER_CHARACTER * size);
+		return (code & mask) | size;
+	}
+
+	Match match(Code query) const {
+		Match result{0, std::cend(m_values), std::cend(m_values)};
+		if (m_codes.empty()) {
+			return result;
+		}
+		const auto position = std::lower_bound(std::cbegin(m_codes), std::cend(m_codes), query);
+		if (position != std::cend(m_codes)) {
+			result.size = common_prefix(query, *position);
+		}
+		if (position != std::cbegin(m_codes)) {
+			result.size = std::max(result.size, common_prefix(query, *(position - 1)));
+		}
+		// The indexed geohash equal to the matched prefix is not beyond the query
+		const Code matched = prefix(query, result.size);
+		const auto limit = position == std::cend(m_codes) ? position : position + 1;
+		const auto exact = std::lower_bound(std::cbegin(m_codes), limit, matched);
+		if (exact != limit && *exact == matched) {
+			const auto index = std::distance(std::cbegin(m_codes), exact);
+			result.first = std::cbegin(m_values) + m_offsets[index];
+			result.beyond = std::cbegin(m_values) + m_offsets[index + 1];
+		}
+		return result;
+	}
+
+public:
+	GeohashIndex() = default;
+
+	/*!
+	 * Inserts a value under a geohash
+	 * @tparam InputIterator
+	 * @param first Start of the characters of the geohash
+	 * @param beyond End of the characters of the geohash, at most MAX_LENGTH characters from first
+	 * @param val The value
+	 * @throws std::invalid_argument if the geohash is longer than MAX_LENGTH or not in the geohash alphabet
+	 */
+	template <std::random_access_iterator InputIterator>
+	void insert(InputIterator first, InputIterator beyond, const Value &val) {
+		m_pending.emplace_back(encode(first, beyond), val);
+	}
+
+	/*!
+	 * Merges the geohashes inserted since the last build into the index.
+	 * Values of the same geohash keep their insertion order.
+	 */
+	void build() {
+		if (m_pending.empty()) {
+			return;
+		}
+		// Reinsert the built entries before the pending ones to keep the insertion order
+		std::vector<std::pair<Code, Value>> entries;
+		entries.reserve(m_values.size() + m_pending.size());
+		for (std::size_t i = 0; i < m_codes.size(); ++i) {
+			for (auto j = m_offsets[i]; j < m_offsets[i + 1]; ++j) {
+				entries.emplace_back(m_codes[i], std::move(m_values[j]));
+			}
+		}
+		std::move(std::begin(m_pending), std::end(m_pending), std::back_inserter(entries));
+		m_pending.clear();
+		std::stable_sort(std::begin(entries), std::end(entries), [](const auto &a, const auto &b) {
+			return a.first < b.first;
+		});
+
+		m_codes.clear();
+		m_offsets.clear();
+		m_values.clear();
+		m_values.reserve(entries.size());
+		for (auto &entry : entries) {
+			if (m_codes.empty() || m_codes.back() != entry.first) {
+				m_codes.push_back(entry.first);
+				m_offsets.push_back(m_values.size());
+			}
+			m_values.push_back(std::move(entry.second));
+		}
+		m_offsets.push_back(m_values.size());
+	}
+
+	/*!
+	 * Finds the longest prefix of the query that is a prefix of an indexed geohash.
+	 * The size of the match is also available through get_match_size().
+	 * @tparam InputIterator
+	 * @param first Start of the characters of the query
+	 * @param beyond End of the characters of the query, at most MAX_LENGTH characters from first
+	 * @return The match
+	 * @throws std::invalid_argument if the query is longer than MAX_LENGTH or not in the geohash alphabet
+	 */
+	template <std::random_access_iterator InputIterator>
+	Match find(InputIterator first, InputIterator beyond) {
+		build();
+		const Match result = match(encode(first, beyond));
+		m_match_size = result.size;
+		return result;
+	}
+
+	/*!
+	 * Finds the longest prefix of the query that is a prefix of an indexed geohash.
+	 * Requires a built index.
+	 * @tparam InputIterator
+	 * @param first Start of the characters of the query
+	 * @param beyond End of the characters of the query, at most MAX_LENGTH characters from first
+	 * @return The match
+	 * @throws std::invalid_argument if the query is longer than MAX_LENGTH or not in the geohash alphabet
+	 */
+	template <std::random_access_iterator InputIterator>
+	Match find(InputIterator first, InputIterator beyond) const {
+		assert(m_pending.empty());
+		return match(encode(first, beyond));
+	}
+
+	/*!
+	 * Finds the matches of a batch of queries, for example the geohashes of the points of a trajectory.
+	 * @tparam QueryIterator Random access iterator over ranges of characters, for example strings
+	 * @tparam OutputIterator
+	 * @param first Start of the queries
+	 * @param beyond End of the queries
+	 * @param result Output iterator for the matches, one per query
+	 * @param thread_pool Optional thread pool to distribute the queries over
+	 * @throws std::invalid_argument if a query is longer than MAX_LENGTH or not in the geohash alphabet
+	 */
+	template <std::random_access_iterator QueryIterator, utils::OutputIterator<Match> OutputIterator>
+	void find(QueryIterator first, QueryIterator beyond, OutputIterator result, utils::ThreadPool *thread_pool = nullptr) {
+		build();
+		const std::size_t num_queries = std::distance(first, beyond);
+		std::vector<Match> matches(num_queries);
+		// Blocks of queries per thread, to amortize the scheduling of the pool
+		constexpr std::size_t BLOCK_SIZE = 256;
+		auto find_block = [&](std::size_t block) {
+			const std::size_t end = std::min(num_queries, (block + 1) * BLOCK_SIZE);
+			for (std::size_t i = block * BLOCK_SIZE; i < end; ++i) {
+				const auto &query = first[i];
+				matches[i] = match(encode(std::cbegin(query), std::cend(query)));
+			}
+		};
+		const std::size_t num_blocks = (num_queries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		if (thread_pool != nullptr) {
+			thread_pool->parallel_for(0, num_blocks, find_block);
+		} else {
+			for (std::size_t block = 0; block < num_blocks; ++block) {
+				find_block(block);
+			}
+		}
+		std::copy(std::begin(matches), std::end(matches), result);
+	}
+
+	/*!
+	 * Reports the indexed geohashes that are not a prefix of another indexed geohash,
+	 * the leaves of the equivalent trie, together with their number of values, in lexicographic order.
+	 * @tparam OutputIterator
+	 * @param iter Output iterator for (geohash, number of values) pairs
+	 */
+	template <utils::OutputIterator<std::pair<std::string, std::size_t>> OutputIterator>
+	void find(OutputIterator iter) {
+		build();
+		for (std::size_t i = 0; i < m_codes.size(); ++i) {
+			const bool is_leaf =
+			    i + 1 == m_codes.size() || common_prefix(m_codes[i], m_codes[i + 1]) < length_of(m_codes[i]);
+			if (is_leaf) {
+				*iter = std::make_pair(decode(m_codes[i]), m_offsets[i + 1] - m_offsets[i]);
+			}
+		}
+	}
+
+	/*!
+	 * Returns the size of the match of the last call to find(first, beyond)
+	 * @return The number of matched characters
+	 */
+	std::size_t get_match_size() const { return m_match_size; }
+};
+}  // namespace movetk::ds
+
+#endif  // MOVETK_DS_GEOHASHINDEX_H
@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file PolygonGridIndex.h
+ *  @brief  Uniform grid index for point in polygon queries
+ */
+
+#ifndef MOVETK_DS_POLYGONGRIDINDEX_H
+#define MOVETK_DS_POLYGONGRIDINDEX_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "movetk/utils/Requirements.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::ds {
+
+/*!
+ * @brief Index over a set of 2D polygons for locating the polygons that contain a point.
+ * @details The bounding box of the polygons is divided into a uniform grid. Every polygon is rasterized
+ * into the grid: a cell is inside, outside or on the boundary of the polygon. Only the inside and boundary
+ * cells are stored. A boundary cell keeps the edges of the polygon that intersect it and whether its center
+ * is inside the polygon. A point in an inside cell is contained without further tests, and a point in a
+ * boundary cell is tested by counting the crossings of the local edges with an axis parallel path from the
+ * point to the center of the cell. Boundary cells thus only test a few edges, instead of all edges
+ * of the polygon.
+ *
+ * Points on the boundary of a polygon may be reported as either inside or outside. The polygons are
+ * read through their vertex ranges, so any backend polygon type works. The index is immutable after construction
+ * and queries can be called concurrently.
+ * @tparam GeometryTraits The kernel, for example @refitem movetk::geom::MovetkGeometryKernel
+ */
+template <class GeometryTraits>
+class PolygonGridIndex {
+public:
+	using NT = typename GeometryTraits::NT;
+	using Point = typename GeometryTraits::MovetkPoint;
+
+	/*!
+	 * @brief Returned when no polygon contains the point
+	 */
+	static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+private:
+	// A polygon that contains (part of) a cell
+	struct CellEntry {
+		std::uint32_t polygon;
+		// Whether the center of the cell is inside the polygon
+		bool center_inside;
+		// Range in m_cell_edges of the edges intersecting the cell, empty for inside cells
+		std::size_t edges_first;
+		std::size_t edges_beyond;
+	};
+
+	std::size_t m_num_polygons = 0;
+	std::size_t m_columns = 0, m_rows = 0;
+	NT m_min_x = 0, m_min_y = 0, m_max_x = 0, m_max_y = 0;
+	NT m_cell_width = 1, m_cell_height = 1;
+
+	// Edges of all polygons, per coordinate
+	std::vector<NT> m_ax, m_ay, m_bx, m_by;
+	// Entries of cell i are m_entries[m_cell_offsets[i]], ..., m_entries[m_cell_offsets[i + 1] - 1], by increasing polygon
+	std::vector<std::size_t> m_cell_offsets;
+	std::vector<CellEntry> m_entries;
+	std::vector<std::uint32_t> m_cell_edges;
+
+	// Relative tolerance, in cells, when rasterizing: cells close to an edge are considered intersected
+	static constexpr NT TOLERANCE = 1e-7;
+
+	template <class Vertex>
+	static std::array<NT, 2> coordinates(const Vertex &vertex) {
+		if constexpr (requires { vertex.x(); vertex.y(); }) {
+			return {static_cast<NT>(vertex.x()), static_cast<NT>(vertex.y())};
+		} else {
+			const Point point(vertex);
+			return {point[0], point[1]};
+		}
+	}
+
+	NT column_x(std::size_t column) const { return m_min_x + static_cast<NT>(column) * m_cell_width; }
+	NT row_y(std::size_t row) const { return m_min_y + static_cast<NT>(row) * m_cell_height; }
+
+	// Conservative range of cells covering [low, high] along an axis
+	static std::pair<std::size_t, std::size_t> cell_range(NT low, NT high, NT min, NT size, std::size_t count) {
+		auto clamp = [count](NT cell) {
+			return static_cast<std::size_t>(std::clamp<NT>(std::floor(cell), 0, static_cast<NT>(count - 1)));
+		};
+		return {clamp((low - min) / size - TOLERANCE), clamp((high - min) / size + TOLERANCE)};
+	}
+
+	// Number of crossings of the edges with the horizontal segment at y between x_low and x_high
+	std::size_t horizontal_crossings(const std::uint32_t *first,
+	                                 const std::uint32_t *beyond,
+	                                 NT y,
+	                                 NT x_low,
+	                                 NT x_high) const {
+		std::size_t crossings = 0;
+		for (; first != beyond; ++first) {
+			const auto e = *first;
+			if ((m_ay[e] > y) != (m_by[e] > y)) {
+				const NT x = m_ax[e] + (y - m_ay[e]) * (m_bx[e] - m_ax[e]) / (m_by[e] - m_ay[e]);
+				crossings += (x >= x_low && x < x_high);
+			}
+		}
+		return crossings;
+	}
+
+	// Number of crossings of the edges with the vertical segment at x between y_low and y_high
+	std::size_t vertical_crossings(const std::uint32_t *first,
+	                               const std::uint32_t *beyond,
+	                               NT x,
+	                               NT y_low,
+	                               NT y_high) const {
+		std::size_t crossings = 0;
+		for (; first != beyond; ++first) {
+			const auto e = *first;
+			if ((m_ax[e] > x) != (m_bx[e] > x)) {
+				const NT y = m_ay[e] + (x - m_ax[e]) * (m_by[e] - m_ay[e]) / (m_bx[e] - m_ax[e]);
+				crossings += (y >= y_low && y < y_high);
+			}
+		}
+		return crossings;
+	}
+
+	// Rasterizes the edges [edges_first, edges_beyond) of a polygon into the given cells,
+	// appends the entries of the polygon to cell_entries.
+	void rasterize(std::uint32_t polygon,
+	               std::size_t edges_first,
+	               std::size_t edges_beyond,
+	               std::vector<std::pair<std::size_t, CellEntry>> &cell_entries) {
+		NT min_x = std::numeric_limits<NT>::max(), min_y = min_x;
+		NT max_x = std::numeric_limits<NT>::lowest(), max_y = max_x;
+		for (auto e = edges_first; e < edges_beyond; ++e) {
+			min_x = std::min({min_x, m_ax[e], m_bx[e]});
+			max_x = std::max({max_x, m_ax[e], m_bx[e]});
+			min_y = std::min({min_y, m_ay[e], m_by[e]});
+			max_y = std::max({max_y, m_ay[e], m_by[e]});
+		}
+		const auto [c0, c1] = cell_range(min_x, max_x, m_min_x, m_cell_width, m_columns);
+		const auto [r0, r1] = cell_range(min_y, max_y, m_min_y, m_cell_height, m_rows);
+		const std::size_t width = c1 - c0 + 1;
+
+		// (local cell, edge) incidences, conservatively
+		std::vector<std::pair<std::size_t, std::uint32_t>> incidences;
+		for (auto e = edges_first; e < edges_beyond; ++e) {
+			const NT ax = m_ax[e], ay = m_ay[e], bx = m_bx[e], by = m_by[e];
+			const auto [e_c0, e_c1] = cell_range(std::min(ax, bx), std::max(ax, bx), m_min_x, m_cell_width, m_columns);
+			for (auto column = e_c0; column <= e_c1; ++column) {
+				NT y_low = std::min(ay, by), y_high = std::max(ay, by);
+				if (ax != bx) {
+					// Part of the edge within the column
+					const NT x_low = std::max(std::min(ax, bx), column_x(column));
+					const NT x_high = std::min(std::max(ax, bx), column_x(column + 1));
+					const NT y_at_low = ay + (x_low - ax) * (by - ay) / (bx - ax);
+					const NT y_at_high = ay + (x_high - ax) * (by - ay) / (bx - ax);
+					y_low = std::max(y_low, std::min(y_at_low, y_at_high));
+					y_high = std::min(y_high, std::max(y_at_low, y_at_high));
+				}
+				const auto [e_r0, e_r1] = cell_range(y_low, y_high, m_min_y, m_cell_height, m_rows);
+				for (auto row = std::max(e_r0, r0); row <= std::min(e_r1, r1); ++row) {
+					incidences.emplace_back((row - r0) * width + (std::clamp(column, c0, c1) - c0),
+					                        static_cast<std::uint32_t>(e));
+				}
+			}
+		}
+		std::sort(std::begin(incidences), std::end(incidences));
+		incidences.erase(std::unique(std::begin(incidences), std::end(incidences)), std::end(incidences));
+
+		// Sweep every row from the left, outside the polygon, and track whether the cell centers are inside
+		auto incidence = std::cbegin(incidences);
+		std::vector<std::uint32_t> previous_edges, edges;
+		for (auto row = r0; row <= r1; ++row) {
+			const NT center_y = row_y(row) + m_cell_height / 2;
+			bool inside = false;
+			NT previous_center_x = column_x(c0) - m_cell_width / 2;
+			previous_edges.clear();
+			for (auto column = c0; column <= c1; ++column) {
+				const std::size_t local = (row - r0) * width + (column - c0);
+				edges.clear();
+				for (; incidence != std::cend(incidences) && incidence->first == local; ++incidence) {
+					edges.push_back(incidence->second);
+				}
+				const NT border = column_x(column);
+				const NT center_x = border + m_cell_width / 2;
+				const auto crossings =
+				    horizontal_crossings(previous_edges.data(),
+				                         previous_edges.data() + previous_edges.size(),
+				                         center_y,
+				                         previous_center_x,
+				                         border) +
+				    horizontal_crossings(edges.data(), edges.data() + edges.size(), center_y, border, center_x);
+				inside ^= (crossings % 2 == 1);
+
+				const std::size_t cell = row * m_columns + column;
+				if (!edges.empty()) {
+					const auto edges_offset = m_cell_edges.size();
+					m_cell_edges.insert(std::end(m_cell_edges), std::begin(edges), std::end(edges));
+					cell_entries.emplace_back(cell, CellEntry{polygon, inside, edges_offset, m_cell_edges.size()});
+				} else if (inside) {
+					cell_entries.emplace_back(cell, CellEntry{polygon, true, 0, 0});
+				}
+				std::swap(previous_edges, edges);
+				previous_center_x = center_x;
+			}
+		}
+	}
+
+	bool contains(const CellEntry &entry, std::size_t row, std::size_t column, NT x, NT y) const {
+		if (entry.edges_first == entry.edges_beyond) {
+			return true;
+		}
+		const auto first = m_cell_edges.data() + entry.edges_first;
+		const auto beyond = m_cell_edges.data() + entry.edges_beyond;
+		const NT center_x = column_x(column) + m_cell_width / 2;
+		const NT center_y = row_y(row) + m_cell_height / 2;
+		// Path from the point vertically to the row of the center, then horizontally to the center
+		const auto crossings = vertical_crossings(first, beyond, x, std::min(y, center_y), std::max(y, center_y)) +
+		                       horizontal_crossings(first, beyond, center_y, std::min(x, center_x), std::max(x, center_x));
+		return entry.center_inside != (crossings % 2 == 1);
+	}
+
+	// Finds the cell of the point, returns false if it is outside the grid
+	bool cell_of(NT x, NT y, std::size_t &row, std::size_t &column) const {
+		if (m_num_polygons == 0 || !(x >= m_min_x && x <= m_max_x && y >= m_min_y && y <= m_max_y)) {
+			return false;
+		}
+		column = std::min(static_cast<std::size_t>((x - m_min_x) / m_cell_width), m_columns - 1);
+		row = std::min(static_cast<std::size_t>((y - m_min_y) / m_cell_height), m_rows - 1);
+		return true;
+	}
+
+	template <class Locate, class OutputIterator>
+	void batch(std::size_t num_points, Locate &&locate, OutputIterator result, utils::ThreadPool *thread_pool) const {
+		std::vector<std::size_t> polygons(num_points);
+		// Blocks of points per thread, to amortize the scheduling of the pool
+		constexpr std::size_t BLOCK_SIZE = 1024;
+		auto locate_block = [&](std::size_t block) {
+			const std::size_t end = std::min(num_points, (block + 1) * BLOCK_SIZE);
+			for (std::size_t i = block * BLOCK_SIZE; i < end; ++i) {
+				polygons[i] = locate(i);
+			}
+		};
+		const std::size_t num_blocks = (num_points + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		if (thread_pool != nullptr) {
+			thread_pool->parallel_for(0, num_blocks, locate_block);
+		} else {
+			for (std::size_t block = 0; block < num_blocks; ++block) {
+				locate_block(block);
+			}
+		}
+		std::copy(std::begin(polygons), std::end(polygons), result);
+	}
+
+public:
+	PolygonGridIndex() = default;
+
+	/*!
+	 * Builds the index over a range of polygons
+	 * @tparam PolygonIterator Iterator over polygons with a v_begin()/v_end() vertex range,
+	 * for example over GeometryTraits::MovetkPolygon
+	 * @param first Start of the range of polygons
+	 * @param beyond End of the range of polygons
+	 * @param cells_per_axis Number of cells along each axis of the grid. By default chosen such that
+	 * the number of cells is about twice the total number of edges.
+	 */
+	template <std::forward_iterator PolygonIterator>
+	PolygonGridIndex(PolygonIterator first, PolygonIterator beyond, std::size_t cells_per_axis = 0) {
+		std::vector<std::size_t> polygon_edges{0};
+		for (auto pit = first; pit != beyond; ++pit) {
+			std::vector<std::array<NT, 2>> vertices;
+			for (auto vit = pit->v_begin(); vit != pit->v_end(); ++vit) {
+				vertices.push_back(coordinates(*vit));
+			}
+			for (std::size_t i = 0; i < vertices.size(); ++i) {
+				const auto &a = vertices[i];
+				const auto &b = vertices[(i + 1) % vertices.size()];
+				m_ax.push_back(a[0]);
+				m_ay.push_back(a[1]);
+				m_bx.push_back(b[0]);
+				m_by.push_back(b[1]);
+			}
+			polygon_edges.push_back(m_ax.size());
+		}
+		m_num_polygons = polygon_edges.size() - 1;
+		if (m_ax.empty()) {
+			m_num_polygons = 0;
+			return;
+		}
+		assert(m_ax.size() <= std::numeric_limits<std::uint32_t>::max());
+
+		m_min_x = std::min(*std::min_element(std::cbegin(m_ax), std::cend(m_ax)),
+		                   *std::min_element(std::cbegin(m_bx), std::cend(m_bx)));
+		m_max_x = std::max(*std::max_element(std::cbegin(m_ax), std::cend(m_ax)),
+		                   *std::max_element(std::cbegin(m_bx), std::cend(m_bx)));
+		m_min_y = std::min(*std::min_element(std::cbegin(m_ay), std::cend(m_ay)),
+		                   *std::min_element(std::cbegin(m_by), std::cend(m_by)));
+		m_max_y = std::max(*std::max_element(std::cbegin(m_ay), std::cend(m_ay)),
+		                   *std::max_element(std::cbegin(m_by), std::cend(m_by)));
+		if (cells_per_axis == 0) {
+			cells_per_axis = static_cast<std::size_t>(std::ceil(std::sqrt(2 * static_cast<double>(m_ax.size()))));
+		}
+		m_columns = m_rows = std::max<std::size_t>(cells_per_axis, 1);
+		m_cell_width = m_max_x > m_min_x ? (m_max_x - m_min_x) / static_cast<NT>(m_columns) : 1;
+		m_cell_height = m_max_y > m_min_y ? (m_max_y - m_min_y) / static_cast<NT>(m_rows) : 1;
+
+		std::vector<std::pair<std::size_t, CellEntry>> cell_entries;
+		for (std::size_t polygon = 0; polygon < m_num_polygons; ++polygon) {
+			if (polygon_edges[polygon] != polygon_edges[polygon + 1]) {
+				rasterize(static_cast<std::uint32_t>(polygon), polygon_edges[polygon], polygon_edges[polygon + 1], cell_entries);
+			}
+		}
+
+		// Group the entries per cell, keeping them ordered by polygon
+		std::stable_sort(std::begin(cell_entries), std::end(cell_entries), [](const auto &a, const auto &b) {
+			return a.first < b.first;
+		});
+		m_cell_offsets.assign(m_columns * m_rows + 1, 0);
+		m_entries.reserve(cell_entries.size());
+		for (const auto &[cell, entry] : cell_entries) {
+			++m_cell_offsets[cell + 1];
+			m_entries.push_back(entry);
+		}
+		std::partial_sum(std::begin(m_cell_offsets), std::end(m_cell_offsets), std::begin(m_cell_offsets));
+	}
+
+	/*!
+	 * Returns the number of indexed polygons
+	 */
+	std::size_t size() const { return m_num_polygons; }
+
+	/*!
+	 * Returns the first polygon, in the order of construction, that contains the point
+	 * @param x The x-coordinate of the point
+	 * @param y The y-coordinate of the point
+	 * @return The index of the polygon, or npos if no polygon contains the point
+	 */
+	std::size_t locate(NT x, NT y) const {
+		std::size_t row, column;
+		if (!cell_of(x, y, row, column)) {
+			return npos;
+		}
+		const std::size_t cell = row * m_columns + column;
+		for (auto i = m_cell_offsets[cell]; i < m_cell_offsets[cell + 1]; ++i) {
+			if (contains(m_entries[i], row, column, x, y)) {
+				return m_entries[i].polygon;
+			}
+		}
+		return npos;
+	}
+
+	/*!
+	 * Returns the first polygon, in the order of construction, that contains the point
+	 * @param point The point
+	 * @return The index of the polygon, or npos if no polygon contains the point
+	 */
+	std::size_t locate(const Point &point) const { return locate(point[0], point[1]); }
+
+	/*!
+	 * Reports all polygons that contain the point, in the order of construction
+	 * @tparam OutputIterator
+	 * @param x The x-coordinate of the point
+	 * @param y The y-coordinate of the point
+	 * @param result Output iterator for the indices of the polygons
+	 */
+	template <utils::OutputIterator<std::size_t> OutputIterator>
+	void containing(NT x, NT y, OutputIterator result) const {
+		std::size_t row, column;
+		if (!cell_of(x, y, row, column)) {
+			return;
+		}
+		const std::size_t cell = row * m_columns + column;
+		for (auto i = m_cell_offsets[cell]; i < m_cell_offsets[cell + 1]; ++i) {
+			if (contains(m_entries[i], row, column, x, y)) {
+				*result = m_entries[i].polygon;
+			}
+		}
+	}
+
+	/*!
+	 * Locates the first containing polygon for a batch of points given as coordinate columns,
+	 * for example the coordinate columns of a trajectory.
+	 * @tparam CoordinateIterator
+	 * @tparam OutputIterator
+	 * @param x_first Start of the x-coordinates
+	 * @param x_beyond End of the x-coordinates
+	 * @param y_first Start of the y-coordinates
+	 * @param result Output iterator for the polygon indices (or npos), one per point
+	 * @param thread_pool Optional thread pool to distribute the points over
+	 */
+	template <utils::RandomAccessIterator<NT> CoordinateIterator, utils::OutputIterator<std::size_t> OutputIterator>
+	void locate(CoordinateIterator x_first,
+	            CoordinateIterator x_beyond,
+	            CoordinateIterator y_first,
+	            OutputIterator result,
+	            utils::ThreadPool *thread_pool = nullptr) const {
+		batch(
+		    std::distance(x_first, x_beyond),
+		    [&](std::size_t i) { return locate(static_cast<NT>(x_first[i]), static_cast<NT>(y_first[i])); },
+		    result,
+		    thread_pool);
+	}
+
+	/*!
+	 * Locates the first containing polygon for a batch of points
+	 * @tparam PointIterator
+	 * @tparam OutputIterator
+	 * @param first Start of the points
+	 * @param beyond End of the points
+	 * @param result Output iterator for the polygon indices (or npos), one per point
+	 * @param thread_pool Optional thread pool to distribute the points over
+	 */
+	template <utils::RandomAccessPointIterator<GeometryTraits> PointIterator,
+	          utils::OutputIterator<std::size_t> OutputIterator>
+	void locate(PointIterator first,
+	            PointIterator beyond,
+	            OutputIterator result,
+	            utils::ThreadPool *thread_pool = nullptr) const {
+		batch(
+		    std::distance(first, beyond), [&](std::size_t i) { return locate(first[i]); }, result, thread_pool);
+	}
+};
+}  // namespace movetk::ds
+
+#endif  // MOVETK_DS_POLYGONGRIDINDEX_H
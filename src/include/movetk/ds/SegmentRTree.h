@@ -0,0 +1,537 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file SegmentRTree.h
+ *  @brief  Packed R-tree over the segments of trajectories
+ */
+
+#ifndef MOVETK_DS_SEGMENTRTREE_H
+#define MOVETK_DS_SEGMENTRTREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "movetk/utils/Requirements.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::ds {
+
+/*!
+ * @brief Static R-tree over the segments of a collection of 2D trajectories (polylines),
+ * bulk loaded with Sort-Tile-Recursive (STR) packing.
+ * @details The segments and the nodes are stored contiguously in a single buffer: a header, followed by
+ * the segments in leaf order and the nodes level by level, with the root last. Every node references
+ * a contiguous range of segments or of child nodes. The buffer contains no pointers, so it can be written
+ * to a file with serialize() and used in place, for example from a memory mapped file, with map().
+ * A mapped buffer is only valid on a platform with the same number type representation.
+ *
+ * Segments are identified by the index of their trajectory in the input and the index of the segment
+ * within the trajectory: segment i connects points i and i + 1. The tree is immutable after construction
+ * and queries can be called concurrently.
+ * @tparam GeometryTraits The kernel, for example @refitem movetk::geom::MovetkGeometryKernel
+ */
+template <class GeometryTraits>
+class SegmentRTree {
+public:
+	using NT = typename GeometryTraits::NT;
+	using Point = typename GeometryTraits::MovetkPoint;
+	/*!
+	 * @brief (trajectory index, segment index) of a segment
+	 */
+	using SegmentId = std::pair<std::size_t, std::size_t>;
+
+private:
+	struct Box {
+		NT min_x, min_y, max_x, max_y;
+
+		static Box empty() {
+			return {std::numeric_limits<NT>::max(),
+			        std::numeric_limits<NT>::max(),
+			        std::numeric_limits<NT>::lowest(),
+			        std::numeric_limits<NT>::lowest()};
+		}
+		void extend(const Box &other) {
+			min_x = std::min(min_x, other.min_x);
+			min_y = std::min(min_y, other.min_y);
+			max_x = std::max(max_x, other.max_x);
+			max_y = std::max(max_y, other.max_y);
+		}
+		bool intersects(const Box &other) const {
+			return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y;
+		}
+		NT center_x() const { return (min_x + max_x) / 2; }
+		NT center_y() const { return (min_y + max_y) / 2; }
+		NT squared_distance(NT x, NT y) const {
+			const NT dx = std::max({min_x - x, NT(0), x - max_x});
+			const NT dy = std::max({min_y - y, NT(0), y - max_y});
+			return dx * dx + dy * dy;
+		}
+	};
+
+	struct Segment {
+		NT ax, ay, bx, by;
+		std::uint32_t trajectory;
+		std::uint32_t index;
+
+		Box box() const { return {std::min(ax, bx), std::min(ay, by), std::max(ax, bx), std::max(ay, by)}; }
+	};
+
+	struct Node {
+		Box box;
+		// Range of children: segments for leaves, nodes otherwise
+		std::uint32_t first;
+		std::uint32_t count;
+		std::uint32_t is_leaf;
+	};
+
+	struct Header {
+		std::uint64_t magic;
+		std::uint64_t number_type_size;
+		std::uint64_t num_segments;
+		std::uint64_t num_nodes;
+		std::uint64_t segments_offset;
+		std::uint64_t nodes_offset;
+	};
+
+	static constexpr std::uint64_t MAGIC = 0x65657274526b746dULL;  // "mtkRtree"
+
+	// Owned buffer, empty if the tree is mapped
+	std::vector<std::byte> m_storage;
+	const Header *m_header = nullptr;
+	const Segment *m_segments = nullptr;
+	const Node *m_nodes = nullptr;
+
+	static std::size_t align_up(std::size_t offset, std::size_t alignment) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	void attach(const std::byte *data) {
+		m_header = reinterpret_cast<const Header *>(data);
+		m_segments = reinterpret_cast<const Segment *>(data + m_header->segments_offset);
+		m_nodes = reinterpret_cast<const Node *>(data + m_header->nodes_offset);
+	}
+
+	template <class Compare>
+	static void parallel_sort(std::vector<std::size_t> &order, Compare compare, utils::ThreadPool *thread_pool) {
+		const std::size_t num_chunks = thread_pool == nullptr ? 1 : thread_pool->size();
+		if (num_chunks == 1 || order.size() < 2 * num_chunks) {
+			std::sort(std::begin(order), std::end(order), compare);
+			return;
+		}
+		std::vector<std::size_t> bounds(num_chunks + 1);
+		for (std::size_t i = 0; i <= num_chunks; ++i) {
+			bounds[i] = order.size() * i / num_chunks;
+		}
+		thread_pool->parallel_for(0, num_chunks, [&](std::size_t chunk) {
+			std::sort(std::begin(order) + bounds[chunk], std::begin(order) + bounds[chunk + 1], compare);
+		});
+		// Merge pairs of sorted runs until a single run is left
+		for (std::size_t width = 1; width < num_chunks; width *= 2) {
+			const std::size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+			thread_pool->parallel_for(0, num_merges, [&](std::size_t merge) {
+				const std::size_t left = 2 * width * merge;
+				const std::size_t middle = std::min(left + width, num_chunks);
+				const std::size_t right = std::min(left + 2 * width, num_chunks);
+				std::inplace_merge(std::begin(order) + bounds[left],
+				                   std::begin(order) + bounds[middle],
+				                   std::begin(order) + bounds[right],
+				                   compare);
+			});
+		}
+	}
+
+	// Orders the boxes by Sort-Tile-Recursive: vertical slices sorted on x, every slice sorted on y
+	static std::vector<std::size_t> str_order(const std::vector<Box> &boxes,
+	                                          std::size_t node_capacity,
+	                                          utils::ThreadPool *thread_pool) {
+		std::vector<std::size_t> order(boxes.size());
+		if (boxes.empty()) {
+			return order;
+		}
+		for (std::size_t i = 0; i < order.size(); ++i) {
+			order[i] = i;
+		}
+		parallel_sort(
+		    order,
+		    [&boxes](std::size_t a, std::size_t b) { return boxes[a].center_x() < boxes[b].center_x(); },
+		    thread_pool);
+		const std::size_t num_groups = (boxes.size() + node_capacity - 1) / node_capacity;
+		const auto num_slices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(num_groups))));
+		const std::size_t slice_size = num_slices * node_capacity;
+		const std::size_t num_slice_ranges = (boxes.size() + slice_size - 1) / slice_size;
+		auto sort_slice = [&](std::size_t slice) {
+			const auto first = std::begin(order) + slice * slice_size;
+			const auto beyond = std::begin(order) + std::min(boxes.size(), (slice + 1) * slice_size);
+			std::sort(first, beyond, [&boxes](std::size_t a, std::size_t b) {
+				return boxes[a].center_y() < boxes[b].center_y();
+			});
+		};
+		if (thread_pool != nullptr) {
+			thread_pool->parallel_for(0, num_slice_ranges, sort_slice);
+		} else {
+			for (std::size_t slice = 0; slice < num_slice_ranges; ++slice) {
+				sort_slice(slice);
+			}
+		}
+		return order;
+	}
+
+	// Groups consecutive children into parents of at most node_capacity children
+	static std::vector<Node> pack(const std::vector<Box> &boxes,
+	                              std::size_t children_offset,
+	                              bool is_leaf,
+	                              std::size_t node_capacity) {
+		std::vector<Node> parents;
+		for (std::size_t first = 0; first < boxes.size(); first += node_capacity) {
+			const std::size_t beyond = std::min(boxes.size(), first + node_capacity);
+			Box box = Box::empty();
+			for (auto i = first; i < beyond; ++i) {
+				box.extend(boxes[i]);
+			}
+			parents.push_back(Node{box,
+			                       static_cast<std::uint32_t>(children_offset + first),
+			                       static_cast<std::uint32_t>(beyond - first),
+			                       static_cast<std::uint32_t>(is_leaf)});
+		}
+		return parents;
+	}
+
+	static int orientation(NT ax, NT ay, NT bx, NT by, NT cx, NT cy) {
+		const NT value = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+		return (value > 0) - (value < 0);
+	}
+
+	static bool on_segment(NT ax, NT ay, NT bx, NT by, NT cx, NT cy) {
+		return std::min(ax, bx) <= cx && cx <= std::max(ax, bx) && std::min(ay, by) <= cy && cy <= std::max(ay, by);
+	}
+
+	static bool intersects(const Segment &s, NT ax, NT ay, NT bx, NT by) {
+		const int o1 = orientation(s.ax, s.ay, s.bx, s.by, ax, ay);
+		const int o2 = orientation(s.ax, s.ay, s.bx, s.by, bx, by);
+		const int o3 = orientation(ax, ay, bx, by, s.ax, s.ay);
+		const int o4 = orientation(ax, ay, bx, by, s.bx, s.by);
+		if (o1 != o2 && o3 != o4) {
+			return true;
+		}
+		return (o1 == 0 && on_segment(s.ax, s.ay, s.bx, s.by, ax, ay)) ||
+		       (o2 == 0 && on_segment(s.ax, s.ay, s.bx, s.by, bx, by)) ||
+		       (o3 == 0 && on_segment(ax, ay, bx, by, s.ax, s.ay)) || (o4 == 0 && on_segment(ax, ay, bx, by, s.bx, s.by));
+	}
+
+	static NT squared_distance(const Segment &s, NT x, NT y) {
+		const NT dx = s.bx - s.ax, dy = s.by - s.ay;
+		const NT squared_length = dx * dx + dy * dy;
+		NT t = 0;
+		if (squared_length > 0) {
+			t = std::clamp(((x - s.ax) * dx + (y - s.ay) * dy) / squared_length, NT(0), NT(1));
+		}
+		const NT px = s.ax + t * dx - x, py = s.ay + t * dy - y;
+		return px * px + py * py;
+	}
+
+	// Visits the segments in nodes whose boxes intersect the query box
+	template <class Visitor>
+	void visit(const Box &query, Visitor &&visitor) const {
+		if (empty()) {
+			return;
+		}
+		std::vector<std::size_t> stack{m_header->num_nodes - 1};
+		while (!stack.empty()) {
+			const Node &node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (!node.box.intersects(query)) {
+				continue;
+			}
+			for (auto child = node.first; child < node.first + node.count; ++child) {
+				if (node.is_leaf) {
+					if (m_segments[child].box().intersects(query)) {
+						visitor(m_segments[child]);
+					}
+				} else {
+					stack.push_back(child);
+				}
+			}
+		}
+	}
+
+	SegmentRTree() = default;
+
+public:
+	/*!
+	 * Builds the tree over the segments of a range of trajectories.
+	 * @tparam TrajectoryIterator Iterator over random access ranges of points, for example
+	 * over std::vector<GeometryTraits::MovetkPoint>
+	 * @param first Start of the range of trajectories
+	 * @param beyond End of the range of trajectories
+	 * @param thread_pool Optional thread pool to distribute the construction over
+	 * @param node_capacity Maximum number of children of a node
+	 */
+	template <std::forward_iterator TrajectoryIterator>
+	SegmentRTree(TrajectoryIterator first,
+	             TrajectoryIterator beyond,
+	             utils::ThreadPool *thread_pool = nullptr,
+	             std::size_t node_capacity = 16) {
+		node_capacity = std::max<std::size_t>(node_capacity, 2);
+		// Trajectory, segment and node indices are stored in 32 bits
+		constexpr std::size_t max_index = std::numeric_limits<std::uint32_t>::max();
+		std::vector<Segment> segments;
+		std::size_t trajectory = 0;
+		for (auto tit = first; tit != beyond; ++tit, ++trajectory) {
+			const auto points_first = std::cbegin(*tit);
+			const auto num_points = std::distance(points_first, std::cend(*tit));
+			if (trajectory > max_index || (num_points > 1 && static_cast<std::size_t>(num_points - 1) > max_index)) {
+				throw std::length_error("Too many trajectories or segments for a segment R-tree");
+			}
+			for (std::ptrdiff_t i = 0; i + 1 < num_points; ++i) {
+				const auto &a = points_first[i];
+				const auto &b = points_first[i + 1];
+				segments.push_back(Segment{a[0],
+				                           a[1],
+				                           b[0],
+				                           b[1],
+				                           static_cast<std::uint32_t>(trajectory),
+				                           static_cast<std::uint32_t>(i)});
+			}
+		}
+		if (segments.size() >= max_index) {
+			throw std::length_error("Too many segments for a segment R-tree");
+		}
+
+		// Leaf level
+		std::vector<Box> boxes(segments.size());
+		for (std::size_t i = 0; i < segments.size(); ++i) {
+			boxes[i] = segments[i].box();
+		}
+		auto order = str_order(boxes, node_capacity, thread_pool);
+		std::vector<Segment> ordered_segments(segments.size());
+		std::vector<Box> ordered_boxes(boxes.size());
+		for (std::size_t i = 0; i < order.size(); ++i) {
+			ordered_segments[i] = segments[order[i]];
+			ordered_boxes[i] = boxes[order[i]];
+		}
+		std::vector<Node> nodes;
+		std::vector<Node> level = pack(ordered_boxes, 0, true, node_capacity);
+
+		// Internal levels, until a single root is left
+		while (level.size() > 1) {
+			std::vector<Box> level_boxes(level.size());
+			for (std::size_t i = 0; i < level.size(); ++i) {
+				level_boxes[i] = level[i].box;
+			}
+			order = str_order(level_boxes, node_capacity, thread_pool);
+			const std::size_t offset = nodes.size();
+			std::vector<Box> child_boxes;
+			child_boxes.reserve(level.size());
+			for (auto i : order) {
+				nodes.push_back(level[i]);
+				child_boxes.push_back(level[i].box);
+			}
+			level = pack(child_boxes, offset, false, node_capacity);
+		}
+		nodes.insert(std::end(nodes), std::begin(level), std::end(level));
+
+		// Lay out the buffer
+		Header header{MAGIC, sizeof(NT), segments.size(), nodes.size(), 0, 0};
+		header.segments_offset = align_up(sizeof(Header), alignof(Segment));
+		header.nodes_offset = align_up(header.segments_offset + segments.size() * sizeof(Segment), alignof(Node));
+		m_storage.resize(header.nodes_offset + nodes.size() * sizeof(Node));
+		std::memcpy(m_storage.data(), &header, sizeof(Header));
+		// memcpy from the data() of an empty vector is undefined
+		if (!segments.empty()) {
+			std::memcpy(m_storage.data() + header.segments_offset, ordered_segments.data(), segments.size() * sizeof(Segment));
+		}
+		if (!nodes.empty()) {
+			std::memcpy(m_storage.data() + header.nodes_offset, nodes.data(), nodes.size() * sizeof(Node));
+		}
+		attach(m_storage.data());
+	}
+
+	// Moving a vector keeps its buffer, so the pointers stay valid; the moved-from tree is left empty
+	SegmentRTree(SegmentRTree &&other) noexcept
+	    : m_storage(std::move(other.m_storage))
+	    , m_header(std::exchange(other.m_header, nullptr))
+	    , m_segments(std::exchange(other.m_segments, nullptr))
+	    , m_nodes(std::exchange(other.m_nodes, nullptr)) {}
+	SegmentRTree &operator=(SegmentRTree &&other) noexcept {
+		m_storage = std::move(other.m_storage);
+		m_header = std::exchange(other.m_header, nullptr);
+		m_segments = std::exchange(other.m_segments, nullptr);
+		m_nodes = std::exchange(other.m_nodes, nullptr);
+		return *this;
+	}
+	SegmentRTree(const SegmentRTree &) = delete;
+	SegmentRTree &operator=(const SegmentRTree &) = delete;
+
+	/*!
+	 * Creates a tree that uses a serialized tree in place, without copying it.
+	 * @param data Start of the serialized tree, aligned to at least alignof(std::max_align_t).
+	 * Must outlive the returned tree.
+	 * @param size Size of the serialized tree in bytes
+	 * @return The tree
+	 * @throws std::invalid_argument if the data is not a serialized tree. Every node is checked to reference
+	 * segments or nodes within the buffer, and inner nodes may only reference nodes stored before them, so a
+	 * mapped tree cannot be traversed out of bounds or in a cycle.
+	 */
+	static SegmentRTree map(const void *data, std::size_t size) {
+		const auto bytes = static_cast<const std::byte *>(data);
+		Header header;
+		if (size < sizeof(Header)) {
+			throw std::invalid_argument("Buffer too small for a segment R-tree");
+		}
+		std::memcpy(&header, bytes, sizeof(Header));
+		// Checks that an array of count elements at offset lies within [begin, end), without overflow
+		const auto fits = [](std::uint64_t offset, std::uint64_t count, std::size_t element_size, std::size_t begin,
+		                     std::size_t end) {
+			return offset >= begin && offset <= end && count <= (end - offset) / element_size;
+		};
+		constexpr std::uint64_t max_index = std::numeric_limits<std::uint32_t>::max();
+		if (header.magic != MAGIC || header.number_type_size != sizeof(NT) || header.num_segments >= max_index ||
+		    header.num_nodes >= max_index ||
+		    header.segments_offset % alignof(Segment) != 0 || header.nodes_offset % alignof(Node) != 0 ||
+		    !fits(header.nodes_offset, header.num_nodes, sizeof(Node), sizeof(Header), size) ||
+		    !fits(header.segments_offset, header.num_segments, sizeof(Segment), sizeof(Header), header.nodes_offset)) {
+			throw std::invalid_argument("Buffer does not contain a compatible segment R-tree");
+		}
+		if (reinterpret_cast<std::uintptr_t>(data) % std::max({alignof(Header), alignof(Segment), alignof(Node)}) != 0) {
+			throw std::invalid_argument("Buffer of the segment R-tree is not aligned");
+		}
+		SegmentRTree tree;
+		tree.attach(bytes);
+		// Children of inner nodes precede their parent, as laid out by the constructor
+		for (std::uint64_t i = 0; i < header.num_nodes; ++i) {
+			const Node &node = tree.m_nodes[i];
+			const std::uint64_t beyond = std::uint64_t{node.first} + node.count;
+			if (node.is_leaf > 1 || beyond > (node.is_leaf ? header.num_segments : i)) {
+				throw std::invalid_argument("Segment R-tree contains an invalid node");
+			}
+		}
+		return tree;
+	}
+
+	/*!
+	 * Writes the tree to a stream, in the format accepted by map()
+	 * @param out The stream
+	 */
+	void serialize(std::ostream &out) const {
+		if (m_header != nullptr) {
+			out.write(reinterpret_cast<const char *>(m_header), size_bytes());
+		}
+	}
+
+	/*!
+	 * Returns the size of the serialized tree in bytes
+	 */
+	std::size_t size_bytes() const {
+		return m_header == nullptr ? 0 : m_header->nodes_offset + m_header->num_nodes * sizeof(Node);
+	}
+
+	/*!
+	 * Returns the number of segments in the tree
+	 */
+	std::size_t size() const { return m_header == nullptr ? 0 : m_header->num_segments; }
+
+	/*!
+	 * Returns whether the tree has no segments
+	 */
+	bool empty() const { return m_header == nullptr || m_header->num_nodes == 0 || m_header->num_segments == 0; }
+
+	/*!
+	 * Reports the segments whose bounding box intersects the query window
+	 * @tparam OutputIterator
+	 * @param min Lower left corner of the window
+	 * @param max Upper right corner of the window
+	 * @param result Output iterator for the segments
+	 */
+	template <utils::OutputIterator<SegmentId> OutputIterator>
+	void window(const Point &min, const Point &max, OutputIterator result) const {
+		visit(Box{min[0], min[1], max[0], max[1]}, [&result](const Segment &segment) {
+			*result = SegmentId(segment.trajectory, segment.index);
+		});
+	}
+
+	/*!
+	 * Reports the segments that intersect the query segment, including touching segments
+	 * @tparam OutputIterator
+	 * @param a First endpoint of the query segment
+	 * @param b Second endpoint of the query segment
+	 * @param result Output iterator for the segments
+	 */
+	template <utils::OutputIterator<SegmentId> OutputIterator>
+	void intersecting(const Point &a, const Point &b, OutputIterator result) const {
+		const NT ax = a[0], ay = a[1], bx = b[0], by = b[1];
+		visit(Box{std::min(ax, bx), std::min(ay, by), std::max(ax, bx), std::max(ay, by)},
+		      [&](const Segment &segment) {
+			      if (intersects(segment, ax, ay, bx, by)) {
+				      *result = SegmentId(segment.trajectory, segment.index);
+			      }
+		      });
+	}
+
+	/*!
+	 * Finds the segment nearest to the query point
+	 * @param point The query point
+	 * @return The nearest segment and its squared distance to the point, or nothing if the tree is empty
+	 */
+	std::optional<std::pair<SegmentId, NT>> nearest(const Point &point) const {
+		if (empty()) {
+			return std::nullopt;
+		}
+		const NT x = point[0], y = point[1];
+		// Best first search over nodes, ordered by the distance to their boxes
+		using Entry = std::pair<NT, std::size_t>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		const std::size_t root = m_header->num_nodes - 1;
+		queue.emplace(m_nodes[root].box.squared_distance(x, y), root);
+		std::optional<std::pair<SegmentId, NT>> best;
+		while (!queue.empty()) {
+			const auto [distance, index] = queue.top();
+			queue.pop();
+			if (best && distance >= best->second) {
+				break;
+			}
+			const Node &node = m_nodes[index];
+			for (auto child = node.first; child < node.first + node.count; ++child) {
+				if (node.is_leaf) {
+					const NT d = squared_distance(m_segments[child], x, y);
+					if (!best || d < best->second) {
+						best.emplace(SegmentId(m_segments[child].trajectory, m_segments[child].index), d);
+					}
+				} else {
+					queue.emplace(m_nodes[child].box.squared_distance(x, y), child);
+				}
+			}
+		}
+		return best;
+	}
+};
+}  // namespace movetk::ds
+
+#endif  // MOVETK_DS_SEGMENTRTREE_H
@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file SpatioTemporalIndex.h
+ *  @brief  Index for spatio-temporal range queries over trajectories
+ */
+
+#ifndef MOVETK_DS_SPATIOTEMPORALINDEX_H
+#define MOVETK_DS_SPATIOTEMPORALINDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "movetk/utils/Requirements.h"
+
+namespace movetk::ds {
+
+/*!
+ * @brief Index over a growing collection of trajectories that answers which trajectories
+ * were inside a region during a time window.
+ * @details Time is partitioned into buckets of fixed width, and the plane into a uniform grid of square cells.
+ * Every (time bucket, cell) pair that is crossed by a segment, moving linearly in time, has a posting list of
+ * (trajectory, range of segments) entries, in which consecutive segments of a trajectory are merged into a
+ * single range. Posting lists are compressed with delta and variable length integer encoding.
+ * A segment that crosses more than a maximum number of (time bucket, cell) pairs, such as a long gap in
+ * the sampling, is stored in a single overflow posting list instead, which every query scans.
+ * A query decodes the posting lists of the buckets and cells overlapping the query, and refines
+ * the candidates exactly: a trajectory is reported if the part of one of its segments within the time window
+ * intersects the region, interpolating the position linearly in time.
+ *
+ * The index stores the points of the trajectories for the refinement. Coordinates are planar: geographic
+ * trajectories are projected while appending, for example with geo::LocalCoordinateReference.
+ * Trajectories are appended incrementally, for example as they are produced by a splitter, and must be
+ * sorted by time. Appending must not run concurrently with queries; queries can run concurrently.
+ * @tparam GeometryTraits The kernel, for example @refitem movetk::geom::MovetkGeometryKernel
+ * @tparam Time The type of the timestamps
+ */
+template <class GeometryTraits, class Time = std::size_t>
+class SpatioTemporalIndex {
+public:
+	using NT = typename GeometryTraits::NT;
+	using Point = typename GeometryTraits::MovetkPoint;
+
+private:
+	struct Key {
+		std::int64_t bucket;
+		std::int64_t column;
+		std::int64_t row;
+
+		bool operator==(const Key &other) const = default;
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key &key) const {
+			std::size_t hash = std::hash<std::int64_t>()(key.bucket);
+			hash = hash * 0x9e3779b97f4a7c15ULL + std::hash<std::int64_t>()(key.column);
+			return hash * 0x9e3779b97f4a7c15ULL + std::hash<std::int64_t>()(key.row);
+		}
+	};
+
+	// Entries (trajectory, first segment, last segment), delta encoded as variable length integers
+	struct PostingList {
+		std::vector<std::uint8_t> bytes;
+		std::size_t last_trajectory = 0;
+		std::size_t last_segment = 0;
+
+		void put(std::size_t value) {
+			while (value >= 0x80) {
+				bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			bytes.push_back(static_cast<std::uint8_t>(value));
+		}
+
+		// Entries must be added by increasing trajectory and segment
+		void add(std::size_t trajectory, std::size_t first, std::size_t last) {
+			// The first segment is relative to the previous entry only within the same trajectory
+			const bool same_trajectory = !bytes.empty() && trajectory == last_trajectory;
+			put(trajectory - last_trajectory);
+			put(same_trajectory ? first - last_segment : first);
+			put(last - first);
+			last_trajectory = trajectory;
+			last_segment = last;
+		}
+
+		template <class Visitor>
+		void decode(Visitor &&visitor) const {
+			auto it = std::cbegin(bytes);
+			auto get = [&it]() {
+				std::size_t value = 0;
+				int shift = 0;
+				for (;; shift += 7) {
+					const auto byte = *it++;
+					value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+					if ((byte & 0x80) == 0) {
+						return value;
+					}
+				}
+			};
+			std::size_t trajectory = 0, segment = 0;
+			bool first_entry = true;
+			while (it != std::cend(bytes)) {
+				const auto trajectory_delta = get();
+				const auto first_delta = get();
+				const auto length = get();
+				const std::size_t first =
+				    trajectory_delta == 0 && !first_entry ? segment + first_delta : first_delta;
+				trajectory += trajectory_delta;
+				segment = first + length;
+				first_entry = false;
+				visitor(trajectory, first, segment);
+			}
+		}
+	};
+
+	NT m_cell_size;
+	Time m_bucket_width;
+	std::size_t m_max_cells_per_segment;
+	std::unordered_map<Key, PostingList, KeyHash> m_postings;
+	PostingList m_overflow;
+	// Points of trajectory i are at [m_offsets[i], m_offsets[i + 1])
+	std::vector<std::size_t> m_offsets{0};
+	std::vector<NT> m_xs, m_ys;
+	std::vector<Time> m_ts;
+
+	std::int64_t cell_of(NT coordinate) const { return static_cast<std::int64_t>(std::floor(coordinate / m_cell_size)); }
+	std::int64_t bucket_of(Time t) const {
+		return static_cast<std::int64_t>(std::floor(static_cast<NT>(t) / static_cast<NT>(m_bucket_width)));
+	}
+
+	std::size_t num_segments(std::size_t trajectory) const {
+		const auto num_points = m_offsets[trajectory + 1] - m_offsets[trajectory];
+		return num_points > 1 ? num_points - 1 : num_points;
+	}
+
+	Key key_of(std::size_t point) const { return {bucket_of(m_ts[point]), cell_of(m_xs[point]), cell_of(m_ys[point])}; }
+
+	// Visits the keys crossed by the segment from point a to point b, moving linearly in time, from the key of
+	// a to the key of b. Walks the grid of (time bucket, column, row) like a 3D DDA, one axis per step.
+	template <class Visitor>
+	void walk(std::size_t a, std::size_t b, const Key &from, const Key &to, Visitor &&visitor) const {
+		const NT origin[3] = {static_cast<NT>(m_ts[a]), m_xs[a], m_ys[a]};
+		const NT direction[3] = {static_cast<NT>(m_ts[b]) - origin[0], m_xs[b] - origin[1], m_ys[b] - origin[2]};
+		const NT size[3] = {static_cast<NT>(m_bucket_width), m_cell_size, m_cell_size};
+		std::int64_t index[3] = {from.bucket, from.column, from.row};
+		const std::int64_t target[3] = {to.bucket, to.column, to.row};
+		std::int64_t step[3];
+		// Parameter along the segment at which the next boundary is crossed, and between boundaries
+		NT next[3], delta[3];
+		for (int i = 0; i < 3; ++i) {
+			step[i] = (target[i] > index[i]) - (target[i] < index[i]);
+			if (step[i] == 0) {
+				next[i] = delta[i] = std::numeric_limits<NT>::max();
+			} else {
+				const NT boundary = static_cast<NT>(index[i] + (step[i] > 0)) * size[i];
+				next[i] = (boundary - origin[i]) / direction[i];
+				delta[i] = size[i] / std::abs(direction[i]);
+			}
+		}
+		visitor(from);
+		// Every step moves one axis towards its target, so the walk ends at the key of b despite rounding
+		while (index[0] != target[0] || index[1] != target[1] || index[2] != target[2]) {
+			int axis = -1;
+			for (int i = 0; i < 3; ++i) {
+				if (index[i] != target[i] && (axis < 0 || next[i] < next[axis])) {
+					axis = i;
+				}
+			}
+			index[axis] += step[axis];
+			next[axis] += delta[axis];
+			visitor(Key{index[0], index[1], index[2]});
+		}
+	}
+
+	// Adds the postings of the last appended trajectory
+	void index_last() {
+		const std::size_t trajectory = m_offsets.size() - 2;
+		const std::size_t offset = m_offsets[trajectory];
+		const std::size_t last_point = m_offsets[trajectory + 1] - 1;
+		using Range = std::pair<std::size_t, std::size_t>;
+		// Extends the open range with the segment, or returns false if the segment does not continue it
+		auto extend = [](Range &range, std::size_t segment) {
+			if (range.second + 1 == segment || range.second == segment) {
+				range.second = segment;
+				return true;
+			}
+			return false;
+		};
+		// Open range of segments per key, and in the overflow list
+		std::unordered_map<Key, Range, KeyHash> open;
+		std::optional<Range> open_overflow;
+		for (std::size_t segment = 0; segment < num_segments(trajectory); ++segment) {
+			const auto a = offset + segment, b = std::min(offset + segment + 1, last_point);
+			const Key from = key_of(a), to = key_of(b);
+			const auto num_steps = static_cast<std::uint64_t>(std::abs(to.bucket - from.bucket)) +
+			                       static_cast<std::uint64_t>(std::abs(to.column - from.column)) +
+			                       static_cast<std::uint64_t>(std::abs(to.row - from.row));
+			if (num_steps >= m_max_cells_per_segment) {
+				if (!open_overflow) {
+					open_overflow.emplace(segment, segment);
+				} else if (!extend(*open_overflow, segment)) {
+					m_overflow.add(trajectory, open_overflow->first, open_overflow->second);
+					open_overflow.emplace(segment, segment);
+				}
+				continue;
+			}
+			walk(a, b, from, to, [&](const Key &key) {
+				auto [it, inserted] = open.try_emplace(key, segment, segment);
+				if (!inserted && !extend(it->second, segment)) {
+					m_postings[key].add(trajectory, it->second.first, it->second.second);
+					it->second = {segment, segment};
+				}
+			});
+		}
+		for (const auto &[key, range] : open) {
+			m_postings[key].add(trajectory, range.first, range.second);
+		}
+		if (open_overflow) {
+			m_overflow.add(trajectory, open_overflow->first, open_overflow->second);
+		}
+	}
+
+	// Whether the part of the segment within [t0, t1] intersects the box
+	bool refine(std::size_t trajectory, std::size_t segment, const Point &min, const Point &max, Time t0, Time t1) const {
+		const std::size_t a = m_offsets[trajectory] + segment;
+		const std::size_t b = std::min(a + 1, m_offsets[trajectory + 1] - 1);
+		if (m_ts[b] < t0 || m_ts[a] > t1) {
+			return false;
+		}
+		NT ax = m_xs[a], ay = m_ys[a], bx = m_xs[b], by = m_ys[b];
+		if (m_ts[b] > m_ts[a]) {
+			const NT duration = static_cast<NT>(m_ts[b] - m_ts[a]);
+			const NT start = m_ts[a] < t0 ? static_cast<NT>(t0 - m_ts[a]) / duration : 0;
+			const NT end = m_ts[b] > t1 ? static_cast<NT>(t1 - m_ts[a]) / duration : 1;
+			const NT dx = bx - ax, dy = by - ay;
+			bx = ax + end * dx;
+			by = ay + end * dy;
+			ax += start * dx;
+			ay += start * dy;
+		}
+		// Liang-Barsky clipping of the segment against the box
+		NT t_enter = 0, t_exit = 1;
+		const NT dx = bx - ax, dy = by - ay;
+		const NT p[4] = {-dx, dx, -dy, dy};
+		const NT q[4] = {ax - min[0], max[0] - ax, ay - min[1], max[1] - ay};
+		for (int i = 0; i < 4; ++i) {
+			if (p[i] == 0) {
+				if (q[i] < 0) {
+					return false;
+				}
+			} else {
+				const NT t = q[i] / p[i];
+				if (p[i] < 0) {
+					t_enter = std::max(t_enter, t);
+				} else {
+					t_exit = std::min(t_exit, t);
+				}
+			}
+		}
+		return t_enter <= t_exit;
+	}
+
+public:
+	/*!
+	 * @param cell_size Width and height of the cells of the spatial grid
+	 * @param bucket_width Duration of the time buckets
+	 * @param max_cells_per_segment Maximum number of (time bucket, cell) pairs a segment is added to; segments
+	 * crossing more are added to the overflow list
+	 */
+	SpatioTemporalIndex(NT cell_size, Time bucket_width, std::size_t max_cells_per_segment = 1024)
+	    : m_cell_size(cell_size), m_bucket_width(bucket_width), m_max_cells_per_segment(max_cells_per_segment) {}
+
+	/*!
+	 * Appends a trajectory given by its coordinate and time columns
+	 * @param x_first Start of the x-coordinates
+	 * @param x_beyond End of the x-coordinates
+	 * @param y_first Start of the y-coordinates
+	 * @param t_first Start of the timestamps, in increasing order
+	 * @return The index of the trajectory, which is the number of previously appended trajectories
+	 */
+	template <utils::RandomAccessIterator<NT> CoordinateIterator, std::random_access_iterator TimeIterator>
+	std::size_t append(CoordinateIterator x_first, CoordinateIterator x_beyond, CoordinateIterator y_first, TimeIterator t_first) {
+		const std::size_t num_points = std::distance(x_first, x_beyond);
+		m_xs.insert(std::end(m_xs), x_first, x_beyond);
+		m_ys.insert(std::end(m_ys), y_first, y_first + num_points);
+		m_ts.insert(std::end(m_ts), t_first, t_first + num_points);
+		m_offsets.push_back(m_xs.size());
+		index_last();
+		return m_offsets.size() - 2;
+	}
+
+	/*!
+	 * Appends a trajectory given by a range of probe points, for example the output of a splitter
+	 * @tparam X Column of the x-coordinate
+	 * @tparam Y Column of the y-coordinate
+	 * @tparam T Column of the timestamp
+	 * @param first Start of the probe points, in increasing order of time
+	 * @param beyond End of the probe points
+	 * @return The index of the trajectory
+	 */
+	template <std::size_t X, std::size_t Y, std::size_t T, std::random_access_iterator ProbeIterator>
+	std::size_t append(ProbeIterator first, ProbeIterator beyond) {
+		for (auto it = first; it != beyond; ++it) {
+			m_xs.push_back(static_cast<NT>(std::get<X>(*it)));
+			m_ys.push_back(static_cast<NT>(std::get<Y>(*it)));
+			m_ts.push_back(static_cast<Time>(std::get<T>(*it)));
+		}
+		m_offsets.push_back(m_xs.size());
+		index_last();
+		return m_offsets.size() - 2;
+	}
+
+	/*!
+	 * Appends a trajectory given by a range of geographic probe points, which are projected to the plane
+	 * @tparam LAT Column of the latitude
+	 * @tparam LON Column of the longitude
+	 * @tparam T Column of the timestamp
+	 * @param first Start of the probe points, in increasing order of time
+	 * @param beyond End of the probe points
+	 * @param projection The projection, for example geo::LocalCoordinateReference
+	 * @return The index of the trajectory
+	 */
+	template <std::size_t LAT, std::size_t LON, std::size_t T, std::random_access_iterator ProbeIterator, class Projection>
+	std::size_t append(ProbeIterator first, ProbeIterator beyond, Projection &projection) {
+		for (auto it = first; it != beyond; ++it) {
+			const auto projected = projection.project(std::get<LAT>(*it), std::get<LON>(*it));
+			m_xs.push_back(static_cast<NT>(projected[0]));
+			m_ys.push_back(static_cast<NT>(projected[1]));
+			m_ts.push_back(static_cast<Time>(std::get<T>(*it)));
+		}
+		m_offsets.push_back(m_xs.size());
+		index_last();
+		return m_offsets.size() - 2;
+	}
+
+	/*!
+	 * Reports the trajectories that were inside the box at some moment during the time window
+	 * @tparam OutputIterator
+	 * @param min Lower left corner of the box
+	 * @param max Upper right corner of the box
+	 * @param t0 Start of the time window
+	 * @param t1 End of the time window
+	 * @param result Output iterator for the trajectory indices, reported in increasing order
+	 */
+	template <utils::OutputIterator<std::size_t> OutputIterator>
+	void query(const Point &min, const Point &max, Time t0, Time t1, OutputIterator result) const {
+		if (t1 < t0 || max[0] < min[0] || max[1] < min[1]) {
+			return;
+		}
+		const Key low{bucket_of(t0), cell_of(min[0]), cell_of(min[1])};
+		const Key high{bucket_of(t1), cell_of(max[0]), cell_of(max[1])};
+		std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> candidates;
+		auto collect = [&candidates](std::size_t trajectory, std::size_t first, std::size_t last) {
+			candidates.emplace_back(trajectory, first, last);
+		};
+		const auto num_keys = static_cast<NT>(high.bucket - low.bucket + 1) * static_cast<NT>(high.column - low.column + 1) *
+		                      static_cast<NT>(high.row - low.row + 1);
+		if (num_keys > static_cast<NT>(m_postings.size())) {
+			for (const auto &[key, postings] : m_postings) {
+				if (key.bucket >= low.bucket && key.bucket <= high.bucket && key.column >= low.column &&
+				    key.column <= high.column && key.row >= low.row && key.row <= high.row) {
+					postings.decode(collect);
+				}
+			}
+		} else {
+			for (auto bucket = low.bucket; bucket <= high.bucket; ++bucket) {
+				for (auto column = low.column; column <= high.column; ++column) {
+					for (auto row = low.row; row <= high.row; ++row) {
+						const auto it = m_postings.find(Key{bucket, column, row});
+						if (it != std::end(m_postings)) {
+							it->second.decode(collect);
+						}
+					}
+				}
+			}
+		}
+		m_overflow.decode(collect);
+
+		std::sort(std::begin(candidates), std::end(candidates));
+		std::size_t reported = std::numeric_limits<std::size_t>::max();
+		for (const auto &[trajectory, first, last] : candidates) {
+			if (trajectory == reported) {
+				continue;
+			}
+			for (auto segment = first; segment <= last; ++segment) {
+				if (refine(trajectory, segment, min, max, t0, t1)) {
+					*result = trajectory;
+					reported = trajectory;
+					break;
+				}
+			}
+		}
+	}
+
+	/*!
+	 * Returns the number of appended trajectories
+	 */
+	std::size_t size() const { return m_offsets.size() - 1; }
+
+	/*!
+	 * Returns the total size of the compressed posting lists in bytes
+	 */
+	std::size_t posting_bytes() const {
+		std::size_t bytes = m_overflow.bytes.size();
+		for (const auto &[key, postings] : m_postings) {
+			bytes += postings.bytes.size();
+		}
+		return bytes;
+	}
+};
+}  // namespace movetk::ds
+
+#endif  // MOVETK_DS_SPATIOTEMPORALINDEX_H
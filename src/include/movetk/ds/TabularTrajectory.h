@@ -31,14 +31,20 @@
 
 #include <algorithm>
 #include <array>
+#include <compare>
+#include <cstddef>
 #include <exception>
 #include <iostream>
+#include <iterator>
+#include <ranges>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "movetk/Interpolation.h"
 #include "movetk/PolylineUtils.h"
+#include "movetk/geom/ObjectCreation.h"
 #include "movetk/io/TrajectoryTraits.h"
 #include "movetk/io/TuplePrinter.h"
 #include "movetk/utils/Meta.h"
@@ -144,11 +150,7 @@ public:
 	 */
 	template <int field_idx>
 	auto get() const -> std::vector<FieldType<field_idx>> {
-		std::vector<FieldType<field_idx>> field_vector;
-		for (auto& p : _points) {
-			field_vector.push_back(std::get<field_idx>(p));
-		}
-		return field_vector;
+		return std::vector<FieldType<field_idx>>(begin<field_idx>(), end<field_idx>());
 	}
 
 	/**
@@ -157,6 +159,16 @@ public:
 	 */
 	const ValueList& data() const { return _points; }
 
+	/**
+	 * @brief Moves the points out of the trajectory, leaving it empty, for example to reuse their storage
+	 * @return The points
+	 */
+	ValueList release() {
+		ValueList points;
+		points.swap(_points);
+		return points;
+	}
+
 	/**
 	 * @brief Updates all the values of the specified field with the new values
 	 * @param new_field_values The new values
@@ -340,71 +352,111 @@ public:
 	}
 
 
-	// FieldIterator nested class
-	template <int field_idx>
-	class FieldIterator {
+	/**
+	 * @brief Random access iterator over the values of one field, striding over the rows
+	 * @tparam field_idx Index of the field
+	 * @tparam RowIterator Iterator of the rows, TrajectoryIterator or ConstTrajectoryIterator
+	 */
+	template <int field_idx, class RowIterator>
+	class BasicFieldIterator {
 	private:
-		TabularTrajectory* _parent;
-		TrajectoryIterator _it;
+		RowIterator _it{};
 
 	public:
-		using iterator_category = std::input_iterator_tag;
-		using value_type = std::tuple_element_t<field_idx, std::tuple<FIELDS...>>;
-		using difference_type = long long;
-		using pointer = value_type*;
-		using reference = value_type&;
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = FieldType<field_idx>;
+		using difference_type = std::ptrdiff_t;
+		using reference = decltype(std::get<field_idx>(*std::declval<RowIterator>()));
+		using pointer = std::remove_reference_t<reference>*;
 
-		FieldIterator() : _parent(nullptr), _it({}) {}
+		BasicFieldIterator() = default;
+
+		/// Construct an iterator at the row of @p it.
+		explicit BasicFieldIterator(RowIterator it) : _it(it) {}
 
 		/// Construct an iterator at the beginning of the @p parent object.
-		FieldIterator(TabularTrajectory& parent) : _parent(&parent) { _it = _parent->begin(); }
+		BasicFieldIterator(TabularTrajectory& parent) : _it(parent._points.begin()) {}
+
+		/// Convert a mutable field iterator to a const one.
+		template <class OtherRowIterator>
+		requires(!std::is_same_v<OtherRowIterator, RowIterator> && std::is_convertible_v<OtherRowIterator, RowIterator>)
+		    BasicFieldIterator(const BasicFieldIterator<field_idx, OtherRowIterator>& other)
+		    : _it(other.underlying_iterator()) {}
 
-		static FieldIterator end_it(TabularTrajectory& parent) {
-			FieldIterator iterator(parent);
-			iterator._it = parent.end();
-			return iterator;
+		static BasicFieldIterator end_it(TabularTrajectory& parent) {
+			return BasicFieldIterator(RowIterator(parent._points.end()));
 		}
 
-		TrajectoryIterator& underlying_iterator() { return _it; }
+		RowIterator& underlying_iterator() { return _it; }
 
-		const TrajectoryIterator& underlying_iterator() const { return _it; }
+		const RowIterator& underlying_iterator() const { return _it; }
 
-		FieldIterator& operator++() {
-			if (_parent != nullptr) {
-				++_it;
-				if (_it == _parent->end()) {
-					_parent = nullptr;
-				}
-			}
+		reference operator*() const { return std::get<field_idx>(*_it); }
+
+		pointer operator->() const { return &std::get<field_idx>(*_it); }
+
+		reference operator[](difference_type n) const { return std::get<field_idx>(_it[n]); }
+
+		BasicFieldIterator& operator++() {
+			++_it;
 			return *this;
 		}
 
-		FieldIterator operator++(int) {
-			FieldIterator copy = *this;
-			++(*this);
+		BasicFieldIterator operator++(int) {
+			BasicFieldIterator copy = *this;
+			++_it;
 			return copy;
 		}
 
-		FieldIterator operator-(int n) const {
-			FieldIterator copy = *this;
-			std::advance(copy.underlying_iterator(), -n);
+		BasicFieldIterator& operator--() {
+			--_it;
+			return *this;
+		}
+
+		BasicFieldIterator operator--(int) {
+			BasicFieldIterator copy = *this;
+			--_it;
 			return copy;
 		}
 
-		reference operator*() const { return std::get<field_idx>(*_it); }
+		BasicFieldIterator& operator+=(difference_type n) {
+			_it += n;
+			return *this;
+		}
 
-		pointer operator->() {
-			return &std::get<field_idx>(*_it);
-			;
+		BasicFieldIterator& operator-=(difference_type n) {
+			_it -= n;
+			return *this;
 		}
 
-		bool operator==(FieldIterator const& other) const {
-			return (this->underlying_iterator() == other.underlying_iterator()) ||
-			       (_parent == nullptr && other._parent == nullptr);
+		friend BasicFieldIterator operator+(BasicFieldIterator it, difference_type n) { return it += n; }
+		friend BasicFieldIterator operator+(difference_type n, BasicFieldIterator it) { return it += n; }
+		friend BasicFieldIterator operator-(BasicFieldIterator it, difference_type n) { return it -= n; }
+		friend difference_type operator-(const BasicFieldIterator& a, const BasicFieldIterator& b) {
+			return a._it - b._it;
+		}
+		friend bool operator==(const BasicFieldIterator& a, const BasicFieldIterator& b) { return a._it == b._it; }
+		friend auto operator<=>(const BasicFieldIterator& a, const BasicFieldIterator& b) {
+			return (a._it - b._it) <=> 0;
 		}
+	};  // /BasicFieldIterator nested class
 
-		bool operator!=(FieldIterator const& other) const { return !(*this == other); }
-	};  // /FieldIterator nested class
+	template <int field_idx>
+	using FieldIterator = BasicFieldIterator<field_idx, TrajectoryIterator>;
+
+	template <int field_idx>
+	using ConstFieldIterator = BasicFieldIterator<field_idx, ConstTrajectoryIterator>;
+
+	/**
+	 * @brief View of the values of one field, a random access range
+	 * @tparam field_idx Index of the field
+	 */
+	template <int field_idx>
+	using FieldView = std::ranges::subrange<FieldIterator<field_idx>>;
+
+	template <int field_idx>
+	using ConstFieldView = std::ranges::subrange<ConstFieldIterator<field_idx>>;
 
 	template <int field_idx>
 	FieldIterator<field_idx> begin() {
@@ -416,6 +468,133 @@ public:
 		return FieldIterator<field_idx>::end_it(*this);
 	}
 
+	template <int field_idx>
+	ConstFieldIterator<field_idx> begin() const {
+		return ConstFieldIterator<field_idx>(_points.cbegin());
+	}
+
+	template <int field_idx>
+	ConstFieldIterator<field_idx> end() const {
+		return ConstFieldIterator<field_idx>(_points.cend());
+	}
+
+	/**
+	 * @brief Returns a view of the values of the field with the given index, without copying them
+	 * @tparam field_idx Index of the field
+	 * @return The view, invalidated when points are inserted
+	 */
+	template <int field_idx>
+	FieldView<field_idx> field() {
+		return {begin<field_idx>(), end<field_idx>()};
+	}
+
+	template <int field_idx>
+	ConstFieldView<field_idx> field() const {
+		return {begin<field_idx>(), end<field_idx>()};
+	}
+
+	/**
+	 * @brief Random access iterator over the points made of two numeric fields, for example the
+	 * (projected) coordinates, such that algorithms on point ranges run directly on the trajectory.
+	 * @details Points are constructed on access, converting the fields to the number type of the kernel,
+	 * as with ColumnPointIterator. Member access through operator-> goes to a copy cached in the iterator,
+	 * so consecutive accesses, such as it->begin() and it->end(), refer to the same point.
+	 * @tparam GeometryTraits The kernel
+	 * @tparam XIdx Index of the field of the x-coordinates
+	 * @tparam YIdx Index of the field of the y-coordinates
+	 */
+	template <class GeometryTraits, int XIdx, int YIdx>
+	class PointIterator {
+	private:
+		ConstTrajectoryIterator _it{};
+		mutable typename GeometryTraits::MovetkPoint _point;
+
+	public:
+		using NT = typename GeometryTraits::NT;
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = typename GeometryTraits::MovetkPoint;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type;
+		using pointer = const value_type*;
+
+		PointIterator() = default;
+
+		/// Construct an iterator at the row of @p it.
+		explicit PointIterator(ConstTrajectoryIterator it) : _it(it) {}
+
+		const ConstTrajectoryIterator& underlying_iterator() const { return _it; }
+
+		reference operator*() const {
+			return geom::MakePoint<GeometryTraits>()(
+			    {static_cast<NT>(std::get<XIdx>(*_it)), static_cast<NT>(std::get<YIdx>(*_it))});
+		}
+
+		/// Returns the point cached in the iterator, valid until the next call or until the iterator is destroyed.
+		pointer operator->() const {
+			_point = **this;
+			return &_point;
+		}
+
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		PointIterator& operator++() {
+			++_it;
+			return *this;
+		}
+
+		PointIterator operator++(int) {
+			PointIterator copy = *this;
+			++_it;
+			return copy;
+		}
+
+		PointIterator& operator--() {
+			--_it;
+			return *this;
+		}
+
+		PointIterator operator--(int) {
+			PointIterator copy = *this;
+			--_it;
+			return copy;
+		}
+
+		PointIterator& operator+=(difference_type n) {
+			_it += n;
+			return *this;
+		}
+
+		PointIterator& operator-=(difference_type n) {
+			_it -= n;
+			return *this;
+		}
+
+		friend PointIterator operator+(PointIterator it, difference_type n) { return it += n; }
+		friend PointIterator operator+(difference_type n, PointIterator it) { return it += n; }
+		friend PointIterator operator-(PointIterator it, difference_type n) { return it -= n; }
+		friend difference_type operator-(const PointIterator& a, const PointIterator& b) { return a._it - b._it; }
+		friend bool operator==(const PointIterator& a, const PointIterator& b) { return a._it == b._it; }
+		friend auto operator<=>(const PointIterator& a, const PointIterator& b) { return (a._it - b._it) <=> 0; }
+	};  // /PointIterator nested class
+
+	template <class GeometryTraits, int XIdx, int YIdx>
+	using PointView = std::ranges::subrange<PointIterator<GeometryTraits, XIdx, YIdx>>;
+
+	/**
+	 * @brief Returns a view of the points made of two numeric fields, without copying them.
+	 * The position of a point in the view is its row index.
+	 * @tparam GeometryTraits The kernel
+	 * @tparam XIdx Index of the field of the x-coordinates
+	 * @tparam YIdx Index of the field of the y-coordinates
+	 * @return The view, invalidated when points are inserted
+	 */
+	template <class GeometryTraits, int XIdx, int YIdx>
+	PointView<GeometryTraits, XIdx, YIdx> points() const {
+		using Iterator = PointIterator<GeometryTraits, XIdx, YIdx>;
+		return {Iterator(_points.cbegin()), Iterator(_points.cend())};
+	}
+
 private:
 	std::vector<std::tuple<FIELDS...>> _points;
 };
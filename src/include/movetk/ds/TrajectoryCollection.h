@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file TrajectoryCollection.h
+ *  @brief  Packed storage of many trajectories in shared columns
+ */
+
+#ifndef MOVETK_DS_TRAJECTORYCOLLECTION_H
+#define MOVETK_DS_TRAJECTORYCOLLECTION_H
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "movetk/ds/ColumnarTrajectory.h"
+#include "movetk/geom/ObjectCreation.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::ds {
+
+/**
+ * @brief Random access iterator that combines two coordinate columns into points of the kernel.
+ * Points are constructed on dereference, so the iterator models RandomAccessPointIterator
+ * without storing the points.
+ * @tparam GeometryTraits The kernel
+ * @tparam X Type of the x-coordinates
+ * @tparam Y Type of the y-coordinates
+ */
+template <class GeometryTraits, class X, class Y = X>
+class ColumnPointIterator {
+public:
+	using NT = typename GeometryTraits::NT;
+	using value_type = typename GeometryTraits::MovetkPoint;
+	using reference = value_type;
+	using difference_type = std::ptrdiff_t;
+	using iterator_category = std::random_access_iterator_tag;
+	using iterator_concept = std::random_access_iterator_tag;
+
+	ColumnPointIterator() = default;
+	ColumnPointIterator(const X* x, const Y* y) : m_x(x), m_y(y) {}
+
+	value_type operator*() const { return geom::MakePoint<GeometryTraits>()({static_cast<NT>(*m_x), static_cast<NT>(*m_y)}); }
+	value_type operator[](difference_type n) const { return *(*this + n); }
+
+	ColumnPointIterator& operator++() {
+		++m_x;
+		++m_y;
+		return *this;
+	}
+	ColumnPointIterator operator++(int) {
+		auto old = *this;
+		++*this;
+		return old;
+	}
+	ColumnPointIterator& operator--() {
+		--m_x;
+		--m_y;
+		return *this;
+	}
+	ColumnPointIterator operator--(int) {
+		auto old = *this;
+		--*this;
+		return old;
+	}
+	ColumnPointIterator& operator+=(difference_type n) {
+		m_x += n;
+		m_y += n;
+		return *this;
+	}
+	ColumnPointIterator& operator-=(difference_type n) { return *this += -n; }
+	friend ColumnPointIterator operator+(ColumnPointIterator it, difference_type n) { return it += n; }
+	friend ColumnPointIterator operator+(difference_type n, ColumnPointIterator it) { return it += n; }
+	friend ColumnPointIterator operator-(ColumnPointIterator it, difference_type n) { return it -= n; }
+	friend difference_type operator-(const ColumnPointIterator& a, const ColumnPointIterator& b) { return a.m_x - b.m_x; }
+	friend bool operator==(const ColumnPointIterator& a, const ColumnPointIterator& b) { return a.m_x == b.m_x; }
+	friend auto operator<=>(const ColumnPointIterator& a, const ColumnPointIterator& b) { return a.m_x <=> b.m_x; }
+
+private:
+	const X* m_x = nullptr;
+	const Y* m_y = nullptr;
+};
+
+/**
+ * @brief Collection of trajectories stored in compressed sparse row format: every field is a single column
+ * holding the points of all trajectories, and an offsets array delimits the trajectories.
+ * @details Trajectories are handed out as lightweight views of spans into the columns. Appending trajectories
+ * invalidates the views. The collection can be read concurrently, for example with for_each().
+ * @tparam ...FIELDS Types of the fields of the points
+ */
+template <class... FIELDS>
+class TrajectoryCollection {
+public:
+	// Total number of fields for each point
+	static constexpr std::size_t NUM_FIELDS = sizeof...(FIELDS);
+	// The type of a point
+	using value_type = std::tuple<FIELDS...>;
+
+	/**
+	 * @brief Returns the type of the field with the given index
+	 * @tparam FieldIdx The field index
+	 */
+	template <std::size_t FieldIdx>
+	using FieldType = std::tuple_element_t<FieldIdx, value_type>;
+
+	/**
+	 * @brief View of a single trajectory of the collection
+	 */
+	class View {
+	public:
+		View() = default;
+		explicit View(std::tuple<std::span<const FIELDS>...> columns) : m_columns(columns) {}
+
+		/**
+		 * @brief Returns the number of points of the trajectory
+		 */
+		std::size_t size() const { return std::get<0>(m_columns).size(); }
+
+		bool empty() const { return size() == 0; }
+
+		/**
+		 * @brief Returns the values of a field of the trajectory
+		 * @tparam FieldIdx The field index
+		 * @return Span of the values
+		 */
+		template <std::size_t FieldIdx>
+		std::span<const FieldType<FieldIdx>> get() const {
+			return std::get<FieldIdx>(m_columns);
+		}
+
+		/**
+		 * @brief Returns a point of the trajectory
+		 * @param i Index of the point
+		 * @return Tuple of the fields of the point
+		 */
+		value_type operator[](std::size_t i) const {
+			return std::apply([i](const auto&... column) { return value_type(column[i]...); }, m_columns);
+		}
+
+		/**
+		 * @brief Returns the start of the points of the trajectory as points of the kernel
+		 * @tparam GeometryTraits The kernel
+		 * @tparam X Index of the field with the x-coordinates
+		 * @tparam Y Index of the field with the y-coordinates
+		 */
+		template <class GeometryTraits, std::size_t X, std::size_t Y>
+		ColumnPointIterator<GeometryTraits, FieldType<X>, FieldType<Y>> points_begin() const {
+			return {get<X>().data(), get<Y>().data()};
+		}
+
+		/**
+		 * @brief Returns the end of the points of the trajectory as points of the kernel
+		 */
+		template <class GeometryTraits, std::size_t X, std::size_t Y>
+		ColumnPointIterator<GeometryTraits, FieldType<X>, FieldType<Y>> points_end() const {
+			return points_begin<GeometryTraits, X, Y>() + static_cast<std::ptrdiff_t>(size());
+		}
+
+	private:
+		std::tuple<std::span<const FIELDS>...> m_columns;
+	};
+
+	TrajectoryCollection() = default;
+
+	/**
+	 * @brief Reserves storage
+	 * @param num_trajectories The expected number of trajectories
+	 * @param num_points The expected total number of points
+	 */
+	void reserve(std::size_t num_trajectories, std::size_t num_points) {
+		m_offsets.reserve(num_trajectories + 1);
+		std::apply([num_points](auto&... column) { (column.reserve(num_points), ...); }, m_columns);
+	}
+
+	/**
+	 * @brief Appends a trajectory given by a range of points, for example of a TabularTrajectory
+	 * @tparam PointIterator Iterator over tuples of the fields
+	 * @param first Start of the points
+	 * @param beyond End of the points
+	 * @return The index of the trajectory
+	 */
+	template <std::input_iterator PointIterator>
+	std::size_t push_back(PointIterator first, PointIterator beyond) {
+		for (; first != beyond; ++first) {
+			push_point(*first, std::make_index_sequence<NUM_FIELDS>{});
+		}
+		m_offsets.push_back(std::get<0>(m_columns).size());
+		return size() - 1;
+	}
+
+	/**
+	 * @brief Appends a trajectory stored in columns
+	 * @param trajectory The trajectory
+	 * @return The index of the trajectory
+	 */
+	std::size_t push_back(const ColumnarTrajectory<FIELDS...>& trajectory) {
+		push_columns(trajectory.data(), std::make_index_sequence<NUM_FIELDS>{});
+		m_offsets.push_back(std::get<0>(m_columns).size());
+		return size() - 1;
+	}
+
+	/**
+	 * @brief Returns the number of trajectories
+	 */
+	std::size_t size() const { return m_offsets.size() - 1; }
+
+	bool empty() const { return size() == 0; }
+
+	/**
+	 * @brief Returns the total number of points of all trajectories
+	 */
+	std::size_t num_points() const { return m_offsets.back(); }
+
+	/**
+	 * @brief Returns the offsets of the trajectories in the columns: trajectory i consists of
+	 * the points at offsets()[i], ..., offsets()[i + 1] - 1.
+	 */
+	std::span<const std::size_t> offsets() const { return m_offsets; }
+
+	/**
+	 * @brief Returns the column of a field, holding the values of all trajectories
+	 * @tparam FieldIdx The field index
+	 */
+	template <std::size_t FieldIdx>
+	std::span<const FieldType<FieldIdx>> column() const {
+		return std::get<FieldIdx>(m_columns);
+	}
+
+	/**
+	 * @brief Returns a view of a trajectory
+	 * @param i Index of the trajectory
+	 */
+	View operator[](std::size_t i) const {
+		assert(i < size());
+		return view(i, std::make_index_sequence<NUM_FIELDS>{});
+	}
+
+	/**
+	 * @brief Calls body(i, view) for every trajectory i of the collection
+	 * @tparam Body Callable taking the index of a trajectory and its view
+	 * @param body The callable, called concurrently when a thread pool is given
+	 * @param thread_pool Optional thread pool to distribute the trajectories over
+	 */
+	template <class Body>
+	void for_each(Body&& body, utils::ThreadPool* thread_pool = nullptr) const {
+		for_each_range(
+		    [&](std::size_t first, std::size_t beyond) {
+			    for (auto i = first; i < beyond; ++i) {
+				    body(i, (*this)[i]);
+			    }
+		    },
+		    thread_pool);
+	}
+
+	/**
+	 * @brief Calls body(first, beyond) for consecutive ranges of trajectories that together cover the collection.
+	 * State that the body creates per call, such as scratch buffers, is therefore reused within a block of
+	 * trajectories and released when the block is done.
+	 * @tparam Body Callable taking the first index and the index beyond the last index of a range
+	 * @param body The callable, called concurrently when a thread pool is given
+	 * @param thread_pool Optional thread pool to distribute the ranges over
+	 */
+	template <class Body>
+	void for_each_range(Body&& body, utils::ThreadPool* thread_pool = nullptr) const {
+		if (thread_pool == nullptr) {
+			if (size() > 0) {
+				body(std::size_t{0}, size());
+			}
+			return;
+		}
+		// Blocks of trajectories with about the same number of points, to balance fleets of short trips
+		const std::size_t num_blocks = std::min(size(), thread_pool->size() * 8);
+		std::vector<std::size_t> bounds(num_blocks + 1, size());
+		bounds[0] = 0;
+		for (std::size_t block = 1; block < num_blocks; ++block) {
+			const auto target = num_points() / num_blocks * block;
+			bounds[block] = std::max<std::size_t>(
+			    bounds[block - 1],
+			    std::distance(std::cbegin(m_offsets), std::lower_bound(std::cbegin(m_offsets), std::cend(m_offsets) - 1, target)));
+		}
+		thread_pool->parallel_for(0, num_blocks, [&](std::size_t block) {
+			if (bounds[block] < bounds[block + 1]) {
+				body(bounds[block], bounds[block + 1]);
+			}
+		});
+	}
+
+private:
+	std::tuple<std::vector<FIELDS>...> m_columns;
+	std::vector<std::size_t> m_offsets{0};
+
+	template <class Point, std::size_t... idx>
+	void push_point(const Point& point, std::index_sequence<idx...>) {
+		(std::get<idx>(m_columns).push_back(std::get<idx>(point)), ...);
+	}
+
+	template <std::size_t... idx>
+	void push_columns(const std::tuple<std::vector<FIELDS>...>& columns, std::index_sequence<idx...>) {
+		assert(((std::get<idx>(columns).size() == std::get<0>(columns).size()) && ...));
+		(std::get<idx>(m_columns).insert(std::end(std::get<idx>(m_columns)),
+		                                 std::cbegin(std::get<idx>(columns)),
+		                                 std::cend(std::get<idx>(columns))),
+		 ...);
+	}
+
+	template <std::size_t... idx>
+	View view(std::size_t i, std::index_sequence<idx...>) const {
+		const auto first = m_offsets[i], count = m_offsets[i + 1] - m_offsets[i];
+		return View(std::make_tuple(std::span<const FIELDS>(std::get<idx>(m_columns).data() + first, count)...));
+	}
+};
+
+/**
+ * @brief Convenience definition to get a TrajectoryCollection with as fields the types of the PROBE_TYPE type,
+ * which should be a tuple-like type
+ * @tparam PROBE_TYPE The probe type
+ */
+template <typename PROBE_TYPE>
+using TrajectoryCollectionForProbeType = movetk::utils::transfer_types<PROBE_TYPE, TrajectoryCollection>;
+}  // namespace movetk::ds
+
+#endif  // MOVETK_DS_TRAJECTORYCOLLECTION_H
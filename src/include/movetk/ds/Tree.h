@@ -43,7 +43,7 @@ namespace movetk::ds {
  * @param v
  * @return
  */
-char f(char& v) {
+inline char f(char& v) {
 	return v;
 }
 
@@ -52,7 +52,7 @@ char f(char& v) {
  * @param v
  * @return
  */
-const char f(const char& v) {
+inline const char f(const char& v) {
 	return v;
 }
 
@@ -61,7 +61,7 @@ const char f(const char& v) {
  * @param v
  * @return
  */
-std::string f(int& v) {
+inline std::string f(int& v) {
 	return std::to_string(v);
 }
 
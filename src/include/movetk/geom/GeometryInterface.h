@@ -187,8 +187,9 @@ private:
 		const auto squared_radius = radius * radius;
 		const auto _slope_ray = center - p;
 
-		NT segment_squared_length = norm(_slope_ray);
-		NT root = norm ^ 1;
+		const auto slope_norm = norm.evaluate(_slope_ray);
+		NT segment_squared_length = slope_norm.powered;
+		NT root = slope_norm ^ 1;
 		if (segment_squared_length < squared_radius || root < MOVETK_EPS) {
 			degenerate = true;
 		}
@@ -371,15 +372,11 @@ private:
 
 	NT get_length(const Point& p_u, const Point& p_v) const {
 		Vector direction = p_v - p_u;
-		norm(direction);
-		NT length = norm ^ 1;
-		return length;
+		return norm.evaluate(direction) ^ 1;
 	}
 
 	NT get_length(const Vector& direction) const {
-		norm(direction);
-		NT length = norm ^ 1;
-		return length;
+		return norm.evaluate(direction) ^ 1;
 	}
 
 	Vector get_direction_vector(const Point& p_u, const Point& p_v) const {
@@ -100,8 +100,9 @@ public:
 		auto interval = static_cast<typename InterpolationTraits::NT>(delta_t);
 
 		auto norm_delta_velocity = norm(delta_velocity);
-		auto norm_delta_position = norm(delta_position);
-		auto displacement = norm ^ 1;
+		const auto delta_position_norm = norm.evaluate(delta_position);
+		auto norm_delta_position = delta_position_norm.powered;
+		auto displacement = delta_position_norm ^ 1;
 
 		if (norm_delta_position > MOVETK_EPS && norm_delta_velocity < MOVETK_EPS) {
 			typename InterpolationTraits::NT speed_v = displacement / delta_t;
@@ -234,8 +235,7 @@ public:
 			auto vit = std::begin(velocities);
 			while (++ip_it != (ip_beyond - 1)) {
 				auto heading_v = std::get<HeadingIdx>(*ip_it);
-				auto squared_length = norm(*vit);
-				auto speed_v = norm ^ 1;
+				auto speed_v = norm.evaluate(*vit) ^ 1;
 				std::get<SpeedIdx>(*ip_it) = speed_v;
 				vit++;
 			}
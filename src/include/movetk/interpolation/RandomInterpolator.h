@@ -23,7 +23,10 @@
 //
 #ifndef MOVETK_INTERPOLATION_RANDOMINTERPOLATOR_H
 #define MOVETK_INTERPOLATION_RANDOMINTERPOLATOR_H
+#include <cstdint>
+
 #include "BaseInterpolator.h"
+#include "movetk/utils/Philox.h"
 namespace movetk::interpolation {
 struct random_trajectory_generator_tag;
 
@@ -39,7 +42,7 @@ private:
 	geom::Translation<typename InterpolationTraits::GeometryTraits> translate;
 	geom::MakePoint<typename InterpolationTraits::GeometryTraits> make_point;
 	typename InterpolationTraits::MovetkPoint ORIGIN = make_point({0, 0});
-	std::default_random_engine rng;
+	utils::Philox4x32 rng;
 
 	template <class Iterator>
 	Iterator find_source(Iterator first, Iterator current) {
@@ -71,17 +74,33 @@ public:
 	             typename InterpolationTraits::NT epsilon) {
 		ref = typename InterpolationTraits::GeoProjection(reflat, reflon);
 		std::random_device random;
-		rng = std::default_random_engine(random());
+		rng = utils::Philox4x32(random());
 		eps = epsilon;
 	}
 
 	Interpolator(typename InterpolationTraits::NT reflat, typename InterpolationTraits::NT reflon) {
 		ref = typename InterpolationTraits::GeoProjection(reflat, reflon);
 		std::random_device random;
-		rng = std::default_random_engine(random());
+		rng = utils::Philox4x32(random());
 		eps = 0.9999;
 	}
 
+	/**
+	 * @brief Construct the interpolator with a fixed seed, so that the generated trajectories can be reproduced
+	 * @param reflat Latitude of the reference point of the projection
+	 * @param reflon Longitude of the reference point of the projection
+	 * @param epsilon Tolerance on the speed bounds
+	 * @param seed Seed of the random generator
+	 */
+	Interpolator(typename InterpolationTraits::NT reflat,
+	             typename InterpolationTraits::NT reflon,
+	             typename InterpolationTraits::NT epsilon,
+	             std::uint64_t seed)
+	    : eps(epsilon)
+	    , rng(seed) {
+		ref = typename InterpolationTraits::GeoProjection(reflat, reflon);
+	}
+
 	template <class TSIterator, class OutputIterator>
 	void operator()(const typename InterpolationTraits::ProbePoint& probe_u,
 	                const typename InterpolationTraits::ProbePoint& probe_v,
@@ -0,0 +1,928 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_IO_BLOCKCOMPRESSION_H
+#define MOVETK_IO_BLOCKCOMPRESSION_H
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef MOVETK_WITH_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::io {
+/**
+ * @brief Compression formats of probe files
+ */
+enum class Compression {
+	/** Uncompressed */
+	None,
+	/** gzip, possibly with multiple members, decompressed sequentially */
+	Gzip,
+	/** Blocked gzip: gzip members of at most 64 KiB with their size in the header, as written by bgzip */
+	Bgzf,
+	/** One or more zstd frames, such as the zstd seekable format */
+	Zstd
+};
+
+namespace compression {
+inline std::uint16_t read_le16(const unsigned char *p) {
+	return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline std::uint32_t read_le32(const unsigned char *p) {
+	return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+	    (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+inline void append_le32(std::string &out, std::uint32_t value) {
+	for (int shift = 0; shift < 32; shift += 8) {
+		out.push_back(static_cast<char>((value >> shift) & 0xff));
+	}
+}
+
+constexpr std::uint32_t ZSTD_MAGIC = 0xFD2FB528;
+constexpr std::uint32_t ZSTD_SKIPPABLE_MAGIC = 0x184D2A50;
+constexpr std::uint32_t ZSTD_SKIPPABLE_MASK = 0xFFFFFFF0;
+
+/**
+ * @brief Returns the BSIZE field of a BGZF header, the size of the block minus one,
+ * or -1 if the extra field of the gzip header does not contain it.
+ * @param extra The extra field
+ * @param length The length of the extra field
+ */
+inline long bgzf_block_size(const unsigned char *extra, std::size_t length) {
+	for (std::size_t i = 0; i + 4 <= length;) {
+		const auto subfield_length = read_le16(extra + i + 2);
+		if (extra[i] == 'B' && extra[i + 1] == 'C' && subfield_length == 2 && i + 6 <= length) {
+			return read_le16(extra + i + 4);
+		}
+		i += 4 + subfield_length;
+	}
+	return -1;
+}
+
+/**
+ * @brief Splits a BGZF file into its blocks and decompresses the blocks independently.
+ */
+class BgzfDecoder {
+public:
+	static constexpr bool PARALLEL = true;
+	static constexpr std::size_t BLOCKS_PER_THREAD = 16;
+
+	/**
+	 * @brief Reads the next compressed block
+	 * @param in The compressed input
+	 * @param block Receives the block, including its header and trailer
+	 * @return False at the end of the input
+	 */
+	bool read_block(std::istream &in, std::string &block) {
+		unsigned char header[HEADER_SIZE];
+		in.read(reinterpret_cast<char *>(header), HEADER_SIZE);
+		if (in.gcount() == 0) {
+			return false;
+		}
+		if (in.gcount() != HEADER_SIZE || header[0] != 0x1f || header[1] != 0x8b || header[2] != Z_DEFLATED ||
+		    (header[3] & FEXTRA) == 0) {
+			throw std::runtime_error("Invalid BGZF block header");
+		}
+		const auto extra_length = read_le16(header + 10);
+		block.resize(HEADER_SIZE + extra_length);
+		std::memcpy(block.data(), header, HEADER_SIZE);
+		in.read(block.data() + HEADER_SIZE, extra_length);
+		const auto block_size = bgzf_block_size(reinterpret_cast<const unsigned char *>(block.data()) + HEADER_SIZE,
+		                                        static_cast<std::size_t>(in.gcount()));
+		if (block_size < 0 || static_cast<std::size_t>(block_size) + 1 < block.size() + TRAILER_SIZE) {
+			throw std::runtime_error("Invalid BGZF block header");
+		}
+		const auto header_size = block.size();
+		block.resize(static_cast<std::size_t>(block_size) + 1);
+		in.read(block.data() + header_size, static_cast<std::streamsize>(block.size() - header_size));
+		if (static_cast<std::size_t>(in.gcount()) != block.size() - header_size) {
+			throw std::runtime_error("Truncated BGZF block");
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Decompresses a block read by read_block(). Can be called concurrently.
+	 * @details The ISIZE field of the trailer is checked against the BGZF block limit before the output is
+	 * allocated, and the block is only accepted if it inflates to exactly ISIZE bytes.
+	 * @param block The block. Left in an unspecified state.
+	 * @param out Receives the decompressed data
+	 */
+	void decode(std::string &block, std::string &out) const {
+		const auto *data = reinterpret_cast<const unsigned char *>(block.data());
+		const auto header_size = HEADER_SIZE + read_le16(data + 10);
+		const auto *trailer = data + block.size() - TRAILER_SIZE;
+		const auto expected_crc = read_le32(trailer);
+		const auto size = read_le32(trailer + 4);
+		if (size > MAX_BLOCK_SIZE) {
+			throw std::runtime_error("Invalid BGZF block size");
+		}
+		out.resize(size);
+		if (size == 0) {
+			return;
+		}
+		z_stream stream{};
+		if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+			throw std::runtime_error("Failed to initialize inflate");
+		}
+		stream.next_in = const_cast<Bytef *>(data + header_size);
+		stream.avail_in = static_cast<uInt>(block.size() - header_size - TRAILER_SIZE);
+		stream.next_out = reinterpret_cast<Bytef *>(out.data());
+		stream.avail_out = size;
+		const auto result = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if (result != Z_STREAM_END || stream.total_out != size ||
+		    crc32(0, reinterpret_cast<const Bytef *>(out.data()), size) != expected_crc) {
+			throw std::runtime_error("Corrupt BGZF block");
+		}
+	}
+
+private:
+	static constexpr std::streamsize HEADER_SIZE = 12;
+	static constexpr std::size_t TRAILER_SIZE = 8;
+	static constexpr std::uint32_t MAX_BLOCK_SIZE = 1 << 16;
+	static constexpr unsigned char FEXTRA = 4;
+};
+
+/**
+ * @brief Decompresses a (multi-member) gzip stream. The boundaries of the members are not known
+ * in advance, so the stream is inflated sequentially while reading, in blocks of 1 MiB.
+ */
+class GzipDecoder {
+public:
+	static constexpr bool PARALLEL = false;
+	static constexpr std::size_t BLOCKS_PER_THREAD = 1;
+
+	GzipDecoder() : m_input(INPUT_SIZE, '\0') {
+		// 32: detect the gzip header
+		if (inflateInit2(&m_stream, MAX_WBITS + 32) != Z_OK) {
+			throw std::runtime_error("Failed to initialize inflate");
+		}
+	}
+
+	GzipDecoder(const GzipDecoder &) = delete;
+	GzipDecoder &operator=(const GzipDecoder &) = delete;
+
+	~GzipDecoder() { inflateEnd(&m_stream); }
+
+	/**
+	 * @brief Inflates the next block of the stream
+	 * @param in The compressed input
+	 * @param block Receives the decompressed data
+	 * @return False at the end of the input
+	 */
+	bool read_block(std::istream &in, std::string &block) {
+		block.resize(OUTPUT_SIZE);
+		m_stream.next_out = reinterpret_cast<Bytef *>(block.data());
+		m_stream.avail_out = static_cast<uInt>(block.size());
+		while (m_stream.avail_out > 0) {
+			if (m_stream.avail_in == 0) {
+				in.read(m_input.data(), static_cast<std::streamsize>(m_input.size()));
+				m_stream.next_in = reinterpret_cast<Bytef *>(m_input.data());
+				m_stream.avail_in = static_cast<uInt>(in.gcount());
+				if (m_stream.avail_in == 0) {
+					if (m_in_member) {
+						throw std::runtime_error("Truncated gzip stream");
+					}
+					break;
+				}
+			}
+			m_in_member = true;
+			const auto result = inflate(&m_stream, Z_NO_FLUSH);
+			if (result == Z_STREAM_END) {
+				// The next member, if any, starts after this one
+				m_in_member = false;
+				inflateReset(&m_stream);
+			} else if (result != Z_OK && result != Z_BUF_ERROR) {
+				throw std::runtime_error("Corrupt gzip stream");
+			}
+		}
+		block.resize(block.size() - m_stream.avail_out);
+		return !block.empty();
+	}
+
+	/**
+	 * @brief Passes on the block inflated by read_block()
+	 */
+	void decode(std::string &block, std::string &out) const { out.swap(block); }
+
+private:
+	static constexpr std::size_t INPUT_SIZE = 1 << 16;
+	static constexpr std::size_t OUTPUT_SIZE = 1 << 20;
+
+	z_stream m_stream{};
+	std::string m_input;
+	bool m_in_member = false;
+};
+
+#ifdef MOVETK_WITH_ZSTD
+/**
+ * @brief Splits a zstd file into its frames and decompresses the frames independently.
+ * Skippable frames, such as the seek table of the zstd seekable format, are skipped.
+ */
+class ZstdDecoder {
+public:
+	static constexpr bool PARALLEL = true;
+	static constexpr std::size_t BLOCKS_PER_THREAD = 1;
+
+	/**
+	 * @brief Reads the next frame
+	 * @param in The compressed input
+	 * @param block Receives the frame
+	 * @return False at the end of the input
+	 */
+	bool read_block(std::istream &in, std::string &block) {
+		while (true) {
+			const auto available = m_pending.size() - m_offset;
+			if (available > 0) {
+				const auto size = ZSTD_findFrameCompressedSize(m_pending.data() + m_offset, available);
+				if (!ZSTD_isError(size)) {
+					block.assign(m_pending, m_offset, size);
+					m_offset += size;
+					return true;
+				}
+				if (ZSTD_getErrorCode(size) != ZSTD_error_srcSize_wrong) {
+					throw std::runtime_error(std::string("Corrupt zstd frame: ") + ZSTD_getErrorName(size));
+				}
+			}
+			if (m_end) {
+				if (available > 0) {
+					throw std::runtime_error("Truncated zstd frame");
+				}
+				return false;
+			}
+			// Frame incomplete: read more input
+			m_pending.erase(0, m_offset);
+			m_offset = 0;
+			const auto old_size = m_pending.size();
+			m_pending.resize(old_size + std::max(INPUT_SIZE, old_size));
+			in.read(m_pending.data() + old_size, static_cast<std::streamsize>(m_pending.size() - old_size));
+			m_pending.resize(old_size + static_cast<std::size_t>(in.gcount()));
+			m_end = in.gcount() == 0;
+		}
+	}
+
+	/**
+	 * @brief Decompresses a frame read by read_block(). Can be called concurrently.
+	 * @details The output is allocated up front from the content size in the frame header only up to
+	 * MAX_PREALLOCATED_SIZE; larger frames are streamed into a buffer that grows with the actual output.
+	 * @param block The frame. Left in an unspecified state.
+	 * @param out Receives the decompressed data
+	 */
+	void decode(std::string &block, std::string &out) const {
+		if (block.size() >= 4 &&
+		    (read_le32(reinterpret_cast<const unsigned char *>(block.data())) & ZSTD_SKIPPABLE_MASK) ==
+		        ZSTD_SKIPPABLE_MAGIC) {
+			out.clear();
+			return;
+		}
+		const auto content_size = ZSTD_getFrameContentSize(block.data(), block.size());
+		if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR &&
+		    content_size <= MAX_PREALLOCATED_SIZE) {
+			out.resize(content_size);
+			const auto size = ZSTD_decompress(out.data(), out.size(), block.data(), block.size());
+			if (ZSTD_isError(size) || size != content_size) {
+				throw std::runtime_error("Corrupt zstd frame");
+			}
+			return;
+		}
+		// Frame without content size, or too large to trust the header: stream into a growing buffer
+		std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream(ZSTD_createDStream(), &ZSTD_freeDStream);
+		ZSTD_inBuffer input{block.data(), block.size(), 0};
+		out.resize(std::max<std::size_t>(ZSTD_DStreamOutSize(), 2 * block.size()));
+		std::size_t written = 0;
+		while (true) {
+			ZSTD_outBuffer output{out.data() + written, out.size() - written, 0};
+			const auto result = ZSTD_decompressStream(stream.get(), &output, &input);
+			if (ZSTD_isError(result)) {
+				throw std::runtime_error("Corrupt zstd frame");
+			}
+			written += output.pos;
+			if (result == 0) {
+				break;
+			}
+			if (written == out.size()) {
+				out.resize(2 * out.size());
+			} else if (input.pos == input.size) {
+				throw std::runtime_error("Truncated zstd frame");
+			}
+		}
+		out.resize(written);
+	}
+
+private:
+	static constexpr std::size_t INPUT_SIZE = 1 << 20;
+	static constexpr unsigned long long MAX_PREALLOCATED_SIZE = 1 << 24;
+
+	std::string m_pending;
+	std::size_t m_offset = 0;
+	bool m_end = false;
+};
+#endif
+
+/**
+ * @brief Writes BGZF: blocks of at most 65280 bytes as independent gzip members,
+ * followed by the empty end-of-file block. The output is valid (multi-member) gzip.
+ */
+class BgzfEncoder {
+public:
+	/**
+	 * @param level The zlib compression level
+	 */
+	explicit BgzfEncoder(int level = Z_DEFAULT_COMPRESSION) : m_level(level) {}
+
+	std::size_t block_size() const { return BLOCK_SIZE; }
+
+	/**
+	 * @brief Compresses a block of at most block_size() bytes. Can be called concurrently.
+	 */
+	void encode(const char *data, std::size_t size, std::string &out) const {
+		out.assign(reinterpret_cast<const char *>(HEADER.data()), HEADER.size());
+		out.resize(HEADER.size() + MAX_BLOCK_SIZE);
+		z_stream stream{};
+		if (deflateInit2(&stream, m_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			throw std::runtime_error("Failed to initialize deflate");
+		}
+		stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+		stream.avail_in = static_cast<uInt>(size);
+		stream.next_out = reinterpret_cast<Bytef *>(out.data() + HEADER.size());
+		stream.avail_out = static_cast<uInt>(MAX_BLOCK_SIZE - HEADER.size() - 8);
+		const auto result = deflate(&stream, Z_FINISH);
+		deflateEnd(&stream);
+		if (result != Z_STREAM_END) {
+			throw std::runtime_error("BGZF block does not fit");
+		}
+		out.resize(HEADER.size() + stream.total_out);
+		append_le32(out, static_cast<std::uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(size))));
+		append_le32(out, static_cast<std::uint32_t>(size));
+		const auto block_size = static_cast<std::uint16_t>(out.size() - 1);
+		out[16] = static_cast<char>(block_size & 0xff);
+		out[17] = static_cast<char>(block_size >> 8);
+	}
+
+	void record(std::size_t, std::size_t) {}
+
+	/**
+	 * @brief Appends the end-of-file block
+	 */
+	void finish(std::string &out) {
+		std::string block;
+		encode(nullptr, 0, block);
+		out += block;
+	}
+
+private:
+	static constexpr std::size_t BLOCK_SIZE = 0xff00;
+	static constexpr std::size_t MAX_BLOCK_SIZE = 1 << 16;
+	// gzip header with FEXTRA and a BC subfield, BSIZE filled in per block
+	static constexpr std::array<unsigned char, 18> HEADER{
+	    0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0, 0};
+
+	int m_level;
+};
+
+#ifdef MOVETK_WITH_ZSTD
+/**
+ * @brief Writes the zstd seekable format: independent frames of 1 MiB of input followed by a seek table,
+ * which zstd decompressors skip.
+ */
+class ZstdEncoder {
+public:
+	/**
+	 * @param level The zstd compression level
+	 * @param frame_size The number of bytes of input per frame
+	 */
+	explicit ZstdEncoder(int level = ZSTD_CLEVEL_DEFAULT, std::size_t frame_size = 1 << 20)
+	    : m_level(level),
+	      m_frame_size(frame_size) {}
+
+	std::size_t block_size() const { return m_frame_size; }
+
+	/**
+	 * @brief Compresses a block of at most block_size() bytes into a frame. Can be called concurrently.
+	 */
+	void encode(const char *data, std::size_t size, std::string &out) const {
+		out.resize(ZSTD_compressBound(size));
+		const auto compressed = ZSTD_compress(out.data(), out.size(), data, size, m_level);
+		if (ZSTD_isError(compressed)) {
+			throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(compressed));
+		}
+		out.resize(compressed);
+	}
+
+	/**
+	 * @brief Records a frame in the seek table, in the order the frames are written
+	 */
+	void record(std::size_t compressed_size, std::size_t size) {
+		m_seek_table.emplace_back(static_cast<std::uint32_t>(compressed_size), static_cast<std::uint32_t>(size));
+	}
+
+	/**
+	 * @brief Appends the seek table as a skippable frame
+	 */
+	void finish(std::string &out) {
+		append_le32(out, ZSTD_SKIPPABLE_MAGIC | 0xE);
+		append_le32(out, static_cast<std::uint32_t>(8 * m_seek_table.size() + 9));
+		for (const auto &[compressed_size, size] : m_seek_table) {
+			append_le32(out, compressed_size);
+			append_le32(out, size);
+		}
+		append_le32(out, static_cast<std::uint32_t>(m_seek_table.size()));
+		out.push_back('\0');
+		append_le32(out, SEEKABLE_MAGIC);
+	}
+
+private:
+	static constexpr std::uint32_t SEEKABLE_MAGIC = 0x8F92EAB1;
+
+	int m_level;
+	std::size_t m_frame_size;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> m_seek_table;
+};
+#endif
+}  // namespace compression
+
+/**
+ * @brief Input stream buffer decompressing a file on a background thread.
+ * @details The background thread reads batches of compressed blocks, decompresses the blocks of a batch in
+ * parallel on a thread pool, and hands the batches to the reader through a ring of RING_SIZE batches, reusing
+ * their buffers. The get area points into the decompressed blocks, so the data is not copied again.
+ * Errors in the input are rethrown by underflow().
+ * @tparam Decoder Splits the input into blocks (read_block) and decompresses a block (decode). Decoders that
+ * cannot split the input (PARALLEL is false) decompress in read_block, on the background thread only.
+ */
+template <class Decoder>
+class DecompressingStreambuf : public std::streambuf {
+public:
+	/**
+	 * @brief Construct the buffer and start decompressing
+	 * @param in The compressed input
+	 * @param num_threads Number of threads decompressing blocks, including the background thread
+	 */
+	explicit DecompressingStreambuf(std::unique_ptr<std::istream> in,
+	                                std::size_t num_threads = std::thread::hardware_concurrency())
+	    : m_in(std::move(in)),
+	      m_pool(Decoder::PARALLEL ? num_threads : 1),
+	      m_blocks_per_batch(m_pool.size() * Decoder::BLOCKS_PER_THREAD) {
+		for (auto &batch : m_ring) {
+			batch.compressed.resize(m_blocks_per_batch);
+			batch.decompressed.resize(m_blocks_per_batch);
+		}
+		m_producer = std::thread([this] { produce(); });
+	}
+
+	DecompressingStreambuf(const DecompressingStreambuf &) = delete;
+	DecompressingStreambuf &operator=(const DecompressingStreambuf &) = delete;
+
+	~DecompressingStreambuf() override {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_freed.notify_all();
+		m_producer.join();
+	}
+
+protected:
+	int_type underflow() override {
+		while (true) {
+			if (m_current != nullptr) {
+				while (m_block < m_current->size) {
+					auto &block = m_current->decompressed[m_block++];
+					if (!block.empty()) {
+						setg(block.data(), block.data(), block.data() + block.size());
+						return traits_type::to_int_type(*gptr());
+					}
+				}
+				// Hand the batch back to the background thread
+				setg(nullptr, nullptr, nullptr);
+				m_current = nullptr;
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					++m_released;
+				}
+				m_freed.notify_one();
+			}
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_filled.wait(lock, [this] { return m_produced > m_released || m_end || m_error; });
+			if (m_produced > m_released) {
+				m_current = &m_ring[m_released % RING_SIZE];
+				m_block = 0;
+			} else if (m_error) {
+				std::rethrow_exception(m_error);
+			} else {
+				return traits_type::eof();
+			}
+		}
+	}
+
+private:
+	static constexpr std::size_t RING_SIZE = 3;
+
+	struct Batch {
+		std::vector<std::string> compressed, decompressed;
+		std::size_t size = 0;
+	};
+
+	void produce() {
+		try {
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_freed.wait(lock, [this] { return m_stop || m_produced - m_released < RING_SIZE; });
+					if (m_stop) {
+						return;
+					}
+				}
+				// The reader does not access this batch until it is produced
+				auto &batch = m_ring[m_produced % RING_SIZE];
+				batch.size = 0;
+				while (batch.size < m_blocks_per_batch && m_decoder.read_block(*m_in, batch.compressed[batch.size])) {
+					++batch.size;
+				}
+				m_pool.parallel_for(0, batch.size, [&batch, this](std::size_t i) {
+					m_decoder.decode(batch.compressed[i], batch.decompressed[i]);
+				});
+				const bool last = batch.size < m_blocks_per_batch;
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (batch.size > 0) {
+						++m_produced;
+					}
+					m_end = last;
+				}
+				m_filled.notify_one();
+				if (last) {
+					return;
+				}
+			}
+		} catch (...) {
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_error = std::current_exception();
+			}
+			m_filled.notify_one();
+		}
+	}
+
+	std::unique_ptr<std::istream> m_in;
+	Decoder m_decoder;
+	utils::ThreadPool m_pool;
+	std::size_t m_blocks_per_batch;
+	std::array<Batch, RING_SIZE> m_ring;
+	Batch *m_current = nullptr;
+	std::size_t m_block = 0;
+
+	std::mutex m_mutex;
+	std::condition_variable m_filled, m_freed;
+	std::size_t m_produced = 0, m_released = 0;
+	bool m_end = false, m_stop = false;
+	std::exception_ptr m_error;
+	std::thread m_producer;
+};
+
+/**
+ * @brief Input stream reading a compressed file through a DecompressingStreambuf.
+ * Errors in the compressed data are thrown by the read operations.
+ */
+template <class Decoder>
+class DecompressingIstream : public std::istream {
+public:
+	explicit DecompressingIstream(std::unique_ptr<std::istream> in,
+	                              std::size_t num_threads = std::thread::hardware_concurrency())
+	    : std::istream(nullptr),
+	      m_buffer(std::move(in), num_threads) {
+		rdbuf(&m_buffer);
+		exceptions(std::ios_base::badbit);
+	}
+
+private:
+	DecompressingStreambuf<Decoder> m_buffer;
+};
+
+/**
+ * @brief Output stream buffer compressing blocks in parallel.
+ * @details Data is collected in blocks of Encoder::block_size() bytes. Batches of blocks are compressed in
+ * parallel on a thread pool and written in order, so the output does not depend on the number of threads.
+ * close() writes the remaining data and the trailer of the format and throws if the output could not be
+ * written. The destructor calls close() as a best-effort fallback and discards its errors, so callers that need
+ * to know whether the output is complete must call close() explicitly.
+ * sync() does not cut blocks short.
+ * @tparam Encoder Compresses a block (encode) and writes the trailer of the format (record, finish)
+ */
+template <class Encoder>
+class CompressingStreambuf : public std::streambuf {
+public:
+	/**
+	 * @brief Construct the buffer
+	 * @param out The output, opened in binary mode
+	 * @param encoder The encoder
+	 * @param num_threads Number of threads compressing blocks
+	 */
+	explicit CompressingStreambuf(std::unique_ptr<std::ostream> out,
+	                              Encoder encoder = Encoder(),
+	                              std::size_t num_threads = std::thread::hardware_concurrency())
+	    : m_out(std::move(out)),
+	      m_encoder(std::move(encoder)),
+	      m_pool(num_threads),
+	      m_input(m_pool.size() * 2),
+	      m_output(m_input.size()) {
+		start_block();
+	}
+
+	CompressingStreambuf(const CompressingStreambuf &) = delete;
+	CompressingStreambuf &operator=(const CompressingStreambuf &) = delete;
+
+	/**
+	 * @brief Closes the buffer if close() was not called. Errors are discarded.
+	 */
+	~CompressingStreambuf() override {
+		try {
+			close();
+		} catch (...) {
+		}
+	}
+
+	/**
+	 * @brief Compresses and writes the remaining data and the trailer. Further output is discarded.
+	 * @throws std::runtime_error If the output could not be written. Calling close() again rethrows the error.
+	 */
+	void close() {
+		if (m_closed) {
+			if (m_error) {
+				std::rethrow_exception(m_error);
+			}
+			return;
+		}
+		m_closed = true;
+		try {
+			end_block();
+			write_batch();
+			std::string trailer;
+			m_encoder.finish(trailer);
+			m_out->write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+			m_out->flush();
+			if (!*m_out) {
+				throw std::runtime_error("Failed to write compressed output");
+			}
+		} catch (...) {
+			m_error = std::current_exception();
+			throw;
+		}
+	}
+
+protected:
+	int_type overflow(int_type c) override {
+		if (m_closed) {
+			return traits_type::eof();
+		}
+		end_block();
+		if (m_filled == m_input.size()) {
+			write_batch();
+		}
+		start_block();
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(c);
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+private:
+	void start_block() {
+		auto &block = m_input[m_filled];
+		block.resize(m_encoder.block_size());
+		setp(block.data(), block.data() + block.size());
+	}
+
+	void end_block() {
+		const auto size = static_cast<std::size_t>(pptr() - pbase());
+		setp(nullptr, nullptr);
+		if (size > 0) {
+			m_input[m_filled++].resize(size);
+		}
+	}
+
+	void write_batch() {
+		m_pool.parallel_for(0, m_filled, [this](std::size_t i) {
+			m_encoder.encode(m_input[i].data(), m_input[i].size(), m_output[i]);
+		});
+		for (std::size_t i = 0; i < m_filled; ++i) {
+			m_encoder.record(m_output[i].size(), m_input[i].size());
+			m_out->write(m_output[i].data(), static_cast<std::streamsize>(m_output[i].size()));
+		}
+		if (!*m_out) {
+			throw std::runtime_error("Failed to write compressed output");
+		}
+		m_filled = 0;
+	}
+
+	std::unique_ptr<std::ostream> m_out;
+	Encoder m_encoder;
+	utils::ThreadPool m_pool;
+	std::vector<std::string> m_input, m_output;
+	std::size_t m_filled = 0;
+	bool m_closed = false;
+	std::exception_ptr m_error;
+};
+
+/**
+ * @brief Output stream that has to be closed explicitly to learn whether all output was written.
+ * Returned by open_compressed(). Destroying the stream without calling close() closes it, but discards errors.
+ */
+class ClosingOstream : public std::ostream {
+public:
+	using std::ostream::ostream;
+
+	/**
+	 * @brief Writes the remaining data and, for compressed output, the trailer of the format
+	 * @throws std::runtime_error If the output could not be written
+	 */
+	virtual void close() = 0;
+};
+
+/**
+ * @brief Output stream compressing blocks in parallel through a CompressingStreambuf
+ */
+template <class Encoder>
+class CompressingOstream : public ClosingOstream {
+public:
+	explicit CompressingOstream(std::unique_ptr<std::ostream> out,
+	                            Encoder encoder = Encoder(),
+	                            std::size_t num_threads = std::thread::hardware_concurrency())
+	    : ClosingOstream(nullptr),
+	      m_buffer(std::move(out), std::move(encoder), num_threads) {
+		rdbuf(&m_buffer);
+	}
+
+	/**
+	 * @brief Writes the remaining data and the trailer of the format
+	 * @throws std::runtime_error If the output could not be written. The destructor does not report errors.
+	 */
+	void close() override { m_buffer.close(); }
+
+private:
+	CompressingStreambuf<Encoder> m_buffer;
+};
+
+/**
+ * @brief Output stream writing a file without compression, with the close() semantics of ClosingOstream
+ */
+class UncompressedOstream : public ClosingOstream {
+public:
+	explicit UncompressedOstream(std::unique_ptr<std::ofstream> out)
+	    : ClosingOstream(out->rdbuf()),
+	      m_out(std::move(out)) {}
+
+	/**
+	 * @brief Flushes and closes the file
+	 * @throws std::runtime_error If the output could not be written
+	 */
+	void close() override {
+		flush();
+		const bool good = !fail() && !m_out->fail();
+		m_out->close();
+		if (!good || m_out->fail()) {
+			setstate(std::ios_base::badbit);
+			throw std::runtime_error("Failed to write output");
+		}
+	}
+
+private:
+	std::unique_ptr<std::ofstream> m_out;
+};
+
+/**
+ * @brief Detects the compression of a stream from its magic bytes. The stream is returned to its position.
+ * @param in Seekable input stream, opened in binary mode
+ */
+inline Compression detect_compression(std::istream &in) {
+	const auto position = in.tellg();
+	unsigned char header[18] = {};
+	in.read(reinterpret_cast<char *>(header), sizeof(header));
+	const auto size = static_cast<std::size_t>(in.gcount());
+	in.clear();
+	in.seekg(position);
+	if (size >= 4 && compression::read_le32(header) == compression::ZSTD_MAGIC) {
+		return Compression::Zstd;
+	}
+	if (size >= 2 && header[0] == 0x1f && header[1] == 0x8b) {
+		const bool extra = size >= 12 && (header[3] & 4) != 0;
+		if (extra && compression::bgzf_block_size(header + 12, std::min<std::size_t>(size - 12, compression::read_le16(header + 10))) >= 0) {
+			return Compression::Bgzf;
+		}
+		return Compression::Gzip;
+	}
+	return Compression::None;
+}
+
+/**
+ * @brief Wraps a stream in a decompressing stream
+ * @param in The compressed input
+ * @param compression The compression of the input
+ * @param num_threads Number of threads for decompressing BGZF and zstd
+ */
+inline std::unique_ptr<std::istream> decompress(std::unique_ptr<std::istream> in,
+                                                Compression compression,
+                                                std::size_t num_threads = std::thread::hardware_concurrency()) {
+	switch (compression) {
+		case Compression::Bgzf:
+			return std::make_unique<DecompressingIstream<compression::BgzfDecoder>>(std::move(in), num_threads);
+		case Compression::Gzip:
+			return std::make_unique<DecompressingIstream<compression::GzipDecoder>>(std::move(in), num_threads);
+		case Compression::Zstd:
+#ifdef MOVETK_WITH_ZSTD
+			return std::make_unique<DecompressingIstream<compression::ZstdDecoder>>(std::move(in), num_threads);
+#else
+			throw std::invalid_argument("zstd compressed input, but MoveTk is built without MOVETK_WITH_ZSTD");
+#endif
+		default:
+			return in;
+	}
+}
+
+/**
+ * @brief Opens a file for reading, decompressing it according to its magic bytes
+ * @param file_name The file
+ * @param num_threads Number of threads for decompressing BGZF and zstd files
+ */
+inline std::unique_ptr<std::istream> open_decompressed(const std::string &file_name,
+                                                       std::size_t num_threads = std::thread::hardware_concurrency()) {
+	auto in = std::make_unique<std::ifstream>(file_name, std::ios_base::in | std::ios_base::binary);
+	if (!*in) {
+		throw std::invalid_argument("Cannot open " + file_name);
+	}
+	const auto compression = detect_compression(*in);
+	return decompress(std::move(in), compression, num_threads);
+}
+
+/**
+ * @brief Opens a file for writing, compressing it in parallel according to its extension:
+ * BGZF for .gz and .bgz, the zstd seekable format for .zst (with MOVETK_WITH_ZSTD), none otherwise.
+ * @details Call close() on the returned stream to write the trailer and to detect write errors;
+ * the destructor does not report them.
+ * @param file_name The file
+ * @param num_threads Number of threads compressing blocks
+ */
+inline std::unique_ptr<ClosingOstream> open_compressed(const std::string &file_name,
+                                                       std::size_t num_threads = std::thread::hardware_concurrency()) {
+	auto out = std::make_unique<std::ofstream>(file_name, std::ios_base::out | std::ios_base::binary);
+	if (!*out) {
+		throw std::invalid_argument("Cannot open " + file_name);
+	}
+	if (file_name.ends_with(".gz") || file_name.ends_with(".bgz")) {
+		return std::make_unique<CompressingOstream<compression::BgzfEncoder>>(
+		    std::move(out), compression::BgzfEncoder(), num_threads);
+	}
+	if (file_name.ends_with(".zst")) {
+#ifdef MOVETK_WITH_ZSTD
+		return std::make_unique<CompressingOstream<compression::ZstdEncoder>>(
+		    std::move(out), compression::ZstdEncoder(), num_threads);
+#else
+		throw std::invalid_argument("Cannot write " + file_name + ", MoveTk is built without MOVETK_WITH_ZSTD");
+#endif
+	}
+	return std::make_unique<UncompressedOstream>(std::move(out));
+}
+}  // namespace movetk::io
+#endif  // MOVETK_IO_BLOCKCOMPRESSION_H
@@ -26,6 +26,8 @@
 
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -33,32 +35,118 @@
 
 namespace movetk::io {
 /**
- *
+ * @brief Dictionary of the distinct values of a categorical field, assigning indices 0, 1, 2, ...
+ * in order of first occurrence.
+ * @details Guarded by a reader-writer lock, so values can be added and looked up concurrently, for example by
+ * parallel probe readers sharing one dictionary. Indices are only deterministic when values are added from
+ * a single thread.
+ * @tparam T type of the values
+ */
+template <class T>
+class CategoryDictionary {
+public:
+	CategoryDictionary() = default;
+	CategoryDictionary(const CategoryDictionary &) = delete;
+	CategoryDictionary &operator=(const CategoryDictionary &) = delete;
+
+	/**
+	 * @brief Returns the index of a value, adding the value if it is new
+	 * @param t The value
+	 * @return The index
+	 */
+	std::size_t intern(T &&t) {
+		{
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+			const auto it = m_indexOf.find(t);
+			if (it != m_indexOf.end()) {
+				return it->second;
+			}
+		}
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+		// Another thread may have added the value in the meantime
+		const auto [it, inserted] = m_indexOf.try_emplace(t, m_values.size());
+		if (inserted) {
+			m_values.push_back(std::move(t));
+		}
+		return it->second;
+	}
+
+	/**
+	 * @brief Returns the value of an index
+	 * @return Copy of the value, since the dictionary may grow concurrently
+	 */
+	T value(std::size_t idx) const {
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		return m_values[idx];
+	}
+
+	/**
+	 * @brief Returns the number of distinct values
+	 */
+	std::size_t size() const {
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		return m_values.size();
+	}
+
+private:
+	mutable std::shared_mutex m_mutex;
+	std::vector<T> m_values;
+	std::unordered_map<T, std::size_t> m_indexOf;
+};
+
+/**
+ * @brief Field with a small set of distinct values, stored as the index of the value in a CategoryDictionary.
+ * @details A field refers to the dictionary it was constructed with, so each reader or column can own its
+ * dictionary and share it across threads. Fields that are default constructed, such as the fields parsed by
+ * the csv reader, refer to default_dictionary(), which is shared by all fields of the same CRTP type for the
+ * lifetime of the program. Fields only compare meaningfully with fields of the same dictionary.
  * @tparam T type of the field
  * @tparam CRTP When subclassed, CRTP parameter should be given the name of the subclass.
- *         (Using the "Curiously recurring template pattern" to enforce separate static variables for each subclass)
+ *         (Using the "Curiously recurring template pattern" to enforce a separate default dictionary for each subclass)
  */
 template <class T, class CRTP>
 struct CategoricalField {
-	std::size_t _idx;
-	static inline std::vector<T> _values = {};
-	static inline std::unordered_map<T, std::size_t> _indexOf = {};
+	using Dictionary = CategoryDictionary<T>;
+
+	std::size_t _idx = 0;
+	Dictionary *_dictionary = &default_dictionary();
+
+	CategoricalField() = default;
+
+	/**
+	 * @brief Construct a field that adds its values to @p dictionary
+	 */
+	explicit CategoricalField(Dictionary &dictionary) : _dictionary(&dictionary) {}
+
+	/**
+	 * @brief Construct a field with value @p t in @p dictionary
+	 */
+	CategoricalField(Dictionary &dictionary, T t) : _dictionary(&dictionary) { add(std::move(t)); }
+
+	/**
+	 * @brief Returns the dictionary used by default constructed fields of this CRTP type
+	 */
+	static Dictionary &default_dictionary() {
+		static Dictionary dictionary;
+		return dictionary;
+	}
 
 	inline std::size_t idx() const { return _idx; }
+
+	inline const Dictionary &dictionary() const { return *_dictionary; }
+
+	/**
+	 * @brief Returns the value of the field
+	 * @return Copy of the value, since the dictionary may grow concurrently
+	 */
+	T value() const { return _dictionary->value(_idx); }
+
 	double operator-(const CategoricalField<T, CRTP> &rhs) const { return _idx - rhs._idx; }
 	bool operator<(const CategoricalField<T, CRTP> &rhs) const { return _idx < rhs._idx; }
 	bool operator>(const CategoricalField<T, CRTP> &rhs) const { return rhs < *this; }
 	bool operator<=(const CategoricalField<T, CRTP> &rhs) const { return !(rhs < *this); }
 	bool operator>=(const CategoricalField<T, CRTP> &rhs) const { return !(*this < rhs); }
-	void add(T &&t) {
-		if (_indexOf.find(t) == _indexOf.end()) {
-			_indexOf[t] = _values.size();
-			_idx = _values.size();
-			_values.push_back(t);
-		} else {
-			_idx = _indexOf[t];
-		}
-	}
+	void add(T &&t) { _idx = _dictionary->intern(std::move(t)); }
 	friend std::istream &operator>>(std::istream &is, CategoricalField<T, CRTP> &field) {
 		T t;
 		is >> t;
@@ -67,7 +155,7 @@ struct CategoricalField {
 	}
 
 	friend std::ostream &operator<<(std::ostream &os, const CategoricalField<T, CRTP> &field) {
-		os << field._values[field._idx];
+		os << field.value();
 		return os;
 	}
 };
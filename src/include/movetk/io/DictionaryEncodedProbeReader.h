@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_IO_DICTIONARYENCODEDPROBEREADER_H
+#define MOVETK_IO_DICTIONARYENCODEDPROBEREADER_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "movetk/io/IdDictionary.h"
+
+namespace movetk::io {
+namespace detail {
+template <std::size_t Idx, class T, class Tuple, std::size_t... Is>
+auto replace_tuple_element(std::index_sequence<Is...>)
+    -> std::tuple<std::conditional_t<Is == Idx, T, std::tuple_element_t<Is, Tuple>>...>;
+}  // namespace detail
+
+/**
+ * @brief Probe tuple type with the field at index Idx replaced by T
+ */
+template <std::size_t Idx, class T, class Tuple>
+using replace_tuple_element_t = decltype(detail::replace_tuple_element<Idx, T, Tuple>(
+    std::make_index_sequence<std::tuple_size_v<Tuple>>()));
+
+/**
+ * @brief Probe reader that replaces the (string) id field of the probes by its EncodedId in an IdDictionary.
+ * @details The probes are converted lazily while iterating, so this adapts any probe range, for example
+ * the one of a ProbeReader. Sorting, grouping and splitting the converted probes then compares integers;
+ * SortedProbeReader groups them with a counting sort. The dictionary maps the codes back to the ids for output.
+ * Readers of different files can share one dictionary, and can run concurrently.
+ * @tparam ProbeInputIterator The input iterator for acquiring probes
+ * @tparam IdFieldIdx Index of the id field, convertible to std::string_view
+ */
+template <class ProbeInputIterator, int IdFieldIdx>
+class DictionaryEncodedProbeReader {
+public:
+	using InputProbePoint = typename std::iterator_traits<ProbeInputIterator>::value_type;
+	using ProbePoint = replace_tuple_element_t<IdFieldIdx, EncodedId, InputProbePoint>;
+	class iterator;
+
+	/**
+	 * @brief Construct the reader using a probe input range
+	 * @param start Start of the probe range
+	 * @param beyond End of the probe range
+	 * @param dictionary The dictionary to add the ids to. A new dictionary is created if null.
+	 */
+	DictionaryEncodedProbeReader(ProbeInputIterator start,
+	                             ProbeInputIterator beyond,
+	                             std::shared_ptr<IdDictionary> dictionary = nullptr)
+	    : m_start(start),
+	      m_beyond(beyond),
+	      m_dictionary(dictionary ? std::move(dictionary) : std::make_shared<IdDictionary>()) {}
+
+	/**
+	 * @brief Return the begin iterator of the converted probes
+	 * @return Begin iterator
+	 */
+	iterator begin() { return iterator(m_start, m_dictionary.get()); }
+
+	/**
+	 * @brief Return the end iterator of the converted probes
+	 * @return End iterator
+	 */
+	iterator end() { return iterator(m_beyond, m_dictionary.get()); }
+
+	/**
+	 * @brief Returns the dictionary of the ids
+	 */
+	const std::shared_ptr<IdDictionary> &dictionary() const { return m_dictionary; }
+
+	/**
+	 * @brief Converts a probe, interning its id
+	 * @param probe The probe
+	 * @param dictionary The dictionary
+	 * @return The converted probe
+	 */
+	static ProbePoint encode(const InputProbePoint &probe, IdDictionary &dictionary) {
+		return encode(probe, dictionary, std::make_index_sequence<std::tuple_size_v<InputProbePoint>>());
+	}
+
+private:
+	template <std::size_t... Is>
+	static ProbePoint encode(const InputProbePoint &probe, IdDictionary &dictionary, std::index_sequence<Is...>) {
+		auto field = [&](auto idx) -> decltype(auto) {
+			if constexpr (decltype(idx)::value == IdFieldIdx) {
+				return dictionary.intern(std::string_view(std::get<IdFieldIdx>(probe)));
+			} else {
+				return std::get<decltype(idx)::value>(probe);
+			}
+		};
+		return ProbePoint(field(std::integral_constant<std::size_t, Is>())...);
+	}
+
+	ProbeInputIterator m_start;
+	ProbeInputIterator m_beyond;
+	std::shared_ptr<IdDictionary> m_dictionary;
+};
+
+/**
+ * @brief Input iterator of the converted probes. A probe is converted once, on the first dereference.
+ */
+template <class ProbeInputIterator, int IdFieldIdx>
+class DictionaryEncodedProbeReader<ProbeInputIterator, IdFieldIdx>::iterator {
+public:
+	using iterator_category = std::input_iterator_tag;
+	using value_type = ProbePoint;
+	using difference_type = std::ptrdiff_t;
+	using pointer = ProbePoint *;
+	using reference = ProbePoint &;
+
+	iterator() = default;
+	iterator(ProbeInputIterator it, IdDictionary *dictionary) : m_it(it), m_dictionary(dictionary) {}
+
+	reference operator*() {
+		if (!m_converted) {
+			m_probe = encode(*m_it, *m_dictionary);
+			m_converted = true;
+		}
+		return m_probe;
+	}
+
+	pointer operator->() { return &**this; }
+
+	iterator &operator++() {
+		++m_it;
+		m_converted = false;
+		return *this;
+	}
+
+	iterator operator++(int) {
+		iterator copy = *this;
+		++(*this);
+		return copy;
+	}
+
+	bool operator==(const iterator &other) { return m_it == other.m_it; }
+	bool operator!=(const iterator &other) { return !(*this == other); }
+
+private:
+	ProbeInputIterator m_it;
+	IdDictionary *m_dictionary = nullptr;
+	ProbePoint m_probe;
+	bool m_converted = false;
+};
+}  // namespace movetk::io
+#endif  // MOVETK_IO_DICTIONARYENCODEDPROBEREADER_H
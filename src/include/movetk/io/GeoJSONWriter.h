@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_GEOJSONWRITER_H
+#define MOVETK_GEOJSONWRITER_H
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "movetk/utils/ThreadPool.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace movetk::io {
+/**
+ * @brief Layout of the output of GeoJSONFeatureCollectionWriter
+ */
+enum class GeoJSONLayout {
+	/** A single FeatureCollection object */
+	FeatureCollection,
+	/** One Feature object per line (GeoJSONSeq / newline delimited GeoJSON) */
+	LineDelimited
+};
+
+/**
+ * @brief Serializes GeoJSON features directly into a character buffer with a rapidjson::Writer,
+ * without building a rapidjson::Document. The output is identical to serializing the documents built by
+ * GeoJSONGeometry, GeoJSONProperties and GeoJSONFeature.
+ */
+class GeoJSONFeatureWriter {
+public:
+	using Buffer = rapidjson::StringBuffer;
+	using Writer = rapidjson::Writer<Buffer>;
+
+	/**
+	 * @brief Construct the writer
+	 * @param buffer The buffer the features are appended to
+	 * @param max_decimal_places Maximum number of decimal places of coordinates and numeric properties,
+	 * to which they are rounded
+	 */
+	explicit GeoJSONFeatureWriter(Buffer &buffer, int max_decimal_places = Writer::kDefaultMaxDecimalPlaces)
+	    : m_buffer(buffer),
+	      m_writer(buffer),
+	      m_scale(max_decimal_places < Writer::kDefaultMaxDecimalPlaces ? std::pow(10.0, max_decimal_places) : 0) {
+		m_writer.SetMaxDecimalPlaces(max_decimal_places);
+	}
+
+	/**
+	 * @brief Writes a feature with a Point geometry
+	 * @param lat Latitude
+	 * @param lon Longitude
+	 * @param first Iterator over (key, value) pairs of properties
+	 * @param beyond End of the properties
+	 */
+	template <class CoordType, class PropertyIterator>
+	void point(const CoordType &lat, const CoordType &lon, PropertyIterator first, PropertyIterator beyond) {
+		start_feature();
+		m_writer.Key("coordinates");
+		coordinates(lat, lon);
+		end_geometry("Point");
+		properties(first, beyond);
+		m_writer.EndObject();
+	}
+
+	/**
+	 * @brief Writes a feature with a LineString geometry
+	 * @param lat_first Iterator over the latitudes
+	 * @param lat_beyond End of the latitudes
+	 * @param lon_first Iterator over the longitudes
+	 * @param first Iterator over (key, value) pairs of properties
+	 * @param beyond End of the properties
+	 */
+	template <class LatIterator, class LonIterator, class PropertyIterator>
+	void line_string(LatIterator lat_first,
+	                 LatIterator lat_beyond,
+	                 LonIterator lon_first,
+	                 PropertyIterator first,
+	                 PropertyIterator beyond) {
+		start_feature();
+		m_writer.Key("coordinates");
+		m_writer.StartArray();
+		for (; lat_first != lat_beyond; ++lat_first, ++lon_first) {
+			coordinates(*lat_first, *lon_first);
+		}
+		m_writer.EndArray();
+		end_geometry("LineString");
+		properties(first, beyond);
+		m_writer.EndObject();
+	}
+
+	/**
+	 * @brief Writes a feature with a LineString geometry with timestamps,
+	 * as positions [lon, lat, 0, timestamp]
+	 * @param lat_first Iterator over the latitudes
+	 * @param lat_beyond End of the latitudes
+	 * @param lon_first Iterator over the longitudes
+	 * @param ts_first Iterator over the timestamps
+	 * @param first Iterator over (key, value) pairs of properties
+	 * @param beyond End of the properties
+	 */
+	template <class LatIterator, class LonIterator, class TSIterator, class PropertyIterator>
+	void line_string(LatIterator lat_first,
+	                 LatIterator lat_beyond,
+	                 LonIterator lon_first,
+	                 TSIterator ts_first,
+	                 PropertyIterator first,
+	                 PropertyIterator beyond) {
+		start_feature();
+		m_writer.Key("coordinates");
+		m_writer.StartArray();
+		for (; lat_first != lat_beyond; ++lat_first, ++lon_first, ++ts_first) {
+			m_writer.StartArray();
+			number(*lon_first);
+			number(*lat_first);
+			m_writer.Int(0);
+			number(*ts_first);
+			m_writer.EndArray();
+		}
+		m_writer.EndArray();
+		end_geometry("LineString");
+		properties(first, beyond);
+		m_writer.EndObject();
+	}
+
+	/**
+	 * @brief Returns the buffer the features are appended to
+	 */
+	Buffer &buffer() { return m_buffer; }
+
+private:
+	void start_feature() {
+		// A writer accepts a single root value
+		m_writer.Reset(m_buffer);
+		m_writer.StartObject();
+		m_writer.Key("type");
+		m_writer.String("Feature");
+		m_writer.Key("geometry");
+		m_writer.StartObject();
+	}
+
+	void end_geometry(std::string_view type) {
+		m_writer.Key("type");
+		m_writer.String(type.data(), static_cast<rapidjson::SizeType>(type.size()));
+		m_writer.EndObject();
+	}
+
+	template <class CoordType>
+	void coordinates(const CoordType &lat, const CoordType &lon) {
+		m_writer.StartArray();
+		number(lon);
+		number(lat);
+		m_writer.EndArray();
+	}
+
+	template <class T>
+	void number(const T &value) {
+		if constexpr (std::is_integral_v<T>) {
+			m_writer.Int64(static_cast<std::int64_t>(value));
+		} else {
+			m_writer.Double(rounded(static_cast<double>(value)));
+		}
+	}
+
+	// The writer truncates to the maximum number of decimal places, so the value is rounded first.
+	// Values too large to have digits beyond the decimal places are left as is.
+	double rounded(double value) const {
+		const double scaled = value * m_scale;
+		if (m_scale > 0 && std::abs(scaled) < MAX_EXACT_INTEGER) {
+			return std::round(scaled) / m_scale;
+		}
+		return value;
+	}
+
+	template <class PropertyIterator>
+	void properties(PropertyIterator first, PropertyIterator beyond) {
+		m_writer.Key("properties");
+		m_writer.StartObject();
+		for (; first != beyond; ++first) {
+			const auto &[key, value] = *first;
+			string(key);
+			using Value = std::decay_t<decltype(value)>;
+			if constexpr (std::is_arithmetic_v<Value>) {
+				number(value);
+			} else {
+				string(value);
+			}
+		}
+		m_writer.EndObject();
+	}
+
+	void string(std::string_view value) {
+		m_writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+	}
+
+	// Doubles beyond 2^53 are integers
+	static constexpr double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+	Buffer &m_buffer;
+	Writer m_writer;
+	// 10 to the power of the maximum number of decimal places, or 0 if values are not rounded
+	double m_scale;
+};
+
+/**
+ * @brief Streams a collection of GeoJSON features to an output stream, without building a document.
+ * @details Features are serialized by a callable taking an item and a GeoJSONFeatureWriter.
+ * Batches of items can be serialized in parallel: each thread serializes a contiguous range of the batch
+ * into its own buffer, and the buffers are written in order, so the output does not depend on the number of
+ * threads. The FeatureCollection is closed by close() or by the destructor.
+ */
+class GeoJSONFeatureCollectionWriter {
+public:
+	using Buffer = GeoJSONFeatureWriter::Buffer;
+
+	/**
+	 * @brief Construct the writer
+	 * @param out The output stream
+	 * @param max_decimal_places Maximum number of decimal places of coordinates and numeric properties
+	 * @param layout Whether to write a FeatureCollection or one feature per line
+	 */
+	explicit GeoJSONFeatureCollectionWriter(std::ostream &out,
+	                                        int max_decimal_places = GeoJSONFeatureWriter::Writer::kDefaultMaxDecimalPlaces,
+	                                        GeoJSONLayout layout = GeoJSONLayout::FeatureCollection)
+	    : m_out(out),
+	      m_max_decimal_places(max_decimal_places),
+	      m_layout(layout),
+	      m_buffers(1) {
+		if (m_layout == GeoJSONLayout::FeatureCollection) {
+			m_out << R"({"type":"FeatureCollection","features":[)";
+		}
+	}
+
+	GeoJSONFeatureCollectionWriter(const GeoJSONFeatureCollectionWriter &) = delete;
+	GeoJSONFeatureCollectionWriter &operator=(const GeoJSONFeatureCollectionWriter &) = delete;
+
+	~GeoJSONFeatureCollectionWriter() { close(); }
+
+	/**
+	 * @brief Writes a single feature
+	 * @param serialize Callable taking a GeoJSONFeatureWriter, writing exactly one feature
+	 */
+	template <class Serialize>
+	void write(Serialize &&serialize) {
+		if (m_closed) {
+			return;
+		}
+		auto &buffer = m_buffers.front();
+		GeoJSONFeatureWriter writer(buffer, m_max_decimal_places);
+		separate(buffer, m_num_features);
+		serialize(writer);
+		terminate(buffer);
+		++m_num_features;
+		if (buffer.GetSize() >= FLUSH_SIZE) {
+			flush_buffer(buffer);
+		}
+	}
+
+	/**
+	 * @brief Writes one feature per item of a range, in parallel if a thread pool is given
+	 * @param first Random access iterator to the first item
+	 * @param beyond End of the items
+	 * @param serialize Callable taking an item and a GeoJSONFeatureWriter, writing exactly one feature.
+	 * Called concurrently when a thread pool is given.
+	 * @param thread_pool Optional thread pool
+	 */
+	template <class RandomAccessIterator, class Serialize>
+	void write(RandomAccessIterator first,
+	           RandomAccessIterator beyond,
+	           Serialize &&serialize,
+	           utils::ThreadPool *thread_pool = nullptr) {
+		if (m_closed) {
+			return;
+		}
+		const auto num_items = static_cast<std::size_t>(std::distance(first, beyond));
+		const auto num_chunks = thread_pool == nullptr ? 1 : std::max<std::size_t>(1, std::min(thread_pool->size(), num_items));
+		if (m_buffers.size() < num_chunks) {
+			m_buffers.resize(num_chunks);
+		}
+		auto serialize_chunk = [&](std::size_t chunk) {
+			const auto chunk_first = num_items * chunk / num_chunks;
+			const auto chunk_beyond = num_items * (chunk + 1) / num_chunks;
+			auto &buffer = m_buffers[chunk];
+			GeoJSONFeatureWriter writer(buffer, m_max_decimal_places);
+			for (auto i = chunk_first; i < chunk_beyond; ++i) {
+				separate(buffer, m_num_features + i);
+				serialize(first[static_cast<std::ptrdiff_t>(i)], writer);
+				terminate(buffer);
+			}
+		};
+		if (num_chunks == 1) {
+			serialize_chunk(0);
+		} else {
+			thread_pool->parallel_for(0, num_chunks, serialize_chunk);
+		}
+		for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+			flush_buffer(m_buffers[chunk]);
+		}
+		m_num_features += num_items;
+	}
+
+	/**
+	 * @brief Writes the buffered features and closes the FeatureCollection. Further writes are ignored.
+	 */
+	void close() {
+		if (m_closed) {
+			return;
+		}
+		flush_buffer(m_buffers.front());
+		if (m_layout == GeoJSONLayout::FeatureCollection) {
+			m_out << "]}";
+		}
+		m_out.flush();
+		m_closed = true;
+	}
+
+	/**
+	 * @brief Returns the number of features written
+	 */
+	std::size_t size() const { return m_num_features; }
+
+private:
+	// Serial writes are collected until the buffer reaches this size
+	static constexpr std::size_t FLUSH_SIZE = 1 << 20;
+
+	void separate(Buffer &buffer, std::size_t feature) const {
+		if (m_layout == GeoJSONLayout::FeatureCollection && feature > 0) {
+			buffer.Put(',');
+		}
+	}
+
+	void terminate(Buffer &buffer) const {
+		if (m_layout == GeoJSONLayout::LineDelimited) {
+			buffer.Put('\n');
+		}
+	}
+
+	void flush_buffer(Buffer &buffer) {
+		if (!m_closed) {
+			m_out.write(buffer.GetString(), static_cast<std::streamsize>(buffer.GetSize()));
+		}
+		// Keeps the capacity for the next batch
+		buffer.Clear();
+	}
+
+	std::ostream &m_out;
+	int m_max_decimal_places;
+	GeoJSONLayout m_layout;
+	std::vector<Buffer> m_buffers;
+	std::size_t m_num_features = 0;
+	bool m_closed = false;
+};
+}  // namespace movetk::io
+#endif
@@ -40,14 +40,90 @@
 #include "movetk/io/SplitByDistanceThreshold.h"
 #include "movetk/io/TuplePrinter.h"
 namespace movetk::io {
-template <class TrajectoryInputIterator, int DateIdx, int LatIdx, int LonIdx>
+/**
+ * @brief View of a split of a trajectory: a range of consecutive points of the parent trajectory.
+ * Does not own or copy the points; materialize() copies them into a trajectory.
+ * @tparam Trajectory The trajectory type, storing its points as a list of tuples
+ */
+template <class Trajectory>
+class TrajectorySplit {
+public:
+	using trajectory_type = Trajectory;
+	using value_type = typename Trajectory::value_type;
+	using const_iterator = typename Trajectory::ValueList::const_iterator;
+
+	TrajectorySplit() = default;
+
+	/**
+	 * @brief Construct the view
+	 * @param parent The parent trajectory
+	 * @param range The indices of the points in the parent trajectory
+	 */
+	TrajectorySplit(const Trajectory& parent, IndexRange range) : _parent(&parent), _range(range) {}
+
+	const_iterator begin() const { return _parent->data().begin() + static_cast<std::ptrdiff_t>(_range.first); }
+
+	const_iterator end() const { return _parent->data().begin() + static_cast<std::ptrdiff_t>(_range.beyond); }
+
+	std::size_t size() const { return _range.size(); }
+
+	const value_type& operator[](std::size_t i) const { return _parent->data()[_range.first + i]; }
+
+	/**
+	 * @brief Returns the parent trajectory
+	 */
+	const Trajectory& parent() const { return *_parent; }
+
+	/**
+	 * @brief Returns the indices of the points in the parent trajectory
+	 */
+	IndexRange range() const { return _range; }
+
+	/**
+	 * @brief Copies the points into a new trajectory
+	 * @return The trajectory
+	 */
+	Trajectory materialize() const { return Trajectory(typename Trajectory::ValueList(begin(), end())); }
+
+private:
+	const Trajectory* _parent = nullptr;
+	IndexRange _range;
+};
+
+/**
+ * @brief Splits trajectories where consecutive points are too far apart in time or in (geodesic) distance,
+ * keeping the splits with at least a minimum number of points.
+ * @details Every input trajectory is split into index ranges of its points, without copying them.
+ * By default, the splits are then materialized one at a time into new trajectories. With MaterializeSplits
+ * set to false, the splits are emitted as TrajectorySplit views into the input trajectory instead,
+ * which are valid until the iterator advances past the last split of that trajectory.
+ * @tparam TrajectoryInputIterator Input iterator over the trajectories
+ * @tparam DateIdx Index of the timestamp field
+ * @tparam LatIdx Index of the latitude field
+ * @tparam LonIdx Index of the longitude field
+ * @tparam MaterializeSplits Whether to emit trajectories or views
+ */
+template <class TrajectoryInputIterator, int DateIdx, int LatIdx, int LonIdx, bool MaterializeSplits = true>
 class HighFrequencyTrajectorySplitter {
 public:
 	using trajectory_type =
 	    typename std::iterator_traits<TrajectoryInputIterator>::value_type;  // TabularTrajectory<fields...>
 	using ProbePoint = typename trajectory_type::value_type;                 // tuple<fields...>
+	using split_type = std::conditional_t<MaterializeSplits, trajectory_type, TrajectorySplit<trajectory_type>>;
 	class iterator;
-	class SplitByTimeDiffOrDistance;
+
+	/**
+	 * @brief Geodesic distance between two (lat, lon) pairs
+	 */
+	struct ExactDistance {
+		double operator()(float lat0, float lon0, float lat1, float lon1) const {
+			return geo::distance_exact(lat0, lon0, lat1, lon1);
+		}
+	};
+
+	using SplitByTimeDiff = SplitByDifferenceThreshold<DateIdx, ProbePoint>;
+	using SplitByDistance = SplitByDistanceThreshold<LatIdx, LonIdx, ProbePoint, ExactDistance>;
+	using SplitByTimeDiffOrDistance = SplitAny<SplitByTimeDiff, SplitByDistance>;
 
 	HighFrequencyTrajectorySplitter(TrajectoryInputIterator start,
 	                                TrajectoryInputIterator beyond,
@@ -56,90 +132,90 @@ public:
 	                                std::size_t min_points = 2)
 	    : _traj_it(start)
 	    , _traj_it_end(beyond)
-	    , _time_diff_threshold_s(time_diff_threshold_s)
-	    , _distance_threshold_m(distance_threshold_m)
-	    , _min_points(min_points) {}
+	    , _split(SplitByTimeDiff(time_diff_threshold_s), SplitByDistance(distance_threshold_m))
+	    , _min_points(min_points) {
+		_range_it = std::end(_ranges);
+	}
 
 	/// Status of the underlying stream
 	/// @{
 	inline bool good() {
 		// good if there are still trajectories to process or current trajectory has not been fully consumed
-		return _traj_it != _traj_it_end || (_split_it != std::end(_splits));
+		return _traj_it != _traj_it_end || (_range_it != std::end(_ranges));
 	}
 
 	iterator begin() { return iterator(*this); }
 
 	iterator end() { return iterator(); }
 
+	/**
+	 * @brief Splits a trajectory into index ranges of its points, without copying them
+	 * @param trajectory The trajectory
+	 * @return The ranges of the splits with at least the minimum number of points
+	 */
+	std::vector<IndexRange> split(const trajectory_type& trajectory) const {
+		std::vector<IndexRange> ranges;
+		split_into(trajectory, ranges);
+		return ranges;
+	}
+
 private:
 	TrajectoryInputIterator _traj_it;
 	TrajectoryInputIterator _traj_it_end;
-	double _time_diff_threshold_s;
-	double _distance_threshold_m;
+	SplitByTimeDiffOrDistance _split;
 	std::size_t _min_points;  // min number of points required for a split to qualify as a trajectory
 
-	// iteration state
-	std::vector<trajectory_type> _splits;
-	typename std::vector<trajectory_type>::iterator _split_it;
-
-	inline std::optional<trajectory_type> read_trajectory() {
-		if (_traj_it != _traj_it_end && _split_it == std::end(_splits)) {
-			_splits.clear();  // reset for next use
-
-			while (_splits.size() == 0 && _traj_it != _traj_it_end) {
-				// std::cout << "Splitting... " << std::get<0>(_traj_it->data()[0]) << '\n';
-
-				// move to the next trajectory, split it and return the first split segment
-				using SplitByTimeDiff = SplitByDifferenceThreshold<DateIdx, ProbePoint>;
-				SplitByTimeDiff split_by_time_diff(_time_diff_threshold_s);
-				using SplitByDistance = SplitByDistanceThreshold<LatIdx, LonIdx, ProbePoint>;
-				std::function<double(float, float, float, float)> distancefn = geo::distance_exact;
-				SplitByDistance split_by_dist(_distance_threshold_m, distancefn);
-				auto split_by_time_diff_or_distance = [&](const ProbePoint& p) {
-					bool t = split_by_time_diff(p);
-					bool d = split_by_dist(p);
-					return (t || d);
-				};
-
-				using ProbeInputIterator = decltype(_traj_it->begin());
-				Splitter<decltype(split_by_time_diff_or_distance), ProbeInputIterator> hifreq_splitter(
-				    _traj_it->begin(),
-				    _traj_it->end(),
-				    split_by_time_diff_or_distance);
-
-
-				for (auto& segment : hifreq_splitter) {
-					if (segment.size() >= _min_points)
-						_splits.emplace_back(trajectory_type{segment});
-				}
-				// std::cout << "Got " << _splits.size() << " splits\n";
-				_split_it = std::begin(_splits);
+	// iteration state: the splits of the trajectory at _traj_it, which is advanced once they are consumed
+	bool _split_current = false;
+	std::vector<IndexRange> _ranges;
+	typename std::vector<IndexRange>::iterator _range_it;
+
+	void split_into(const trajectory_type& trajectory, std::vector<IndexRange>& ranges) const {
+		split_ranges(std::begin(trajectory.data()),
+		             std::end(trajectory.data()),
+		             _split,
+		             std::back_inserter(ranges),
+		             _min_points);
+	}
+
+	inline std::optional<split_type> read_trajectory() {
+		while (_range_it == std::end(_ranges)) {
+			if (_split_current) {
 				++_traj_it;
+				_split_current = false;
+			}
+			if (_traj_it == _traj_it_end) {
+				return std::nullopt;
 			}
+			_ranges.clear();
+			split_into(*_traj_it, _ranges);
+			_range_it = std::begin(_ranges);
+			_split_current = true;
 		}
 
-		if (_split_it != std::end(_splits)) {
-			trajectory_type t = *_split_it;
-			++_split_it;
-			return t;
-		} else
-			return std::nullopt;
+		TrajectorySplit<trajectory_type> split(*_traj_it, *_range_it);
+		++_range_it;
+		if constexpr (MaterializeSplits) {
+			return split.materialize();
+		} else {
+			return split;
+		}
 	}
 };
 
 /// Iterator; just calls iteratively @ref HighFrequencyTrajectorySplitter::read_trajectory and stores the result.
-template <class TrajectoryInputIterator, int DateIdx, int LatIdx, int LonIdx>
-class HighFrequencyTrajectorySplitter<TrajectoryInputIterator, DateIdx, LatIdx, LonIdx>::iterator {
+template <class TrajectoryInputIterator, int DateIdx, int LatIdx, int LonIdx, bool MaterializeSplits>
+class HighFrequencyTrajectorySplitter<TrajectoryInputIterator, DateIdx, LatIdx, LonIdx, MaterializeSplits>::iterator {
 private:
-	HighFrequencyTrajectorySplitter::trajectory_type _trajectory;
+	HighFrequencyTrajectorySplitter::split_type _trajectory;
 	HighFrequencyTrajectorySplitter* _parent;
 
 public:
 	typedef std::input_iterator_tag iterator_category;
-	typedef HighFrequencyTrajectorySplitter::trajectory_type value_type;
+	typedef HighFrequencyTrajectorySplitter::split_type value_type;
 	typedef std::size_t difference_type;
-	typedef HighFrequencyTrajectorySplitter::trajectory_type* pointer;
-	typedef HighFrequencyTrajectorySplitter::trajectory_type& reference;
+	typedef HighFrequencyTrajectorySplitter::split_type* pointer;
+	typedef HighFrequencyTrajectorySplitter::split_type& reference;
 
 	/// Construct an empty/end iterator
 	inline iterator() : _parent(nullptr) {}
@@ -153,7 +229,7 @@ public:
 			if (!optional_trajectory) {
 				_parent = nullptr;
 			} else {
-				_trajectory = *optional_trajectory;
+				_trajectory = std::move(*optional_trajectory);
 			}
 		}
 		return *this;
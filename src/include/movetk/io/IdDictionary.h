@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_IO_IDDICTIONARY_H
+#define MOVETK_IO_IDDICTIONARY_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace movetk::io {
+/**
+ * @brief Object id encoded as its dense integer code in an IdDictionary.
+ * Compares, sorts and hashes as an integer, and prints as the code.
+ */
+struct EncodedId {
+	using Code = std::uint32_t;
+	Code code = 0;
+
+	friend auto operator<=>(const EncodedId &, const EncodedId &) = default;
+
+	friend std::ostream &operator<<(std::ostream &os, const EncodedId &id) { return os << id.code; }
+};
+
+/**
+ * @brief Dictionary interning object ids (strings) into dense codes 0, 1, 2, ... in order of first occurrence.
+ * @details The strings are stored once, in blocks that never move, and are looked up by std::string_view,
+ * so looking up a known id does not allocate. The hash table is split into shards with their own reader-writer
+ * locks, so readers of different files can intern into the same dictionary concurrently, mostly taking shared
+ * locks since ids repeat. Codes are only deterministic when ids are interned from a single thread.
+ */
+class IdDictionary {
+public:
+	using Code = EncodedId::Code;
+
+	IdDictionary() = default;
+	IdDictionary(const IdDictionary &) = delete;
+	IdDictionary &operator=(const IdDictionary &) = delete;
+
+	/**
+	 * @brief Returns the code of an id, adding the id if it is new
+	 * @param id The id
+	 * @return The code
+	 */
+	EncodedId intern(std::string_view id) {
+		auto &shard = shard_of(id);
+		{
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			const auto it = shard.codes.find(id);
+			if (it != shard.codes.end()) {
+				return {it->second};
+			}
+		}
+		std::unique_lock<std::shared_mutex> lock(shard.mutex);
+		// Another thread may have added the id in the meantime
+		const auto it = shard.codes.find(id);
+		if (it != shard.codes.end()) {
+			return {it->second};
+		}
+		const auto [code, stored] = store(id);
+		shard.codes.emplace(stored, code);
+		return {code};
+	}
+
+	/**
+	 * @brief Returns the code of an id, if present
+	 * @param id The id
+	 */
+	std::optional<EncodedId> find(std::string_view id) const {
+		const auto &shard = shard_of(id);
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+		const auto it = shard.codes.find(id);
+		if (it == shard.codes.end()) {
+			return std::nullopt;
+		}
+		return EncodedId{it->second};
+	}
+
+	/**
+	 * @brief Returns the id of a code
+	 * @param id The code
+	 * @return View of the id, valid for the lifetime of the dictionary
+	 */
+	std::string_view value(EncodedId id) const {
+		std::shared_lock<std::shared_mutex> lock(m_values_mutex);
+		return m_values.at(id.code);
+	}
+
+	/**
+	 * @brief Returns the number of distinct ids
+	 */
+	std::size_t size() const {
+		std::shared_lock<std::shared_mutex> lock(m_values_mutex);
+		return m_values.size();
+	}
+
+private:
+	static constexpr std::size_t NUM_SHARDS = 64;
+	static constexpr std::size_t BLOCK_SIZE = 1 << 16;
+
+	struct Shard {
+		mutable std::shared_mutex mutex;
+		std::unordered_map<std::string_view, Code> codes;
+	};
+
+	Shard &shard_of(std::string_view id) { return m_shards[shard_index(id)]; }
+
+	const Shard &shard_of(std::string_view id) const { return m_shards[shard_index(id)]; }
+
+	static std::size_t shard_index(std::string_view id) {
+		// High bits, the table within the shard uses the low bits
+		return (std::hash<std::string_view>{}(id) >> 20) % NUM_SHARDS;
+	}
+
+	// Copies the id into the blocks and assigns the next code
+	std::pair<Code, std::string_view> store(std::string_view id) {
+		std::unique_lock<std::shared_mutex> lock(m_values_mutex);
+		if (m_values.size() > std::numeric_limits<Code>::max()) {
+			throw std::overflow_error("Too many distinct ids for EncodedId::Code");
+		}
+		if (m_blocks.empty() || m_blocks.back().size() + id.size() > m_blocks.back().capacity()) {
+			// Blocks are not reallocated, so views into them stay valid
+			m_blocks.emplace_back().reserve(std::max(BLOCK_SIZE, id.size()));
+		}
+		auto &block = m_blocks.back();
+		const auto offset = block.size();
+		block.append(id);
+		const std::string_view stored(block.data() + offset, id.size());
+		m_values.push_back(stored);
+		return {static_cast<Code>(m_values.size() - 1), stored};
+	}
+
+	std::array<Shard, NUM_SHARDS> m_shards;
+	mutable std::shared_mutex m_values_mutex;
+	std::deque<std::string> m_blocks;
+	std::vector<std::string_view> m_values;
+};
+}  // namespace movetk::io
+
+template <>
+struct std::hash<movetk::io::EncodedId> {
+	std::size_t operator()(const movetk::io::EncodedId &id) const noexcept { return id.code; }
+};
+#endif  // MOVETK_IO_IDDICTIONARY_H
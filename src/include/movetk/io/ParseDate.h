@@ -28,21 +28,36 @@
 #ifndef MOVETK_PARSEDATE_H
 #define MOVETK_PARSEDATE_H
 
+#include <array>
+#include <cctype>
+#include <cstdint>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <string_view>
+
+#include "movetk/io/TimestampParser.h"
+#include "movetk/utils/Instrumentation.h"
 
 namespace movetk::io {
+/**
+ * @brief Timestamp field, read and written in a strftime-style format as UTC.
+ * @details Dates in the layouts of TimestampLayout are read by a TimestampParser; other formats are read with
+ * std::get_time. Both convert the civil time to seconds since the epoch arithmetically, without time zone lookups.
+ * A timestamp that does not match the format sets the failbit of the stream.
+ */
 class ParseDate {
 protected:
 	std::time_t _ts;
 	std::string _date_format;
+	TimestampLayout _layout = TimestampLayout::Other;
 
 public:
 	explicit ParseDate(std::time_t ts = 0, std::string date_format = "%Y-%m-%d")
 	    : _ts(ts)
-	    , _date_format(std::move(date_format)) {}
+	    , _date_format(std::move(date_format))
+	    , _layout(timestamp_layout(_date_format)) {}
 
 	/**
 	 * @brief (Implicitly) Construct a ParseData from a timestamp
@@ -76,21 +91,28 @@ public:
 	}
 
 	friend std::istream &operator>>(std::istream &is, ParseDate &date) {
-		if (!date._date_format.empty()) {
-			std::tm _tm = {};
-			is >> std::get_time(&_tm, date._date_format.c_str());
-			if (is.fail()) {
-				std::cout << "Parse date failed\n";
-				return is;
-			}
-			date.ts(std::mktime(&_tm));
+		MOVETK_SCOPED_TIMER(DateParse);
+		if (date._date_format.empty()) {
+			return is;
+		}
+		if (date._layout != TimestampLayout::Other) {
+			return read_fixed_layout(is, date);
+		}
+		std::tm _tm = {};
+		is >> std::get_time(&_tm, date._date_format.c_str());
+		if (!is.fail()) {
+			const auto days = days_from_civil(_tm.tm_year + 1900, static_cast<unsigned>(_tm.tm_mon) + 1, 1) + _tm.tm_mday - 1;
+			date.ts(static_cast<std::time_t>(days * 86400 + _tm.tm_hour * 3600 + _tm.tm_min * 60 + _tm.tm_sec));
 		}
-
 		return is;
 	}
 
 	friend std::ostream &operator<<(std::ostream &os, const ParseDate &date) {
-		if (!date._date_format.empty()) {
+		if (date._layout == TimestampLayout::EpochSeconds) {
+			os << date._ts;
+		} else if (date._layout == TimestampLayout::EpochMilliseconds) {
+			os << static_cast<std::int64_t>(date._ts) * 1000;
+		} else if (!date._date_format.empty()) {
 			auto ts = date.ts();
 			os << std::put_time(std::gmtime(&ts), date._date_format.c_str());  // "%c"
 		} else {
@@ -98,6 +120,47 @@ public:
 		}
 		return os;
 	}
+
+private:
+	// Reads the timestamp into a local buffer and parses it with the parser of the layout
+	static std::istream &read_fixed_layout(std::istream &is, ParseDate &date) {
+		// The date cache makes the parsers stateful
+		thread_local std::array<TimestampParser, 4> parsers = {TimestampParser(TimestampLayout::Date),
+		                                                       TimestampParser(TimestampLayout::DateTime),
+		                                                       TimestampParser(TimestampLayout::EpochSeconds),
+		                                                       TimestampParser(TimestampLayout::EpochMilliseconds)};
+		std::istream::sentry sentry(is);
+		if (!sentry) {
+			return is;
+		}
+		std::array<char, 64> buffer;
+		std::size_t size = 0;
+		auto *buf = is.rdbuf();
+		for (auto c = buf->sgetc();; c = buf->snextc()) {
+			if (std::char_traits<char>::eq_int_type(c, std::char_traits<char>::eof())) {
+				is.setstate(std::ios_base::eofbit);
+				break;
+			}
+			const auto ch = std::char_traits<char>::to_char_type(c);
+			// The date and time may be separated by a space
+			const bool separator = ch == ' ' && size == 10 && date._layout == TimestampLayout::DateTime;
+			if (std::isspace(static_cast<unsigned char>(ch)) && !separator) {
+				break;
+			}
+			if (size == buffer.size()) {
+				is.setstate(std::ios_base::failbit);
+				return is;
+			}
+			buffer[size++] = ch;
+		}
+		const auto ts = parsers[static_cast<std::size_t>(date._layout)].parse(std::string_view(buffer.data(), size));
+		if (!ts) {
+			is.setstate(std::ios_base::failbit);
+			return is;
+		}
+		date.ts(*ts);
+		return is;
+	}
 };
 }  // namespace movetk::io
 #endif  // MOVETK_PARSEDATE_H
@@ -35,6 +35,7 @@
 #include <string_view>
 #include <utility>  // for move
 
+#include "movetk/io/BlockCompression.h"
 #include "movetk/io/csv/csv.h"
 #include "movetk/utils/text.h"  // for ends_with
 
@@ -109,18 +110,36 @@ class ProbeReaderFactory {
 public:
 	static constexpr std::string_view CSV_EXT = ".csv";
 	static constexpr std::string_view GZ_EXT = ".gz";
+	static constexpr std::string_view BGZF_EXT = ".bgz";
+	static constexpr std::string_view ZSTD_EXT = ".zst";
+
+	/**
+	 * @brief Creates a reader for a csv file, which may be compressed.
+	 * Files ending in .csv are read as is. The compression of other files (.gz, .bgz, .zst) is detected from their
+	 * magic bytes: BGZF and zstd files are decompressed in parallel, gzip files on a background thread.
+	 * @param file_name The file
+	 * @param num_threads Number of threads decompressing BGZF and zstd files
+	 */
 	template <class ProbeTraits>
-	static std::unique_ptr<movetk::io::ProbeReader<ProbeTraits>> create(const std::string& file_name) {
-		// TODO: check if file exists
+	static std::unique_ptr<movetk::io::ProbeReader<ProbeTraits>> create(
+	    const std::string& file_name,
+	    std::size_t num_threads = std::thread::hardware_concurrency()) {
 		if (file_name.ends_with(CSV_EXT)) {
 			auto fin = std::make_unique<std::ifstream>(file_name);
+			if (!*fin) {
+				throw std::invalid_argument("Cannot open " + file_name);
+			}
 			return std::make_unique<CsvProbeReader<ProbeTraits>>(std::move(fin));
-		} else if (file_name.ends_with(GZ_EXT)) {
-			auto fin = std::make_unique<std::ifstream>(file_name, std::ios_base::in | std::ios_base::binary);
-			return std::make_unique<ZippedProbeReader<ProbeTraits>>(std::move(fin));
-		} else {
+		}
+		auto fin = std::make_unique<std::ifstream>(file_name, std::ios_base::in | std::ios_base::binary);
+		if (!*fin) {
+			throw std::invalid_argument("Cannot open " + file_name);
+		}
+		const auto compression = detect_compression(*fin);
+		if (compression == Compression::None) {
 			throw std::invalid_argument("Unsupported probe file extension!");
 		}
+		return std::make_unique<CsvProbeReader<ProbeTraits>>(decompress(std::move(fin), compression, num_threads));
 	}
 
 	template <class ProbeTraits>
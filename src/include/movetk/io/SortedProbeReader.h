@@ -25,15 +25,21 @@
 #define MOVETK_SORTEDPROBEREADER_H
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "SortByField.h"
+#include "movetk/io/IdDictionary.h"
 
 namespace movetk::io {
 /**
  * @brief Probe reader that sorts the probes according to a field
+ * @details Probes with an EncodedId sort field are grouped by a stable counting sort on the dense codes,
+ * in time linear in the number of probes, instead of a comparison sort.
  * @tparam ProbeInputIterator The input iterator for acquiring probes
  */
 template <class ProbeInputIterator, int SortByFieldIdx>
@@ -55,6 +61,11 @@ public:
 			++probe_count;
 		}
 
+		if constexpr (std::is_same_v<std::decay_t<std::tuple_element_t<SortByFieldIdx, ProbePoint>>, EncodedId>) {
+			counting_sort();
+			return;
+		}
+
 		// Sort all probe points by SortByFieldIdx
 		SortByField<SortByFieldIdx, ProbePoint> sort_by_field_id_asc;
 #ifdef _GLIBCXX_PARALLEL
@@ -79,6 +90,26 @@ public:
 	iterator end() { return std::end(buffered_probe); }
 
 private:
+	// Single pass of a radix sort, with one digit per distinct code
+	void counting_sort() {
+		EncodedId::Code max_code = 0;
+		for (const auto &probe : buffered_probe) {
+			max_code = std::max(max_code, std::get<SortByFieldIdx>(probe).code);
+		}
+		std::vector<std::size_t> offsets(static_cast<std::size_t>(max_code) + 2, 0);
+		for (const auto &probe : buffered_probe) {
+			++offsets[std::get<SortByFieldIdx>(probe).code + 1];
+		}
+		for (std::size_t i = 1; i < offsets.size(); ++i) {
+			offsets[i] += offsets[i - 1];
+		}
+		std::vector<ProbePoint> sorted(buffered_probe.size());
+		for (auto &probe : buffered_probe) {
+			sorted[offsets[std::get<SortByFieldIdx>(probe).code]++] = std::move(probe);
+		}
+		buffered_probe = std::move(sorted);
+	}
+
 	std::vector<ProbePoint> buffered_probe;
 };
 
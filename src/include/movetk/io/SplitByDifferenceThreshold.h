@@ -33,6 +33,8 @@ namespace movetk::io {
 /**
  * @brief Predicate to signal when to split a range of probes into separate trajectories,
  * based on a threshold for the difference of the field of consecutive probes
+ * @details Comparing two given probes with the binary operator() is reentrant. The unary operator() tracks
+ * the previous probe itself and is meant for one probe stream at a time.
  * @tparam FieldIndex Index of the field in the probe tuple
  * @tparam ProbePoint The probe point types
 */
@@ -43,6 +45,16 @@ public:
 
 	explicit SplitByDifferenceThreshold(float threshold) : _threshold(threshold) {}
 
+	/**
+	 * @brief Determine whether to split between two consecutive probes
+	 * @param previous The previous probe point
+	 * @param current The current probe point
+	 * @return Whether or not to split.
+	 */
+	bool operator()(const ProbePoint& previous, const ProbePoint& current) const {
+		return std::abs(std::get<FieldIndex>(current) - std::get<FieldIndex>(previous)) > _threshold;
+	}
+
 	/**
 	 * @brief Determine whether to split between the previous and current probe pont
 	 * @param p The current probe point
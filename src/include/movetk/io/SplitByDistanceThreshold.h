@@ -25,21 +25,61 @@
 #define MOVETK_SPLITBYDISTANCEFFERENCETHRESHOLD_H
 
 #include <cmath>
+#include <concepts>
 #include <functional>
 #include <optional>
 #include <string>
 #include <tuple>
 
+#include "movetk/utils/Requirements.h"
+
 namespace movetk::io {
-template <int LatFieldIndex, int LonFieldIndex, class ProbePoint>
+/**
+ * @brief Predicate to signal when to split a range of probes into separate trajectories,
+ * based on a threshold for the distance between consecutive probes
+ * @details The binary operator() may be called concurrently if the distance function allows it;
+ * the unary one keeps the coordinates of the last probe it saw.
+ * @tparam LatFieldIndex Index of the latitude in the probe tuple
+ * @tparam LonFieldIndex Index of the longitude in the probe tuple
+ * @tparam ProbePoint The probe point types
+ * @tparam DistanceFunction Callable taking two (lat, lon) pairs as floats. A function object type avoids
+ * the indirection of std::function.
+ */
+template <int LatFieldIndex,
+          int LonFieldIndex,
+          class ProbePoint,
+          class DistanceFunction = std::function<double(float, float, float, float)>>
 class SplitByDistanceThreshold {
 public:
 	using field_type = typename std::tuple_element<LatFieldIndex, ProbePoint>::type;
 
-	explicit SplitByDistanceThreshold(float threshold, std::function<double(float, float, float, float)> distance)
+	explicit SplitByDistanceThreshold(float threshold, DistanceFunction distance)
 	    : _threshold(threshold)
 	    , _distance(std::move(distance)) {}
 
+	/**
+	 * @brief Construct the predicate with a default constructed distance function object.
+	 * Not available for std::function, which would be empty and throw std::bad_function_call.
+	 * @param threshold The distance threshold
+	 */
+	explicit SplitByDistanceThreshold(float threshold) requires(
+	    std::default_initializable<DistanceFunction> &&
+	    !utils::is_specialization_of<DistanceFunction, std::function>::value)
+	    : _threshold(threshold) {}
+
+	/**
+	 * @brief Determine whether to split between two consecutive probes
+	 * @param previous The previous probe point
+	 * @param current The current probe point
+	 * @return Whether or not to split.
+	 */
+	bool operator()(const ProbePoint& previous, const ProbePoint& current) const {
+		return _distance(std::get<LatFieldIndex>(current),
+		                 std::get<LonFieldIndex>(current),
+		                 std::get<LatFieldIndex>(previous),
+		                 std::get<LonFieldIndex>(previous)) > _threshold;
+	}
+
 	bool operator()(const ProbePoint& p) {
 		//        if (!prev_coord) {
 		//            prev_coord = std::make_tuple(std::get<LatFieldIndex>(p), std::get<LonFieldIndex>(p));
@@ -66,7 +106,7 @@ private:
 	std::optional<field_type> prev_lat_value;
 	std::optional<field_type> prev_lon_value;
 	float _threshold;
-	std::function<double(float, float, float, float)> _distance;
+	DistanceFunction _distance;
 };
 }  // namespace movetk::io
 #endif  // MOVETK_SPLITBYDISTANCEFFERENCETHRESHOLD_H
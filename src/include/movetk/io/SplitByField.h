@@ -31,6 +31,8 @@
 namespace movetk::io {
 /**
  * @brief Predicate object for splitting by a field value
+ * @details The unary operator() remembers the field value of the previous probe, so an instance serves a single
+ * stream of probes. The binary operator() is const and keeps no state, so an instance can be shared between threads.
  * @tparam FieldIndex Index of the field value
  * @tparam ProbePoint The probe point type
  */
@@ -39,6 +41,16 @@ class SplitByField {
 public:
 	using field_type = typename std::tuple_element<FieldIndex, ProbePoint>::type;
 
+	/**
+	 * @brief Determine whether a new trajectory starts between two consecutive probes
+	 * @param previous The previous probe point
+	 * @param current The current probe point
+	 * @return Whether or not to split.
+	 */
+	bool operator()(const ProbePoint& previous, const ProbePoint& current) const {
+		return !(std::get<FieldIndex>(current) == std::get<FieldIndex>(previous));
+	}
+
 	bool operator()(const ProbePoint& p) {
 		if (!prev_field_value) {
 			prev_field_value = std::get<FieldIndex>(p);
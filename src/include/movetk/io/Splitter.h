@@ -24,12 +24,15 @@
 #ifndef MOVETK_SPLITTER_H
 #define MOVETK_SPLITTER_H
 
+#include <cstddef>
 #include <iostream>
 #include <iterator>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "movetk/io/TuplePrinter.h"
+#include "movetk/utils/Instrumentation.h"
 
 namespace movetk::io {
 /**
@@ -97,18 +100,30 @@ private:
 	ProbePoint _carry;
 	bool _exists_carry;
 
+	/**
+	 * @brief Stores a probe at the given position of a segment, assigning to an existing element if possible,
+	 * so the storage of recycled segments (including that of string fields) is reused
+	 */
+	static void store(value_type &segment, std::size_t &size, const ProbePoint &probe) {
+		if (size < segment.size()) {
+			segment[size] = probe;
+		} else {
+			segment.push_back(probe);
+		}
+		++size;
+	}
+
 	/**
 	 * @brief Read a single (sub)trajectory from the probes
-	 * @return The trajectory.
+	 * @param _segment Output of the trajectory. Its storage is reused.
 	*/
-	inline value_type read_segment() {
+	inline void read_segment(value_type &_segment) {
 		bool segment_done = false;
-		value_type _segment;
+		std::size_t size = 0;
 		State next_state = State::Uninitialized;
 
 		if (_state == State::Start_of_Segment && _exists_carry) {
-			_segment.clear();
-			_segment.push_back(_carry);
+			store(_segment, size, _carry);
 			_exists_carry = false;
 		}
 
@@ -118,10 +133,10 @@ private:
 			switch (_state) {
 				case State::Uninitialized:
 					if (_predicate(input)) {
-						_segment.push_back(input);
+						store(_segment, size, input);
 						next_state = State::Start_of_Segment;
 					} else {
-						_segment.clear();
+						size = 0;
 						next_state = State::Uninitialized;
 					}
 					break;
@@ -132,7 +147,7 @@ private:
 						_exists_carry = true;
 						next_state = State::Start_of_Segment;
 					} else {
-						_segment.push_back(input);
+						store(_segment, size, input);
 						next_state = State::In_Segment;
 					}
 					break;
@@ -143,7 +158,7 @@ private:
 						_exists_carry = true;
 						next_state = State::Start_of_Segment;
 					} else {
-						_segment.push_back(input);
+						store(_segment, size, input);
 						next_state = State::In_Segment;
 					}
 					break;
@@ -152,7 +167,10 @@ private:
 			_start++;
 		}
 
-		return _segment;
+		_segment.erase(_segment.begin() + static_cast<std::ptrdiff_t>(size), _segment.end());
+		if (!_segment.empty()) {
+			MOVETK_COUNT(SplitterSegmentsEmitted);
+		}
 	}
 };
 
@@ -179,7 +197,7 @@ public:
 	/// Read one segment, if possible. Set to end if parent is not good anymore.
 	inline iterator &operator++() {
 		if (_parent != nullptr) {
-			_segment = _parent->read_segment();
+			_parent->read_segment(_segment);
 			if (_segment.empty()) {  // if (!_parent->good()) {
 				_parent = nullptr;
 			}
@@ -195,6 +213,12 @@ public:
 
 	inline Splitter::value_type const &operator*() const { return _segment; }
 
+	/**
+	 * @brief Returns the segment. It may be moved from or swapped with another segment, whose storage is then
+	 * reused for the next segment.
+	 */
+	inline Splitter::value_type &operator*() { return _segment; }
+
 	inline Splitter::value_type const *operator->() const { return &_segment; }
 
 	bool operator==(iterator const &other) {
@@ -202,5 +226,71 @@ public:
 	}
 	bool operator!=(iterator const &other) { return !(*this == other); }
 };
+
+/**
+ * @brief Half-open range [first, beyond) of indices of consecutive probes
+ */
+struct IndexRange {
+	std::size_t first = 0;
+	std::size_t beyond = 0;
+
+	std::size_t size() const { return beyond - first; }
+
+	bool operator==(const IndexRange &other) const = default;
+};
+
+/**
+ * @brief Pairwise split predicate that splits between two consecutive probes when any of the given
+ * pairwise predicates does. The predicates are composed at compile time, and evaluated in order until one splits.
+ * @tparam Predicates Types of the pairwise predicates
+ */
+template <class... Predicates>
+class SplitAny {
+public:
+	explicit SplitAny(Predicates... predicates) : _predicates(std::move(predicates)...) {}
+
+	template <class ProbePoint>
+	bool operator()(const ProbePoint &previous, const ProbePoint &current) const {
+		return std::apply([&](const auto &...predicate) { return (predicate(previous, current) || ...); }, _predicates);
+	}
+
+private:
+	std::tuple<Predicates...> _predicates;
+};
+
+/**
+ * @brief Splits a random access range of probes into ranges of consecutive probes, without copying the probes.
+ * @details Unlike Splitter, which copies the probes of every segment, this only reports the index ranges,
+ * so the segments can be used as views into the input, and copied only when needed.
+ * @param first Start of the probes
+ * @param beyond End of the probes
+ * @param split Pairwise predicate, returning whether a new range starts between two consecutive probes
+ * @param out Output iterator of IndexRange
+ * @param min_size Minimum number of probes of a range, smaller ranges are skipped
+ * @return The output iterator beyond the written ranges
+ */
+template <class RandomAccessIterator, class PairwisePredicate, class OutputIterator>
+OutputIterator split_ranges(RandomAccessIterator first,
+                            RandomAccessIterator beyond,
+                            const PairwisePredicate &split,
+                            OutputIterator out,
+                            std::size_t min_size = 1) {
+	const auto size = static_cast<std::size_t>(std::distance(first, beyond));
+	auto emit = [&](std::size_t range_first, std::size_t range_beyond) {
+		if (range_beyond > range_first && range_beyond - range_first >= min_size) {
+			MOVETK_COUNT(SplitterSegmentsEmitted);
+			*out++ = IndexRange{range_first, range_beyond};
+		}
+	};
+	std::size_t range_first = 0;
+	for (std::size_t i = 1; i < size; ++i) {
+		if (split(first[i - 1], first[i])) {
+			emit(range_first, i);
+			range_first = i;
+		}
+	}
+	emit(range_first, size);
+	return out;
+}
 }  // namespace movetk::io
 #endif  // MOVETK_SPLITTER_H
@@ -0,0 +1,494 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file SyntheticTrajectoryGenerator.h
+ *  @brief  Deterministic generator of synthetic vehicle trajectories for load and stress tests
+ */
+
+#ifndef MOVETK_IO_SYNTHETICTRAJECTORYGENERATOR_H
+#define MOVETK_IO_SYNTHETICTRAJECTORYGENERATOR_H
+
+#include <algorithm>
+#include <charconv>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <iterator>
+#include <numbers>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <tuple>
+#include <vector>
+
+#include "movetk/ds/ColumnarTrajectory.h"
+#include "movetk/utils/Philox.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::io {
+
+/**
+ * @brief Speed profiles of the synthetic vehicles
+ */
+enum class SpeedProfile {
+	// Constant cruise speed
+	Constant,
+	// Stop-and-go driving with turns at intersections
+	Urban,
+	// High speed with slow variations and gentle curves
+	Highway
+};
+
+/**
+ * @brief Parameters of the synthetic trajectories. Times are in seconds, distances in meters
+ * and speeds in meters per second.
+ */
+struct SyntheticTrajectoryOptions {
+	// Seed of the generator. Trajectory i is generated from stream i of the seed.
+	std::uint64_t seed = 1;
+	// Range of the number of samples of a trajectory, excluding duplicates
+	std::size_t min_samples = 100;
+	std::size_t max_samples = 1000;
+	// Time between consecutive samples
+	std::time_t sampling_interval = 1;
+	// The trajectories start uniformly at random in [start_time, start_time + start_time_spread)
+	std::time_t start_time = 1537228800;
+	std::time_t start_time_spread = 3600;
+	// The trajectories start uniformly at random in a square of extent degrees around the center
+	double center_lat = 51.4416;
+	double center_lon = 5.4697;
+	double extent = 0.2;
+	SpeedProfile speed_profile = SpeedProfile::Urban;
+	// Upper bound on the true speed of the vehicles
+	double max_speed = 14;
+	// Standard deviation of the Gaussian position noise
+	double gps_noise = 5;
+	// Probability that a sample is displaced by outlier_distance in a random direction
+	double outlier_probability = 0.001;
+	double outlier_distance = 500;
+	// Probability that no samples are reported for gap_duration after a sample
+	double gap_probability = 0.001;
+	std::time_t gap_duration = 120;
+	// Probability that a sample is reported twice with the same timestamp
+	double duplicate_probability = 0.001;
+};
+
+/**
+ * @brief A generated probe. The heading is in degrees clockwise from north and the speed in km/h,
+ * as in the c2d probe format.
+ */
+struct SyntheticProbe {
+	std::size_t trajectory;
+	std::time_t timestamp;
+	double lat;
+	double lon;
+	double heading;
+	double speed;
+
+	bool operator==(const SyntheticProbe&) const = default;
+};
+
+/**
+ * @brief Columns of a SyntheticTrajectory
+ */
+enum SyntheticTrajectoryColumns { SAMPLE_DATE, LAT, LON, HEADING, SPEED };
+
+using SyntheticTrajectory = ds::ColumnarTrajectory<std::time_t, double, double, double, double>;
+
+/**
+ * @brief Generates synthetic vehicle trajectories with GPS noise, outliers, gaps and duplicate timestamps.
+ * @details Trajectory i only depends on the options and on i: it is generated from its own stream of a
+ * counter-based random generator. Trajectories can therefore be generated in any order and in parallel,
+ * and the output is the same for any number of threads.
+ * The csv output follows the c2d raw probe format
+ * (PROBE_ID,SAMPLE_DATE,LAT,LON,HEADING,SPEED,PROBE_DATA_PROVIDER), with dates in UTC.
+ */
+class SyntheticTrajectoryGenerator {
+public:
+	// Number of trajectories that a thread formats (and compresses) at a time
+	static constexpr std::size_t TRAJECTORIES_PER_BLOCK = 64;
+
+	/**
+	 * @brief Construct the generator
+	 * @param options The options
+	 * @throws std::invalid_argument If min_samples exceeds max_samples, or the sampling interval or the
+	 * start time spread is negative
+	 */
+	explicit SyntheticTrajectoryGenerator(SyntheticTrajectoryOptions options = {}) : m_options(options) {
+		if (options.min_samples > options.max_samples) {
+			throw std::invalid_argument("The minimum number of samples should not exceed the maximum number of samples");
+		}
+		if (options.sampling_interval < 0 || options.start_time_spread < 0) {
+			throw std::invalid_argument("The sampling interval and the start time spread should not be negative");
+		}
+	}
+
+	const SyntheticTrajectoryOptions& options() const { return m_options; }
+
+	/**
+	 * @brief Generates a single trajectory
+	 * @tparam OutputIterator Output iterator accepting SyntheticProbe
+	 * @param trajectory Index of the trajectory
+	 * @param result Output iterator for the probes, in order of time
+	 * @return The output iterator after writing the probes
+	 */
+	template <class OutputIterator>
+	OutputIterator generate(std::size_t trajectory, OutputIterator result) const {
+		constexpr double EARTH_RADIUS = 6371008.8;
+		constexpr double TO_DEGREES = 180 / std::numbers::pi;
+		const auto& o = m_options;
+		utils::Philox4x32 rng(o.seed, trajectory);
+
+		const auto num_samples =
+		    o.min_samples + static_cast<std::size_t>(rng.uniform() * static_cast<double>(o.max_samples - o.min_samples + 1));
+		auto timestamp = o.start_time + static_cast<std::time_t>(rng.uniform() * static_cast<double>(o.start_time_spread));
+		const auto lat0 = o.center_lat + rng.uniform(-o.extent, o.extent) / 2;
+		const auto lon0 = o.center_lon + rng.uniform(-o.extent, o.extent) / 2;
+		const auto meters_per_degree_lon = EARTH_RADIUS * std::cos(lat0 / TO_DEGREES) / TO_DEGREES;
+		const auto meters_per_degree_lat = EARTH_RADIUS / TO_DEGREES;
+
+		MotionState state;
+		state.heading = rng.uniform(0, 2 * std::numbers::pi);
+		state.cruise_speed = o.speed_profile == SpeedProfile::Highway ? o.max_speed * rng.uniform(0.8, 1)
+		                                                              : o.max_speed * rng.uniform(0.6, 1);
+		state.speed = o.speed_profile == SpeedProfile::Urban ? 0 : state.cruise_speed;
+
+		auto report = [&]() {
+			auto x = state.x + rng.normal(0, o.gps_noise);
+			auto y = state.y + rng.normal(0, o.gps_noise);
+			if (rng.bernoulli(o.outlier_probability)) {
+				const auto direction = rng.uniform(0, 2 * std::numbers::pi);
+				x += o.outlier_distance * std::cos(direction);
+				y += o.outlier_distance * std::sin(direction);
+			}
+			auto heading = std::fmod(90 - state.heading * TO_DEGREES, 360.0);
+			if (heading < 0) {
+				heading += 360;
+			}
+			const auto speed = std::max(0.0, state.speed + rng.normal(0, 0.2)) * 3.6;
+			*result++ = SyntheticProbe{trajectory,
+			                           timestamp,
+			                           lat0 + y / meters_per_degree_lat,
+			                           lon0 + x / meters_per_degree_lon,
+			                           heading,
+			                           speed};
+		};
+
+		for (std::size_t i = 0; i < num_samples; ++i) {
+			if (i > 0) {
+				auto interval = o.sampling_interval;
+				if (rng.bernoulli(o.gap_probability)) {
+					interval += o.gap_duration;
+				}
+				advance(state, rng, static_cast<double>(interval));
+				timestamp += interval;
+			}
+			report();
+			if (rng.bernoulli(o.duplicate_probability)) {
+				report();
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Generates a single trajectory in columns
+	 * @param trajectory Index of the trajectory
+	 */
+	SyntheticTrajectory generate_columnar(std::size_t trajectory) const {
+		std::vector<SyntheticProbe> probes;
+		generate(trajectory, std::back_inserter(probes));
+		std::tuple<std::vector<std::time_t>, std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>>
+		    columns;
+		std::apply([&](auto&... column) { (column.reserve(probes.size()), ...); }, columns);
+		for (const auto& probe : probes) {
+			std::get<SAMPLE_DATE>(columns).push_back(probe.timestamp);
+			std::get<LAT>(columns).push_back(probe.lat);
+			std::get<LON>(columns).push_back(probe.lon);
+			std::get<HEADING>(columns).push_back(probe.heading);
+			std::get<SPEED>(columns).push_back(probe.speed);
+		}
+		return SyntheticTrajectory(std::move(columns));
+	}
+
+	/**
+	 * @brief Generates the trajectories first, ..., beyond - 1 in columns
+	 * @param first Index of the first trajectory
+	 * @param beyond One beyond the index of the last trajectory
+	 * @param thread_pool Optional thread pool to generate the trajectories in parallel
+	 */
+	std::vector<SyntheticTrajectory> generate_columnar(std::size_t first,
+	                                                   std::size_t beyond,
+	                                                   utils::ThreadPool* thread_pool = nullptr) const {
+		std::vector<SyntheticTrajectory> trajectories(beyond > first ? beyond - first : 0);
+		auto body = [&](std::size_t i) { trajectories[i] = generate_columnar(first + i); };
+		if (thread_pool == nullptr) {
+			for (std::size_t i = 0; i < trajectories.size(); ++i) {
+				body(i);
+			}
+		} else {
+			thread_pool->parallel_for(0, trajectories.size(), body);
+		}
+		return trajectories;
+	}
+
+	/**
+	 * @brief Writes trajectories 0, ..., num_trajectories - 1 as csv, one trajectory after the other.
+	 * Only a bounded number of trajectories is held in memory.
+	 * @param out The output stream
+	 * @param num_trajectories The number of trajectories
+	 * @param thread_pool Optional thread pool to generate and format the trajectories in parallel
+	 * @param header Whether to write a header line
+	 */
+	void write_csv(std::ostream& out,
+	               std::size_t num_trajectories,
+	               utils::ThreadPool* thread_pool = nullptr,
+	               bool header = true) const {
+		write_blocks(out, num_trajectories, thread_pool, header, [](std::string&) {});
+	}
+
+	/**
+	 * @brief Writes trajectories 0, ..., num_trajectories - 1 as gzipped csv.
+	 * Blocks of trajectories are compressed in parallel into separate gzip members, which
+	 * gzip decompressors concatenate.
+	 * @param out The output stream, should be opened in binary mode
+	 * @param num_trajectories The number of trajectories
+	 * @param thread_pool Optional thread pool to generate and compress the trajectories in parallel
+	 * @param header Whether to write a header line
+	 */
+	void write_gzip_csv(std::ostream& out,
+	                    std::size_t num_trajectories,
+	                    utils::ThreadPool* thread_pool = nullptr,
+	                    bool header = true) const {
+		write_blocks(out, num_trajectories, thread_pool, header, [](std::string& block) {
+			std::string compressed;
+			{
+				boost::iostreams::filtering_ostream compressor;
+				compressor.push(boost::iostreams::gzip_compressor());
+				compressor.push(std::back_inserter(compressed));
+				compressor.write(block.data(), static_cast<std::streamsize>(block.size()));
+			}
+			block = std::move(compressed);
+		});
+	}
+
+	/**
+	 * @brief Returns the probe id of a trajectory in the csv output
+	 * @param trajectory Index of the trajectory
+	 */
+	static std::string probe_id(std::size_t trajectory) {
+		std::string id(PROBE_ID_LENGTH, ' ');
+		write_probe_id(id.data(), trajectory);
+		return id;
+	}
+
+	/**
+	 * @brief Appends a probe as csv line
+	 * @param line The string to append to
+	 * @param probe The probe
+	 */
+	static void append_csv(std::string& line, const SyntheticProbe& probe) {
+		// Formatted with std::to_chars, which is several times faster than printf
+		char buffer[160];
+		char* const end = buffer + sizeof(buffer);
+		char* out = write_probe_id(buffer, probe.trajectory);
+		*out++ = ',';
+		out = write_date(out, probe.timestamp);
+		for (const auto& [value, precision] :
+		     {std::pair(probe.lat, 7), std::pair(probe.lon, 7), std::pair(probe.heading, 1), std::pair(probe.speed, 1)}) {
+			*out++ = ',';
+			out = std::to_chars(out, end, value, std::chars_format::fixed, precision).ptr;
+		}
+		constexpr std::string_view PROVIDER = ",SYNTHETIC\n";
+		out = std::copy(PROVIDER.begin(), PROVIDER.end(), out);
+		line.append(buffer, out);
+	}
+
+private:
+	struct MotionState {
+		double x = 0;
+		double y = 0;
+		// Direction of movement in radians, counterclockwise from east
+		double heading = 0;
+		double speed = 0;
+		double cruise_speed = 0;
+		// Remaining time of a stop
+		double stop_time = 0;
+	};
+
+	SyntheticTrajectoryOptions m_options;
+
+	/**
+	 * @brief Moves the vehicle forward in steps of at most one second
+	 */
+	void advance(MotionState& state, utils::Philox4x32& rng, double duration) const {
+		const auto& o = m_options;
+		while (duration > 0) {
+			const auto dt = std::min(duration, 1.0);
+			duration -= dt;
+			double target = state.cruise_speed;
+			double wander = 0.02;
+			switch (o.speed_profile) {
+				case SpeedProfile::Constant:
+					break;
+				case SpeedProfile::Urban:
+					if (state.stop_time > 0) {
+						state.stop_time -= dt;
+						target = 0;
+					} else if (rng.bernoulli(dt / 90)) {
+						// Traffic light or congestion
+						state.stop_time = rng.uniform(5, 45);
+						target = 0;
+					}
+					if (state.speed > 2 && rng.bernoulli(dt / 45)) {
+						state.heading += rng.bernoulli(0.5) ? std::numbers::pi / 2 : -std::numbers::pi / 2;
+					}
+					wander = 0.05;
+					break;
+				case SpeedProfile::Highway:
+					state.cruise_speed = std::clamp(state.cruise_speed + rng.normal(0, 0.1), 0.7 * o.max_speed, o.max_speed);
+					wander = 0.005;
+					break;
+			}
+			// Limited acceleration and deceleration
+			state.speed = std::clamp(target, state.speed - 4 * dt, state.speed + 2.5 * dt);
+			state.heading += rng.normal(0, wander * std::sqrt(dt));
+			state.x += state.speed * dt * std::cos(state.heading);
+			state.y += state.speed * dt * std::sin(state.heading);
+		}
+	}
+
+	static constexpr std::string_view PROBE_ID_PREFIX = "synthetic";
+	static constexpr std::size_t PROBE_ID_LENGTH = PROBE_ID_PREFIX.size() + 16;
+
+	/**
+	 * @brief Writes the probe id of a trajectory: a prefix followed by the index as 16 hexadecimal digits
+	 * @return Pointer beyond the written characters
+	 */
+	static char* write_probe_id(char* out, std::size_t trajectory) {
+		constexpr std::string_view HEX_DIGITS = "0123456789abcdef";
+		out = std::copy(PROBE_ID_PREFIX.begin(), PROBE_ID_PREFIX.end(), out);
+		const auto id = static_cast<std::uint64_t>(trajectory);
+		for (int i = 15; i >= 0; --i) {
+			*out++ = HEX_DIGITS[(id >> (4 * i)) & 0xf];
+		}
+		return out;
+	}
+
+	/**
+	 * @brief Writes a non-negative number with leading zeros
+	 * @return Pointer beyond the written characters
+	 */
+	static char* write_digits(char* out, std::int64_t value, int width) {
+		for (int i = width - 1; i >= 0; --i) {
+			out[i] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		return out + width;
+	}
+
+	/**
+	 * @brief Writes a UTC timestamp as %Y-%m-%d %H:%M:%S. Unlike std::gmtime, this is thread safe.
+	 * @return Pointer beyond the written characters
+	 */
+	static char* write_date(char* out, std::time_t timestamp) {
+		// Conversion of days since the epoch to a civil date of H. Hinnant, "chrono-Compatible Low-Level Date Algorithms"
+		auto days = static_cast<std::int64_t>(timestamp / 86400);
+		auto seconds = static_cast<std::int64_t>(timestamp % 86400);
+		if (seconds < 0) {
+			seconds += 86400;
+			--days;
+		}
+		days += 719468;
+		const auto era = (days >= 0 ? days : days - 146096) / 146097;
+		const auto day_of_era = days - era * 146097;
+		const auto year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+		const auto day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+		const auto shifted_month = (5 * day_of_year + 2) / 153;
+		const auto day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+		const auto month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+		const auto year = year_of_era + era * 400 + (month <= 2);
+		out = write_digits(out, year, 4);
+		*out++ = '-';
+		out = write_digits(out, month, 2);
+		*out++ = '-';
+		out = write_digits(out, day, 2);
+		*out++ = ' ';
+		out = write_digits(out, seconds / 3600, 2);
+		*out++ = ':';
+		out = write_digits(out, seconds / 60 % 60, 2);
+		*out++ = ':';
+		return write_digits(out, seconds % 60, 2);
+	}
+
+	/**
+	 * @brief Formats blocks of trajectories as csv, transforms the blocks in parallel and writes them in order
+	 */
+	template <class Transform>
+	void write_blocks(std::ostream& out,
+	                  std::size_t num_trajectories,
+	                  utils::ThreadPool* thread_pool,
+	                  bool header,
+	                  Transform transform) const {
+		const auto num_blocks = (num_trajectories + TRAJECTORIES_PER_BLOCK - 1) / TRAJECTORIES_PER_BLOCK;
+		const std::size_t blocks_per_round = thread_pool == nullptr ? 1 : thread_pool->size() * 4;
+		std::vector<std::string> blocks(blocks_per_round);
+		auto format_block = [&](std::size_t block, std::string& text) {
+			text.clear();
+			if (header && block == 0) {
+				text += "PROBE_ID,SAMPLE_DATE,LAT,LON,HEADING,SPEED,PROBE_DATA_PROVIDER\n";
+			}
+			std::vector<SyntheticProbe> probes;
+			const auto beyond = std::min(num_trajectories, (block + 1) * TRAJECTORIES_PER_BLOCK);
+			for (auto trajectory = block * TRAJECTORIES_PER_BLOCK; trajectory < beyond; ++trajectory) {
+				probes.clear();
+				generate(trajectory, std::back_inserter(probes));
+				for (const auto& probe : probes) {
+					append_csv(text, probe);
+				}
+			}
+			transform(text);
+		};
+		for (std::size_t round_first = 0; round_first < num_blocks; round_first += blocks_per_round) {
+			const auto round_size = std::min(blocks_per_round, num_blocks - round_first);
+			auto body = [&](std::size_t i) { format_block(round_first + i, blocks[i]); };
+			if (thread_pool == nullptr) {
+				body(0);
+			} else {
+				thread_pool->parallel_for(0, round_size, body);
+			}
+			for (std::size_t i = 0; i < round_size; ++i) {
+				out.write(blocks[i].data(), static_cast<std::streamsize>(blocks[i].size()));
+			}
+		}
+		if (num_blocks == 0 && header) {
+			std::string text;
+			format_block(0, text);
+			out.write(text.data(), static_cast<std::streamsize>(text.size()));
+		}
+	}
+};
+
+}  // namespace movetk::io
+
+#endif  // MOVETK_IO_SYNTHETICTRAJECTORYGENERATOR_H
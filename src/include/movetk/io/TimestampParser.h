@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_IO_TIMESTAMPPARSER_H
+#define MOVETK_IO_TIMESTAMPPARSER_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <optional>
+#include <string_view>
+
+namespace movetk::io {
+/**
+ * @brief Timestamp layouts with a specialized parser
+ */
+enum class TimestampLayout {
+	/** %Y-%m-%d */
+	Date,
+	/** ISO-8601 date and time: %Y-%m-%d %H:%M:%S or %Y-%m-%dT%H:%M:%S, optionally followed by
+	 * fractional seconds (truncated) and a time zone designator Z, +hh, +hhmm or +hh:mm */
+	DateTime,
+	/** Seconds since the epoch, %s */
+	EpochSeconds,
+	/** Milliseconds since the epoch, %Q */
+	EpochMilliseconds,
+	/** Any other format */
+	Other
+};
+
+/**
+ * @brief Returns the layout of a strftime-style format string
+ * @param format The format
+ * @return The layout, TimestampLayout::Other if the format has no specialized parser
+ */
+constexpr TimestampLayout timestamp_layout(std::string_view format) noexcept {
+	constexpr std::array<std::string_view, 2> dates = {"%Y-%m-%d", "%F"};
+	constexpr std::array<std::string_view, 12> date_times = {"%Y-%m-%d %H:%M:%S",
+	                                                         "%Y-%m-%dT%H:%M:%S",
+	                                                         "%Y-%m-%dT%H:%M:%SZ",
+	                                                         "%Y-%m-%dT%H:%M:%S%z",
+	                                                         "%Y-%m-%d %H:%M:%S%z",
+	                                                         "%Y-%m-%d %T",
+	                                                         "%Y-%m-%dT%T",
+	                                                         "%F %T",
+	                                                         "%FT%T",
+	                                                         "%FT%TZ",
+	                                                         "%FT%T%z",
+	                                                         "%F %T%z"};
+	for (auto date : dates) {
+		if (format == date) {
+			return TimestampLayout::Date;
+		}
+	}
+	for (auto date_time : date_times) {
+		if (format == date_time) {
+			return TimestampLayout::DateTime;
+		}
+	}
+	if (format == "%s") {
+		return TimestampLayout::EpochSeconds;
+	}
+	if (format == "%Q") {
+		return TimestampLayout::EpochMilliseconds;
+	}
+	return TimestampLayout::Other;
+}
+
+/**
+ * @brief Returns the number of days since 1970-01-01 of a date in the proleptic Gregorian calendar
+ * @details Days beyond the end of the month continue into the next month, as with std::mktime.
+ * @param year The year
+ * @param month The month, 1 to 12
+ * @param day The day of the month
+ */
+constexpr std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept {
+	// Years start in March, so the leap day is the last day of the year
+	year -= month <= 2;
+	const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+	const auto year_of_era = static_cast<unsigned>(year - era * 400);
+	const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+	return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+}
+
+/**
+ * @brief Parser of timestamps in a fixed layout into seconds since the epoch (UTC), without std::get_time,
+ * std::mktime, locales or time zone lookups.
+ * @details Dates are validated and converted arithmetically. The date of the last timestamp is cached,
+ * since consecutive probes mostly share their date, so a parser should not be shared between threads.
+ */
+class TimestampParser {
+public:
+	/**
+	 * @brief Construct the parser
+	 * @param layout The layout, must not be TimestampLayout::Other
+	 */
+	explicit TimestampParser(TimestampLayout layout = TimestampLayout::DateTime) : m_layout(layout) {}
+
+	/**
+	 * @brief Returns the layout of the parser
+	 */
+	TimestampLayout layout() const { return m_layout; }
+
+	/**
+	 * @brief Parses a timestamp
+	 * @param text The timestamp, without surrounding whitespace
+	 * @return Seconds since the epoch, or std::nullopt if the text does not match the layout
+	 */
+	std::optional<std::time_t> parse(std::string_view text) {
+		switch (m_layout) {
+			case TimestampLayout::Date: {
+				if (text.size() != DATE_LENGTH) {
+					return std::nullopt;
+				}
+				const auto days = parse_date(text);
+				if (!days) {
+					return std::nullopt;
+				}
+				return static_cast<std::time_t>(*days * SECONDS_PER_DAY);
+			}
+			case TimestampLayout::DateTime:
+				return parse_date_time(text);
+			case TimestampLayout::EpochSeconds:
+				return parse_epoch(text, 1);
+			case TimestampLayout::EpochMilliseconds:
+				return parse_epoch(text, 1000);
+			default:
+				return std::nullopt;
+		}
+	}
+
+private:
+	static constexpr std::size_t DATE_LENGTH = 10;
+	static constexpr std::size_t DATE_TIME_LENGTH = 19;
+	static constexpr std::int64_t SECONDS_PER_DAY = 86400;
+
+	static constexpr unsigned digit(char c) { return static_cast<unsigned>(c) - '0'; }
+
+	// Parses the digits of text[first, first + N), accumulating in bad whether any is not a digit
+	template <std::size_t N>
+	static constexpr unsigned digits(std::string_view text, std::size_t first, unsigned &bad) {
+		unsigned value = 0;
+		for (std::size_t i = first; i < first + N; ++i) {
+			const auto d = digit(text[i]);
+			bad |= static_cast<unsigned>(d > 9);
+			value = value * 10 + d;
+		}
+		return value;
+	}
+
+	static constexpr bool is_leap(unsigned year) { return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0); }
+
+	// Days since the epoch of YYYY-MM-DD at the start of the text
+	std::optional<std::int64_t> parse_date(std::string_view text) {
+		if (m_cached && std::memcmp(m_last_date.data(), text.data(), DATE_LENGTH) == 0) {
+			return m_last_days;
+		}
+		unsigned bad = static_cast<unsigned>(text[4] != '-') | static_cast<unsigned>(text[7] != '-');
+		const auto year = digits<4>(text, 0, bad);
+		const auto month = digits<2>(text, 5, bad);
+		const auto day = digits<2>(text, 8, bad);
+		constexpr std::array<unsigned, 12> month_days = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+		if (bad != 0 || month < 1 || month > 12 || day < 1 ||
+		    day > month_days[month - 1] + static_cast<unsigned>(month == 2 && is_leap(year))) {
+			return std::nullopt;
+		}
+		m_last_days = days_from_civil(year, month, day);
+		std::memcpy(m_last_date.data(), text.data(), DATE_LENGTH);
+		m_cached = true;
+		return m_last_days;
+	}
+
+	std::optional<std::time_t> parse_date_time(std::string_view text) {
+		if (text.size() < DATE_TIME_LENGTH || (text[10] != ' ' && text[10] != 'T')) {
+			return std::nullopt;
+		}
+		const auto days = parse_date(text);
+		if (!days) {
+			return std::nullopt;
+		}
+		unsigned bad = static_cast<unsigned>(text[13] != ':') | static_cast<unsigned>(text[16] != ':');
+		const auto hours = digits<2>(text, 11, bad);
+		const auto minutes = digits<2>(text, 14, bad);
+		const auto seconds = digits<2>(text, 17, bad);
+		// A leap second is accepted, as with std::get_time
+		if (bad != 0 || hours > 23 || minutes > 59 || seconds > 60) {
+			return std::nullopt;
+		}
+		std::int64_t ts = *days * SECONDS_PER_DAY + hours * 3600 + minutes * 60 + seconds;
+
+		auto pos = DATE_TIME_LENGTH;
+		if (pos < text.size() && (text[pos] == '.' || text[pos] == ',')) {
+			const auto first = ++pos;
+			while (pos < text.size() && digit(text[pos]) <= 9) {
+				++pos;
+			}
+			if (pos == first) {
+				return std::nullopt;
+			}
+		}
+		if (pos < text.size()) {
+			const auto designator = text[pos++];
+			if (designator == 'Z') {
+				if (pos != text.size()) {
+					return std::nullopt;
+				}
+			} else if (designator == '+' || designator == '-') {
+				// hh, hhmm or hh:mm
+				const auto rest = text.size() - pos;
+				const bool colon = rest == 5 && text[pos + 2] == ':';
+				if (rest != 2 && rest != 4 && !colon) {
+					return std::nullopt;
+				}
+				unsigned offset_bad = 0;
+				const auto offset_hours = digits<2>(text, pos, offset_bad);
+				const auto offset_minutes = rest == 2 ? 0 : digits<2>(text, pos + (colon ? 3 : 2), offset_bad);
+				if (offset_bad != 0 || offset_hours > 23 || offset_minutes > 59) {
+					return std::nullopt;
+				}
+				const std::int64_t offset = offset_hours * 3600 + offset_minutes * 60;
+				ts -= designator == '+' ? offset : -offset;
+			} else {
+				return std::nullopt;
+			}
+		}
+		return static_cast<std::time_t>(ts);
+	}
+
+	static std::optional<std::time_t> parse_epoch(std::string_view text, std::int64_t units_per_second) {
+		std::size_t pos = 0;
+		const bool negative = !text.empty() && text[0] == '-';
+		pos += negative;
+		const auto first = pos;
+		std::int64_t value = 0;
+		// At most 18 digits, so the value does not overflow
+		for (; pos < text.size() && pos - first < 18 && digit(text[pos]) <= 9; ++pos) {
+			value = value * 10 + digit(text[pos]);
+		}
+		if (pos == first) {
+			return std::nullopt;
+		}
+		bool fraction = false;
+		if (pos < text.size() && text[pos] == '.') {
+			const auto fraction_first = ++pos;
+			while (pos < text.size() && digit(text[pos]) <= 9) {
+				fraction = fraction || text[pos] != '0';
+				++pos;
+			}
+			if (pos == fraction_first) {
+				return std::nullopt;
+			}
+		}
+		if (pos != text.size()) {
+			return std::nullopt;
+		}
+		// Rounds towards minus infinity, as the fraction is truncated
+		auto seconds = value / units_per_second;
+		if (negative) {
+			seconds = -seconds - static_cast<std::int64_t>(value % units_per_second != 0 || fraction);
+		}
+		return static_cast<std::time_t>(seconds);
+	}
+
+	TimestampLayout m_layout;
+	std::array<char, DATE_LENGTH> m_last_date{};
+	std::int64_t m_last_days = 0;
+	bool m_cached = false;
+};
+}  // namespace movetk::io
+#endif  // MOVETK_IO_TIMESTAMPPARSER_H
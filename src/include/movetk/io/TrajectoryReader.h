@@ -28,6 +28,8 @@
 #include <iterator>
 #include <memory>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "SortByField.h"
@@ -40,6 +42,9 @@
 namespace movetk::io {
 /**
  * @brief Trajectory reader class, that converts a range of probes into trajectories
+ * @details Segments are moved (tabular) or transposed (columnar) into the trajectories, and are only sorted when
+ * they are not sorted yet. Consumers that are done with a trajectory can hand it back with recycle(): the storage
+ * of recycled trajectories is reused for the next ones, so reading does not allocate in the steady state.
  * @tparam TrajectoryTraits The traits for the reader
  * @tparam ProbeInputIterator Type of the probe range iterators
  * @tparam SortTrajectory Whether or not to sort the trajectory
@@ -71,19 +76,45 @@ public:
 
 	iterator end() { return iterator(); }
 
+	/**
+	 * @brief Hands back a trajectory that is no longer needed, to reuse its storage for the next trajectories
+	 * @param trajectory The trajectory, for example moved from the iterator
+	 */
+	void recycle(value_type &&trajectory) {
+		if (_pool.size() < MAX_POOL_SIZE) {
+			_pool.push_back(trajectory.release());
+		}
+	}
+
 private:
+	using storage_type = std::decay_t<decltype(std::declval<value_type &>().release())>;
+	// Bounds the storage held for consumers that recycle more than they read
+	static constexpr std::size_t MAX_POOL_SIZE = 16;
+
 	std::unique_ptr<Splitter<SplitByFieldIdx, ProbeInputIterator>> _splitter;
 	typename Splitter<SplitByFieldIdx, ProbeInputIterator>::iterator _splitit;
 	typename Splitter<SplitByFieldIdx, ProbeInputIterator>::iterator _splitit_end;
+	std::vector<storage_type> _pool;
+
+	inline storage_type take_storage() {
+		if (_pool.empty()) {
+			return storage_type();
+		}
+		auto storage = std::move(_pool.back());
+		_pool.pop_back();
+		return storage;
+	}
 
 	inline value_type read_trajectory() {
-		// Splitter<SplitByFieldIdx, ProbeInputIterator>::iterator::value_type
-		auto segment = *_splitit;
+		// The segment is taken from the splitter, which reuses the storage it gets in exchange
+		auto &segment = *_splitit;
 
 		if constexpr (SortTrajectory || RemoveDuplicates) {
 			// Sort trajectory by attribute
 			SortByField<SortByFieldIdx, ProbePoint> sort_by_field_asc;
-			std::sort(segment.begin(), segment.end(), sort_by_field_asc);
+			if (!std::is_sorted(segment.begin(), segment.end(), sort_by_field_asc)) {
+				std::sort(segment.begin(), segment.end(), sort_by_field_asc);
+			}
 		}
 
 		if constexpr (RemoveDuplicates) {
@@ -97,18 +128,20 @@ private:
 
 		if constexpr (value_type::storage_scheme() == StorageScheme::columnar) {
 			// Convert vector of tuples to tuple of vectors
-			auto trans_segment = movetk::utils::Transpose(segment)();
+			auto columns = take_storage();
+			movetk::utils::Transpose transpose(segment);
+			transpose(columns);
 			// Construct the trajectory
-			value_type traj{trans_segment};
-			return traj;
+			return value_type{std::move(columns)};
 		} else {
-			// Construct the trajectory
-			value_type traj{segment};
-			return traj;
+			// Construct the trajectory from the segment, and give the splitter other storage to fill
+			auto points = take_storage();
+			std::swap(points, segment);
+			return value_type{std::move(points)};
 		}
 	}
 
-	inline void increment_underlying_iterator() { _splitit++; }
+	inline void increment_underlying_iterator() { ++_splitit; }
 };
 
 
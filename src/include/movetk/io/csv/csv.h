@@ -36,6 +36,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "movetk/utils/Instrumentation.h"
+
 namespace movetk::io::csv {
 
 template <class Tuple, int... idx>
@@ -129,6 +131,7 @@ private:
 
 	/// Reads a line into a stringstream, and then reads the line into a tuple, that is returned
 	inline value_type read_row() {
+		MOVETK_SCOPED_TIMER(CsvReadRow);
 		std::string line;
 		std::getline(_in, line);
 		//        std::cout << line << std::endl;
@@ -140,6 +143,7 @@ private:
 		std::stringstream line_stream(line);
 		Tuple retval;
 		csvtools::read_tuple<0>(line_stream, retval, _delim);
+		MOVETK_COUNT(CsvRowsParsed);
 		return subset_tuple<Tuple, selidx...>(retval);
 	}
 };
@@ -44,7 +44,7 @@ struct ComputeSquaredDistance {
 	 * @return GeometryTraits::NT
 	 */
 	template <class T1, class T2>
-	typename Kernel::NT operator()(T1& object1, T2& object2) {
+	typename Kernel::NT operator()(const T1& object1, const T2& object2) {
 		using algorithm = squared_distance_algorithm<Kernel, Norm, typename Kernel::MovetkSquaredDistance>;
 		typename algorithm::square_distance distance;
 		return distance(object1, object2);
@@ -61,8 +61,7 @@ struct squared_distance_d {
 		const auto line_direction = line[1] - line[0];
 		const auto line_to_point_direction = point - line[0];
 		const auto product = line_direction * line_to_point_direction;
-		n(product);
-		const auto vv = n ^ 2;
+		const auto vv = n.evaluate(product) ^ 2;
 		product *= (product / vv);
 		const auto Pb = line[0] + line_to_point_direction;
 		const auto v2 = point - Pb;
@@ -93,8 +92,7 @@ struct squared_distance_d {
 		if (uv <= 0) {
 			return n(u);
 		}
-		n(v);
-		typename Kernel::NT vv = n ^ Norm::P;
+		typename Kernel::NT vv = n.evaluate(v) ^ Norm::P;
 		if (vv <= uv) {
 			return n(v1);
 		}
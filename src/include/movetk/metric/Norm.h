@@ -32,10 +32,11 @@
 namespace movetk::metric {
 /**
  * @brief \f$L^p\f$ norm functor
+ * @details evaluate() is const and keeps no state, so a single instance can be shared between threads.
+ * operator() followed by operator^ stores the intermediate result in the functor, so that pair of calls
+ * must not be used concurrently on the same instance.
  * @tparam Kernel Kernel to use
  * todo(bram): I think the chosen operators are quite confusing, maybe rename this.
- * Also, maybe don't save the result internally, but return a proxy object for which
- * you can apply the power.
  */
 template <class Kernel, std::size_t p>
 class FiniteNorm {
@@ -45,8 +46,35 @@ private:
 public:
 	constexpr static size_t P = p;
 	static_assert(P > 0);
+
+	/**
+	 * @brief Result of evaluating the norm: the sum of the absolute values of the coordinates raised to
+	 * the power \p p, for example the squared length for \p p = 2.
+	 */
+	struct Value {
+		typename Kernel::NT powered;
+
+		/**
+		 * @brief Returns the \f$L_p\f$ norm raised to the power \p exponent, for example the length for \p exponent = 1.
+		 */
+		typename Kernel::NT operator^(std::size_t exponent) const {
+			return std::pow(powered, exponent / static_cast<typename Kernel::NT>(p));
+		}
+	};
+
 	FiniteNorm() {}
 
+	/**
+	 * @brief Evaluates the norm of \p v without storing the result
+	 * @param v The vector
+	 * @return The sum of raised coordinates, from which the norm can be obtained with operator^
+	 */
+	Value evaluate(const typename Kernel::MovetkVector &v) const {
+		auto sum_exponent_p = [](typename Kernel::NT sum, typename Kernel::NT coord) ->
+		    typename Kernel::NT { return std::move(sum) + std::pow(abs(coord), p); };
+		return {static_cast<typename Kernel::NT>(std::accumulate(std::begin(v), std::end(v), 0.0, sum_exponent_p))};
+	}
+
 	/**
 	 * @brief Computes the sum of the absolute values of the coordinates of \p v, raise
 	 * to the power power \p p.
@@ -54,9 +82,7 @@ public:
 	 * @return The sum of raised coordinates
 	 */
 	typename Kernel::NT operator()(const typename Kernel::MovetkVector &v) const {
-		auto sum_exponent_p = [](typename Kernel::NT sum, typename Kernel::NT coord) ->
-		    typename Kernel::NT { return std::move(sum) + std::pow(abs(coord), p); };
-		result = std::accumulate(std::begin(v), std::end(v), 0.0, sum_exponent_p);
+		result = evaluate(v).powered;
 		return result;
 	}
 
@@ -66,14 +92,12 @@ public:
 	 * @param exponent The exponent to raise the result to
 	 * @return The raised \f$L_p\f$ norm.
 	 */
-	typename Kernel::NT operator^(std::size_t exponent) const {
-		typename Kernel::NT n = exponent / static_cast<typename Kernel::NT>(p);
-		return std::pow(result, n);
-	}
+	typename Kernel::NT operator^(std::size_t exponent) const { return Value{result} ^ exponent; }
 };
 
 /**
  * @brief \f$L^\infty\f$ norm functor
+ * @details Like FiniteNorm, evaluate() is reentrant, while the pair operator(), operator^ is not.
  * @tparam Kernel Kernel to use
  */
 template <class Kernel>
@@ -85,12 +109,25 @@ private:
 	};
 
 public:
+	/**
+	 * @brief Result of evaluating the norm: the maximum absolute value of the coordinates
+	 */
+	struct Value {
+		typename Kernel::NT norm;
+
+		typename Kernel::NT operator^(std::size_t exponent) const { return std::pow(norm, exponent); }
+	};
+
+	Value evaluate(const typename Kernel::MovetkVector &v) const {
+		return {abs(*std::max_element(std::begin(v), std::end(v), abs_compare))};
+	}
+
 	typename Kernel::NT operator()(const typename Kernel::MovetkVector &v) const {
-		result = abs(*std::max_element(std::begin(v), std::end(v), abs_compare));
+		result = evaluate(v).norm;
 		return result;
 	}
 
-	typename Kernel::NT operator^(std::size_t exponent) const { return std::pow(result, exponent); }
+	typename Kernel::NT operator^(std::size_t exponent) const { return Value{result} ^ exponent; }
 };
 }  // namespace movetk::metric
 #endif  // MOVETK_NORM_H
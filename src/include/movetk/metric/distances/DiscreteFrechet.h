@@ -26,6 +26,7 @@
 
 
 #include "movetk/geom/GeometryInterface.h"
+#include "movetk/utils/Instrumentation.h"
 
 namespace movetk::metric {
 /**
@@ -92,6 +93,7 @@ public:
 				previous = current;
 			}
 			dp_row[j - 1] = previous;
+			MOVETK_COUNT_N(DpCellsEvaluated, size_polyline_b);
 		}
 
 		// Return the normed distance of the last element, this is now the discrete Frechet distance.
@@ -27,9 +27,12 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <atomic>
 #include <iostream>
 
 #include "movetk/geom/GeometryInterface.h"
+#include "movetk/utils/Instrumentation.h"
+#include "movetk/utils/ThreadPool.h"
 
 namespace movetk::metric {
 
@@ -268,6 +271,8 @@ private:
 	}
 
 	bool decide(NT epsilon) const {
+		MOVETK_COUNT(FrechetDecideCalls);
+		MOVETK_SCOPED_TIMER(FrechetDecide);
 		const auto epsilon_sq = epsilon * epsilon;
 		const auto &polynomials = m_parameterized_freespace;
 		const auto maxI = polynomials.size();
@@ -461,73 +466,197 @@ class StrongFrechet {
 	};
 
 	/**
-	 * \brief Precomputes the polynomials describing the freespace cell boundaries.
-	 * \tparam PointIt Type of the input point iterators for the polylines
-	 * \param polyA First polyline, specified as pair of start and end iterator of points
-	 * \param polyB Second polyline, specified as pair of start and end iterator of points
-	 * \param polynomials Output table of polynomials.
+	 * \brief Reachable interval on a cell boundary
+	 */
+	struct Interval {
+		NT min = std::numeric_limits<NT>::max();
+		NT max = std::numeric_limits<NT>::lowest();
+		Interval() {}
+		Interval(NT min, NT max) : min(min), max(max) {}
+		bool isEmpty() const { return max < min; }
+		void assignMaxToMin(const Interval &other) {
+			if (isEmpty())
+				return;
+			min = std::max(min, other.min);
+		}
+	};
+	/**
+	 * \brief Reachable intervals on the bottom (0) and left (1) boundary of a cell
+	 */
+	struct CellIntervals {
+		Interval intervals[2] = {{}, {}};
+		bool isReachable() const {
+			// Reachable if one of the intervals is not empty
+			return !intervals[0].isEmpty() || !intervals[1].isEmpty();
+		}
+		Interval &operator[](int i) { return intervals[i]; }
+		const Interval &operator[](int i) const { return intervals[i]; }
+	};
+
+	/**
+	 * \brief Lower bound on the strong Frechet distance derived from the cell boundary polynomials.
+	 * Every path through the freespace diagram crosses each inner row and column boundary, so epsilon
+	 * should be at least the minimumEpsilon of one of the polynomials on that boundary. Only a
+	 * minimum per row and per column is kept.
+	 */
+	class FreespaceLowerBound {
+		std::vector<NT> m_columnMinima;
+		NT m_rowBound = 0;
+		NT m_currentRowMinimum = std::numeric_limits<NT>::max();
+		std::size_t m_row = 0;
+
+	public:
+		explicit FreespaceLowerBound(std::size_t cols) : m_columnMinima(cols, std::numeric_limits<NT>::max()) {}
+		/**
+		 * \brief Adds the polynomials of the cell at the given row and column. Cells should be added row by row.
+		 */
+		void add(std::size_t row, std::size_t col, const CellPolynomials &cell) {
+			if (row != m_row) {
+				if (m_row > 0) {
+					m_rowBound = std::max(m_rowBound, m_currentRowMinimum);
+				}
+				m_currentRowMinimum = std::numeric_limits<NT>::max();
+				m_row = row;
+			}
+			// The first row and column boundaries contain the start of the path and are not constrained.
+			if (row > 0) {
+				m_currentRowMinimum = std::min(m_currentRowMinimum, cell.polys[0].minimumEpsilon);
+			}
+			m_columnMinima[col] = std::min(m_columnMinima[col], cell.polys[1].minimumEpsilon);
+		}
+		/**
+		 * \brief Returns the lower bound after all cells have been added.
+		 */
+		NT value() const {
+			NT bound = m_row > 0 ? std::max(m_rowBound, m_currentRowMinimum) : m_rowBound;
+			for (std::size_t c = 1; c < m_columnMinima.size(); ++c) {
+				bound = std::max(bound, m_columnMinima[c]);
+			}
+			return bound;
+		}
+	};
+
+	/**
+	 * \brief Freespace diagram given as a precomputed table of polynomials describing the cell boundaries.
+	 * Requires O(nm) memory.
+	 */
+	class PrecomputedFreespace {
+		std::vector<std::vector<CellPolynomials>> m_polynomials;
+		NT m_lowerBound = 0;
+
+	public:
+		/**
+		 * \brief Precomputes the polynomials describing the freespace cell boundaries.
+		 * \param polyA First polyline, specified as pair of start and end iterator of points
+		 * \param polyB Second polyline, specified as pair of start and end iterator of points
+		 */
+		template <typename PointItA, typename PointItB>
+		PrecomputedFreespace(const std::pair<PointItA, PointItA> &polyA, const std::pair<PointItB, PointItB> &polyB) {
+			// We don't save the boundaries at the top/right of the freespacediagram, since they are not need:
+			// by convexity, if a path uses the boundary, then the left/bottom boundaries should have atleast one
+			// point of free space.
+			const auto polyASize = std::distance(polyA.first, polyA.second);
+			const auto polyBSize = std::distance(polyB.first, polyB.second);
+			m_polynomials.resize(polyASize - 1, {});
+			for (auto &el : m_polynomials) {
+				el.resize(polyBSize - 1, CellPolynomials{});
+			}
+			FreespaceLowerBound lowerBound(polyBSize - 1);
+			std::size_t i = 0;
+			for (auto pointA = polyA.first; pointA != std::prev(polyA.second); ++pointA, ++i) {
+				std::size_t j = 0;
+				for (auto pointB = polyB.first; pointB != std::prev(polyB.second); ++pointB, ++j) {
+					// Compute bottom boundary polynomial
+					m_polynomials[i][j].polys[0].compute(*pointA, *pointB, *(std::next(pointB)));
+					// Compute left boundary polynomial
+					m_polynomials[i][j].polys[1].compute(*pointB, *pointA, *std::next(pointA));
+					lowerBound.add(i, j, m_polynomials[i][j]);
+				}
+			}
+			m_lowerBound = lowerBound.value();
+		}
+		std::size_t rows() const { return m_polynomials.size(); }
+		std::size_t cols() const { return m_polynomials[0].size(); }
+		NT lowerBound() const { return m_lowerBound; }
+		const Polynomial &polynomial(std::size_t row, std::size_t col, int boundary) const {
+			return m_polynomials[row][col].polys[boundary];
+		}
+	};
+
+	/**
+	 * \brief Freespace diagram of which the cell boundary polynomials are computed on the fly
+	 * when they are requested. Only O(n+m) memory is used, at the cost of recomputing
+	 * the polynomials for every decision.
+	 * \tparam PointItA Iterator type of the first polyline
+	 * \tparam PointItB Iterator type of the second polyline
 	 */
 	template <typename PointItA, typename PointItB>
-	void precomputePolynomials(const std::pair<PointItA, PointItA> &polyA,
-	                           const std::pair<PointItB, PointItB> &polyB,
-	                           std::vector<std::vector<CellPolynomials>> &polynomials) const {
-		// We don't save the boundaries at the top/right of the freespacediagram, since they are not need:
-		// by convexity, if a path uses the boundary, then the left/bottom boundaries should have atleast one
-		// point of free space.
-		const auto polyASize = std::distance(polyA.first, polyA.second);
-		const auto polyBSize = std::distance(polyB.first, polyB.second);
-		polynomials.resize(polyASize - 1, {});
-		for (auto &el : polynomials) {
-			el.resize(polyBSize - 1, CellPolynomials{});
+	class StreamedFreespace {
+		PointItA m_polyA;
+		PointItB m_polyB;
+		std::size_t m_rows;
+		std::size_t m_cols;
+		NT m_lowerBound = 0;
+
+	public:
+		StreamedFreespace(const std::pair<PointItA, PointItA> &polyA, const std::pair<PointItB, PointItB> &polyB)
+		    : m_polyA(polyA.first),
+		      m_polyB(polyB.first),
+		      m_rows(std::distance(polyA.first, polyA.second) - 1),
+		      m_cols(std::distance(polyB.first, polyB.second) - 1) {
+			FreespaceLowerBound lowerBound(m_cols);
+			CellPolynomials cell;
+			for (std::size_t i = 0; i < m_rows; ++i) {
+				for (std::size_t j = 0; j < m_cols; ++j) {
+					cell.polys[0] = polynomial(i, j, 0);
+					cell.polys[1] = polynomial(i, j, 1);
+					lowerBound.add(i, j, cell);
+				}
+			}
+			m_lowerBound = lowerBound.value();
 		}
-		std::size_t i = 0;
-		for (auto pointA = polyA.first; pointA != std::prev(polyA.second); ++pointA, ++i) {
-			std::size_t j = 0;
-			for (auto pointB = polyB.first; pointB != std::prev(polyB.second); ++pointB, ++j) {
-				// Compute bottom boundary polynomial
-				polynomials[i][j].polys[0].compute(*pointA, *pointB, *(std::next(pointB)));
-				// Compute left boundary polynomial
-				polynomials[i][j].polys[1].compute(*pointB, *pointA, *std::next(pointA));
+		std::size_t rows() const { return m_rows; }
+		std::size_t cols() const { return m_cols; }
+		NT lowerBound() const { return m_lowerBound; }
+		Polynomial polynomial(std::size_t row, std::size_t col, int boundary) const {
+			Polynomial poly;
+			if (boundary == 0) {
+				// Bottom boundary polynomial
+				poly.compute(m_polyA[row], m_polyB[col], m_polyB[col + 1]);
+			} else {
+				// Left boundary polynomial
+				poly.compute(m_polyB[col], m_polyA[row], m_polyA[row + 1]);
 			}
+			return poly;
 		}
-	}
+	};
 
 	/**
 	 * \brief Given the freespace diagram and an epsilon, decide if the strong Frechet distance
 	 * is at most epsilon.
 	 * It is assumed that the given epsilon is larger than or equal to the smallest distance
 	 * of the endpoints of the polylines.
-	 * \param polynomials Freespace diagram, given as a table of polynomials
+	 * \tparam Freespace Type of the freespace diagram, either PrecomputedFreespace or StreamedFreespace
+	 * \param freespace Freespace diagram, providing the polynomials of the cell boundaries
 	 * \param epsilon The maximum allowed Frechet distance
 	 * \return Whether or not the polylines are within Frechet distance epsilon
 	 */
-	bool decide(const std::vector<std::vector<CellPolynomials>> &polynomials, NT epsilon) const {
-		const auto maxI = polynomials.size();
-		const auto maxJ = polynomials[0].size();
+	template <typename Freespace>
+	bool decide(const Freespace &freespace, NT epsilon) const {
+		MOVETK_COUNT(FrechetDecideCalls);
+		MOVETK_SCOPED_TIMER(FrechetDecide);
+		// Some inner row or column of the diagram cannot be crossed.
+		if (epsilon < freespace.lowerBound()) {
+			return false;
+		}
+		const auto maxI = freespace.rows();
+		const auto maxJ = freespace.cols();
+		if (m_threadPool != nullptr && m_threadPool->size() > 1 && maxI > m_tileSize && maxJ > m_tileSize) {
+			return decideWavefront(freespace, epsilon);
+		}
 
 		const std::size_t sizes[2] = {maxI, maxJ};
 
-		struct Interval {
-			NT min = std::numeric_limits<NT>::max();
-			NT max = std::numeric_limits<NT>::lowest();
-			Interval() {}
-			Interval(NT min, NT max) : min(min), max(max) {}
-			bool isEmpty() const { return max < min; }
-			void assignMaxToMin(const Interval &other) {
-				if (isEmpty())
-					return;
-				min = std::max(min, other.min);
-			}
-		};
-		struct CellIntervals {
-			Interval intervals[2] = {{}, {}};
-			bool isReachable() const {
-				// Reachable if one of the intervals is not empty
-				return !intervals[0].isEmpty() || !intervals[1].isEmpty();
-			}
-			Interval &operator[](int i) { return intervals[i]; }
-			const Interval &operator[](int i) const { return intervals[i]; }
-		};
 		// Save two rows/columns while computing the decision problem
 		std::vector<CellIntervals> progress[2];
 		// Which of the two saved rows/columns to fill. Either 0 or 1
@@ -542,10 +671,12 @@ class StrongFrechet {
 		const int secondaryDim = 1 - dim;
 
 		// Get the freespace interval for a cell boundary at the given dimension.
-		auto getFreeSpace = [dim, &polynomials, epsilon](int primaryDimIndex, int secondaryDimIndex, int targetDim) {
+		auto getFreeSpace = [dim, &freespace, epsilon](std::size_t primaryDimIndex,
+		                                               std::size_t secondaryDimIndex,
+		                                               int targetDim) {
 			const auto r = dim == 0 ? primaryDimIndex : secondaryDimIndex;
 			const auto c = dim == 0 ? secondaryDimIndex : primaryDimIndex;
-			auto res = polynomials[r][c].polys[targetDim].range(epsilon);
+			auto res = freespace.polynomial(r, c, targetDim).range(epsilon);
 			return Interval{res.first, res.second};
 		};
 
@@ -555,14 +686,14 @@ class StrongFrechet {
 		    Interval(std::numeric_limits<NT>::lowest(), std::numeric_limits<NT>::max());  // Fully open interval
 		progress[current][0].intervals[dim] =
 		    Interval(std::numeric_limits<NT>::lowest(), std::numeric_limits<NT>::max());  // Fully open interval
-		for (auto i = 1; i < sizes[dim]; ++i) {
+		for (std::size_t i = 1; i < sizes[dim]; ++i) {
 			if (!progress[current][i - 1].intervals[dim].isEmpty()) {
 				progress[current][i].intervals[dim] = getFreeSpace(i, 0, dim);
 				progress[current][i].intervals[dim].assignMaxToMin(progress[current][i - 1].intervals[dim]);
 			}
 		}
 		// Go over all other rows(columns).
-		for (auto j = 1; j < sizes[secondaryDim]; ++j) {
+		for (std::size_t j = 1; j < sizes[secondaryDim]; ++j) {
 			// Fill other
 			const auto prev = current;
 			current = 1 - current;
@@ -583,7 +714,7 @@ class StrongFrechet {
 			const auto &prevCells = progress[prev];
 			const auto &currCells = progress[current];
 			bool hasReachable = firstCell.isReachable();
-			for (auto i = 1; i < sizes[dim]; ++i) {
+			for (std::size_t i = 1; i < sizes[dim]; ++i) {
 				auto &currCell = progress[current][i];
 				// Compute secondary dimension element
 				if (prevCells[i].isReachable()) {
@@ -611,33 +742,142 @@ class StrongFrechet {
 		return progress[current].back().isReachable();
 	}
 
+	/**
+	 * \brief Computes the reachable intervals for the cells of a tile of the freespace diagram.
+	 * \param freespace Freespace diagram, providing the polynomials of the cell boundaries
+	 * \param epsilon The maximum allowed Frechet distance
+	 * \param rows The range of rows of the tile
+	 * \param cols The range of columns of the tile
+	 * \param top On input, the cells of the row below the tile. On output, the cells of the last row of the tile.
+	 * Indexed by column.
+	 * \param right On input, the cells of the column left of the tile. On output, the cells of the
+	 * last column of the tile. Indexed by row.
+	 * \return Whether any of the output cells is reachable.
+	 */
+	template <typename Freespace>
+	bool propagateTile(const Freespace &freespace,
+	                   NT epsilon,
+	                   std::pair<std::size_t, std::size_t> rows,
+	                   std::pair<std::size_t, std::size_t> cols,
+	                   std::vector<CellIntervals> &top,
+	                   std::vector<CellIntervals> &right) const {
+		const auto rowsReachable = std::any_of(std::begin(right) + rows.first,
+		                                       std::begin(right) + rows.second,
+		                                       [](const auto &cell) { return cell.isReachable(); });
+		const auto colsReachable = std::any_of(std::begin(top) + cols.first,
+		                                       std::begin(top) + cols.second,
+		                                       [](const auto &cell) { return cell.isReachable(); });
+		// No path can enter the tile, so the output stays unreachable.
+		if (!rowsReachable && !colsReachable && (rows.first != 0 || cols.first != 0)) {
+			std::fill(std::begin(top) + cols.first, std::begin(top) + cols.second, CellIntervals{});
+			std::fill(std::begin(right) + rows.first, std::begin(right) + rows.second, CellIntervals{});
+			return false;
+		}
+		auto getFreeSpace = [&freespace, epsilon](std::size_t r, std::size_t c, int boundary) {
+			auto res = freespace.polynomial(r, c, boundary).range(epsilon);
+			return Interval{res.first, res.second};
+		};
+		bool hasReachable = false;
+		for (auto r = rows.first; r < rows.second; ++r) {
+			CellIntervals left = right[r];
+			for (auto c = cols.first; c < cols.second; ++c) {
+				const CellIntervals below = top[c];
+				CellIntervals cell;
+				if (r == 0 && c == 0) {
+					// Fully open intervals at the start of the diagram
+					cell[0] = Interval(std::numeric_limits<NT>::lowest(), std::numeric_limits<NT>::max());
+					cell[1] = Interval(std::numeric_limits<NT>::lowest(), std::numeric_limits<NT>::max());
+				} else {
+					if (below.isReachable()) {
+						cell[0] = getFreeSpace(r, c, 0);
+						if (below[1].isEmpty() && !below[0].isEmpty()) {
+							cell[0].assignMaxToMin(below[0]);
+						}
+					}
+					if (left.isReachable()) {
+						cell[1] = getFreeSpace(r, c, 1);
+						if (left[0].isEmpty() && !left[1].isEmpty()) {
+							cell[1].assignMaxToMin(left[1]);
+						}
+					}
+				}
+				top[c] = cell;
+				left = cell;
+			}
+			right[r] = left;
+			hasReachable = hasReachable || left.isReachable();
+		}
+		return hasReachable || std::any_of(std::begin(top) + cols.first,
+		                                   std::begin(top) + cols.second,
+		                                   [](const auto &cell) { return cell.isReachable(); });
+	}
+
+	/**
+	 * \brief Parallel version of decide(). The freespace diagram is partitioned in square tiles,
+	 * which are processed in anti-diagonal wavefronts on the thread pool: all tiles on a wavefront only
+	 * depend on tiles of the previous wavefront. Only the last row and column of cells of every
+	 * tile are kept. Stops as soon as no cell on the boundaries of a wavefront is reachable.
+	 * \param freespace Freespace diagram, providing the polynomials of the cell boundaries
+	 * \param epsilon The maximum allowed Frechet distance
+	 * \return Whether or not the polylines are within Frechet distance epsilon
+	 */
+	template <typename Freespace>
+	bool decideWavefront(const Freespace &freespace, NT epsilon) const {
+		const auto maxI = freespace.rows();
+		const auto maxJ = freespace.cols();
+		const auto tileRows = (maxI + m_tileSize - 1) / m_tileSize;
+		const auto tileCols = (maxJ + m_tileSize - 1) / m_tileSize;
+		auto tileRange = [this](std::size_t tile, std::size_t size) {
+			return std::make_pair(tile * m_tileSize, std::min(size, (tile + 1) * m_tileSize));
+		};
+
+		// Last computed cell per column and per row.
+		std::vector<CellIntervals> top(maxJ), right(maxI);
+		for (std::size_t wavefront = 0; wavefront < tileRows + tileCols - 1; ++wavefront) {
+			// Tiles (r, wavefront - r) on this wavefront
+			const auto firstTileRow = wavefront < tileCols ? 0 : wavefront - tileCols + 1;
+			const auto lastTileRow = std::min(wavefront, tileRows - 1);
+			std::atomic<bool> anyReachable{false};
+			m_threadPool->parallel_for(firstTileRow, lastTileRow + 1, [&](std::size_t tileRow) {
+				const auto tileCol = wavefront - tileRow;
+				if (propagateTile(freespace, epsilon, tileRange(tileRow, maxI), tileRange(tileCol, maxJ), top, right)) {
+					anyReachable = true;
+				}
+			});
+			// Early out
+			if (!anyReachable) {
+				return false;
+			}
+		}
+		return right.back().isReachable();
+	}
+
 	/**
 	 * \brief Search the epsilon such that the strong Frechet distance is epsilon, within the predefined tolerance. The
-	 * given lower and upper bound give the range between which it is known that the value of epsilon should lie. \param
-	 * polynomials The freespace diagram, described as a table of polynomials describing the cell boundary freespace
+	 * given lower and upper bound give the range between which it is known that the value of epsilon should lie.
+	 * \param freespace The freespace diagram, providing the polynomials describing the cell boundary freespace
 	 * \param tolerance The tolerance to use for determining the epsilon
 	 * \param lower The lower bound on the range to search epsilon in
 	 * \param upper The upper bound on the range to search epsilon in
 	 * \param outDist The output epsilon value
 	 * \return Whether or not the epsilon was found in the given range.
 	 */
-	bool bisectionSearchInInterval(const std::vector<std::vector<CellPolynomials>> &polynomials,
-	                               NT tolerance,
-	                               NT lower,
-	                               NT upper,
-	                               NT &outDist) const {
+	template <typename Freespace>
+	bool bisectionSearchInInterval(const Freespace &freespace, NT tolerance, NT lower, NT upper, NT &outDist) const {
 		// Upper should be valid, otherwise we are searching in an infeasible interval.
-		if (!decide(polynomials, upper))
+		if (!decide(freespace, upper))
 			return false;
 
-		NT lBound = lower, rBound = upper;
+		// Everything below the lower bound of the freespace is known to be infeasible.
+		NT lBound = std::max(lower, std::min(freespace.lowerBound(), upper)), rBound = upper;
 		NT currentBest = upper;
 		while (true) {
 			if (std::abs(lBound - rBound) < tolerance)
 				break;
 			// New value to test
 			const NT curr = (lBound + rBound) * 0.5;
-			if (decide(polynomials, curr)) {
+			MOVETK_COUNT(FrechetEpsilonIterations);
+			if (decide(freespace, curr)) {
 				rBound = curr;
 				currentBest = curr;
 			} else {
@@ -665,15 +905,14 @@ class StrongFrechet {
 			return false;
 		}
 
-		std::vector<std::vector<CellPolynomials>> polynomials;
-		precomputePolynomials(polyA, polyB, polynomials);
-
-		// If the endpoint epsilon is the smallest, within some fraction, we are ok with selecting that
-		if (decide(polynomials, minEps + m_precision)) {
-			outDist = minEps;
-			return true;
-		}
-		return bisectionSearchInInterval(polynomials, m_precision, minEps, m_upperBound, outDist);
+		return withFreespace(polyA, polyB, [this, minEps, &outDist](const auto &freespace) {
+			// If the endpoint epsilon is the smallest, within some fraction, we are ok with selecting that
+			if (decide(freespace, minEps + m_precision)) {
+				outDist = minEps;
+				return true;
+			}
+			return bisectionSearchInInterval(freespace, m_precision, minEps, m_upperBound, outDist);
+		});
 	}
 
 	template <typename PointItA, typename PointItB>
@@ -691,34 +930,63 @@ class StrongFrechet {
 			return false;
 		}
 
-		std::vector<std::vector<CellPolynomials>> polynomials;
-		precomputePolynomials(polyA, polyB, polynomials);
-
-		// If the endpoint epsilon is the smallest, within some fraction, we are ok with selecting that
-		if (decide(polynomials, minEps + m_precision)) {
-			outDist = minEps + m_precision;
-			return true;
-		}
-		if (minEps < m_precision) {
-			minEps = m_precision;
-		}
+		return withFreespace(polyA, polyB, [this, minEps, &outDist](const auto &freespace) mutable {
+			// If the endpoint epsilon is the smallest, within some fraction, we are ok with selecting that
+			if (decide(freespace, minEps + m_precision)) {
+				outDist = minEps + m_precision;
+				return true;
+			}
+			if (minEps < m_precision) {
+				minEps = m_precision;
+			}
 
-		// Double the epsilon at each step
-		NT currEps = minEps * 2.0;
-		while (true) {
-			// Should happen at some point unless the input is extremely malformed
-			if (decide(polynomials, currEps)) {
-				return bisectionSearchInInterval(polynomials, m_precision, currEps * 0.5, currEps, outDist);
+			// Double the epsilon at each step, starting from the lower bound of the freespace if it is larger.
+			NT currEps = std::max(minEps, freespace.lowerBound()) * 2.0;
+			while (true) {
+				// Should happen at some point unless the input is extremely malformed
+				MOVETK_COUNT(FrechetEpsilonIterations);
+				if (decide(freespace, currEps)) {
+					return bisectionSearchInInterval(freespace, m_precision, currEps * 0.5, currEps, outDist);
+				}
+				currEps *= 2.0;
 			}
-			currEps *= 2.0;
-		}
+		});
 	}
 
 public:
 	enum class Mode { BisectionSearch, DoubleAndSearch };
+	/**
+	 * \brief How the freespace diagram is stored during the computation.
+	 * Precomputed stores the polynomials of all cell boundaries, using O(nm) memory.
+	 * Streamed recomputes the polynomials while sweeping over the diagram, using O(n+m) memory.
+	 */
+	enum class FreespaceStorage { Precomputed, Streamed };
 
 private:
 	Mode m_mode;
+	FreespaceStorage m_storage = FreespaceStorage::Precomputed;
+	// Optional thread pool for deciding on large freespace diagrams, not owned.
+	utils::ThreadPool *m_threadPool = nullptr;
+	// Number of cells along the side of a tile of the freespace diagram in the parallel decision procedure.
+	std::size_t m_tileSize = 256;
+
+	/**
+	 * \brief Constructs the freespace diagram for the given polylines, using the configured storage,
+	 * and invokes the callback with it.
+	 * \param polyA First polyline, specified as pair of start and end iterator of points
+	 * \param polyB Second polyline, specified as pair of start and end iterator of points
+	 * \param callback Callable taking the freespace diagram
+	 * \return The result of the callback
+	 */
+	template <typename PointItA, typename PointItB, typename Callback>
+	bool withFreespace(const std::pair<PointItA, PointItA> &polyA,
+	                   const std::pair<PointItB, PointItB> &polyB,
+	                   Callback &&callback) const {
+		if (m_storage == FreespaceStorage::Streamed) {
+			return callback(StreamedFreespace<PointItA, PointItB>(polyA, polyB));
+		}
+		return callback(PrecomputedFreespace(polyA, polyB));
+	}
 
 public:
 	StrongFrechet(Mode mode = Mode::DoubleAndSearch) : m_mode(mode) {}
@@ -735,6 +1003,34 @@ public:
 	 */
 	void setMode(Mode mode) { m_mode = mode; }
 
+	/**
+	 * \brief Returns how the freespace diagram is stored during the computation
+	 * \return The freespace storage
+	 */
+	FreespaceStorage freespaceStorage() const { return m_storage; }
+
+	/**
+	 * \brief Set how the freespace diagram is stored during the computation. Use
+	 * FreespaceStorage::Streamed for very long polylines, for which the full diagram does not fit in memory.
+	 * \param storage The freespace storage
+	 */
+	void setFreespaceStorage(FreespaceStorage storage) { m_storage = storage; }
+
+	/**
+	 * \brief Set the thread pool to use for the decision procedure. Freespace diagrams with more
+	 * rows and columns than the tile size are then decided in parallel. The pool is not owned and
+	 * should outlive the computation. Pass nullptr to decide sequentially.
+	 * \param threadPool The thread pool
+	 */
+	void setThreadPool(utils::ThreadPool *threadPool) { m_threadPool = threadPool; }
+
+	/**
+	 * \brief Set the number of cells along the side of a tile in the parallel decision procedure.
+	 * \param tileSize The tile size, at least 1
+	 */
+	void setTileSize(std::size_t tileSize) { m_tileSize = std::max<std::size_t>(tileSize, 1); }
+	std::size_t tileSize() const { return m_tileSize; }
+
 	/**
 	 * \brief Set upperbound for upperbounded search approaches
 	 * \param upperBound The upperbound on the Frechet distance
@@ -794,11 +1090,9 @@ public:
 			return false;
 		}
 
-		std::vector<std::vector<CellPolynomials>> polynomials;
-		precomputePolynomials(std::make_pair(poly_a, poly_a_beyond), std::make_pair(poly_b, poly_b_beyond), polynomials);
-
-		// If the endpoint epsilon is the smallest, within some fraction, we are ok with selecting that
-		return decide(polynomials, epsilon);
+		return withFreespace(std::make_pair(poly_a, poly_a_beyond),
+		                     std::make_pair(poly_b, poly_b_beyond),
+		                     [this, epsilon](const auto &freespace) { return decide(freespace, epsilon); });
 	}
 
 	/**
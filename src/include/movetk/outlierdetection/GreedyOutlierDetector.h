@@ -62,7 +62,7 @@ public:
 	 * @brief Construct greedy outlier detector with the given threshold for the predicate
 	 * @param threshold The threshold for the predicate
 	 */
-	explicit OutlierDetection(NT threshold) : m_threshold(threshold), m_predicate(m_threshold) {}
+	explicit OutlierDetection(NT threshold) : m_predicate(threshold), m_threshold(threshold) {}
 
 	/**
 	 * @brief Computes the consistent range of the elements of the provided input range.
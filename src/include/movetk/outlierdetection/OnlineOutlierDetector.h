@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_OUTLIERDETECTION_ONLINEOUTLIERDETECTOR_H
+#define MOVETK_OUTLIERDETECTION_ONLINEOUTLIERDETECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "movetk/utils/ThreadPool.h"
+
+namespace movetk::outlierdetection {
+/**
+ * @brief Decision of an online outlier detector on a probe
+ */
+enum class OutlierDecision { Accepted, Rejected };
+
+/**
+ * @brief Push-based outlier detection of the probes of many moving objects, such as a stream of vehicle probes.
+ * @details Probes are pushed one at a time per object, in time order, and a decision is emitted for every probe.
+ * A probe that satisfies the predicate with the last accepted probe of its object is accepted immediately.
+ * Otherwise it becomes pending: as in the smart greedy detector, the pending probes form candidate sequences
+ * of consecutive probes satisfying the predicate. When the object has horizon pending probes, the longest
+ * sequence is accepted and the other pending probes are rejected, so a decision is delayed by less than
+ * horizon probes of the same object. flush() and evict_idle() decide the pending probes early.
+ *
+ * The state of an object is its last accepted probe and at most horizon pending probes. The states are kept
+ * in hash maps split into shards with their own lock, so probes of different shards can be pushed
+ * concurrently, for example with the batch push() on a thread pool.
+ * @tparam Id Type of the object ids
+ * @tparam Probe The probe type, as accepted by the predicate
+ * @tparam Predicate Binary predicate on consecutive probes, for example the linear_speed_bounded_test_tag TEST
+ * @tparam Hash Hash of the object ids
+ */
+template <class Id, class Probe, class Predicate, class Hash = std::hash<Id>>
+class OnlineOutlierDetector {
+public:
+	using NT = typename Predicate::NT;
+	static constexpr std::size_t TimeIdx = Predicate::Cols::SAMPLE_DATE;
+	using Time = std::decay_t<std::tuple_element_t<TimeIdx, Probe>>;
+
+	/**
+	 * @brief Construct the detector
+	 * @param threshold The threshold for the predicate
+	 * @param horizon Maximum number of pending probes of an object, at least 1
+	 * @param num_shards Number of shards of the object states
+	 */
+	explicit OnlineOutlierDetector(NT threshold, std::size_t horizon = 8, std::size_t num_shards = 64)
+	    : m_horizon(horizon), m_shards(std::max<std::size_t>(num_shards, 1)) {
+		if (horizon == 0) {
+			throw std::invalid_argument("The horizon of the online outlier detector should be positive");
+		}
+		for (auto& shard : m_shards) {
+			shard.predicate = Predicate(threshold);
+		}
+	}
+
+	/**
+	 * @brief Returns the maximum number of pending probes of an object
+	 */
+	std::size_t horizon() const { return m_horizon; }
+
+	/**
+	 * @brief Returns the number of shards
+	 */
+	std::size_t num_shards() const { return m_shards.size(); }
+
+	/**
+	 * @brief Returns the shard of the state of an object
+	 * @param id The object id
+	 */
+	std::size_t shard_index(const Id& id) const {
+		// The table within the shard uses the low bits of the hash, so mix them into the high bits
+		const auto hash = static_cast<std::uint64_t>(Hash{}(id)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<std::size_t>(hash >> 32) % m_shards.size();
+	}
+
+	/**
+	 * @brief Returns the number of objects with a state
+	 */
+	std::size_t num_objects() const {
+		std::size_t count = 0;
+		for (const auto& shard : m_shards) {
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			count += shard.objects.size();
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Pushes the next probe of an object. Probes that are not later than the previous probe
+	 * of the object are rejected immediately.
+	 * @param id The object id
+	 * @param probe The probe
+	 * @param sink Callable taking the id, a probe and its OutlierDecision, called for the decided probes
+	 */
+	template <class Sink>
+	void push(const Id& id, const Probe& probe, Sink&& sink) {
+		auto& shard = m_shards[shard_index(id)];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		push(shard, id, probe, sink);
+	}
+
+	/**
+	 * @brief Pushes a batch of probes of many objects, processing the shards in parallel on a thread pool.
+	 * The probes of an object are processed in the order of the batch.
+	 * @param first Start of the range of (id, probe) pairs
+	 * @param beyond End of the range of (id, probe) pairs
+	 * @param sink Callable taking the id, a probe and its OutlierDecision, called concurrently for different shards
+	 * @param pool The thread pool
+	 */
+	template <std::random_access_iterator InputIterator, class Sink>
+	requires(std::is_convertible_v<std::iter_reference_t<InputIterator>, const std::pair<Id, Probe>&>)
+	void push(InputIterator first, InputIterator beyond, Sink&& sink, utils::ThreadPool& pool) {
+		// Counting sort of the batch by shard, keeping the order within a shard
+		const auto num_probes = static_cast<std::size_t>(std::distance(first, beyond));
+		std::vector<std::size_t> shard_of_probe(num_probes);
+		std::vector<std::size_t> offsets(m_shards.size() + 1, 0);
+		for (std::size_t i = 0; i < num_probes; ++i) {
+			shard_of_probe[i] = shard_index(first[i].first);
+			++offsets[shard_of_probe[i] + 1];
+		}
+		for (std::size_t s = 1; s < offsets.size(); ++s) {
+			offsets[s] += offsets[s - 1];
+		}
+		std::vector<std::size_t> order(num_probes);
+		auto next = offsets;
+		for (std::size_t i = 0; i < num_probes; ++i) {
+			order[next[shard_of_probe[i]]++] = i;
+		}
+		pool.parallel_for(0, m_shards.size(), [&](std::size_t s) {
+			if (offsets[s] == offsets[s + 1]) {
+				return;
+			}
+			auto& shard = m_shards[s];
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			for (auto k = offsets[s]; k < offsets[s + 1]; ++k) {
+				const std::pair<Id, Probe>& item = first[order[k]];
+				push(shard, item.first, item.second, sink);
+			}
+		});
+	}
+
+	/**
+	 * @brief Decides the pending probes of an object
+	 * @param id The object id
+	 * @param sink Callable taking the id, a probe and its OutlierDecision
+	 */
+	template <class Sink>
+	void flush(const Id& id, Sink&& sink) {
+		auto& shard = m_shards[shard_index(id)];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		const auto it = shard.objects.find(id);
+		if (it != shard.objects.end()) {
+			decide(it->first, it->second, sink);
+		}
+	}
+
+	/**
+	 * @brief Decides the pending probes of all objects
+	 * @param sink Callable taking the id, a probe and its OutlierDecision
+	 */
+	template <class Sink>
+	void flush(Sink&& sink) {
+		for (auto& shard : m_shards) {
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			for (auto& [id, state] : shard.objects) {
+				decide(id, state, sink);
+			}
+		}
+	}
+
+	/**
+	 * @brief Decides the pending probes of the objects without probes in a time window, and removes their state.
+	 * A later probe of such an object starts a new state.
+	 * @param now The current time, in the unit of the probe timestamps
+	 * @param max_idle Maximum time since the last probe of an object to keep its state
+	 * @param sink Callable taking the id, a probe and its OutlierDecision
+	 * @return The number of evicted objects
+	 */
+	template <class Sink>
+	std::size_t evict_idle(Time now, Time max_idle, Sink&& sink) {
+		std::size_t count = 0;
+		for (auto& shard : m_shards) {
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			for (auto it = shard.objects.begin(); it != shard.objects.end();) {
+				if (it->second.last_time + max_idle < now) {
+					decide(it->first, it->second, sink);
+					it = shard.objects.erase(it);
+					++count;
+				} else {
+					++it;
+				}
+			}
+		}
+		return count;
+	}
+
+private:
+	// Candidate sequence of pending probes, by index
+	struct Sequence {
+		std::vector<std::uint32_t> probes;
+		// Whether the first probe satisfies the predicate with the last accepted probe
+		bool anchored = false;
+	};
+
+	struct ObjectState {
+		std::optional<Probe> last_accepted;
+		std::vector<Probe> pending;
+		std::vector<Sequence> sequences;
+		Time last_time{};
+	};
+
+	struct Shard {
+		mutable std::mutex mutex;
+		std::unordered_map<Id, ObjectState, Hash> objects;
+		Predicate predicate;
+	};
+
+	template <class Sink>
+	void push(Shard& shard, const Id& id, const Probe& probe, Sink& sink) {
+		const auto time = std::get<TimeIdx>(probe);
+		auto [it, inserted] = shard.objects.try_emplace(id);
+		auto& state = it->second;
+		if (!inserted && !(state.last_time < time)) {
+			sink(it->first, probe, OutlierDecision::Rejected);
+			return;
+		}
+		state.last_time = time;
+		const bool anchored = state.last_accepted && shard.predicate(*state.last_accepted, probe);
+		if (state.pending.empty() && anchored) {
+			state.last_accepted = probe;
+			sink(it->first, probe, OutlierDecision::Accepted);
+			return;
+		}
+
+		const auto index = static_cast<std::uint32_t>(state.pending.size());
+		state.pending.push_back(probe);
+		bool extended = false, extended_anchored = false;
+		for (auto& sequence : state.sequences) {
+			if (shard.predicate(state.pending[sequence.probes.back()], probe)) {
+				sequence.probes.push_back(index);
+				extended = true;
+				extended_anchored = extended_anchored || sequence.anchored;
+			}
+		}
+		// A probe consistent with the last accepted probe also starts an anchored sequence
+		if (!extended || (anchored && !extended_anchored)) {
+			state.sequences.push_back(Sequence{{index}, anchored});
+		}
+		if (state.pending.size() >= m_horizon) {
+			decide(it->first, state, sink);
+		}
+	}
+
+	// Accepts the longest sequence, preferring anchored sequences and then earlier ones, and rejects the
+	// other pending probes
+	template <class Sink>
+	void decide(const Id& id, ObjectState& state, Sink& sink) {
+		if (state.pending.empty()) {
+			return;
+		}
+		const auto best = std::max_element(state.sequences.begin(),
+		                                   state.sequences.end(),
+		                                   [](const Sequence& a, const Sequence& b) {
+			                                   return std::make_pair(a.probes.size(), a.anchored) <
+			                                          std::make_pair(b.probes.size(), b.anchored);
+		                                   });
+		auto accepted = best->probes.begin();
+		for (std::uint32_t i = 0; i < state.pending.size(); ++i) {
+			if (accepted != best->probes.end() && *accepted == i) {
+				sink(id, state.pending[i], OutlierDecision::Accepted);
+				++accepted;
+			} else {
+				sink(id, state.pending[i], OutlierDecision::Rejected);
+			}
+		}
+		state.last_accepted = state.pending[best->probes.back()];
+		state.pending.clear();
+		state.sequences.clear();
+	}
+
+	std::size_t m_horizon;
+	std::vector<Shard> m_shards;
+};
+}  // namespace movetk::outlierdetection
+#endif  // MOVETK_OUTLIERDETECTION_ONLINEOUTLIERDETECTOR_H
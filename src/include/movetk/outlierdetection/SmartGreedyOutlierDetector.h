@@ -31,6 +31,13 @@
 #define MOVETK_OUTLIERDETECTION_SMARTGREEDYOUTLIERDETECTOR_H
 
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "OutlierDetection.h"
 #include "movetk/geo/geo.h"
 #include "movetk/io/CartesianProbeTraits.h"
@@ -42,11 +49,16 @@ namespace movetk::outlierdetection {
 // Maximum Physically Consistent Trajectories
 // published in SIGSPATIAL 2019
 struct smart_greedy_outlier_detector_tag;
-// Physics-based outlier detection running in O(nk) time, where k is the number of outliers
+// Physics-based outlier detection. The sequences are started and extended as in the paper, but sequences
+// that share their last probe are merged: they are extended by the same probes from then on, so only the
+// longest of them can end up maximal. A probe is therefore tested against the distinct open tails only, and
+// the sequences are kept as links between probes, with their lengths, instead of as copies.
 template <class GeometryKernel, class Predicate>
 class OutlierDetection<GeometryKernel, Predicate, smart_greedy_outlier_detector_tag> {
 private:
 	using NT = typename GeometryKernel::NT;
+	using Index = std::uint32_t;
+	static constexpr Index NONE = std::numeric_limits<Index>::max();
 	Predicate m_predicate;
 	NT m_threshold;
 
@@ -60,54 +72,89 @@ public:
 	};
 
 	/*!
-	 *
+	 * Computes the maximal sequences of consistent probes
 	 * @tparam InputIterator
-	 * @tparam OutputIterator
+	 * @tparam Container Container of sequences of input iterators
 	 * @param first
 	 * @param beyond
-	 * @param result
+	 * @param sequences Output of the maximal sequences, in the order of their first probe
+	 * @return The end of the maximal sequences
 	 */
-	template <std::random_access_iterator InputIterator,
-	          typename Container
-				//,typename = movetk::utils::requires_random_access_iterator<InputIterator>,
-	          //typename = movetk::utils::requires_equality<InputIterator, typename Container::value_type::value_type>
-	>
+	template <std::random_access_iterator InputIterator, typename Container>
 	typename Container::const_iterator operator()(InputIterator first, InputIterator beyond, Container& sequences) {
-		auto bit = std::back_inserter(sequences);
-		for (auto it = first; it != beyond; it++) {
-			bool extend_subsequence = false;
-			for (auto sit = std::begin(sequences); sit != std::end(sequences); sit++) {
-				InputIterator prev = *(sit->cend() - 1);
-				if (m_predicate(*prev, *it)) {
-					auto node_bit = std::back_inserter(*sit);
-					node_bit = it;
-					extend_subsequence = true;
+		const auto num_probes = static_cast<std::size_t>(std::distance(first, beyond));
+		if (num_probes == 0) {
+			return std::cend(sequences);
+		}
+		// Length of the longest sequence ending at a probe
+		std::vector<Index> length(num_probes, 0);
+		// Previous probes of the longest sequences ending at a probe, as a linked list. A probe is followed
+		// by at most one probe, so the next_previous link of a probe is unique.
+		std::vector<Index> first_previous(num_probes, NONE), next_previous(num_probes, NONE);
+		// Probes ending the open sequences
+		std::vector<Index> tails;
+
+		for (Index i = 0; i < num_probes; ++i) {
+			const auto &probe = first[i];
+			Index max_length = 0;
+			auto open = tails.begin();
+			for (auto tail : tails) {
+				if (m_predicate(first[tail], probe)) {
+					if (length[tail] > max_length) {
+						max_length = length[tail];
+						first_previous[i] = NONE;
+					}
+					if (length[tail] == max_length) {
+						next_previous[tail] = first_previous[i];
+						first_previous[i] = tail;
+					}
+				} else {
+					*open++ = tail;
 				}
 			}
-			if (!extend_subsequence) {
-				typename Container::value_type node;
-				auto node_bit = std::back_inserter(node);
-				node_bit = it;
-				bit = node;
-			}
+			tails.erase(open, tails.end());
+			tails.push_back(i);
+			length[i] = max_length + 1;
 		}
 
-		std::sort(std::begin(sequences), std::end(sequences), [](auto a, auto b) {
-			std::size_t size_a = std::distance(std::begin(a), std::end(a));
-			std::size_t size_b = std::distance(std::begin(b), std::end(b));
-			return size_a > size_b;
-		});
-
-		auto sit = std::cbegin(sequences);
-		std::size_t max_size = sit->size();
-
-		auto eit = std::remove_if(std::begin(sequences), std::end(sequences), [max_size](auto a) {
-			std::size_t size_a = std::distance(std::begin(a), std::end(a));
-			return size_a != max_size;
-		});
-
-		return eit;
+		// Enumerate the sequences ending at the longest tails, back to front
+		Index max_length = 0;
+		for (auto tail : tails) {
+			max_length = std::max(max_length, length[tail]);
+		}
+		std::vector<std::vector<Index>> maximal;
+		std::vector<Index> path(max_length);
+		std::vector<std::pair<Index, Index>> stack;
+		for (auto tail : tails) {
+			if (length[tail] != max_length) {
+				continue;
+			}
+			stack.emplace_back(tail, max_length - 1);
+			while (!stack.empty()) {
+				const auto [probe, position] = stack.back();
+				stack.pop_back();
+				path[position] = probe;
+				if (position == 0) {
+					maximal.push_back(path);
+				}
+				for (auto previous = first_previous[probe]; previous != NONE; previous = next_previous[previous]) {
+					stack.emplace_back(previous, position - 1);
+				}
+			}
+		}
+		std::sort(maximal.begin(), maximal.end(), [](const auto &a, const auto &b) { return a.front() < b.front(); });
 
+		const auto offset = std::distance(std::begin(sequences), std::end(sequences));
+		auto bit = std::back_inserter(sequences);
+		for (const auto &indices : maximal) {
+			typename Container::value_type node;
+			auto node_bit = std::back_inserter(node);
+			for (auto index : indices) {
+				node_bit = first + index;
+			}
+			bit = std::move(node);
+		}
+		return std::next(std::cbegin(sequences), offset + static_cast<std::ptrdiff_t>(maximal.size()));
 	}  // operator()
 };
 }  // namespace movetk::outlierdetection
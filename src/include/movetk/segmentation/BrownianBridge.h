@@ -39,12 +39,18 @@
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_min.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "movetk/geom/trajectory_to_interface.h"
 #include "movetk/utils/Iterators.h"
 #include "movetk/utils/Requirements.h"
+#include "movetk/utils/ThreadPool.h"
 
 /*!
  * @file AlgorithmTraits.h
@@ -119,8 +125,26 @@ concept ParameterTraits = requires() {
 };
 }  // namespace concepts
 
+/*!
+ * @brief State of the golden section minimizer of MLE.
+ * @details A workspace owns a GSL minimizer and is used by one estimate at a time. Keep one workspace
+ * per thread and pass it to the estimates of that thread to avoid allocating a minimizer per estimate.
+ */
+class MinimizerWorkspace {
+private:
+	struct Free {
+		void operator()(gsl_min_fminimizer *s) const { gsl_min_fminimizer_free(s); }
+	};
+	std::unique_ptr<gsl_min_fminimizer, Free> m_minimizer{gsl_min_fminimizer_alloc(gsl_min_fminimizer_goldensection)};
+
+public:
+	gsl_min_fminimizer *get() const { return m_minimizer.get(); }
+};
+
 /*!
  * @brief The Maximum Likelihood Estimator
+ * @details The estimate is computed on construction. An estimator without a workspace allocates its own;
+ * estimators that share a workspace must not run concurrently.
  * @tparam GeometryTraits -   This class is a collection of movetk
  *  geometry types.
  * @tparam ParameterTraits -  This traits class serves as a collection of types
@@ -143,8 +167,8 @@ template <
 class MLE {
 private:
 	using NT = typename GeometryTraits::NT;
-	const gsl_min_fminimizer_type *T = gsl_min_fminimizer_goldensection;
-	gsl_min_fminimizer *s = gsl_min_fminimizer_alloc(T);
+	std::optional<MinimizerWorkspace> m_own_workspace;
+	gsl_min_fminimizer *s;
 	gsl_function F;
 	NT estimated_parameter;
 	std::size_t iter = 0, status;
@@ -196,17 +220,7 @@ private:
 			estimated_parameter = result;
 	}
 
-public:
-	/*!
-	 *
-	 * @param first
-	 * @param beyond
-	 * @param result
-	 * @param x_lower
-	 * @param x_upper
-	 * @param eps
-	 */
-	MLE(InputIterator first, InputIterator beyond, NT result, NT x_lower, NT x_upper, NT eps) {
+	void estimate(InputIterator first, InputIterator beyond, NT result, NT x_lower, NT x_upper, NT eps) {
 		Norm norm;
 		std::size_t num_elements = std::distance(first, beyond);
 		if (num_elements == 1) {
@@ -221,12 +235,7 @@ public:
 		(*this)(first, beyond, result, x_lower, x_upper, eps);
 	}
 
-	/*!
-	 *
-	 * @param first
-	 * @param beyond
-	 */
-	MLE(InputIterator first, InputIterator beyond) {
+	void estimate(InputIterator first, InputIterator beyond) {
 		Norm norm;
 		InputIterator it = first;
 		NT upper_bound = 0, squared_length = 0;
@@ -253,13 +262,266 @@ public:
 		(*this)(first, beyond, initial_estimate, MOVETK_EPS, upper_bound, MOVETK_EPS);
 	}
 
+public:
+	/*!
+	 *
+	 * @param first
+	 * @param beyond
+	 * @param result
+	 * @param x_lower
+	 * @param x_upper
+	 * @param eps
+	 */
+	MLE(InputIterator first, InputIterator beyond, NT result, NT x_lower, NT x_upper, NT eps)
+	    : m_own_workspace(std::in_place)
+	    , s(m_own_workspace->get()) {
+		estimate(first, beyond, result, x_lower, x_upper, eps);
+	}
+
+	/*!
+	 *
+	 * @param first
+	 * @param beyond
+	 */
+	MLE(InputIterator first, InputIterator beyond) : m_own_workspace(std::in_place), s(m_own_workspace->get()) {
+		estimate(first, beyond);
+	}
+
+	/*!
+	 * Estimates with the minimizer of a workspace
+	 * @param workspace The workspace, not used concurrently by other estimators
+	 * @param first
+	 * @param beyond
+	 * @param result
+	 * @param x_lower
+	 * @param x_upper
+	 * @param eps
+	 */
+	MLE(MinimizerWorkspace &workspace, InputIterator first, InputIterator beyond, NT result, NT x_lower, NT x_upper, NT eps)
+	    : s(workspace.get()) {
+		estimate(first, beyond, result, x_lower, x_upper, eps);
+	}
+
+	/*!
+	 * Estimates with the minimizer of a workspace
+	 * @param workspace The workspace, not used concurrently by other estimators
+	 * @param first
+	 * @param beyond
+	 */
+	MLE(MinimizerWorkspace &workspace, InputIterator first, InputIterator beyond) : s(workspace.get()) {
+		estimate(first, beyond);
+	}
+
 	/*!
 	 * Returns the estimated parameter
 	 * @return The estimated parameter
 	 */
 	NT operator()() const { return estimated_parameter; }
+};
+
+
+/*!
+ * @brief The sufficient statistics of a range of bridges for estimating
+ * the squared standard deviation: the number of bridges, the sum and the maximum
+ * of the squared deviations of the bridge points from their means.
+ * @tparam NT The number type
+ */
+template <class NT>
+struct SufficientStatistics {
+	std::size_t count = 0;
+	NT sum_squared_deviations = 0;
+	NT max_squared_deviation = 0;
 
-	~MLE() { gsl_min_fminimizer_free(s); }
+	/*!
+	 * Accumulates the statistics of a range of bridges
+	 * @param first Start of the range of bridges
+	 * @param beyond End of the range of bridges
+	 * @param norm The norm computing the squared length of a deviation
+	 */
+	template <class ParameterTraits, class InputIterator, class Norm>
+	void accumulate(InputIterator first, InputIterator beyond, Norm &norm) {
+		for (; first != beyond; ++first) {
+			const auto v = std::get<ParameterTraits::ParameterColumns::POINT>(*first) -
+			               std::get<ParameterTraits::ParameterColumns::MU>(*first);
+			const NT l = norm(v);
+			sum_squared_deviations += l;
+			max_squared_deviation = std::max(max_squared_deviation, l);
+			++count;
+		}
+	}
+};
+
+/*!
+ * @brief Maximum likelihood estimator of the squared standard deviation of the bridges
+ * that solves the likelihood equation in closed form.
+ * @details The negative log likelihood of \f$n\f$ bridges with sum of squared deviations \f$D\f$
+ * is \f$n \log \sigma^2 + D / (2 \sigma^2)\f$ up to a constant, which is unimodal with its minimum at
+ * \f$\sigma^2 = D / (2n)\f$. The estimate is that minimum, clamped to the search interval,
+ * which is the value MLE converges to without the iterative minimization.
+ * The estimator only keeps the sufficient statistics of the bridges and allocates nothing.
+ * @tparam GeometryTraits -   This class is a collection of movetk
+ *  geometry types.
+ * @tparam ParameterTraits -  This traits class serves as a collection of types
+ * for parameterization of BBMM
+ * @tparam Norm - The type that models Euclidean distance
+ */
+template <class GeometryTraits, concepts::ParameterTraits ParameterTraits, class Norm>
+class ClosedFormMLE {
+	using NT = typename GeometryTraits::NT;
+	NT estimated_parameter = MOVETK_EPS;
+
+	void estimate(const SufficientStatistics<NT> &statistics, NT x_lower, NT x_upper) {
+		if (statistics.count == 0 || statistics.max_squared_deviation < MOVETK_EPS) {
+			estimated_parameter = MOVETK_EPS;
+			return;
+		}
+		const NT estimate = statistics.sum_squared_deviations / (2 * statistics.count);
+		estimated_parameter = std::clamp(estimate, x_lower, std::max(x_lower, x_upper));
+	}
+
+public:
+	/*!
+	 * Estimates the parameter from the sufficient statistics of a range of bridges,
+	 * within the interval [MOVETK_EPS, largest squared deviation].
+	 * @param statistics The sufficient statistics
+	 */
+	explicit ClosedFormMLE(const SufficientStatistics<NT> &statistics) {
+		estimate(statistics, MOVETK_EPS, statistics.max_squared_deviation);
+	}
+
+	/*!
+	 * Estimates the parameter of a range of bridges, within the interval [MOVETK_EPS, largest squared deviation].
+	 * @param first Start of the range of bridges
+	 * @param beyond End of the range of bridges
+	 */
+	template <std::random_access_iterator InputIterator>
+	ClosedFormMLE(InputIterator first, InputIterator beyond) {
+		Norm norm;
+		SufficientStatistics<NT> statistics;
+		statistics.template accumulate<ParameterTraits>(first, beyond, norm);
+		estimate(statistics, MOVETK_EPS, statistics.max_squared_deviation);
+	}
+
+	/*!
+	 * Estimates the parameter of a range of bridges, within the interval [x_lower, x_upper].
+	 * @param first Start of the range of bridges
+	 * @param beyond End of the range of bridges
+	 * @param x_lower Lower bound of the parameter
+	 * @param x_upper Upper bound of the parameter
+	 */
+	template <std::random_access_iterator InputIterator>
+	ClosedFormMLE(InputIterator first, InputIterator beyond, NT x_lower, NT x_upper) {
+		Norm norm;
+		SufficientStatistics<NT> statistics;
+		statistics.template accumulate<ParameterTraits>(first, beyond, norm);
+		estimate(statistics, x_lower, x_upper);
+	}
+
+	/*!
+	 * Returns the estimated parameter
+	 * @return The estimated parameter
+	 */
+	NT operator()() const { return estimated_parameter; }
+};
+
+/*!
+ * @brief Estimates the squared standard deviations of many segments of bridges at once
+ * with ClosedFormMLE, optionally distributing the segments over a thread pool.
+ * @tparam GeometryTraits -   This class is a collection of movetk
+ *  geometry types.
+ * @tparam ParameterTraits -  This traits class serves as a collection of types
+ * for parameterization of BBMM
+ * @tparam Norm - The type that models Euclidean distance
+ */
+template <class GeometryTraits, concepts::ParameterTraits ParameterTraits, class Norm>
+class BatchMLE {
+	using NT = typename GeometryTraits::NT;
+	using Estimator = ClosedFormMLE<GeometryTraits, ParameterTraits, Norm>;
+
+	utils::ThreadPool *m_thread_pool = nullptr;
+	// Number of segments handled by a thread at a time
+	std::size_t m_chunk_size = 1024;
+
+	template <class SegmentEstimator>
+	void estimate(std::size_t num_segments, std::vector<NT> &estimates, SegmentEstimator &&segment_estimator) const {
+		estimates.resize(num_segments);
+		const std::size_t num_chunks = (num_segments + m_chunk_size - 1) / m_chunk_size;
+		auto estimate_chunk = [&](std::size_t chunk) {
+			const std::size_t beyond = std::min(num_segments, (chunk + 1) * m_chunk_size);
+			for (std::size_t i = chunk * m_chunk_size; i < beyond; ++i) {
+				estimates[i] = segment_estimator(i);
+			}
+		};
+		if (m_thread_pool != nullptr) {
+			m_thread_pool->parallel_for(0, num_chunks, estimate_chunk);
+		} else {
+			for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+				estimate_chunk(chunk);
+			}
+		}
+	}
+
+public:
+	/*!
+	 * @param thread_pool Optional thread pool to distribute the segments over
+	 */
+	explicit BatchMLE(utils::ThreadPool *thread_pool = nullptr) : m_thread_pool(thread_pool) {}
+
+	/*!
+	 * Estimates the parameter of every single bridge, as a segment of its own.
+	 * @param first Start of the range of bridges
+	 * @param beyond End of the range of bridges
+	 * @param result Output iterator for the estimates, one per bridge
+	 */
+	template <std::random_access_iterator InputIterator, utils::OutputIterator<NT> OutputIterator>
+	void operator()(InputIterator first, InputIterator beyond, OutputIterator result) const {
+		std::vector<NT> estimates;
+		estimate(std::distance(first, beyond), estimates, [first](std::size_t i) {
+			return Estimator(first + i, first + i + 1)();
+		});
+		std::copy(std::begin(estimates), std::end(estimates), result);
+	}
+
+	/*!
+	 * Estimates the parameter of consecutive segments of bridges. Segment i consists of the bridges
+	 * with indices in [offsets[i], offsets[i+1]).
+	 * @param first Start of the range of bridges
+	 * @param beyond End of the range of bridges
+	 * @param offsets_first Start of the range of segment offsets into the bridges
+	 * @param offsets_beyond End of the range of segment offsets into the bridges
+	 * @param result Output iterator for the estimates, one per segment
+	 */
+	template <std::random_access_iterator InputIterator,
+	          utils::RandomAccessIterator<std::size_t> OffsetIterator,
+	          utils::OutputIterator<NT> OutputIterator>
+	void operator()(InputIterator first,
+	                InputIterator beyond,
+	                OffsetIterator offsets_first,
+	                OffsetIterator offsets_beyond,
+	                OutputIterator result) const {
+		const std::size_t num_offsets = std::distance(offsets_first, offsets_beyond);
+		if (num_offsets < 2) {
+			return;
+		}
+		assert(static_cast<std::size_t>(std::distance(first, beyond)) >= *(offsets_beyond - 1));
+		std::vector<NT> estimates;
+		estimate(num_offsets - 1, estimates, [first, offsets_first](std::size_t i) {
+			return Estimator(first + offsets_first[i], first + offsets_first[i + 1])();
+		});
+		std::copy(std::begin(estimates), std::end(estimates), result);
+	}
+
+	/*!
+	 * Set the thread pool to distribute the segments over, or nullptr to estimate sequentially.
+	 * @param thread_pool The thread pool
+	 */
+	void set_thread_pool(utils::ThreadPool *thread_pool) { m_thread_pool = thread_pool; }
+
+	/*!
+	 * Set the number of segments handled by a thread at a time.
+	 * @param chunk_size The chunk size, at least 1
+	 */
+	void set_chunk_size(std::size_t chunk_size) { m_chunk_size = std::max<std::size_t>(chunk_size, 1); }
 };
 
 
@@ -409,9 +671,49 @@ class LogLikelihood {
 	using NT = typename GeometryTraits::NT;
 	using Parameters = typename ParameterTraits::Parameters;
 
+	// Terms of the log-likelihood that only depend on the squared standard deviation,
+	// for a fixed range of squared standard deviations.
+	std::vector<NT> m_log_terms;
+	std::vector<NT> m_twice_sigma_squared;
+
 public:
 	LogLikelihood() = default;
 
+	/**
+	 * @brief Constructs the log-likelihood for a fixed range of squared standard deviations,
+	 * for which the terms that do not depend on the parameters are precomputed.
+	 * @param first Start of standard deviation value range
+	 * @param beyond End of standard deviation value range
+	 */
+	template <utils::RandomAccessIterator<NT> InputIterator>
+	LogLikelihood(InputIterator first, InputIterator beyond) {
+		const auto size = std::distance(first, beyond);
+		m_log_terms.reserve(size);
+		m_twice_sigma_squared.reserve(size);
+		for (auto pit = first; pit != beyond; ++pit) {
+			m_log_terms.push_back(-LOG_TWO_PI - log(*pit));
+			m_twice_sigma_squared.push_back(2 * (*pit));
+		}
+	}
+
+	/**
+	 * @brief Computes the log-likelihood for the given parameters, for all squared standard deviations
+	 * given at construction.
+	 * @param params The base parameters to use
+	 * @param result Output iterator for writing the result to
+	 */
+	template <utils::OutputIterator<NT> OutputIterator>
+	void operator()(const Parameters &params, OutputIterator result) const {
+		Norm norm;
+		const auto v = std::get<ParameterTraits::ParameterColumns::POINT>(params) -
+		               std::get<ParameterTraits::ParameterColumns::MU>(params);
+		const NT squared_length = norm(v);
+		const auto size = m_log_terms.size();
+		for (std::size_t j = 0; j < size; ++j, ++result) {
+			*result = m_log_terms[j] + (-squared_length / m_twice_sigma_squared[j]);
+		}
+	}
+
 	/**
 	 * @brief Computes the log-likelihood for the given parameters, using a range of
 	 * parameter values for the squared standard deviation
@@ -433,6 +735,7 @@ public:
 			const auto operand2 = -squared_length / (2 * (*pit));
 			const auto log_likelihood = operand1 + operand2;
 			*result = log_likelihood;
+			++result;
 		}
 	}
 
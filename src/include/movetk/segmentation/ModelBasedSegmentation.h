@@ -26,6 +26,12 @@
  */
 #ifndef MOVETK_ALGO_SEGMENTATION_MODELBASEDSEGMENTATION_H
 #define MOVETK_ALGO_SEGMENTATION_MODELBASEDSEGMENTATION_H
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "movetk/Search.h"
 #include "movetk/utils/Iterators.h"
 #include "movetk/utils/Requirements.h"
@@ -39,7 +45,8 @@ namespace movetk::segmentation {
  * a single parameter. 
  * @tparam GeometryTraits 
  * @tparam LogLikelihood 
- * @complexity \f$O(nm)\f$ for a trajectory of complexity \f$n\f$ and for \f$m\f$ model parameter values.
+ * @complexity \f$O(nm)\f$ time and \f$O(n+m)\f$ memory for a trajectory of complexity \f$n\f$ and
+ * for \f$m\f$ model parameter values.
  * Based on \mtkCite{alewijnse2018model}.
 */
 template <class GeometryTraits, class LogLikelihood>
@@ -48,8 +55,6 @@ class ModelBasedSegmentation {
 
 	using NT = typename GeometryTraits::NT;
 	using Row = std::vector<typename GeometryTraits::NT>;
-	using Table = std::vector<Row>;
-	using TableIterator = typename Table::const_iterator;
 
 	struct InformationCriteria {
 		NT penalty_factor;
@@ -64,12 +69,15 @@ public:
 	explicit ModelBasedSegmentation(NT penalty_factor) { ic.penalty_factor = penalty_factor; }
 
 	/**
-	 * @brief 
-	 * @param rfirst 
-	 * @param rbeyond 
-	 * @param cfirst 
-	 * @param cbeyond 
-	 * @param result 
+	 * @brief Segments the sequence of model parameters, such that the information criterion is minimized.
+	 * @details Only two rows of the dynamic programming table are kept, together with the column
+	 * of the minimum of every row, which is all that is needed for backtracking. The index of
+	 * the minimum is stored with 16 bits when there are few enough model parameter values.
+	 * @param rfirst Start of the range of model parameters of the trajectory, for example the bridges
+	 * @param rbeyond End of the range of model parameters of the trajectory
+	 * @param cfirst Start of the range of candidate model parameter values
+	 * @param cbeyond End of the range of candidate model parameter values
+	 * @param result Output iterator for the start of the segments, written in reverse order
 	*/
 	template <std::random_access_iterator RowIterator,
 	          std::random_access_iterator ColumnIterator,
@@ -79,70 +87,74 @@ public:
 	                ColumnIterator cfirst,
 	                ColumnIterator cbeyond,
 	                OutputIterator result) {
-		LogLikelihood ll;
+		const std::size_t num_columns = std::distance(cfirst, cbeyond);
+		if (num_columns <= std::numeric_limits<std::uint16_t>::max()) {
+			segment<std::uint16_t>(rfirst, rbeyond, cfirst, cbeyond, result);
+		} else {
+			segment<std::uint32_t>(rfirst, rbeyond, cfirst, cbeyond, result);
+		}
+	}
 
-		std::size_t num_rows = std::distance(rfirst, rbeyond);
-		std::size_t num_columns = std::distance(cfirst, cbeyond);
+private:
+	template <typename ColumnIndex, typename RowIterator, typename ColumnIterator, typename OutputIterator>
+	void segment(RowIterator rfirst,
+	             RowIterator rbeyond,
+	             ColumnIterator cfirst,
+	             ColumnIterator cbeyond,
+	             OutputIterator result) {
+		const std::size_t num_rows = std::distance(rfirst, rbeyond);
+		const std::size_t num_columns = std::distance(cfirst, cbeyond);
+
+		// Log likelihoods of a row for all model parameter values. If supported, the terms that
+		// only depend on the model parameter values are computed once.
+		Row log_likelihoods(num_columns);
+		auto evaluate = [&]() {
+			if constexpr (std::constructible_from<LogLikelihood, ColumnIterator, ColumnIterator>) {
+				return [ll = LogLikelihood(cfirst, cbeyond), &log_likelihoods](const auto &row) mutable {
+					ll(row, std::begin(log_likelihoods));
+				};
+			} else {
+				return [ll = LogLikelihood(), cfirst, cbeyond, &log_likelihoods](const auto &row) mutable {
+					ll(row, cfirst, cbeyond, std::begin(log_likelihoods));
+				};
+			}
+		}();
 
-		Row dp_row;
-		Table dp_table(num_rows);
+		Row previous(num_columns), current(num_columns);
+		std::vector<ColumnIndex> row_minima(num_rows);
+		auto store_minimum = [&row_minima](std::size_t i, const Row &row) {
+			const auto min_ic = std::min_element(std::cbegin(row), std::cend(row));
+			row_minima[i] = static_cast<ColumnIndex>(std::distance(std::cbegin(row), min_ic));
+			return *min_ic;
+		};
 
 		// Fill up Dynamic Programming Table
-		ll(*rfirst, cfirst, cbeyond, std::back_inserter(dp_row));
-
-		std::transform(std::begin(dp_row), std::end(dp_row), std::begin(dp_row), ic);
-		auto min_ic = std::min_element(std::cbegin(dp_row), std::cend(dp_row));
-		std::size_t i = 0;
-		dp_table[i] = std::move(dp_row);
-		i++;
-		RowIterator rit = rfirst + 1;
-		while (rit != rbeyond) {
-			ColumnIterator cit = cfirst;
-			std::size_t j = 0;
-			Row dp_row(num_columns);
-			while (cit != cbeyond) {
-				NT log_likelihood = ll(*rit, *cit);
-				NT ic_extend = dp_table[i - 1][j];
-				NT ic_append = *min_ic + ic.penalty_factor;
-				dp_row[j] = std::min(ic_extend, ic_append) - 2 * log_likelihood;
-				cit++;
-				j++;
+		evaluate(*rfirst);
+		std::transform(std::begin(log_likelihoods), std::end(log_likelihoods), std::begin(previous), ic);
+		NT min_ic = store_minimum(0, previous);
+		std::size_t i = 1;
+		for (RowIterator rit = rfirst + 1; rit != rbeyond; ++rit, ++i) {
+			evaluate(*rit);
+			const NT ic_append = min_ic + ic.penalty_factor;
+			for (std::size_t j = 0; j < num_columns; ++j) {
+				current[j] = std::min(previous[j], ic_append) - 2 * log_likelihoods[j];
 			}
-			min_ic = std::min_element(std::cbegin(dp_row), std::cend(dp_row));
-			dp_table[i] = std::move(dp_row);
-			rit++;
-			i++;
+			min_ic = store_minimum(i, current);
+			std::swap(previous, current);
 		}
 
-		// Backtrack through the  Dynamic Programming Table
-		TableIterator table_iterator = std::cend(dp_table) - 1;
-		RowIterator parameter_iterator = rbeyond - 1;
-		auto last_min_ic = std::min_element(std::cbegin(*table_iterator), std::cend(*table_iterator));
-		std::size_t last_position = std::distance(std::cbegin(*table_iterator), last_min_ic);
-		*result = parameter_iterator;
-
+		// Backtrack through the minima of the rows
+		*result = rbeyond - 1;
 		if (num_rows == 1)
 			return;
 
-		table_iterator--;
-		parameter_iterator--;
-
-		while (table_iterator != std::cbegin(dp_table)) {
-			min_ic = std::min_element(std::cbegin(*table_iterator), std::cend(*table_iterator));
-			std::size_t position = std::distance(std::cbegin(*table_iterator), min_ic);
+		std::size_t last_position = row_minima[num_rows - 1];
+		for (std::size_t row = num_rows - 1; row-- > 0;) {
+			const std::size_t position = row_minima[row];
 			if (last_position != position) {
-				*result = parameter_iterator;
+				*result = rfirst + row;
 			}
 			last_position = position;
-			table_iterator--;
-			parameter_iterator--;
-		}
-
-		min_ic = std::min_element(std::cbegin(*table_iterator), std::cend(*table_iterator));
-		std::size_t position = std::distance(std::cbegin(*table_iterator), min_ic);
-
-		if (last_position != position) {
-			*result = parameter_iterator;
 		}
 	}
 };
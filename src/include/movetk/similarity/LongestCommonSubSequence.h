@@ -26,10 +26,17 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <optional>
+#include <vector>
 
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/utils/AlgorithmUtils.h"
+#include "movetk/utils/Instrumentation.h"
 #include "movetk/utils/Iterators.h"
 #include "movetk/utils/Requirements.h"
 
@@ -41,6 +48,10 @@ namespace movetk::similarity {
  * @brief Functor for computing the longest common subsequence
  * @details Implementation is based on doi=10.1.1.78.240
  * http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.78.240&rep=rep1&type=pdf
+ * Since two elements can only be matched when their indices differ by less than delta,
+ * only the cells of the dynamic program inside the band |i - j| < delta are evaluated,
+ * which results in O(n * delta) time. When only the length is required, the band is
+ * processed with the bit-parallel formulation of Hyyro (doi=10.1007/978-3-540-27801-6_18).
  * @tparam GeometryTraits The kernel to use
  * @tparam Norm The norm to use
  */
@@ -66,7 +77,15 @@ public:
 		del = delta;
 	}
 
-	
+	/**
+	 * @brief Computes the longest common subsequence between two polylines
+	 * @param polyline_a_first Start of the first polyline
+	 * @param polyline_a_beyond End of the first polyline
+	 * @param polyline_b_first Start of the second polyline
+	 * @param polyline_b_beyond End of the second polyline
+	 * @param result Output iterator for the pairs of matched elements
+	 * @return The length of the longest common subsequence
+	 */
 	template <utils::RandomAccessIterator<typename GeometryTraits::MovetkPoint> InputIterator,
 	          utils::OutputIterator<std::pair<InputIterator, InputIterator>> OutputIterator>
 	std::size_t operator()(InputIterator polyline_a_first,
@@ -77,19 +96,49 @@ public:
 		utils::Output<OutputIterator> outputter(result);
 		return compute_lcss(polyline_a_first, polyline_a_beyond, polyline_b_first, polyline_b_beyond, outputter);
 	}
+
+	/**
+	 * @brief Computes the length of the longest common subsequence between two polylines
+	 * @param polyline_a_first Start of the first polyline
+	 * @param polyline_a_beyond End of the first polyline
+	 * @param polyline_b_first Start of the second polyline
+	 * @param polyline_b_beyond End of the second polyline
+	 * @return The length of the longest common subsequence
+	 */
 	template <utils::RandomAccessIterator<typename GeometryTraits::MovetkPoint> InputIterator>
 	std::size_t operator()(InputIterator polyline_a_first,
 	                       InputIterator polyline_a_beyond,
 	                       InputIterator polyline_b_first,
 	                       InputIterator polyline_b_beyond) {
-		utils::Output<void> stub;
-		return compute_lcss(polyline_a_first, polyline_a_beyond, polyline_b_first, polyline_b_beyond, stub);
+		return compute_lcss_length(polyline_a_first, polyline_a_beyond, polyline_b_first, polyline_b_beyond, std::nullopt);
+	}
+
+	/**
+	 * @brief Decides whether the longest common subsequence between two polylines has at least the given length.
+	 * @details Stops as soon as the threshold is reached, or as soon as the remaining elements of
+	 * the first polyline can no longer make up for the difference.
+	 * @param polyline_a_first Start of the first polyline
+	 * @param polyline_a_beyond End of the first polyline
+	 * @param polyline_b_first Start of the second polyline
+	 * @param polyline_b_beyond End of the second polyline
+	 * @param threshold The length to test for
+	 * @return Whether the length of the longest common subsequence is at least threshold
+	 */
+	template <utils::RandomAccessIterator<typename GeometryTraits::MovetkPoint> InputIterator>
+	bool at_least(InputIterator polyline_a_first,
+	              InputIterator polyline_a_beyond,
+	              InputIterator polyline_b_first,
+	              InputIterator polyline_b_beyond,
+	              std::size_t threshold) {
+		return compute_lcss_length(polyline_a_first, polyline_a_beyond, polyline_b_first, polyline_b_beyond, threshold) >=
+		    threshold;
 	}
 
 private:
 	/**
 	 * @brief Predicate for determining whether two values can be matched
 	 * @tparam VALUE_TYPE The value type to use
+	 * @param norm The norm to measure the distance with
 	 * @param i Index of the first element
 	 * @param i_value Value of the first element
 	 * @param j Index of the second element
@@ -97,30 +146,63 @@ private:
 	 * @return Whether these elements can be matched
 	*/
 	template <typename VALUE_TYPE>
-	bool lcss_predicate(size_t i, const VALUE_TYPE& i_value, size_t j, const VALUE_TYPE& j_value) {
+	bool lcss_predicate(Norm& norm, size_t i, const VALUE_TYPE& i_value, size_t j, const VALUE_TYPE& j_value) const {
+		if (unsigned_abs(i, j) >= del) {
+			return false;
+		}
 		auto v = i_value - j_value;
-		Norm norm;
-		NT distance = norm(v);
-		return distance < eps && unsigned_abs(i, j) < del;
+		return norm(v) < eps;
 	}
 
+	/**
+	 * @brief Returns the first column of the band for the given row, 1-based.
+	 * @param i The row, 1-based
+	 */
+	std::size_t band_begin(std::size_t i) const { return i < del ? 1 : i - del + 1; }
+
+	/**
+	 * @brief Returns the last column of the band for the given row, 1-based and clamped to the number of columns.
+	 * @param i The row, 1-based
+	 * @param columns The number of columns
+	 */
+	std::size_t band_end(std::size_t i, std::size_t columns) const {
+		return std::min(columns, i + std::min(del - 1, columns));
+	}
+
+	/**
+	 * @brief Banded dynamic program for the longest common subsequence.
+	 * @details Only keeps a single row of the table. Cells left of the band keep the value of
+	 * the last row they were part of, the cell right of the band is kept equal to the last cell of the band.
+	 */
 	template <utils::RandomAccessIterator<typename GeometryTraits::MovetkPoint> InputIterator, typename OutputType>
 	size_t compute_lcss(InputIterator polyline_a_first,
 	                    InputIterator polyline_a_beyond,
 	                    InputIterator polyline_b_first,
 	                    InputIterator polyline_b_beyond,
 	                    utils::Output<OutputType>& output) {
-		std::size_t size_polyline_b = std::distance(polyline_b_first, polyline_b_beyond);
-		std::vector<std::size_t> dp_row(size_polyline_b + 1);
-		std::fill(std::begin(dp_row), std::begin(dp_row) + size_polyline_b + 1, 0);
+		if (del == 0) {
+			return 0;
+		}
+		const std::size_t size_polyline_a = std::distance(polyline_a_first, polyline_a_beyond);
+		const std::size_t size_polyline_b = std::distance(polyline_b_first, polyline_b_beyond);
+		std::vector<std::size_t> dp_row(size_polyline_b + 2, 0);
+		Norm norm;
 		InputIterator it_a = polyline_a_first;
 		std::size_t i = 1, prev_value = 0, prev_cell = 0;
 
 		[[maybe_unused]] std::vector<std::pair<InputIterator, InputIterator>> stored_output;
 		for (; it_a != polyline_a_beyond; ++it_a, ++i) {
-			std::size_t j = 1, previous = 0, current = 0;
-			for (auto it_b = polyline_b_first; it_b != polyline_b_beyond; ++it_b, ++j) {
-				if (lcss_predicate(i, *it_a, j, *it_b)) {
+			const std::size_t first = band_begin(i);
+			const std::size_t last = band_end(i, size_polyline_b);
+			if (first > last) {
+				// The band has moved beyond the second polyline, all columns are final.
+				break;
+			}
+			MOVETK_COUNT_N(DpCellsEvaluated, last - first + 1);
+			std::size_t j = first, previous = dp_row[first - 1], current = 0;
+			auto it_b = polyline_b_first + (first - 1);
+			for (; j <= last; ++it_b, ++j) {
+				if (lcss_predicate(norm, i, *it_a, j, *it_b)) {
 					current = dp_row[j - 1] + 1;
 					if (current != prev_value) {
 						prev_value = current;
@@ -145,11 +227,76 @@ private:
 				previous = current;
 			}
 			dp_row[j - 1] = previous;
+			// Extend the last cell of the band to the right, such that the next row sees the correct value.
+			dp_row[j] = previous;
 		}
 		if constexpr (output.requires_output()) {
 			std::copy(stored_output.begin(), stored_output.end(), output.target);
 		}
-		return dp_row.back();
+		return dp_row[band_end(size_polyline_a, size_polyline_b)];
+	}
+
+	/**
+	 * @brief Bit-parallel computation of the length of the longest common subsequence restricted to the band.
+	 * @details Every column of the table is represented by a bit of V, where the number of zero bits equals
+	 * the length of the LCSS. Words left of the band are never modified and do not emit a carry, words right
+	 * of the band have never been part of a band and therefore consist of ones only, which are invariant under
+	 * the update. Hence only the words overlapping the band are updated.
+	 * @param threshold If given, stops early when this length is reached or has become unreachable
+	 * @return The length of the LCSS. When stopped early, a lower bound that is at least the threshold,
+	 * or a value below the threshold.
+	 */
+	template <utils::RandomAccessIterator<typename GeometryTraits::MovetkPoint> InputIterator>
+	size_t compute_lcss_length(InputIterator polyline_a_first,
+	                           InputIterator polyline_a_beyond,
+	                           InputIterator polyline_b_first,
+	                           InputIterator polyline_b_beyond,
+	                           std::optional<std::size_t> threshold) {
+		using Word = std::uint64_t;
+		constexpr std::size_t word_bits = std::numeric_limits<Word>::digits;
+		if (del == 0 || threshold == 0) {
+			return 0;
+		}
+		const std::size_t size_polyline_a = std::distance(polyline_a_first, polyline_a_beyond);
+		const std::size_t size_polyline_b = std::distance(polyline_b_first, polyline_b_beyond);
+		std::vector<Word> v((size_polyline_b + word_bits - 1) / word_bits, ~Word(0));
+		std::vector<Word> matches;
+		Norm norm;
+		std::size_t length = 0;
+		std::size_t i = 1;
+		for (auto it_a = polyline_a_first; it_a != polyline_a_beyond; ++it_a, ++i) {
+			const std::size_t first = band_begin(i);
+			const std::size_t last = band_end(i, size_polyline_b);
+			if (first > last) {
+				break;
+			}
+			MOVETK_COUNT_N(DpCellsEvaluated, last - first + 1);
+			const std::size_t first_word = (first - 1) / word_bits;
+			const std::size_t last_word = (last - 1) / word_bits;
+			matches.assign(last_word - first_word + 1, 0);
+			auto it_b = polyline_b_first + (first - 1);
+			for (std::size_t j = first; j <= last; ++j, ++it_b) {
+				if (lcss_predicate(norm, i, *it_a, j, *it_b)) {
+					const std::size_t bit = j - 1;
+					matches[bit / word_bits - first_word] |= Word(1) << (bit % word_bits);
+				}
+			}
+			Word carry = 0;
+			for (std::size_t w = first_word; w <= last_word; ++w) {
+				const Word old_v = v[w];
+				const Word m = matches[w - first_word];
+				const Word u = old_v & m;
+				const Word sum = old_v + u;
+				const Word total = sum + carry;
+				carry = static_cast<Word>(sum < old_v) | static_cast<Word>(total < sum);
+				v[w] = total | (old_v & ~m);
+				length += static_cast<std::size_t>(std::popcount(old_v)) - static_cast<std::size_t>(std::popcount(v[w]));
+			}
+			if (threshold && (length >= *threshold || length + (size_polyline_a - i) < *threshold)) {
+				break;
+			}
+		}
+		return length;
 	}
 };
 }  // namespace movetk::similarity
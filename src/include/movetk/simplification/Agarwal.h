@@ -28,6 +28,7 @@
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/metric/DistanceInterface.h"
 #include "movetk/metric/Norm.h"
+#include "movetk/utils/Instrumentation.h"
 #include "movetk/utils/Iterators.h"
 #include "movetk/utils/Requirements.h"
 
@@ -95,6 +96,7 @@ public:
 		segment[0] = *curr;
 
 		while (true) {
+			MOVETK_COUNT(AgarwalSearchSteps);
 			// The bounds to search in when the Frechet predicate fails
 			std::size_t searchLower = offset / 2;
 			std::size_t searchUpper = offset;
@@ -105,6 +107,9 @@ public:
 				segment[1] = *(std::prev(beyond));
 
 				// If the segment to the end point is within epsilon or we only have one segment left, we are done
+				if (offset != 2) {
+					MOVETK_COUNT(AgarwalDecideCalls);
+				}
 				if (offset == 2 || m_strong_frechet_distance.decide(segment.begin(), segment.end(), curr, beyond, m_epsilon)) {
 					*result = std::prev(beyond);
 					break;
@@ -119,6 +124,7 @@ public:
 			// Iterator to the point to check
 			auto nextPointIt = curr + searchUpper + 1;
 			// Distance is larger than epsilon
+			MOVETK_COUNT(AgarwalDecideCalls);
 			if (!m_strong_frechet_distance.decide(segment.begin(), segment.end(), curr, nextPointIt, m_epsilon)) {
 				auto upper = binary_search_for_violating_point(searchLower, searchUpper, segment, curr);
 				// Assign the output
@@ -158,6 +164,8 @@ private:
 		while (upper > lower + 1) {
 			auto mid = (lower + upper) / 2;  // Floored when uneven.
 			segment_to_check[1] = *(curr + mid);
+			MOVETK_COUNT(AgarwalSearchSteps);
+			MOVETK_COUNT(AgarwalDecideCalls);
 			// Higher than epsilon
 			if (!m_strong_frechet_distance
 			         .decide(segment_to_check.begin(), segment_to_check.end(), curr, curr + mid + 1, m_epsilon)) {
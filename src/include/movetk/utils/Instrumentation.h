@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file Instrumentation.h
+ *  @brief  Counters and scoped timers for the hot paths of MoveTk
+ */
+
+#ifndef MOVETK_UTILS_INSTRUMENTATION_H
+#define MOVETK_UTILS_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Set to 1 to record the counters and timers at the instrumented points of the library.
+ * When 0, the MOVETK_COUNT and MOVETK_SCOPED_TIMER macros compile to nothing.
+ */
+#ifndef MOVETK_INSTRUMENTATION
+#define MOVETK_INSTRUMENTATION 0
+#endif
+
+namespace movetk::utils::instrumentation {
+
+/**
+ * @brief Whether the instrumented points of the library record anything
+ */
+constexpr bool enabled = MOVETK_INSTRUMENTATION != 0;
+
+/**
+ * @brief Monotonically increasing counters at the instrumented points
+ */
+enum class Counter : std::size_t {
+	// Rows read by csv::read_row
+	CsvRowsParsed,
+	// Calls to the decision procedure of StrongFrechet
+	FrechetDecideCalls,
+	// Candidate epsilons probed by the searches of StrongFrechet
+	FrechetEpsilonIterations,
+	// Strong Frechet decisions made by Agarwal
+	AgarwalDecideCalls,
+	// Steps of the exponential and binary searches of Agarwal
+	AgarwalSearchSteps,
+	// Calls to geo::distance_exact
+	GeodesicDistanceCalls,
+	// Cells of the dynamic programming tables of the discrete Frechet distance and LCSS
+	DpCellsEvaluated,
+	// Trajectories emitted by Splitter
+	SplitterSegmentsEmitted,
+	NumCounters
+};
+
+/**
+ * @brief Scoped timers at the instrumented points
+ */
+enum class Timer : std::size_t {
+	// csv::read_row
+	CsvReadRow,
+	// Parsing a ParseDate from a stream
+	DateParse,
+	// geo::distance_exact
+	GeodesicDistance,
+	// The decision procedure of StrongFrechet
+	FrechetDecide,
+	NumTimers
+};
+
+constexpr std::size_t NUM_COUNTERS = static_cast<std::size_t>(Counter::NumCounters);
+constexpr std::size_t NUM_TIMERS = static_cast<std::size_t>(Timer::NumTimers);
+
+constexpr std::array<std::string_view, NUM_COUNTERS> COUNTER_NAMES = {"csv_rows_parsed",
+                                                                      "frechet_decide_calls",
+                                                                      "frechet_epsilon_iterations",
+                                                                      "agarwal_decide_calls",
+                                                                      "agarwal_search_steps",
+                                                                      "geodesic_distance_calls",
+                                                                      "dp_cells_evaluated",
+                                                                      "splitter_segments_emitted"};
+constexpr std::array<std::string_view, NUM_TIMERS> TIMER_NAMES = {"csv_read_row",
+                                                                  "date_parse",
+                                                                  "geodesic_distance",
+                                                                  "frechet_decide"};
+
+/**
+ * @brief Accumulated measurements of a timer
+ */
+struct TimerValue {
+	std::uint64_t calls = 0;
+	std::uint64_t nanoseconds = 0;
+};
+
+/**
+ * @brief The counters and timers summed over all threads at some moment
+ */
+class Snapshot {
+public:
+	std::uint64_t counter(Counter counter) const { return m_counters[static_cast<std::size_t>(counter)]; }
+
+	TimerValue timer(Timer timer) const { return m_timers[static_cast<std::size_t>(timer)]; }
+
+	/**
+	 * @brief Returns the measurements since an earlier snapshot, for example to report per batch of a long running job
+	 * @param earlier The earlier snapshot
+	 */
+	Snapshot operator-(const Snapshot &earlier) const {
+		Snapshot difference;
+		for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+			difference.m_counters[i] = m_counters[i] - earlier.m_counters[i];
+		}
+		for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+			difference.m_timers[i].calls = m_timers[i].calls - earlier.m_timers[i].calls;
+			difference.m_timers[i].nanoseconds = m_timers[i].nanoseconds - earlier.m_timers[i].nanoseconds;
+		}
+		return difference;
+	}
+
+	/**
+	 * @brief Writes the snapshot as a JSON object of the form
+	 * {"counters":{"csv_rows_parsed":10,...},"timers":{"csv_read_row":{"calls":10,"nanoseconds":1200},...}}
+	 * @param out The stream to write to
+	 */
+	void to_json(std::ostream &out) const {
+		out << "{\"counters\":{";
+		for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+			out << (i == 0 ? "" : ",") << '"' << COUNTER_NAMES[i] << "\":" << m_counters[i];
+		}
+		out << "},\"timers\":{";
+		for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+			out << (i == 0 ? "" : ",") << '"' << TIMER_NAMES[i] << "\":{\"calls\":" << m_timers[i].calls
+			    << ",\"nanoseconds\":" << m_timers[i].nanoseconds << '}';
+		}
+		out << "}}";
+	}
+
+	/**
+	 * @brief Writes the snapshot in the Prometheus text exposition format. Every counter becomes a metric
+	 * <prefix>_<name>_total, the timers become the metrics <prefix>_timer_calls_total and
+	 * <prefix>_timer_seconds_total labelled with the name of the timer.
+	 * @param out The stream to write to
+	 * @param prefix Prefix of the metric names
+	 */
+	void to_prometheus(std::ostream &out, std::string_view prefix = "movetk") const {
+		for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+			out << "# TYPE " << prefix << '_' << COUNTER_NAMES[i] << "_total counter\n";
+			out << prefix << '_' << COUNTER_NAMES[i] << "_total " << m_counters[i] << '\n';
+		}
+		out << "# TYPE " << prefix << "_timer_calls_total counter\n";
+		for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+			out << prefix << "_timer_calls_total{timer=\"" << TIMER_NAMES[i] << "\"} " << m_timers[i].calls << '\n';
+		}
+		out << "# TYPE " << prefix << "_timer_seconds_total counter\n";
+		for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+			out << prefix << "_timer_seconds_total{timer=\"" << TIMER_NAMES[i] << "\"} "
+			    << static_cast<double>(m_timers[i].nanoseconds) * 1e-9 << '\n';
+		}
+	}
+
+private:
+	friend class Registry;
+	std::array<std::uint64_t, NUM_COUNTERS> m_counters{};
+	std::array<TimerValue, NUM_TIMERS> m_timers{};
+};
+
+/**
+ * @brief Measurements of a single thread. Only the owning thread writes to the slots, so an increment is
+ * a relaxed load and store rather than a locked read-modify-write, while other threads can still read
+ * the slots for a snapshot.
+ */
+class ThreadSlots {
+public:
+	void add(Counter counter, std::uint64_t amount) { add(m_counters[static_cast<std::size_t>(counter)], amount); }
+
+	void add(Timer timer, std::uint64_t nanoseconds) {
+		add(m_timer_calls[static_cast<std::size_t>(timer)], 1);
+		add(m_timer_nanoseconds[static_cast<std::size_t>(timer)], nanoseconds);
+	}
+
+private:
+	friend class Registry;
+	std::array<std::atomic<std::uint64_t>, NUM_COUNTERS> m_counters{};
+	std::array<std::atomic<std::uint64_t>, NUM_TIMERS> m_timer_calls{};
+	std::array<std::atomic<std::uint64_t>, NUM_TIMERS> m_timer_nanoseconds{};
+
+	static void add(std::atomic<std::uint64_t> &slot, std::uint64_t amount) {
+		slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+};
+
+/**
+ * @brief Process wide registry of the slots of all threads. The measurements of exited threads
+ * are kept, so snapshots never decrease.
+ */
+class Registry {
+public:
+	static Registry &instance() {
+		static Registry registry;
+		return registry;
+	}
+
+	void attach(ThreadSlots *slots) {
+		std::lock_guard lock(m_mutex);
+		m_threads.push_back(slots);
+	}
+
+	void detach(ThreadSlots *slots) {
+		std::lock_guard lock(m_mutex);
+		accumulate(*slots, m_retired);
+		m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), slots), m_threads.end());
+	}
+
+	Snapshot snapshot() {
+		std::lock_guard lock(m_mutex);
+		Snapshot result = m_retired;
+		for (const auto *slots : m_threads) {
+			accumulate(*slots, result);
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Sets all measurements to zero. Measurements made concurrently may be lost.
+	 */
+	void reset() {
+		std::lock_guard lock(m_mutex);
+		m_retired = Snapshot();
+		for (auto *slots : m_threads) {
+			for (auto &slot : slots->m_counters) {
+				slot.store(0, std::memory_order_relaxed);
+			}
+			for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+				slots->m_timer_calls[i].store(0, std::memory_order_relaxed);
+				slots->m_timer_nanoseconds[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	std::mutex m_mutex;
+	std::vector<ThreadSlots *> m_threads;
+	Snapshot m_retired;
+
+	static void accumulate(const ThreadSlots &slots, Snapshot &result) {
+		for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+			result.m_counters[i] += slots.m_counters[i].load(std::memory_order_relaxed);
+		}
+		for (std::size_t i = 0; i < NUM_TIMERS; ++i) {
+			result.m_timers[i].calls += slots.m_timer_calls[i].load(std::memory_order_relaxed);
+			result.m_timers[i].nanoseconds += slots.m_timer_nanoseconds[i].load(std::memory_order_relaxed);
+		}
+	}
+};
+
+/**
+ * @brief Returns the slots of the calling thread, registered on first use
+ */
+inline ThreadSlots &local_slots() {
+	struct Handle {
+		ThreadSlots slots;
+		Handle() { Registry::instance().attach(&slots); }
+		~Handle() { Registry::instance().detach(&slots); }
+	};
+	thread_local Handle handle;
+	return handle.slots;
+}
+
+/**
+ * @brief Increments a counter of the calling thread
+ * @param counter The counter
+ * @param amount The increment
+ */
+inline void count(Counter counter, std::uint64_t amount = 1) { local_slots().add(counter, amount); }
+
+/**
+ * @brief Adds the lifetime of the object to a timer of the calling thread
+ */
+class ScopedTimer {
+public:
+	explicit ScopedTimer(Timer timer) : m_timer(timer), m_start(std::chrono::steady_clock::now()) {}
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+	~ScopedTimer() {
+		const auto elapsed = std::chrono::steady_clock::now() - m_start;
+		local_slots().add(m_timer,
+		                  static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+	}
+
+private:
+	Timer m_timer;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Returns the measurements of all threads so far
+ */
+inline Snapshot snapshot() { return Registry::instance().snapshot(); }
+
+/**
+ * @brief Sets all measurements to zero
+ */
+inline void reset() { Registry::instance().reset(); }
+
+}  // namespace movetk::utils::instrumentation
+
+#define MOVETK_INSTRUMENTATION_CONCAT_IMPL(a, b) a##b
+#define MOVETK_INSTRUMENTATION_CONCAT(a, b) MOVETK_INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+#if MOVETK_INSTRUMENTATION
+/**
+ * @brief Increments the instrumentation counter with the given name by one
+ */
+#define MOVETK_COUNT(name) ::movetk::utils::instrumentation::count(::movetk::utils::instrumentation::Counter::name)
+/**
+ * @brief Increments the instrumentation counter with the given name by amount
+ */
+#define MOVETK_COUNT_N(name, amount) \
+	::movetk::utils::instrumentation::count(::movetk::utils::instrumentation::Counter::name, (amount))
+/**
+ * @brief Adds the time until the end of the enclosing scope to the instrumentation timer with the given name
+ */
+#define MOVETK_SCOPED_TIMER(name)                                                                   \
+	const ::movetk::utils::instrumentation::ScopedTimer MOVETK_INSTRUMENTATION_CONCAT(movetk_timer_, \
+	                                                                                  __LINE__)(     \
+	    ::movetk::utils::instrumentation::Timer::name)
+#else
+#define MOVETK_COUNT(name) static_cast<void>(0)
+#define MOVETK_COUNT_N(name, amount) static_cast<void>(0)
+#define MOVETK_SCOPED_TIMER(name) static_cast<void>(0)
+#endif
+
+#endif  // MOVETK_UTILS_INSTRUMENTATION_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+/*! @file Philox.h
+ *  @brief  Counter-based Philox random number generator
+ */
+
+#ifndef MOVETK_UTILS_PHILOX_H
+#define MOVETK_UTILS_PHILOX_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+
+namespace movetk::utils {
+/**
+ * @brief The Philox4x32-10 generator of Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (2011).
+ * @details The generator encrypts a 128 bit counter with a 64 bit key. The key is the seed and the upper
+ * half of the counter selects a stream, so every (seed, stream) pair gives an independent sequence
+ * that can be created in any thread without coordination, for example one stream per trajectory.
+ * Models UniformRandomBitGenerator, so it can be used with the distributions of the standard library.
+ * Those distributions are implementation defined however; use uniform() and normal() for sequences
+ * that are identical on every platform.
+ */
+class Philox4x32 {
+public:
+	using result_type = std::uint32_t;
+	using Block = std::array<std::uint32_t, 4>;
+	using Key = std::array<std::uint32_t, 2>;
+
+	/**
+	 * @brief Construct the generator
+	 * @param seed The seed, used as key
+	 * @param stream Index of the stream
+	 */
+	explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+	    : m_key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+	      m_stream(stream) {}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()() {
+		if (m_position == 4) {
+			m_block = generate(m_counter++);
+			m_position = 0;
+		}
+		return m_block[m_position++];
+	}
+
+	/**
+	 * @brief Skips the next count numbers in constant time
+	 * @param count The number of numbers to skip
+	 */
+	void discard(std::uint64_t count) {
+		const auto available = static_cast<std::uint64_t>(4 - m_position);
+		if (count <= available) {
+			m_position += static_cast<unsigned>(count);
+			return;
+		}
+		count -= available;
+		m_counter += count / 4;
+		m_block = generate(m_counter++);
+		m_position = static_cast<unsigned>(count % 4);
+	}
+
+	/**
+	 * @brief Returns a uniformly distributed number in [0, 1) with 53 random bits
+	 */
+	double uniform() {
+		const auto high = static_cast<std::uint64_t>((*this)() >> 5);
+		const auto low = static_cast<std::uint64_t>((*this)() >> 6);
+		return static_cast<double>((high << 26) | low) * 0x1.0p-53;
+	}
+
+	/**
+	 * @brief Returns a uniformly distributed number in [a, b)
+	 */
+	double uniform(double a, double b) { return a + (b - a) * uniform(); }
+
+	/**
+	 * @brief Returns true with the given probability
+	 */
+	bool bernoulli(double probability) { return uniform() < probability; }
+
+	/**
+	 * @brief Returns a normally distributed number, using the Box-Muller transform
+	 * @param mean The mean
+	 * @param sigma The standard deviation
+	 */
+	double normal(double mean = 0, double sigma = 1) {
+		if (m_has_spare) {
+			m_has_spare = false;
+			return mean + sigma * m_spare;
+		}
+		const auto radius = std::sqrt(-2 * std::log(1 - uniform()));
+		const auto angle = 2 * std::numbers::pi * uniform();
+		m_spare = radius * std::sin(angle);
+		m_has_spare = true;
+		return mean + sigma * radius * std::cos(angle);
+	}
+
+	/**
+	 * @brief Applies the Philox4x32-10 bijection to a counter block
+	 * @param counter The counter
+	 * @param key The key
+	 * @return The random block
+	 */
+	static constexpr Block bijection(Block counter, Key key) {
+		constexpr std::uint64_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+		constexpr std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+		for (int round = 0; round < 10; ++round) {
+			if (round > 0) {
+				key[0] += W0;
+				key[1] += W1;
+			}
+			const auto product0 = M0 * counter[0];
+			const auto product1 = M1 * counter[2];
+			counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+			           static_cast<std::uint32_t>(product1),
+			           static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+			           static_cast<std::uint32_t>(product0)};
+		}
+		return counter;
+	}
+
+private:
+	Key m_key;
+	std::uint64_t m_stream;
+	std::uint64_t m_counter = 0;
+	Block m_block{};
+	unsigned m_position = 4;
+	double m_spare = 0;
+	bool m_has_spare = false;
+
+	Block generate(std::uint64_t counter) const {
+		return bijection({static_cast<std::uint32_t>(counter),
+		                  static_cast<std::uint32_t>(counter >> 32),
+		                  static_cast<std::uint32_t>(m_stream),
+		                  static_cast<std::uint32_t>(m_stream >> 32)},
+		                 m_key);
+	}
+};
+}  // namespace movetk::utils
+#endif  // MOVETK_UTILS_PHILOX_H
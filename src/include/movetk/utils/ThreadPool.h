@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#ifndef MOVETK_UTILS_THREADPOOL_H
+#define MOVETK_UTILS_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace movetk::utils {
+/**
+ * @brief Fixed size pool of worker threads for data parallel loops.
+ * @details The pool executes one loop at a time: parallel_for() hands out the indices
+ * of the loop to the workers and to the calling thread, and returns when all indices are processed.
+ * The first exception thrown by the loop body is rethrown in the calling thread.
+ * parallel_for() should not be called concurrently on the same pool, nor from within a loop body.
+ */
+class ThreadPool {
+public:
+	/**
+	 * @brief Construct the pool
+	 * @param num_threads Total number of threads taking part in a loop, including the calling thread.
+	 * Defaults to the hardware concurrency.
+	 */
+	explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency()) {
+		num_threads = std::max<std::size_t>(num_threads, 1);
+		m_workers.reserve(num_threads - 1);
+		for (std::size_t i = 1; i < num_threads; ++i) {
+			m_workers.emplace_back([this] { work(); });
+		}
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto &worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	/**
+	 * @brief Returns the number of threads taking part in a loop, including the calling thread.
+	 */
+	std::size_t size() const { return m_workers.size() + 1; }
+
+	/**
+	 * @brief Calls body(i) for every i in [first, beyond), distributed over the threads of the pool.
+	 * @param first First index
+	 * @param beyond One beyond the last index
+	 * @param body Callable taking the index
+	 */
+	template <typename Body>
+	void parallel_for(std::size_t first, std::size_t beyond, Body &&body) {
+		if (beyond <= first) {
+			return;
+		}
+		if (m_workers.empty() || beyond - first == 1) {
+			for (auto i = first; i < beyond; ++i) {
+				body(i);
+			}
+			return;
+		}
+		std::atomic<std::size_t> next{first};
+		std::exception_ptr error;
+		std::mutex error_mutex;
+		m_task = [&]() {
+			for (auto i = next++; i < beyond; i = next++) {
+				try {
+					body(i);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (!error) {
+						error = std::current_exception();
+					}
+					// Make the other threads stop handing out indices
+					next = beyond;
+				}
+			}
+		};
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busy = m_workers.size();
+			++m_generation;
+		}
+		m_wake.notify_all();
+		m_task();
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [this] { return m_busy == 0; });
+		}
+		m_task = nullptr;
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+private:
+	void work() {
+		std::size_t seen_generation = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this, seen_generation] { return m_stop || m_generation != seen_generation; });
+				if (m_stop) {
+					return;
+				}
+				seen_generation = m_generation;
+			}
+			m_task();
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				--m_busy;
+			}
+			m_done.notify_one();
+		}
+	}
+
+	std::vector<std::thread> m_workers;
+	std::function<void()> m_task;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	std::size_t m_generation = 0;
+	std::size_t m_busy = 0;
+	bool m_stop = false;
+};
+}  // namespace movetk::utils
+#endif  // MOVETK_UTILS_THREADPOOL_H
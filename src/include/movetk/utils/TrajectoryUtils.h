@@ -288,8 +288,7 @@ void get_speeds(InputIterator first, InputIterator beyond) {
 	while (++it != beyond - 1) {
 		p = get_point<Traits>(std::get<LatIdx>(*it), std::get<LonIdx>(*it), ref);
 		typename Traits::MovetkVector v = p - prev;
-		typename Traits::NT squared_length = norm(v);
-		typename Traits::NT length = norm ^ 1;
+		typename Traits::NT length = norm.evaluate(v) ^ 1;
 		typename Traits::NT delta_t = std::get<TsIdx>(*it) - std::get<TsIdx>(*(it - 1));
 		typename Traits::NT speed_v = length / delta_t;
 		std::get<SpeedIdx>(*it) = speed_v;
@@ -24,6 +24,8 @@
 #ifndef MOVETK_TRANSPOSE_H
 #define MOVETK_TRANSPOSE_H
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -42,18 +44,47 @@ struct Transpose {
 	std::vector<typename std::tuple_element<idx, std::tuple<FIELDS...>>::type> convert_rows_to_column() {
 		using type = typename std::tuple_element<idx, std::tuple<FIELDS...>>::type;
 		std::vector<type> v;
-		for (auto x : _inp) {
+		v.reserve(_inp.size());
+		for (const auto &x : _inp) {
 			v.push_back(std::get<idx>(x));
 		}
 		return v;
 	}
 
+	/**
+	 * @brief Writes a column into an existing vector, assigning to its elements where possible
+	 * so their storage is reused
+	 */
+	template <std::size_t idx>
+	void convert_rows_to_column(std::vector<typename std::tuple_element<idx, std::tuple<FIELDS...>>::type> &column) {
+		const auto n = std::min(column.size(), _inp.size());
+		for (std::size_t i = 0; i < n; ++i) {
+			column[i] = std::get<idx>(_inp[i]);
+		}
+		column.erase(column.begin() + static_cast<std::ptrdiff_t>(n), column.end());
+		column.reserve(_inp.size());
+		for (std::size_t i = n; i < _inp.size(); ++i) {
+			column.push_back(std::get<idx>(_inp[i]));
+		}
+	}
+
 	template <std::size_t... idx>
 	tuple_of_vectors_type convert_rows_to_columns(std::index_sequence<idx...>) {
 		return std::make_tuple(convert_rows_to_column<idx>()...);
 	}
 
+	template <std::size_t... idx>
+	void convert_rows_to_columns(tuple_of_vectors_type &columns, std::index_sequence<idx...>) {
+		(convert_rows_to_column<idx>(std::get<idx>(columns)), ...);
+	}
+
 	tuple_of_vectors_type operator()() { return convert_rows_to_columns(std::make_index_sequence<N>{}); }
+
+	/**
+	 * @brief Transposes the rows into existing columns, reusing their storage
+	 * @param columns The columns
+	 */
+	void operator()(tuple_of_vectors_type &columns) { convert_rows_to_columns(columns, std::make_index_sequence<N>{}); }
 };
 }  // namespace movetk::utils
 #endif  // MOVETK_TRANSPOSE_H
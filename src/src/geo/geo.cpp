@@ -21,6 +21,7 @@
 // Created by onur on 11/8/18.
 //
 #include "movetk/geo/geo.h"
+#include "movetk/utils/Instrumentation.h"
 
 #include <iostream>
 #include <cmath>
@@ -32,6 +33,8 @@ using namespace GeographicLib;
 
 namespace movetk::geo {
 double distance_exact(double lat0, double lon0, double lat1, double lon1) {
+    MOVETK_COUNT(GeodesicDistanceCalls);
+    MOVETK_SCOPED_TIMER(GeodesicDistance);
     const Geodesic& geod = Geodesic::WGS84();
     double s12;
     geod.Inverse(lat0, lon0, lat1, lon1, s12);
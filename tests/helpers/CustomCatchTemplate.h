@@ -3,8 +3,11 @@
 #include <catch2/catch.hpp>
 #include "../test_includes.h"
 
+// Unlike TEMPLATE_LIST_TEST_CASE_METHOD, which declares the test struct at global scope with a counter based name,
+// the test structs are declared in an anonymous namespace. Otherwise structs with the same name in different test
+// files violate the one definition rule and the linker keeps the test body of only one of them.
 #define MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(test_class, test_name, test_tags) \
-	TEMPLATE_LIST_TEST_CASE_METHOD(test_class, test_name, test_tags, movetk::test::AvailableBackends)
+	MOVETK_TEMPLATED_BACKEND_TEST_CASE_METHOD(test_class, (), test_name, test_tags)
 #define MOVETK_TEMPLATE_LIST_TEST_CASE(test_name, test_tags) \
 	TEMPLATE_LIST_TEST_CASE(test_name, test_tags, movetk::test::AvailableBackends)
 
@@ -38,12 +41,14 @@
 	CATCH_INTERNAL_START_WARNINGS_SUPPRESSION                                                                           \
 	CATCH_INTERNAL_SUPPRESS_GLOBALS_WARNINGS                                                                            \
 	CATCH_INTERNAL_SUPPRESS_UNUSED_TEMPLATE_WARNINGS                                                                    \
+	namespace {                                                                                                         \
 	template <typename TestType>                                                                                        \
 	struct TestName : public INTERNAL_CATCH_REMOVE_PARENS(ClassName<TestType>) {                                        \
 		using Fixture = INTERNAL_CATCH_REMOVE_PARENS(ClassName<TestType>);                                                \
 		MOVETK_CONCAT(MOVETK_EXPAND, Definitions)                                                                         \
 		void test();                                                                                                      \
 	};                                                                                                                  \
+	}                                                                                                                   \
 	namespace {                                                                                                         \
 	namespace INTERNAL_CATCH_MAKE_NAMESPACE(TestName) {                                                                 \
 		INTERNAL_CATCH_TYPE_GEN                                                                                           \
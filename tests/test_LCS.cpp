@@ -149,4 +149,64 @@ MOVETK_TEMPLATE_LIST_TEST_CASE("Check Longest Common Subsequence 3", "[longest_c
 	                                                   typename MovetkGeometryKernel::MovetkPoint>);*/
 	REQUIRE(lcs_length == 0);
 	REQUIRE(output.size() == 0);
-}
\ No newline at end of file
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Check banded Longest Common Subsequence against full table",
+                               "[longest_common_sense_banded]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Norm = movetk::metric::FiniteNorm<MovetkGeometryKernel, 2>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+	typedef std::vector<typename MovetkGeometryKernel::MovetkPoint> PolyLine;
+
+	// Two zigzag polylines of different length, such that the band is clamped at both sides.
+	PolyLine polyline1, polyline2;
+	for (std::size_t i = 0; i < 150; ++i) {
+		polyline1.push_back(make_point({static_cast<NT>(i), static_cast<NT>((i * 7) % 5)}));
+	}
+	for (std::size_t i = 0; i < 90; ++i) {
+		polyline2.push_back(make_point({static_cast<NT>(i) + 0.5, static_cast<NT>((i * 3) % 4)}));
+	}
+	const NT eps = 1.5;
+
+	for (std::size_t delta : {0, 1, 3, 10, 70, 200}) {
+		// Reference: full table
+		Norm norm;
+		std::vector<std::vector<std::size_t>> table(polyline1.size() + 1,
+		                                            std::vector<std::size_t>(polyline2.size() + 1, 0));
+		for (std::size_t i = 1; i <= polyline1.size(); ++i) {
+			for (std::size_t j = 1; j <= polyline2.size(); ++j) {
+				auto v = polyline1[i - 1] - polyline2[j - 1];
+				const std::size_t index_distance = i > j ? i - j : j - i;
+				if (index_distance < delta && norm(v) < eps) {
+					table[i][j] = table[i - 1][j - 1] + 1;
+				} else {
+					table[i][j] = std::max(table[i - 1][j], table[i][j - 1]);
+				}
+			}
+		}
+		const std::size_t expected = table.back().back();
+
+		movetk::similarity::LongestCommonSubSequence<MovetkGeometryKernel, Norm> lcs(eps, delta);
+		std::vector<std::pair<typename PolyLine::const_iterator, typename PolyLine::const_iterator>> output;
+		REQUIRE(lcs(std::cbegin(polyline1),
+		            std::cend(polyline1),
+		            std::cbegin(polyline2),
+		            std::cend(polyline2),
+		            std::back_inserter(output)) == expected);
+		REQUIRE(lcs(std::cbegin(polyline1), std::cend(polyline1), std::cbegin(polyline2), std::cend(polyline2)) ==
+		        expected);
+		REQUIRE(lcs(std::cbegin(polyline2), std::cend(polyline2), std::cbegin(polyline1), std::cend(polyline1)) ==
+		        expected);
+		REQUIRE(lcs.at_least(std::cbegin(polyline1),
+		                     std::cend(polyline1),
+		                     std::cbegin(polyline2),
+		                     std::cend(polyline2),
+		                     expected));
+		REQUIRE(!lcs.at_least(std::cbegin(polyline1),
+		                      std::cend(polyline1),
+		                      std::cbegin(polyline2),
+		                      std::cend(polyline2),
+		                      expected + 1));
+	}
+}
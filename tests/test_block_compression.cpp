@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "movetk/io/BlockCompression.h"
+#include "movetk/io/ParseDate.h"
+#include "movetk/io/ProbeReader.h"
+#include "movetk/io/ProbeTraits.h"
+#include "movetk/io/SyntheticTrajectoryGenerator.h"
+
+using movetk::io::Compression;
+
+namespace {
+std::string synthetic_csv(std::size_t num_trajectories) {
+	movetk::io::SyntheticTrajectoryOptions options;
+	options.min_samples = 50;
+	options.max_samples = 150;
+	std::ostringstream csv;
+	movetk::io::SyntheticTrajectoryGenerator(options).write_csv(csv, num_trajectories);
+	return csv.str();
+}
+
+template <class Encoder>
+std::string compress(const std::string& data, std::size_t num_threads, Encoder encoder = Encoder()) {
+	auto sink = std::make_unique<std::ostringstream>(std::ios_base::out | std::ios_base::binary);
+	auto* compressed = sink.get();
+	movetk::io::CompressingOstream<Encoder> out(std::move(sink), std::move(encoder), num_threads);
+	// Written in pieces of varying size, crossing block boundaries
+	for (std::size_t first = 0, piece = 1; first < data.size(); first += piece, piece = piece * 7 % 100003 + 1) {
+		out.write(data.data() + first, static_cast<std::streamsize>(std::min(piece, data.size() - first)));
+	}
+	out.close();
+	return compressed->str();
+}
+
+std::string decompress(const std::string& data, std::size_t num_threads) {
+	auto in = std::make_unique<std::istringstream>(data, std::ios_base::in | std::ios_base::binary);
+	const auto compression = movetk::io::detect_compression(*in);
+	auto decompressed = movetk::io::decompress(std::move(in), compression, num_threads);
+	std::string out;
+	char buffer[4096];
+	while (decompressed->read(buffer, sizeof(buffer)) || decompressed->gcount() > 0) {
+		out.append(buffer, static_cast<std::size_t>(decompressed->gcount()));
+	}
+	return out;
+}
+}  // namespace
+
+TEST_CASE("BGZF round trip", "[block_compression]") {
+	const auto csv = synthetic_csv(300);
+	REQUIRE(csv.size() > 1000000);
+	const auto bgzf = compress<movetk::io::compression::BgzfEncoder>(csv, 4);
+	REQUIRE(bgzf.size() < csv.size() / 2);
+	REQUIRE(compress<movetk::io::compression::BgzfEncoder>(csv, 1) == bgzf);
+
+	std::istringstream detect(bgzf);
+	REQUIRE(movetk::io::detect_compression(detect) == Compression::Bgzf);
+	for (std::size_t num_threads : {1, 3, 8}) {
+		REQUIRE(decompress(bgzf, num_threads) == csv);
+	}
+
+	// BGZF is valid multi-member gzip
+	std::istringstream gzip_in(bgzf, std::ios_base::in | std::ios_base::binary);
+	boost::iostreams::filtering_istream gzip;
+	gzip.push(boost::iostreams::gzip_decompressor());
+	gzip.push(gzip_in);
+	std::ostringstream restored;
+	boost::iostreams::copy(gzip, restored);
+	REQUIRE(restored.str() == csv);
+
+	SECTION("Corrupt input") {
+		auto corrupt = bgzf;
+		corrupt[corrupt.size() / 2] ^= 0x55;
+		REQUIRE_THROWS(decompress(corrupt, 2));
+		REQUIRE_THROWS(decompress(bgzf.substr(0, bgzf.size() / 3), 2));
+	}
+
+	SECTION("Inconsistent ISIZE") {
+		movetk::io::compression::BgzfDecoder decoder;
+		std::istringstream in(bgzf, std::ios_base::in | std::ios_base::binary);
+		std::string block, out;
+		REQUIRE(decoder.read_block(in, block));
+		const auto set_isize = [](std::string& block, std::uint32_t size) {
+			for (std::size_t i = 0; i < 4; ++i) {
+				block[block.size() - 4 + i] = static_cast<char>((size >> (8 * i)) & 0xff);
+			}
+		};
+		auto copy = block;
+		decoder.decode(copy, out);
+		const auto size = static_cast<std::uint32_t>(out.size());
+		for (std::uint32_t isize : {size - 1, size + 1, std::uint32_t{1} << 16 | 1, std::uint32_t{0xffffffff}}) {
+			copy = block;
+			set_isize(copy, isize);
+			REQUIRE_THROWS_WITH(decoder.decode(copy, out), Catch::Contains("BGZF block"));
+		}
+	}
+
+	SECTION("Empty input") {
+		const auto empty = compress<movetk::io::compression::BgzfEncoder>("", 2);
+		REQUIRE(empty.size() == 28);
+		REQUIRE(decompress(empty, 2).empty());
+	}
+}
+
+TEST_CASE("Closing a compressed stream reports write errors", "[block_compression]") {
+	// A sink that rejects all output
+	struct FailingStreambuf : std::streambuf {
+		int_type overflow(int_type) override { return traits_type::eof(); }
+	} failing;
+	auto sink = std::make_unique<std::ostream>(&failing);
+	movetk::io::CompressingOstream<movetk::io::compression::BgzfEncoder> out(std::move(sink), movetk::io::compression::BgzfEncoder(), 2);
+	out << "id,lat,lon\n";
+	REQUIRE_THROWS_WITH(out.close(), "Failed to write compressed output");
+	REQUIRE_THROWS_WITH(out.close(), "Failed to write compressed output");
+}
+
+TEST_CASE("Closing an uncompressed output file reports write errors", "[block_compression]") {
+	if (!std::filesystem::exists("/dev/full")) {
+		return;
+	}
+	auto out = movetk::io::open_compressed("/dev/full", 1);
+	*out << std::string(1 << 16, 'x');
+	REQUIRE_THROWS_WITH(out->close(), "Failed to write output");
+}
+
+TEST_CASE("Multi-member gzip is decompressed", "[block_compression]") {
+	movetk::io::SyntheticTrajectoryOptions options;
+	options.min_samples = 50;
+	options.max_samples = 150;
+	movetk::io::SyntheticTrajectoryGenerator generator(options);
+	std::ostringstream csv, gzip(std::ios_base::out | std::ios_base::binary);
+	generator.write_csv(csv, 300);
+	generator.write_gzip_csv(gzip, 300);
+
+	std::istringstream detect(gzip.str());
+	REQUIRE(movetk::io::detect_compression(detect) == Compression::Gzip);
+	REQUIRE(decompress(gzip.str(), 4) == csv.str());
+	REQUIRE_THROWS(decompress(gzip.str().substr(0, gzip.str().size() - 100), 4));
+
+	std::istringstream plain(csv.str());
+	REQUIRE(movetk::io::detect_compression(plain) == Compression::None);
+	REQUIRE(plain.tellg() == 0);
+}
+
+#ifdef MOVETK_WITH_ZSTD
+TEST_CASE("zstd round trip", "[block_compression]") {
+	const auto csv = synthetic_csv(300);
+	const movetk::io::compression::ZstdEncoder encoder(3, 100000);
+	const auto zstd = compress(csv, 4, encoder);
+	REQUIRE(zstd.size() < csv.size() / 2);
+	REQUIRE(compress(csv, 1, encoder) == zstd);
+	// Seekable format footer
+	REQUIRE(movetk::io::compression::read_le32(reinterpret_cast<const unsigned char*>(zstd.data() + zstd.size() - 4)) ==
+	        0x8F92EAB1);
+
+	std::istringstream detect(zstd);
+	REQUIRE(movetk::io::detect_compression(detect) == Compression::Zstd);
+	for (std::size_t num_threads : {1, 3, 8}) {
+		REQUIRE(decompress(zstd, num_threads) == csv);
+	}
+	REQUIRE_THROWS(decompress(zstd.substr(0, zstd.size() / 2), 2));
+
+	SECTION("Implausible content size") {
+		// Single segment frame claiming 2^60 bytes of content, followed by one raw block of 1 byte
+		const std::string frame("\x28\xb5\x2f\xfd\xe0\0\0\0\0\0\0\0\x10\x09\0\0x", 17);
+		REQUIRE_THROWS_WITH(decompress(frame, 2), Catch::Contains("zstd frame"));
+	}
+}
+#endif
+
+TEST_CASE("ProbeReaderFactory dispatches on the compression", "[block_compression]") {
+	using Row = std::tuple<std::string, movetk::io::ParseDate, double, double, double, double, std::string>;
+	using ProbeCsv = movetk::io::csv::csv<Row, 0, 2, 3>;
+	using ProbeTraits = movetk::io::_ProbeTraits<void, ProbeCsv, Row>;
+
+	const auto csv = synthetic_csv(20);
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto plain_file = (directory / "movetk_test_probes.csv").string();
+	const auto bgzf_file = (directory / "movetk_test_probes.csv.gz").string();
+	std::ofstream(plain_file) << csv;
+	{
+		auto out = movetk::io::open_compressed(bgzf_file, 2);
+		*out << csv;
+		out->close();
+	}
+
+	auto count_rows = [](const std::string& file_name) {
+		auto reader = movetk::io::ProbeReaderFactory::create<ProbeTraits>(file_name, 3);
+		std::size_t rows = 0;
+		double latitude_sum = 0;
+		for (auto it = reader->begin(); it != reader->end(); ++it) {
+			latitude_sum += std::get<1>(*it);
+			++rows;
+		}
+		return std::make_pair(rows, latitude_sum);
+	};
+	const auto expected = count_rows(plain_file);
+	REQUIRE(expected.first > 20 * 50);
+	REQUIRE(count_rows(bgzf_file) == expected);
+	REQUIRE_THROWS_AS(movetk::io::ProbeReaderFactory::create<ProbeTraits>((directory / "missing.csv.gz").string()),
+	                  std::invalid_argument);
+
+	std::filesystem::remove(plain_file);
+	std::filesystem::remove(bgzf_file);
+}
@@ -28,6 +28,7 @@
 
 #include <array>
 #include <catch2/catch.hpp>
+#include <thread>
 #include <vector>
 
 #include "helpers/CustomCatchTemplate.h"
@@ -35,7 +36,9 @@
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/metric/Norm.h"
 #include "movetk/segmentation/BrownianBridge.h"
+#include "movetk/segmentation/ModelBasedSegmentation.h"
 #include "movetk/utils/Iterators.h"
+#include "movetk/utils/ThreadPool.h"
 #include "movetk/utils/TrajectoryUtils.h"
 
 template <typename Backend>
@@ -63,6 +66,18 @@ struct BrownianBridgeTests {
 	using Projection = movetk::geo::LocalCoordinateReference<NT>;
 };
 
+namespace {
+// Exposes only the range evaluation of a log likelihood, so that ModelBasedSegmentation cannot
+// precompute the terms of the candidate values.
+template <class LogLikelihood>
+struct RangeLogLikelihood {
+	template <typename Parameters, typename InputIterator, typename OutputIterator>
+	void operator()(const Parameters &params, InputIterator first, InputIterator beyond, OutputIterator result) {
+		LogLikelihood()(params, first, beyond, result);
+	}
+};
+}  // namespace
+
 MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(BrownianBridgeTests, "brownian bridge mle 1", "[test brownian bridge mle 1]") {
 	using Fixture = BrownianBridgeTests<TestType>;
 	typename Fixture::Norm norm;
@@ -124,6 +139,42 @@ MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(BrownianBridgeTests, "brownian bridge mle
 	REQUIRE(std::abs(mle() - 50.25) < MOVETK_EPS);
 }
 
+MOVETK_TEMPLATE_LIST_TEST_CASE("brownian bridge mle with workspaces", "[test brownian bridge mle with workspaces]") {
+	using Fixture = BrownianBridgeTests<TestType>;
+	using Ts = typename Fixture::EmptyTrajectoryTs;
+	using NT = typename Fixture::NT;
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+
+	typename Ts::Trajectory t = {};
+	std::vector<typename Ts::Parameters> bridges;
+	for (int i = 0; i < 40; ++i) {
+		bridges.emplace_back(make_point({0, static_cast<NT>(i % 7 + 1)}), make_point({0, 0}), 0, t.begin(), t.begin());
+	}
+	std::vector<NT> expected;
+	for (auto it = std::cbegin(bridges); it != std::cend(bridges); ++it) {
+		expected.push_back(typename Ts::MLE(it, it + 1)());
+	}
+
+	// One workspace per thread, reused for all estimates of that thread
+	std::vector<NT> actual(bridges.size());
+	std::vector<std::thread> threads;
+	for (std::size_t thread = 0; thread < 4; ++thread) {
+		threads.emplace_back([&, thread]() {
+			movetk::segmentation::brownian_bridge::MinimizerWorkspace workspace;
+			for (std::size_t i = thread; i < bridges.size(); i += 4) {
+				actual[i] = typename Ts::MLE(workspace, std::cbegin(bridges) + i, std::cbegin(bridges) + i + 1)();
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	for (std::size_t i = 0; i < bridges.size(); ++i) {
+		REQUIRE(actual[i] == expected[i]);
+	}
+}
+
 
 MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(BrownianBridgeTests,
                                       "brownian bridge model 1",
@@ -299,3 +350,136 @@ MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(BrownianBridgeTests,
 		std::cout << "Coefficient: " << coeff << "\n";
 	}
 }
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("brownian bridge precomputed log likelihood",
+                               "[test brownian bridge precomputed log likelihood]") {
+	using Fixture = BrownianBridgeTests<TestType>;
+	using Ts = typename Fixture::EmptyTrajectoryTs;
+	using NT = typename Fixture::NT;
+	using LogLikelihood = movetk::segmentation::brownian_bridge::
+	    LogLikelihood<typename Fixture::MovetkGeometryKernel, typename Ts::ParameterTraits, typename Fixture::Norm>;
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+
+	typename Ts::Trajectory t = {};
+	typename Ts::Parameters bridge{make_point({10, 20}), make_point({20, 10}), 0, t.begin(), t.begin()};
+	const std::vector<NT> coefficients{0.5, 2, 13.25, 100, 1000};
+
+	std::vector<NT> expected, actual(coefficients.size());
+	LogLikelihood()(bridge, std::cbegin(coefficients), std::cend(coefficients), std::back_inserter(expected));
+	LogLikelihood(std::cbegin(coefficients), std::cend(coefficients))(bridge, std::begin(actual));
+	for (std::size_t i = 0; i < coefficients.size(); ++i) {
+		REQUIRE(std::abs(actual[i] - expected[i]) < MOVETK_EPS);
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("brownian bridge segmentation with a range log likelihood",
+                               "[test brownian bridge segmentation with a range log likelihood]") {
+	using Fixture = BrownianBridgeTests<TestType>;
+	using Ts = typename Fixture::EmptyTrajectoryTs;
+	using NT = typename Fixture::NT;
+	using LogLikelihood = movetk::segmentation::brownian_bridge::
+	    LogLikelihood<typename Fixture::MovetkGeometryKernel, typename Ts::ParameterTraits, typename Fixture::Norm>;
+	using Segmentation = movetk::segmentation::ModelBasedSegmentation<typename Fixture::MovetkGeometryKernel,
+	                                                                  LogLikelihood>;
+	using RangeSegmentation = movetk::segmentation::
+	    ModelBasedSegmentation<typename Fixture::MovetkGeometryKernel, RangeLogLikelihood<LogLikelihood>>;
+	static_assert(!std::constructible_from<RangeLogLikelihood<LogLikelihood>,
+	                                       typename std::vector<NT>::const_iterator,
+	                                       typename std::vector<NT>::const_iterator>);
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+
+	// Bridges that deviate little from their mean, followed by bridges that deviate a lot
+	typename Ts::Trajectory t = {};
+	std::vector<typename Ts::Parameters> bridges;
+	for (std::size_t i = 0; i < 20; ++i) {
+		const NT offset = i < 10 ? 0.5 : 20;
+		bridges.emplace_back(make_point({offset, 0}), make_point({0, 0}), 0, t.begin(), t.begin());
+	}
+	const std::vector<NT> coefficients{0.5, 2, 13.25, 100, 1000};
+
+	std::vector<typename Ts::BridgeIterator> expected, actual;
+	Segmentation(10)(std::cbegin(bridges),
+	                 std::cend(bridges),
+	                 std::cbegin(coefficients),
+	                 std::cend(coefficients),
+	                 std::back_inserter(expected));
+	RangeSegmentation(10)(std::cbegin(bridges),
+	                      std::cend(bridges),
+	                      std::cbegin(coefficients),
+	                      std::cend(coefficients),
+	                      std::back_inserter(actual));
+	REQUIRE(expected.size() == 2);
+	REQUIRE(actual == expected);
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("brownian bridge closed form mle", "[test brownian bridge closed form mle]") {
+	using Fixture = BrownianBridgeTests<TestType>;
+	using Ts = typename Fixture::EmptyTrajectoryTs;
+	using ClosedFormMLE = movetk::segmentation::brownian_bridge::
+	    ClosedFormMLE<typename Fixture::MovetkGeometryKernel, typename Ts::ParameterTraits, typename Fixture::Norm>;
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+
+	typename Ts::Trajectory t = {};
+	std::vector<typename Ts::Parameters> bridges{
+	    {make_point({0, 1}), make_point({0, 0}), 0, t.begin(), t.begin()},
+	    {make_point({10, 20}), make_point({20, 10}), 0, t.begin(), t.begin()},
+	    {make_point({3, 3}), make_point({3, 3}), 0, t.begin(), t.begin()}};
+
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin(), bridges.cbegin() + 1)() - 0.5) < MOVETK_EPS);
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin() + 1, bridges.cbegin() + 2)() - 100) < MOVETK_EPS);
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin(), bridges.cbegin() + 2)() - 50.25) < MOVETK_EPS);
+	// A degenerate bridge gets the smallest parameter, as with MLE
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin() + 2, bridges.cend())() - MOVETK_EPS) < MOVETK_EPS);
+	// The estimate is clamped to the search interval
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin(), bridges.cbegin() + 2, 60, 200)() - 60) < MOVETK_EPS);
+
+	// Agrees with the iterative estimator
+	typename Ts::MLE mle(std::cbegin(bridges), std::cend(bridges));
+	REQUIRE(std::abs(ClosedFormMLE(bridges.cbegin(), bridges.cend())() - mle()) < 0.01);
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("brownian bridge batch mle", "[test brownian bridge batch mle]") {
+	using Fixture = BrownianBridgeTests<TestType>;
+	using Ts = typename Fixture::EmptyTrajectoryTs;
+	using NT = typename Fixture::NT;
+	using ClosedFormMLE = movetk::segmentation::brownian_bridge::
+	    ClosedFormMLE<typename Fixture::MovetkGeometryKernel, typename Ts::ParameterTraits, typename Fixture::Norm>;
+	using BatchMLE = movetk::segmentation::brownian_bridge::
+	    BatchMLE<typename Fixture::MovetkGeometryKernel, typename Ts::ParameterTraits, typename Fixture::Norm>;
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+
+	typename Ts::Trajectory t = {};
+	std::vector<typename Ts::Parameters> bridges;
+	for (std::size_t i = 0; i < 5000; ++i) {
+		const NT x = static_cast<NT>(i % 17), y = static_cast<NT>(i % 11);
+		bridges.emplace_back(make_point({x, y}), make_point({y, x + 1}), 0, t.begin(), t.begin());
+	}
+	std::vector<std::size_t> offsets{0};
+	while (offsets.back() < bridges.size()) {
+		offsets.push_back(std::min(bridges.size(), offsets.back() + 1 + offsets.size() % 7));
+	}
+
+	movetk::utils::ThreadPool pool(4);
+	for (movetk::utils::ThreadPool *thread_pool : {static_cast<movetk::utils::ThreadPool *>(nullptr), &pool}) {
+		BatchMLE batch(thread_pool);
+		batch.set_chunk_size(100);
+
+		std::vector<NT> per_bridge;
+		batch(bridges.cbegin(), bridges.cend(), std::back_inserter(per_bridge));
+		REQUIRE(per_bridge.size() == bridges.size());
+		for (std::size_t i = 0; i < bridges.size(); ++i) {
+			REQUIRE(per_bridge[i] == ClosedFormMLE(bridges.cbegin() + i, bridges.cbegin() + i + 1)());
+		}
+
+		std::vector<NT> per_segment;
+		batch(bridges.cbegin(), bridges.cend(), offsets.cbegin(), offsets.cend(), std::back_inserter(per_segment));
+		REQUIRE(per_segment.size() == offsets.size() - 1);
+		for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+			REQUIRE(per_segment[i] == ClosedFormMLE(bridges.cbegin() + offsets[i], bridges.cbegin() + offsets[i + 1])());
+		}
+	}
+}
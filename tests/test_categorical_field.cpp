@@ -22,7 +22,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
-#include <sstream>
+#include <thread>
+#include <vector>
 using std::string;
 
 #include "movetk/io/CategoricalField.h"
@@ -54,3 +55,48 @@ TEST_CASE( "Categorical field", "[categoricalfield]" ) {
     os << c3;
     REQUIRE( os.str() == "Provider1" );
 }
+
+TEST_CASE( "Categorical fields with their own dictionary", "[categoricalfield]" ) {
+    using Field = movetk::io::CategoricalField<std::string, CategoricalStringField>;
+    Field::Dictionary first, second;
+
+    Field a(first, "LongProviderName2");
+    Field b(second, "Provider3");
+    Field c(second);
+    std::istringstream is("LongProviderName2");
+    is >> c;
+
+    REQUIRE( a.idx() == 0 );
+    REQUIRE( b.idx() == 0 );
+    REQUIRE( c.idx() == 1 );
+    REQUIRE( &c.dictionary() == &second );
+    REQUIRE( a.value() == "LongProviderName2" );
+    REQUIRE( c.value() == "LongProviderName2" );
+    REQUIRE( first.size() == 1 );
+    REQUIRE( second.size() == 2 );
+    REQUIRE( &Field().dictionary() == &Field::default_dictionary() );
+}
+
+class ConcurrentCategoricalField : public movetk::io::CategoricalField<std::string, ConcurrentCategoricalField> {};
+
+TEST_CASE( "Categorical field parsed concurrently", "[categoricalfield]" ) {
+    std::vector<std::thread> threads;
+    std::vector<std::vector<ConcurrentCategoricalField>> fields(4, std::vector<ConcurrentCategoricalField>(100));
+    for (std::size_t t = 0; t < fields.size(); ++t) {
+        threads.emplace_back([&fields, t]() {
+            for (std::size_t i = 0; i < fields[t].size(); ++i) {
+                std::istringstream is("Provider" + std::to_string((i + t) % 10));
+                is >> fields[t][i];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (std::size_t t = 0; t < fields.size(); ++t) {
+        for (std::size_t i = 0; i < fields[t].size(); ++i) {
+            REQUIRE( fields[t][i].idx() < 10 );
+            REQUIRE( fields[t][i].value() == "Provider" + std::to_string((i + t) % 10) );
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "movetk/ds/GeohashIndex.h"
+#include "movetk/ds/Tree.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace {
+template <class T>
+class Values {
+private:
+	std::string id;
+	std::vector<T> values;
+
+public:
+	typedef typename std::vector<T>::const_iterator Iterator;
+
+	Values(const std::string& identifier) : id(identifier) {}
+
+	void operator()(const T& value) { values.push_back(value); }
+
+	const std::string& operator()() { return id; }
+	Iterator begin() const { return cbegin(values); }
+
+	Iterator end() const { return cend(values); }
+};
+}  // namespace
+
+TEST_CASE("Create and search in a geohash index", "[test_geohash_index]") {
+	movetk::ds::GeohashIndex<int> index;
+	{
+		const std::string str = "u1hx";
+		index.insert(begin(str), end(str), 1);
+	}
+	{
+		const std::string str = "u1hyb";
+		index.insert(begin(str), end(str), 2);
+		index.insert(begin(str), end(str), 4);
+	}
+
+	const std::string search_str = "u1hxcj";
+	const auto result = index.find(cbegin(search_str), cend(search_str));
+	REQUIRE(index.get_match_size() == 4);
+	REQUIRE(result.size == 4);
+	REQUIRE(std::distance(result.v_begin(), result.v_end()) == 1);
+	REQUIRE(*result.v_begin() == 1);
+
+	// A matched prefix that is not an indexed geohash has no values
+	const std::string inner_str = "u1hy";
+	const auto inner = index.find(cbegin(inner_str), cend(inner_str));
+	REQUIRE(inner.size == 4);
+	REQUIRE(inner.v_begin() == inner.v_end());
+
+	const std::string other_str = "gbsu";
+	index.find(cbegin(other_str), cend(other_str));
+	REQUIRE(index.get_match_size() == 0);
+
+	std::vector<std::pair<std::string, size_t>> leaves;
+	index.find(std::back_inserter(leaves));
+	REQUIRE(leaves.size() == 2);
+	REQUIRE(leaves[0].first == "u1hx");
+	REQUIRE(leaves[0].second == 1);
+	REQUIRE(leaves[1].first == "u1hyb");
+	REQUIRE(leaves[1].second == 2);
+
+	// Geohashes longer than MAX_LENGTH, or outside the alphabet, are rejected instead of truncated
+	const std::string longest_str = "u1hxcjkmnpqr";
+	const std::string too_long_str = longest_str + "s";
+	const std::string invalid_str = "u1ha";
+	REQUIRE_NOTHROW(index.find(cbegin(longest_str), cend(longest_str)));
+	REQUIRE_THROWS_AS(index.find(cbegin(too_long_str), cend(too_long_str)), std::invalid_argument);
+	REQUIRE_THROWS_AS(index.insert(cbegin(too_long_str), cend(too_long_str), 5), std::invalid_argument);
+	REQUIRE_THROWS_AS(index.find(cbegin(invalid_str), cend(invalid_str)), std::invalid_argument);
+	const std::vector<std::string> queries{longest_str, too_long_str};
+	std::vector<movetk::ds::GeohashIndex<int>::Match> matches;
+	movetk::utils::ThreadPool pool(2);
+	REQUIRE_THROWS_AS(index.find(cbegin(queries), cend(queries), std::back_inserter(matches), &pool),
+	                  std::invalid_argument);
+}
+
+TEST_CASE("Geohash index agrees with the trie", "[test_geohash_index]") {
+	typedef movetk::ds::TrieNode<const char, Values<int>> Node;
+	movetk::ds::Tree<Node> tree(std::make_unique<Node>('a'));
+	movetk::ds::GeohashIndex<int> index;
+
+	const std::string alphabet = "0123456789bcdefghjkmnpqrstuvwxyz";
+	std::mt19937 generator(17);
+	// A small alphabet prefix makes shared prefixes likely
+	std::uniform_int_distribution<std::size_t> character(0, 3), length(1, 8);
+	auto random_geohash = [&](std::size_t size) {
+		std::string geohash;
+		for (std::size_t i = 0; i < size; ++i) {
+			geohash += alphabet[character(generator) + (i % 2) * 20];
+		}
+		return geohash;
+	};
+
+	// Leaves of the trie must have the indexed length, so all inserted geohashes have the same length
+	for (int value = 0; value < 200; ++value) {
+		const auto geohash = random_geohash(6);
+		tree.insert(cbegin(geohash), cend(geohash), value);
+		index.insert(cbegin(geohash), cend(geohash), value);
+	}
+
+	std::vector<std::string> queries;
+	for (int i = 0; i < 1000; ++i) {
+		queries.push_back(random_geohash(length(generator)));
+	}
+
+	movetk::utils::ThreadPool pool(4);
+	std::vector<movetk::ds::GeohashIndex<int>::Match> matches;
+	index.find(cbegin(queries), cend(queries), std::back_inserter(matches), &pool);
+	REQUIRE(matches.size() == queries.size());
+
+	for (std::size_t i = 0; i < queries.size(); ++i) {
+		const auto& query = queries[i];
+		auto& node = tree.find(cbegin(query), cend(query));
+		const auto match = index.find(cbegin(query), cend(query));
+		REQUIRE(index.get_match_size() == tree.get_match_size());
+		REQUIRE(matches[i].size == match.size);
+		if (match.size == 6) {
+			REQUIRE(std::equal(match.v_begin(), match.v_end(), node->v_begin(), node->v_end()));
+			REQUIRE(std::equal(matches[i].v_begin(), matches[i].v_end(), node->v_begin(), node->v_end()));
+		} else {
+			REQUIRE(match.v_begin() == match.v_end());
+		}
+	}
+
+	std::vector<std::pair<std::string, size_t>> tree_leaves, index_leaves;
+	tree.find(std::back_inserter(tree_leaves));
+	index.find(std::back_inserter(index_leaves));
+	REQUIRE(tree_leaves == index_leaves);
+}
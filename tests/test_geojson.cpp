@@ -1,9 +1,14 @@
 #include <array>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "catch2/catch.hpp"
 #include "movetk/io/GeoJSON.h"
+#include "movetk/io/GeoJSONWriter.h"
+#include "movetk/utils/ThreadPool.h"
 #include "helpers/CustomCatchTemplate.h"
 using namespace rapidjson;
 
@@ -57,4 +62,99 @@ TEST_CASE("Test GeoJSON", "[test_geojson]") {
 	std::cout << geojson << std::endl;
 
 	REQUIRE(expected_geojson.compare(geojson) == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test streaming GeoJSON", "[test_geojson]") {
+	using Properties = std::vector<std::pair<std::string, std::string>>;
+	struct LineString {
+		std::vector<double> lat, lon;
+		Properties properties;
+	};
+	const std::vector<LineString> line_strings{
+	    {{0.0, 1.0, 0.0, 1.0},
+	     {102.0, 103.0, 104.0, 105.0},
+	     {{"id", "a1398a11-d1ce-421c-bf66-a456ff525de9"}, {"stroke", "red"}, {"stroke-width", "4"}}},
+	    {{0.0, 0.0, 1.0, 1.0},
+	     {100.0, 101.0, 101.0, 100.0},
+	     {{"id", "d1ce-a1398a11-421c-bf66-a456ff525de9"}, {"stroke", "blue"}, {"stroke-width", "6"}}}};
+	auto serialize = [](const LineString& line_string, movetk::io::GeoJSONFeatureWriter& writer) {
+		writer.line_string(std::begin(line_string.lat),
+		                   std::end(line_string.lat),
+		                   std::begin(line_string.lon),
+		                   std::begin(line_string.properties),
+		                   std::end(line_string.properties));
+	};
+
+	SECTION("Same output as the document based serialization") {
+		const std::string expected_geojson =
+		    "{\"type\":\"FeatureCollection\",\"features\":\
+[{\"type\":\"Feature\",\"geometry\":{\"coordinates\":[[102.0,0.0],[103.0,1.0],[104.0,0.0],[105.0,1.0]],\"type\"\
+:\"LineString\"},\"properties\":{\"id\":\"a1398a11-d1ce-421c-bf66-a456ff525de9\",\"stroke\":\"red\",\"stroke-width\":\"4\"}},\
+{\"type\":\"Feature\",\"geometry\":{\"coordinates\":[[100.0,0.0],[101.0,0.0],[101.0,1.0],[100.0,1.0]],\
+\"type\":\"LineString\"},\"properties\":{\"id\":\"d1ce-a1398a11-421c-bf66-a456ff525de9\",\"stroke\":\"blue\",\"stroke-width\":\"6\"}}]}";
+		std::ostringstream out;
+		{
+			movetk::io::GeoJSONFeatureCollectionWriter writer(out);
+			writer.write([&](auto& feature_writer) { serialize(line_strings[0], feature_writer); });
+			writer.write([&](auto& feature_writer) { serialize(line_strings[1], feature_writer); });
+			REQUIRE(writer.size() == 2);
+		}
+		REQUIRE(out.str() == expected_geojson);
+	}
+
+	SECTION("Parallel serialization") {
+		std::vector<LineString> many;
+		for (int i = 0; i < 101; ++i) {
+			many.push_back(line_strings[i % 2]);
+			many.back().lat[0] = 0.125 * i;
+		}
+		std::ostringstream sequential, parallel;
+		movetk::utils::ThreadPool pool(4);
+		{
+			movetk::io::GeoJSONFeatureCollectionWriter writer(sequential);
+			for (const auto& line_string : many) {
+				writer.write([&](auto& feature_writer) { serialize(line_string, feature_writer); });
+			}
+		}
+		{
+			movetk::io::GeoJSONFeatureCollectionWriter writer(parallel);
+			writer.write(many.begin(), many.begin() + 3, serialize, &pool);
+			writer.write(many.begin() + 3, many.end(), serialize, &pool);
+			writer.close();
+			REQUIRE(writer.size() == many.size());
+		}
+		REQUIRE(sequential.str() == parallel.str());
+	}
+
+	SECTION("Line delimited with limited precision") {
+		std::ostringstream out;
+		movetk::io::GeoJSONFeatureCollectionWriter writer(out, 2, movetk::io::GeoJSONLayout::LineDelimited);
+		const std::vector<double> lat{52.123456}, lon{5.987654};
+		const std::vector<long> ts{1500000000};
+		const std::vector<std::pair<std::string, double>> properties{{"speed", 12.5}};
+		writer.write([&](auto& feature_writer) {
+			feature_writer.line_string(lat.begin(), lat.end(), lon.begin(), ts.begin(), properties.begin(), properties.end());
+		});
+		writer.write(line_strings.begin(), line_strings.end(), serialize);
+		writer.close();
+		// Writes after closing are ignored
+		writer.write([&](auto& feature_writer) { serialize(line_strings[0], feature_writer); });
+		writer.write(line_strings.begin(), line_strings.end(), serialize);
+		REQUIRE(writer.size() == 3);
+		const std::string expected_first =
+		    R"({"type":"Feature","geometry":{"coordinates":[[5.99,52.12,0,1500000000]],"type":"LineString"},)"
+		    R"("properties":{"speed":12.5}})";
+		std::istringstream in(out.str());
+		std::string line;
+		std::size_t num_lines = 0;
+		while (std::getline(in, line)) {
+			if (num_lines == 0) {
+				REQUIRE(line == expected_first);
+			}
+			REQUIRE(line.front() == '{');
+			REQUIRE(line.back() == '}');
+			++num_lines;
+		}
+		REQUIRE(num_lines == 3);
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "movetk/io/DictionaryEncodedProbeReader.h"
+#include "movetk/io/IdDictionary.h"
+#include "movetk/io/SortedProbeReader.h"
+#include "movetk/io/SplitByField.h"
+#include "movetk/io/Splitter.h"
+
+TEST_CASE("Id dictionary assigns dense codes", "[id_dictionary]") {
+	movetk::io::IdDictionary dictionary;
+	REQUIRE(dictionary.intern("b").code == 0);
+	REQUIRE(dictionary.intern("a").code == 1);
+	REQUIRE(dictionary.intern("b").code == 0);
+	REQUIRE(dictionary.size() == 2);
+	REQUIRE(dictionary.value({1}) == "a");
+	REQUIRE(dictionary.find("a") == movetk::io::EncodedId{1});
+	REQUIRE_FALSE(dictionary.find("c"));
+	// Views stay valid when the dictionary grows
+	const auto b = dictionary.value({0});
+	for (int i = 0; i < 100000; ++i) {
+		dictionary.intern("id" + std::to_string(i));
+	}
+	REQUIRE(b == "b");
+	REQUIRE(dictionary.value(*dictionary.find("id99999")) == "id99999");
+}
+
+TEST_CASE("Id dictionary interned concurrently", "[id_dictionary]") {
+	movetk::io::IdDictionary dictionary;
+	std::vector<std::vector<movetk::io::EncodedId>> codes(4, std::vector<movetk::io::EncodedId>(1000));
+	std::vector<std::thread> threads;
+	for (std::size_t t = 0; t < codes.size(); ++t) {
+		threads.emplace_back([&, t]() {
+			for (std::size_t i = 0; i < codes[t].size(); ++i) {
+				codes[t][i] = dictionary.intern("vehicle" + std::to_string((i + t) % 100));
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	REQUIRE(dictionary.size() == 100);
+	for (std::size_t t = 0; t < codes.size(); ++t) {
+		for (std::size_t i = 0; i < codes[t].size(); ++i) {
+			REQUIRE(codes[t][i].code < 100);
+			REQUIRE(dictionary.value(codes[t][i]) == "vehicle" + std::to_string((i + t) % 100));
+		}
+	}
+}
+
+TEST_CASE("Dictionary encoded probes are grouped like string ids", "[id_dictionary]") {
+	using Row = std::tuple<int, std::string, double>;
+	std::vector<Row> rows;
+	for (int i = 0; i < 500; ++i) {
+		rows.emplace_back(i, "v" + std::to_string((i * 7919) % 37), 0.5 * i);
+	}
+
+	auto dictionary = std::make_shared<movetk::io::IdDictionary>();
+	using EncodedReader = movetk::io::DictionaryEncodedProbeReader<std::vector<Row>::iterator, 1>;
+	EncodedReader encoded_reader(rows.begin(), rows.end(), dictionary);
+	REQUIRE(encoded_reader.dictionary() == dictionary);
+	using EncodedRow = EncodedReader::ProbePoint;
+	static_assert(std::is_same_v<EncodedRow, std::tuple<int, movetk::io::EncodedId, double>>);
+
+	movetk::io::SortedProbeReader<EncodedReader::iterator, 1> sorted_encoded(encoded_reader.begin(), encoded_reader.end());
+	movetk::io::SortedProbeReader<std::vector<Row>::iterator, 1> sorted_strings(rows.begin(), rows.end());
+
+	using EncodedIterator = decltype(sorted_encoded.begin());
+	using StringIterator = decltype(sorted_strings.begin());
+	movetk::io::Splitter<movetk::io::SplitByField<1, EncodedRow>, EncodedIterator> encoded_splitter(
+	    sorted_encoded.begin(),
+	    sorted_encoded.end());
+	movetk::io::Splitter<movetk::io::SplitByField<1, Row>, StringIterator> string_splitter(sorted_strings.begin(),
+	                                                                                       sorted_strings.end());
+
+	std::vector<std::vector<EncodedRow>> encoded_groups(encoded_splitter.begin(), encoded_splitter.end());
+	std::vector<std::vector<Row>> string_groups(string_splitter.begin(), string_splitter.end());
+	REQUIRE(dictionary->size() == 37);
+	REQUIRE(encoded_groups.size() == 37);
+	REQUIRE(string_groups.size() == 37);
+
+	// Groups are in order of first occurrence rather than in lexicographic order
+	std::size_t num_probes = 0;
+	for (std::size_t g = 0; g < encoded_groups.size(); ++g) {
+		const auto& group = encoded_groups[g];
+		REQUIRE(std::get<1>(group.front()).code == g);
+		const auto id = dictionary->value(std::get<1>(group.front()));
+		const auto matching = std::find_if(string_groups.begin(), string_groups.end(), [&](const auto& string_group) {
+			return std::get<1>(string_group.front()) == id;
+		});
+		REQUIRE(matching != string_groups.end());
+		REQUIRE(matching->size() == group.size());
+		auto string_group = *matching;
+		std::sort(string_group.begin(), string_group.end());
+		for (std::size_t i = 0; i < group.size(); ++i) {
+			// The counting sort is stable, so the probes of a group stay in input order
+			REQUIRE(std::get<0>(group[i]) == std::get<0>(string_group[i]));
+			REQUIRE(std::get<2>(group[i]) == std::get<2>(string_group[i]));
+			REQUIRE(dictionary->value(std::get<1>(group[i])) == std::get<1>(string_group[i]));
+		}
+		num_probes += group.size();
+	}
+	REQUIRE(num_probes == rows.size());
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "movetk/io/csv/csv.h"
+#include "movetk/utils/Instrumentation.h"
+
+namespace instrumentation = movetk::utils::instrumentation;
+using instrumentation::Counter;
+using instrumentation::Timer;
+
+TEST_CASE("Instrumentation counters and timers accumulate", "[instrumentation]") {
+	const auto before = instrumentation::snapshot();
+	instrumentation::count(Counter::CsvRowsParsed);
+	instrumentation::count(Counter::CsvRowsParsed, 4);
+	instrumentation::count(Counter::DpCellsEvaluated, 100);
+	{
+		instrumentation::ScopedTimer timer(Timer::DateParse);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	const auto delta = instrumentation::snapshot() - before;
+	REQUIRE(delta.counter(Counter::CsvRowsParsed) == 5);
+	REQUIRE(delta.counter(Counter::DpCellsEvaluated) == 100);
+	REQUIRE(delta.counter(Counter::FrechetDecideCalls) == 0);
+	REQUIRE(delta.timer(Timer::DateParse).calls == 1);
+	REQUIRE(delta.timer(Timer::DateParse).nanoseconds >= 2'000'000);
+	REQUIRE(delta.timer(Timer::CsvReadRow).calls == 0);
+}
+
+TEST_CASE("Instrumentation keeps the measurements of exited threads", "[instrumentation]") {
+	const auto before = instrumentation::snapshot();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([] {
+			for (int i = 0; i < 1000; ++i) {
+				instrumentation::count(Counter::SplitterSegmentsEmitted);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	const auto delta = instrumentation::snapshot() - before;
+	REQUIRE(delta.counter(Counter::SplitterSegmentsEmitted) == 4000);
+}
+
+TEST_CASE("Instrumentation reset clears all measurements", "[instrumentation]") {
+	instrumentation::count(Counter::GeodesicDistanceCalls, 3);
+	instrumentation::reset();
+	const auto snapshot = instrumentation::snapshot();
+	for (std::size_t i = 0; i < instrumentation::NUM_COUNTERS; ++i) {
+		REQUIRE(snapshot.counter(static_cast<Counter>(i)) == 0);
+	}
+	for (std::size_t i = 0; i < instrumentation::NUM_TIMERS; ++i) {
+		REQUIRE(snapshot.timer(static_cast<Timer>(i)).calls == 0);
+	}
+}
+
+TEST_CASE("Instrumentation snapshots are written as JSON and Prometheus text", "[instrumentation]") {
+	instrumentation::reset();
+	instrumentation::count(Counter::FrechetEpsilonIterations, 7);
+	const auto snapshot = instrumentation::snapshot();
+
+	std::ostringstream json;
+	snapshot.to_json(json);
+	REQUIRE(json.str().find("\"counters\":{\"csv_rows_parsed\":0,") != std::string::npos);
+	REQUIRE(json.str().find("\"frechet_epsilon_iterations\":7") != std::string::npos);
+	REQUIRE(json.str().find("\"timers\":{\"csv_read_row\":{\"calls\":0,\"nanoseconds\":0}") != std::string::npos);
+
+	std::ostringstream prometheus;
+	snapshot.to_prometheus(prometheus);
+	REQUIRE(prometheus.str().find("# TYPE movetk_frechet_epsilon_iterations_total counter\n"
+	                              "movetk_frechet_epsilon_iterations_total 7\n") != std::string::npos);
+	REQUIRE(prometheus.str().find("movetk_timer_calls_total{timer=\"date_parse\"} 0\n") != std::string::npos);
+}
+
+TEST_CASE("Instrumented csv parsing counts the rows", "[instrumentation]") {
+	std::istringstream stream("A,B\n1,2\n3,4\n5,6\n");
+	movetk::io::csv::csv<std::tuple<int, int>, 0, 1> table(stream, ',', true);
+	const auto before = instrumentation::snapshot();
+	std::size_t rows = 0;
+	for ([[maybe_unused]] const auto& row : table) {
+		++rows;
+	}
+	REQUIRE(rows == 3);
+	const auto delta = instrumentation::snapshot() - before;
+	if constexpr (instrumentation::enabled) {
+		REQUIRE(delta.counter(Counter::CsvRowsParsed) == 3);
+		REQUIRE(delta.timer(Timer::CsvReadRow).calls >= 3);
+	} else {
+		REQUIRE(delta.counter(Counter::CsvRowsParsed) == 0);
+		REQUIRE(delta.timer(Timer::CsvReadRow).calls == 0);
+	}
+}
@@ -75,4 +75,22 @@ MOVETK_TEMPLATE_LIST_TEST_CASE("Check Infinity norm", "[is_valid_infinity_norm]"
 	REQUIRE(abs(infinity_norm(v) - 2.28) < MOVETK_EPS);
 	const auto result = infinity_norm ^ 2;
 	REQUIRE(abs(result - 5.1984) < MOVETK_EPS);
-}
\ No newline at end of file
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Check stateless norm evaluation", "[norm_evaluate]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+	const movetk::metric::FiniteNorm<MovetkGeometryKernel, 2> euclidean_norm{};
+	const movetk::metric::InfinityNorm<MovetkGeometryKernel> infinity_norm{};
+	const auto v = make_point({3.22, 1.3}) - make_point({5.5, 3.1});
+	const auto w = make_point({3, 4}) - make_point({0, 0});
+
+	// Interleaved evaluations do not affect each other
+	const auto v_norm = euclidean_norm.evaluate(v);
+	const auto w_norm = euclidean_norm.evaluate(w);
+	REQUIRE(abs(v_norm.powered - 8.4384) < MOVETK_EPS);
+	REQUIRE(abs((v_norm ^ 2) - 8.4384) < MOVETK_EPS);
+	REQUIRE(abs((w_norm ^ 1) - 5) < MOVETK_EPS);
+	REQUIRE(abs((infinity_norm.evaluate(v) ^ 2) - 5.1984) < MOVETK_EPS);
+	REQUIRE(abs(infinity_norm.evaluate(w).norm - 4) < MOVETK_EPS);
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "helpers/CustomCatchTemplate.h"
+#include "movetk/AlgorithmTraits.h"
+#include "movetk/OutlierDetection.h"
+#include "movetk/io/CartesianProbeTraits.h"
+#include "movetk/outlierdetection/OutlierDetectionPredicates.h"
+#include "movetk/utils/ThreadPool.h"
+
+using movetk::outlierdetection::OutlierDecision;
+
+template <typename Backend>
+struct OnlineOutlierDetectorTests : public test_helpers::BaseTestFixture<Backend> {
+	using Base = test_helpers::BaseTestFixture<Backend>;
+	using CartesianProbeTraits = movetk::io::ProbeTraits<typename Base::MovetkGeometryKernel>;
+	using Probe = typename CartesianProbeTraits::ProbePoint;
+	using OutlierDetectionTraits = movetk::outlierdetection::
+	    OutlierDetectionTraits<CartesianProbeTraits, typename Base::MovetkGeometryKernel, typename Base::Norm>;
+	using LinearSpeedBoundedTest = movetk::outlierdetection::TEST<movetk::outlierdetection::linear_speed_bounded_test_tag,
+	                                                              movetk::algo::cartesian_coordinates_tag,
+	                                                              OutlierDetectionTraits>;
+	using Detector = movetk::outlierdetection::OnlineOutlierDetector<int, Probe, LinearSpeedBoundedTest>;
+	// Decided probe timestamps per object
+	using Decisions = std::map<int, std::vector<std::pair<std::size_t, OutlierDecision>>>;
+
+	struct Recorder {
+		Decisions* decisions;
+		std::mutex* mutex;
+		void operator()(int id, const Probe& probe, OutlierDecision decision) const {
+			std::lock_guard<std::mutex> lock(*mutex);
+			(*decisions)[id].emplace_back(std::get<1>(probe), decision);
+		}
+	};
+
+	movetk::geom::MakePoint<typename Base::MovetkGeometryKernel> make_point;
+
+	std::vector<Probe> trajectory() {
+		return {{make_point({-5, 5}), 0},
+		        {make_point({-6, 3}), 1},
+		        {make_point({-5, 3}), 2},
+		        {make_point({-3, 5}), 3},
+		        {make_point({-2, 3}), 4},
+		        {make_point({-1, 3}), 5},
+		        {make_point({1, 5}), 6},
+		        {make_point({2, 2}), 7},
+		        {make_point({4, 5}), 8},
+		        {make_point({5, 5}), 9},
+		        {make_point({6, 5}), 10},
+		        {make_point({7, 5}), 11}};
+	}
+
+	static std::vector<std::size_t> accepted(const std::vector<std::pair<std::size_t, OutlierDecision>>& decisions) {
+		std::vector<std::size_t> timestamps;
+		for (const auto& [timestamp, decision] : decisions) {
+			if (decision == OutlierDecision::Accepted) {
+				timestamps.push_back(timestamp);
+			}
+		}
+		return timestamps;
+	}
+};
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Online outlier detector matches smart greedy within the horizon",
+                               "[online_outlier_detector]") {
+	using Fixture = OnlineOutlierDetectorTests<TestType>;
+	Fixture fixture;
+	typename Fixture::Decisions decisions;
+	std::mutex mutex;
+	typename Fixture::Recorder recorder{&decisions, &mutex};
+	typename Fixture::Detector detector(1.5, 16, 4);
+	for (const auto& probe : fixture.trajectory()) {
+		detector.push(7, probe, recorder);
+	}
+	// Nothing is decided before the horizon
+	REQUIRE(decisions.empty());
+	detector.flush(recorder);
+	REQUIRE(decisions[7].size() == 12);
+	// The first of the longest sequences of the smart greedy detector
+	REQUIRE(Fixture::accepted(decisions[7]) == std::vector<std::size_t>{0, 2, 4, 5, 10, 11});
+
+	SECTION("Consistent probes are accepted immediately") {
+		decisions.clear();
+		detector.push(7, {fixture.make_point({8, 5}), 12}, recorder);
+		REQUIRE(decisions[7] == std::vector<std::pair<std::size_t, OutlierDecision>>{{12, OutlierDecision::Accepted}});
+		// Probes that are not later than the previous probe are rejected
+		detector.push(7, {fixture.make_point({8, 5}), 12}, recorder);
+		REQUIRE(decisions[7].back() == std::make_pair(std::size_t(12), OutlierDecision::Rejected));
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Online outlier detector decisions have bounded delay", "[online_outlier_detector]") {
+	using Fixture = OnlineOutlierDetectorTests<TestType>;
+	Fixture fixture;
+	using Probe = typename Fixture::Probe;
+	typename Fixture::Decisions decisions;
+	std::mutex mutex;
+	typename Fixture::Recorder recorder{&decisions, &mutex};
+	constexpr std::size_t horizon = 4;
+	typename Fixture::Detector detector(1.5, horizon);
+
+	// Unit steps, with a spike of two probes every ten probes
+	std::vector<std::size_t> expected;
+	for (std::size_t t = 0; t < 100; ++t) {
+		const bool spike = t % 10 == 5 || t % 10 == 6;
+		const auto x = static_cast<typename TestType::NT>(t), y = static_cast<typename TestType::NT>(spike ? 50 : 0);
+		const Probe probe{fixture.make_point({x, y}), t};
+		detector.push(3, probe, recorder);
+		if (!spike) {
+			expected.push_back(t);
+		}
+		REQUIRE(decisions[3].size() + horizon > t + 1);
+	}
+	detector.flush(3, recorder);
+	REQUIRE(decisions[3].size() == 100);
+	REQUIRE(Fixture::accepted(decisions[3]) == expected);
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Online outlier detector processes batches of many objects in parallel",
+                               "[online_outlier_detector]") {
+	using Fixture = OnlineOutlierDetectorTests<TestType>;
+	Fixture fixture;
+	using Probe = typename Fixture::Probe;
+	using NT = typename TestType::NT;
+	constexpr int num_objects = 200;
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> step(-1, 1);
+	std::uniform_int_distribution<int> object(0, num_objects - 1);
+	std::bernoulli_distribution outlier(0.05);
+
+	std::vector<std::pair<int, Probe>> stream;
+	std::vector<std::pair<double, double>> positions(num_objects, {0, 0});
+	std::vector<std::size_t> times(num_objects, 0);
+	for (int i = 0; i < 20000; ++i) {
+		const auto id = object(generator);
+		auto& [x, y] = positions[id];
+		x += step(generator);
+		y += step(generator);
+		const double offset = outlier(generator) ? 100 : 0;
+		const auto point = fixture.make_point({static_cast<NT>(x + offset), static_cast<NT>(y)});
+		stream.emplace_back(id, Probe{point, ++times[id]});
+	}
+
+	std::mutex mutex;
+	typename Fixture::Decisions sequential, parallel;
+	typename Fixture::Detector sequential_detector(1.5, 6, 16);
+	for (const auto& [id, probe] : stream) {
+		sequential_detector.push(id, probe, typename Fixture::Recorder{&sequential, &mutex});
+	}
+	REQUIRE(sequential_detector.num_objects() == num_objects);
+
+	typename Fixture::Detector parallel_detector(1.5, 6, 16);
+	movetk::utils::ThreadPool pool(4);
+	for (std::size_t first = 0; first < stream.size(); first += 1000) {
+		parallel_detector.push(stream.begin() + first,
+		                       stream.begin() + first + 1000,
+		                       typename Fixture::Recorder{&parallel, &mutex},
+		                       pool);
+	}
+	REQUIRE(parallel == sequential);
+
+	// Evicting every object decides all pending probes
+	const auto evicted = parallel_detector.evict_idle(1000, 0, typename Fixture::Recorder{&parallel, &mutex});
+	REQUIRE(evicted == num_objects);
+	REQUIRE(parallel_detector.num_objects() == 0);
+	std::size_t num_decisions = 0, num_rejected = 0;
+	for (const auto& [id, decisions] : parallel) {
+		REQUIRE(decisions.size() == times[id]);
+		num_decisions += decisions.size();
+		num_rejected += decisions.size() - Fixture::accepted(decisions).size();
+	}
+	REQUIRE(num_decisions == stream.size());
+	// About 5% outliers
+	REQUIRE(num_rejected > stream.size() / 40);
+	REQUIRE(num_rejected < stream.size() / 10);
+}
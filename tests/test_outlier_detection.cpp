@@ -26,6 +26,7 @@
 #include <array>
 #include <catch2/catch.hpp>
 #include <iostream>
+#include <random>
 #include <stack>
 
 #include "helpers/CustomCatchTemplate.h"
@@ -236,6 +237,58 @@ MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(OutlierDetectionTests,
 }
 
 
+MOVETK_TEMPLATE_LIST_TEST_CASE("smart_greedy_outlier_detector matches extending every sequence",
+                               "[smart_greedy_outlier_detector 3]") {
+	using Fixture = OutlierDetectionTests<TestType>;
+	using NT = typename TestType::NT;
+	Fixture fixture;
+	auto make_point = fixture.make_point;
+	using OutlierDetector = typename Fixture::OutlierDetectionFactory::template outlierdetector_for_tag<
+	    movetk::outlierdetection::smart_greedy_outlier_detector_tag>;
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<double> step(-1, 1);
+	std::bernoulli_distribution outlier(0.1);
+	for (int run = 0; run < 20; ++run) {
+		typename Fixture::Trajectory trajectory;
+		double x = 0, y = 0;
+		for (std::size_t i = 0; i < 300; ++i) {
+			x += step(generator);
+			y += step(generator);
+			const double offset = outlier(generator) ? 4 * step(generator) : 0;
+			trajectory.push_back({make_point({static_cast<NT>(x + offset), static_cast<NT>(y)}), i});
+		}
+		const NT threshold = 1.5;
+
+		// Every sequence is tested and extended separately
+		typename Fixture::LinearSpeedboundedTest predicate(threshold);
+		typename Fixture::Sequences expected;
+		for (auto it = trajectory.cbegin(); it != trajectory.cend(); ++it) {
+			bool extended = false;
+			for (auto& sequence : expected) {
+				if (predicate(*sequence.back(), *it)) {
+					sequence.push_back(it);
+					extended = true;
+				}
+			}
+			if (!extended) {
+				expected.push_back({it});
+			}
+		}
+		std::size_t max_size = 0;
+		for (const auto& sequence : expected) {
+			max_size = std::max(max_size, sequence.size());
+		}
+		expected.erase(std::remove_if(expected.begin(),
+		                              expected.end(),
+		                              [max_size](const auto& sequence) { return sequence.size() != max_size; }),
+		               expected.end());
+
+		OutlierDetector outlier_detector(threshold);
+		Fixture::verify_outlier_detector_multi_output(outlier_detector, trajectory, expected);
+	}
+}
+
+
 MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(OutlierDetectionTests,
                                       "zheng_greedy_outlier_detector 1",
                                       "[zheng_greedy_outlier_detector 1]") {
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "helpers/CustomCatchTemplate.h"
+#include "movetk/ds/PolygonGridIndex.h"
+#include "movetk/geom/GeometryInterface.h"
+#include "movetk/utils/ThreadPool.h"
+
+namespace {
+// Reference crossing number test
+template <class NT>
+bool crossing_number(const std::vector<std::array<NT, 2>>& vertices, NT x, NT y) {
+	bool inside = false;
+	for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+		const auto& a = vertices[i];
+		const auto& b = vertices[j];
+		if ((a[1] > y) != (b[1] > y) && x < a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1])) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+}  // namespace
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Locate points in a polygon grid index", "[polygon_grid_index]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Polygon = typename MovetkGeometryKernel::MovetkPolygon;
+	using Index = movetk::ds::PolygonGridIndex<MovetkGeometryKernel>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+	movetk::geom::MakePolygon<MovetkGeometryKernel> make_polygon;
+
+	// Non-convex star shaped polygons with random radii, some of them overlapping
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> center(0, 100), radius(2, 12), unit(0, 1);
+	std::vector<Polygon> polygons;
+	std::vector<std::vector<std::array<NT, 2>>> vertices;
+	for (int p = 0; p < 40; ++p) {
+		const double cx = center(generator), cy = center(generator), r = radius(generator);
+		const int num_vertices = 3 + p % 20;
+		std::vector<typename MovetkGeometryKernel::MovetkPoint> points;
+		vertices.emplace_back();
+		for (int v = 0; v < num_vertices; ++v) {
+			const double angle = 2 * M_PI * v / num_vertices;
+			const double length = r * (0.4 + 0.6 * unit(generator));
+			const NT x = cx + length * std::cos(angle), y = cy + length * std::sin(angle);
+			points.push_back(make_point({x, y}));
+			vertices.back().push_back({x, y});
+		}
+		polygons.push_back(make_polygon(std::cbegin(points), std::cend(points)));
+	}
+
+	std::vector<NT> xs, ys;
+	for (int i = 0; i < 5000; ++i) {
+		xs.push_back(-5 + 110 * unit(generator));
+		ys.push_back(-5 + 110 * unit(generator));
+	}
+	auto first_containing = [&](std::size_t i) {
+		for (std::size_t p = 0; p < vertices.size(); ++p) {
+			if (crossing_number(vertices[p], xs[i], ys[i])) {
+				return p;
+			}
+		}
+		return Index::npos;
+	};
+
+	movetk::utils::ThreadPool pool(4);
+	for (std::size_t cells_per_axis : {0, 1, 7, 64}) {
+		Index index(std::cbegin(polygons), std::cend(polygons), cells_per_axis);
+		REQUIRE(index.size() == polygons.size());
+
+		std::vector<std::size_t> located;
+		index.locate(std::cbegin(xs), std::cend(xs), std::cbegin(ys), std::back_inserter(located), &pool);
+		REQUIRE(located.size() == xs.size());
+		std::size_t num_contained = 0;
+		for (std::size_t i = 0; i < xs.size(); ++i) {
+			const auto expected = first_containing(i);
+			REQUIRE(located[i] == expected);
+			REQUIRE(index.locate(xs[i], ys[i]) == expected);
+			num_contained += expected != Index::npos;
+
+			std::vector<std::size_t> containing, expected_containing;
+			index.containing(xs[i], ys[i], std::back_inserter(containing));
+			for (std::size_t p = 0; p < vertices.size(); ++p) {
+				if (crossing_number(vertices[p], xs[i], ys[i])) {
+					expected_containing.push_back(p);
+				}
+			}
+			REQUIRE(containing == expected_containing);
+		}
+		REQUIRE(num_contained > 0);
+	}
+
+	// Batch lookup of points
+	Index index(std::cbegin(polygons), std::cend(polygons));
+	std::vector<typename MovetkGeometryKernel::MovetkPoint> points;
+	for (std::size_t i = 0; i < 1000; ++i) {
+		points.push_back(make_point({xs[i], ys[i]}));
+	}
+	std::vector<std::size_t> located;
+	index.locate(std::cbegin(points), std::cend(points), std::back_inserter(located));
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		REQUIRE(located[i] == first_containing(i));
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Polygon grid index on axis aligned polygons", "[polygon_grid_index]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using Index = movetk::ds::PolygonGridIndex<MovetkGeometryKernel>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+	movetk::geom::MakePolygon<MovetkGeometryKernel> make_polygon;
+
+	// Vertices and edges on the grid lines
+	std::vector<typename MovetkGeometryKernel::MovetkPolygon> polygons;
+	{
+		std::vector<typename MovetkGeometryKernel::MovetkPoint> points{
+		    make_point({0, 0}), make_point({4, 0}), make_point({4, 4}), make_point({0, 4})};
+		polygons.push_back(make_polygon(std::cbegin(points), std::cend(points)));
+	}
+	{
+		std::vector<typename MovetkGeometryKernel::MovetkPoint> points{
+		    make_point({1, 1}), make_point({3, 1}), make_point({3, 3}), make_point({1, 3})};
+		polygons.push_back(make_polygon(std::cbegin(points), std::cend(points)));
+	}
+	Index index(std::cbegin(polygons), std::cend(polygons), 4);
+
+	REQUIRE(index.locate(0.5, 0.5) == 0);
+	REQUIRE(index.locate(2, 2) == 0);
+	REQUIRE(index.locate(5, 2) == Index::npos);
+	REQUIRE(index.locate(-1, 2) == Index::npos);
+	std::vector<std::size_t> containing;
+	index.containing(2, 2, std::back_inserter(containing));
+	REQUIRE(containing == std::vector<std::size_t>{0, 1});
+	containing.clear();
+	index.containing(3.5, 2, std::back_inserter(containing));
+	REQUIRE(containing == std::vector<std::size_t>{0});
+}
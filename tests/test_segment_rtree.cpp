@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "helpers/CustomCatchTemplate.h"
+#include "movetk/ds/SegmentRTree.h"
+#include "movetk/geom/GeometryInterface.h"
+#include "movetk/utils/ThreadPool.h"
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Queries on a segment R-tree", "[segment_rtree]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Point = typename MovetkGeometryKernel::MovetkPoint;
+	using Tree = movetk::ds::SegmentRTree<MovetkGeometryKernel>;
+	using SegmentId = typename Tree::SegmentId;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	// Random walks
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> start(0, 100), step(-3, 3), unit(0, 1);
+	std::vector<std::vector<Point>> trajectories;
+	for (int t = 0; t < 30; ++t) {
+		std::vector<Point> trajectory;
+		NT x = start(generator), y = start(generator);
+		for (int i = 0; i < 10 + t * 5; ++i) {
+			trajectory.push_back(make_point({x, y}));
+			x += step(generator);
+			y += step(generator);
+		}
+		trajectories.push_back(trajectory);
+	}
+
+	auto for_each_segment = [&](auto&& f) {
+		for (std::size_t t = 0; t < trajectories.size(); ++t) {
+			for (std::size_t i = 0; i + 1 < trajectories[t].size(); ++i) {
+				f(SegmentId(t, i), trajectories[t][i], trajectories[t][i + 1]);
+			}
+		}
+	};
+	auto orientation = [](const Point& a, const Point& b, const Point& c) {
+		const NT value = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+		return (value > 0) - (value < 0);
+	};
+
+	movetk::utils::ThreadPool pool(4);
+	for (std::size_t node_capacity : {2, 4, 16}) {
+		Tree tree(std::cbegin(trajectories), std::cend(trajectories), &pool, node_capacity);
+		std::size_t num_segments = 0;
+		for_each_segment([&](auto, const auto&, const auto&) { ++num_segments; });
+		REQUIRE(tree.size() == num_segments);
+
+		for (int q = 0; q < 50; ++q) {
+			const NT x = start(generator), y = start(generator), w = 20 * unit(generator), h = 20 * unit(generator);
+			const auto min = make_point({x, y});
+			const auto max = make_point({x + w, y + h});
+			std::vector<SegmentId> found, expected;
+			tree.window(min, max, std::back_inserter(found));
+			for_each_segment([&](SegmentId id, const Point& a, const Point& b) {
+				if (std::min(a[0], b[0]) <= x + w && std::max(a[0], b[0]) >= x && std::min(a[1], b[1]) <= y + h &&
+				    std::max(a[1], b[1]) >= y) {
+					expected.push_back(id);
+				}
+			});
+			std::sort(std::begin(found), std::end(found));
+			REQUIRE(found == expected);
+
+			// Segment intersection
+			const auto c = make_point({x + w, y});
+			found.clear();
+			expected.clear();
+			tree.intersecting(min, c, std::back_inserter(found));
+			for_each_segment([&](SegmentId id, const Point& a, const Point& b) {
+				if (orientation(a, b, min) != orientation(a, b, c) && orientation(min, c, a) != orientation(min, c, b)) {
+					expected.push_back(id);
+				}
+			});
+			std::sort(std::begin(found), std::end(found));
+			REQUIRE(found == expected);
+
+			// Nearest segment
+			const auto nearest = tree.nearest(min);
+			REQUIRE(nearest.has_value());
+			NT best = std::numeric_limits<NT>::max();
+			for_each_segment([&](SegmentId, const Point& a, const Point& b) {
+				const NT dx = b[0] - a[0], dy = b[1] - a[1];
+				const NT t = std::clamp(((x - a[0]) * dx + (y - a[1]) * dy) / (dx * dx + dy * dy), NT(0), NT(1));
+				const NT px = a[0] + t * dx - x, py = a[1] + t * dy - y;
+				best = std::min(best, px * px + py * py);
+			});
+			REQUIRE(std::abs(nearest->second - best) < MOVETK_EPS);
+		}
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Serialize and map a segment R-tree", "[segment_rtree]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using Point = typename MovetkGeometryKernel::MovetkPoint;
+	using Tree = movetk::ds::SegmentRTree<MovetkGeometryKernel>;
+	using SegmentId = typename Tree::SegmentId;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	std::vector<std::vector<Point>> trajectories{
+	    {make_point({0, 0}), make_point({10, 10}), make_point({20, 0})},
+	    {make_point({0, 10}), make_point({20, 10})},
+	    {make_point({30, 30})}};
+	Tree tree(std::cbegin(trajectories), std::cend(trajectories));
+	REQUIRE(tree.size() == 3);
+
+	std::stringstream stream;
+	tree.serialize(stream);
+	const std::string serialized = stream.str();
+	REQUIRE(serialized.size() == tree.size_bytes());
+	// Copy into a suitably aligned buffer, as a memory mapped file would be
+	std::vector<std::max_align_t> buffer(serialized.size() / sizeof(std::max_align_t) + 1);
+	std::memcpy(buffer.data(), serialized.data(), serialized.size());
+	const Tree mapped = Tree::map(buffer.data(), serialized.size());
+	REQUIRE(mapped.size() == 3);
+
+	std::vector<SegmentId> found;
+	mapped.intersecting(make_point({5, 0}), make_point({5, 20}), std::back_inserter(found));
+	std::sort(std::begin(found), std::end(found));
+	REQUIRE(found == std::vector<SegmentId>{{0, 0}, {1, 0}});
+
+	const auto nearest = mapped.nearest(make_point({20, 1}));
+	REQUIRE(nearest->first == SegmentId(0, 1));
+
+	REQUIRE_THROWS_AS(Tree::map(serialized.data(), 4), std::invalid_argument);
+
+	// Corrupt header fields: num_segments, num_nodes, segments_offset, nodes_offset
+	const auto corrupt = [&](std::size_t field, std::uint64_t value) {
+		std::vector<std::max_align_t> copy(buffer);
+		std::memcpy(reinterpret_cast<std::byte*>(copy.data()) + 8 * field, &value, sizeof(value));
+		return Tree::map(copy.data(), serialized.size());
+	};
+	const auto read_field = [&](std::size_t field) {
+		std::uint64_t value;
+		std::memcpy(&value, serialized.data() + 8 * field, sizeof(value));
+		return value;
+	};
+	REQUIRE_THROWS_AS(corrupt(2, read_field(2) + 1), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(2, std::uint64_t{1} << 62), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(3, std::uint64_t{1} << 62), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(4, read_field(4) + 1), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(4, 0), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(5, read_field(5) + 1), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(5, ~std::uint64_t{0} - 7), std::invalid_argument);
+	std::memmove(reinterpret_cast<std::byte*>(buffer.data()) + 1, buffer.data(), serialized.size());
+	REQUIRE_THROWS_AS(Tree::map(reinterpret_cast<std::byte*>(buffer.data()) + 1, serialized.size()),
+	                  std::invalid_argument);
+
+	std::vector<std::vector<Point>> no_trajectories;
+	const Tree empty(std::cbegin(no_trajectories), std::cend(no_trajectories));
+	REQUIRE(empty.empty());
+	REQUIRE(!empty.nearest(make_point({0, 0})).has_value());
+
+	Tree moved(std::move(tree));
+	REQUIRE(moved.size() == 3);
+	REQUIRE(tree.size() == 0);
+	REQUIRE(tree.empty());
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Reject a mapped segment R-tree with corrupt nodes", "[segment_rtree]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Point = typename MovetkGeometryKernel::MovetkPoint;
+	using Tree = movetk::ds::SegmentRTree<MovetkGeometryKernel>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	// Three segments with two children per node: two leaves and an inner root, stored last
+	std::vector<std::vector<Point>> trajectories{
+	    {make_point({0, 0}), make_point({10, 10}), make_point({20, 0}), make_point({30, 10})}};
+	const Tree tree(std::cbegin(trajectories), std::cend(trajectories), nullptr, 2);
+	std::stringstream stream;
+	tree.serialize(stream);
+	const std::string serialized = stream.str();
+	std::vector<std::max_align_t> buffer(serialized.size() / sizeof(std::max_align_t) + 1);
+	std::memcpy(buffer.data(), serialized.data(), serialized.size());
+	REQUIRE_NOTHROW(Tree::map(buffer.data(), serialized.size()));
+
+	std::uint64_t num_nodes, nodes_offset;
+	std::memcpy(&num_nodes, serialized.data() + 8 * 3, sizeof(num_nodes));
+	std::memcpy(&nodes_offset, serialized.data() + 8 * 5, sizeof(nodes_offset));
+	REQUIRE(num_nodes == 3);
+	const std::size_t node_size = (serialized.size() - nodes_offset) / num_nodes;
+	// Fields of a node after its box: 0 = first, 1 = count, 2 = is_leaf
+	const auto corrupt = [&](std::size_t node, std::size_t field, std::uint32_t value) {
+		std::vector<std::max_align_t> copy(buffer);
+		std::memcpy(reinterpret_cast<std::byte*>(copy.data()) + nodes_offset + node * node_size + 4 * sizeof(NT) +
+		                4 * field,
+		            &value,
+		            sizeof(value));
+		return Tree::map(copy.data(), serialized.size());
+	};
+	const std::size_t root = 2;
+	// Leaf referencing segments beyond the segment array
+	REQUIRE_THROWS_AS(corrupt(0, 0, 3), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(0, 1, ~std::uint32_t{0}), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(0, 2, 2), std::invalid_argument);
+	// Inner node referencing itself, a later node or nodes beyond the array
+	REQUIRE_THROWS_AS(corrupt(root, 1, 3), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(root, 0, 2), std::invalid_argument);
+	REQUIRE_THROWS_AS(corrupt(root, 0, ~std::uint32_t{0}), std::invalid_argument);
+	// Leaf turned into an inner node, which then references itself
+	REQUIRE_THROWS_AS(corrupt(0, 2, 0), std::invalid_argument);
+}
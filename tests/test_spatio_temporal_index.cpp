@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "helpers/CustomCatchTemplate.h"
+#include "movetk/ds/SpatioTemporalIndex.h"
+#include "movetk/geom/GeometryInterface.h"
+
+namespace {
+template <class NT>
+NT cross(NT ax, NT ay, NT bx, NT by, NT cx, NT cy) {
+	return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+template <class NT>
+bool segments_intersect(NT ax, NT ay, NT bx, NT by, NT cx, NT cy, NT dx, NT dy) {
+	const NT d1 = cross(cx, cy, dx, dy, ax, ay), d2 = cross(cx, cy, dx, dy, bx, by);
+	const NT d3 = cross(ax, ay, bx, by, cx, cy), d4 = cross(ax, ay, bx, by, dx, dy);
+	return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+// Whether the segment intersects the box, by its endpoints and the edges of the box
+template <class NT>
+bool segment_in_box(NT ax, NT ay, NT bx, NT by, NT x0, NT y0, NT x1, NT y1) {
+	auto inside = [&](NT x, NT y) { return x >= x0 && x <= x1 && y >= y0 && y <= y1; };
+	return inside(ax, ay) || inside(bx, by) || segments_intersect(ax, ay, bx, by, x0, y0, x1, y0) ||
+	       segments_intersect(ax, ay, bx, by, x1, y0, x1, y1) || segments_intersect(ax, ay, bx, by, x1, y1, x0, y1) ||
+	       segments_intersect(ax, ay, bx, by, x0, y1, x0, y0);
+}
+}  // namespace
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Queries on a spatio-temporal index", "[spatio_temporal_index]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Index = movetk::ds::SpatioTemporalIndex<MovetkGeometryKernel>;
+	using Probe = std::tuple<std::size_t, NT, NT>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	// Random walks with irregular sampling
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> start(0, 100), step(-4, 4);
+	std::uniform_int_distribution<std::size_t> start_time(0, 5000), interval(1, 60);
+	std::vector<std::vector<Probe>> trajectories;
+	for (int t = 0; t < 40; ++t) {
+		std::vector<Probe> trajectory;
+		NT x = start(generator), y = start(generator);
+		std::size_t ts = start_time(generator);
+		for (int i = 0; i < 1 + t * 3; ++i) {
+			trajectory.emplace_back(ts, x, y);
+			x += step(generator);
+			y += step(generator);
+			ts += interval(generator);
+		}
+		trajectories.push_back(trajectory);
+	}
+
+	Index index(10, 300);
+	for (std::size_t t = 0; t < trajectories.size(); ++t) {
+		REQUIRE(index.template append<1, 2, 0>(std::cbegin(trajectories[t]), std::cend(trajectories[t])) == t);
+	}
+	REQUIRE(index.size() == trajectories.size());
+	REQUIRE(index.posting_bytes() > 0);
+
+	auto brute_force = [&](NT x0, NT y0, NT x1, NT y1, std::size_t t0, std::size_t t1) {
+		std::vector<std::size_t> result;
+		for (std::size_t t = 0; t < trajectories.size(); ++t) {
+			const auto& trajectory = trajectories[t];
+			for (std::size_t i = 0; i < trajectory.size(); ++i) {
+				const auto& [ta, ax, ay] = trajectory[i];
+				const auto& [tb, bx, by] = trajectory[std::min(i + 1, trajectory.size() - 1)];
+				if (i + 1 == trajectory.size() && trajectory.size() > 1) {
+					break;
+				}
+				if (tb < t0 || ta > t1) {
+					continue;
+				}
+				NT sx = ax, sy = ay, ex = bx, ey = by;
+				if (tb > ta) {
+					const NT s = ta < t0 ? NT(t0 - ta) / NT(tb - ta) : 0;
+					const NT e = tb > t1 ? NT(t1 - ta) / NT(tb - ta) : 1;
+					sx = ax + s * (bx - ax);
+					sy = ay + s * (by - ay);
+					ex = ax + e * (bx - ax);
+					ey = ay + e * (by - ay);
+				}
+				if (segment_in_box(sx, sy, ex, ey, x0, y0, x1, y1)) {
+					result.push_back(t);
+					break;
+				}
+			}
+		}
+		return result;
+	};
+
+	std::uniform_real_distribution<double> corner(-10, 110), extent(0, 40);
+	std::uniform_int_distribution<std::size_t> window_start(0, 6000), window_length(0, 1500);
+	for (int q = 0; q < 300; ++q) {
+		const NT x0 = corner(generator), y0 = corner(generator);
+		const NT x1 = x0 + extent(generator), y1 = y0 + extent(generator);
+		const std::size_t t0 = window_start(generator), t1 = t0 + window_length(generator);
+		std::vector<std::size_t> found;
+		index.query(make_point({x0, y0}), make_point({x1, y1}), t0, t1, std::back_inserter(found));
+		REQUIRE(found == brute_force(x0, y0, x1, y1, t0, t1));
+	}
+
+	SECTION("Query covering everything") {
+		std::vector<std::size_t> found;
+		index.query(make_point({-1000, -1000}), make_point({1000, 1000}), 0, 100000, std::back_inserter(found));
+		REQUIRE(found.size() == trajectories.size());
+	}
+
+	SECTION("Empty window") {
+		std::vector<std::size_t> found;
+		index.query(make_point({0, 0}), make_point({100, 100}), 10, 5, std::back_inserter(found));
+		REQUIRE(found.empty());
+	}
+
+	SECTION("Appending from columns") {
+		const std::vector<NT> xs{0, 10, 20}, ys{0, 0, 0};
+		const std::vector<std::size_t> ts{100000, 100010, 100020};
+		const auto id = index.append(std::cbegin(xs), std::cend(xs), std::cbegin(ys), std::cbegin(ts));
+		REQUIRE(id == trajectories.size());
+		std::vector<std::size_t> found;
+		// The trajectory is at x = 15 at time 100015
+		index.query(make_point({14, -1}), make_point({16, 1}), 100014, 100016, std::back_inserter(found));
+		REQUIRE(found == std::vector<std::size_t>{id});
+		found.clear();
+		index.query(make_point({14, -1}), make_point({16, 1}), 100000, 100005, std::back_inserter(found));
+		REQUIRE(found.empty());
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Spatio-temporal index with long gaps", "[spatio_temporal_index]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Index = movetk::ds::SpatioTemporalIndex<MovetkGeometryKernel>;
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	// A diagonal gap of 1000 cells and 10000 buckets, followed by a short hop
+	const std::vector<NT> xs{0, 10000, 10001}, ys{0, 10000, 10001};
+	const std::vector<std::size_t> ts{0, 1000000, 1000010};
+	// A segment crossing fewer cells is added to the cells along it only, not to its bounding box
+	const std::vector<NT> diagonal_xs{0, 1000}, diagonal_ys{0, 1000};
+	const std::vector<std::size_t> diagonal_ts{0, 10};
+
+	Index index(10, 100);
+	REQUIRE(index.append(std::cbegin(xs), std::cend(xs), std::cbegin(ys), std::cbegin(ts)) == 0);
+	REQUIRE(index.append(std::cbegin(diagonal_xs), std::cend(diagonal_xs), std::cbegin(diagonal_ys), std::cbegin(diagonal_ts)) ==
+	        1);
+	// About three bytes per posting: at most 201 cells along the diagonal plus a few for the rest
+	REQUIRE(index.posting_bytes() < 1000);
+
+	std::vector<std::size_t> found;
+	// The gap passes through (5000, 5000) at time 500000
+	index.query(make_point({4999, 4999}), make_point({5001, 5001}), 499900, 500100, std::back_inserter(found));
+	REQUIRE(found == std::vector<std::size_t>{0});
+	found.clear();
+	index.query(make_point({4999, 4999}), make_point({5001, 5001}), 0, 400000, std::back_inserter(found));
+	REQUIRE(found.empty());
+	// Off the diagonal, inside its bounding box
+	index.query(make_point({900, 0}), make_point({1000, 100}), 0, 10, std::back_inserter(found));
+	REQUIRE(found.empty());
+	index.query(make_point({495, 495}), make_point({505, 505}), 0, 10, std::back_inserter(found));
+	REQUIRE(found == std::vector<std::size_t>{1});
+
+	// With at most one (bucket, cell) pair per segment, the gap is only in the overflow list
+	Index overflowing(10, 100, 1);
+	overflowing.append(std::cbegin(xs), std::cend(xs), std::cbegin(ys), std::cbegin(ts));
+	found.clear();
+	overflowing.query(make_point({4999, 4999}), make_point({5001, 5001}), 499900, 500100, std::back_inserter(found));
+	REQUIRE(found == std::vector<std::size_t>{0});
+}
@@ -21,8 +21,11 @@
 #include <catch2/catch.hpp>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
+#include "movetk/ds/TabularTrajectory.h"
 #include "movetk/geo/geo.h"
+#include "movetk/io/HighFrequencyTrajectorySplitter.h"
 #include "movetk/io/ParseDate.h"
 #include "movetk/io/ProbeTraits.h"
 #include "movetk/io/SplitByDifferenceThreshold.h"
@@ -117,8 +120,57 @@ TEST_CASE("Splitter", "[splitter]") {
 		REQUIRE(i == expected_split_count);
 	}
 
+	SECTION("Pairwise split predicates agree with the stateful ones") {
+		const movetk::io::SplitByField<0, Row> by_field_pairwise;
+		const movetk::io::SplitByDifferenceThreshold<4, Row> by_time_pairwise(15.0);
+		movetk::io::SplitByField<0, Row> by_field;
+		movetk::io::SplitByDifferenceThreshold<4, Row> by_time(15.0);
+		by_field(probe_points[0]);
+		by_time(probe_points[0]);
+		for (std::size_t i = 1; i < probe_points.size(); ++i) {
+			REQUIRE(by_field_pairwise(probe_points[i - 1], probe_points[i]) == by_field(probe_points[i]));
+			REQUIRE(by_time_pairwise(probe_points[i - 1], probe_points[i]) == by_time(probe_points[i]));
+		}
+	}
+
+	SECTION("Split ranges agree with the Splitter") {
+		using SplitByDiff = movetk::io::SplitByDifferenceThreshold<4, Row>;
+		const movetk::io::SplitAny<movetk::io::SplitByField<0, Row>, SplitByDiff> split(
+		    movetk::io::SplitByField<0, Row>(),
+		    SplitByDiff(15.0));
+		std::vector<movetk::io::IndexRange> ranges;
+		movetk::io::split_ranges(probe_points.begin(), probe_points.end(), split, std::back_inserter(ranges));
+		REQUIRE(ranges == std::vector<movetk::io::IndexRange>{{0, 1}, {1, 3}, {3, 4}, {4, 6}});
+
+		movetk::io::SplitByField<0, Row> by_field;
+		SplitByDiff by_time(15.0);
+		auto stateful = [&](const Row& row) {
+			const bool f = by_field(row);
+			const bool t = by_time(row);
+			return f || t;
+		};
+		using ProbeInputIterator = decltype(probe_points.begin());
+		movetk::io::Splitter<decltype(stateful), ProbeInputIterator> splitter(probe_points.begin(),
+		                                                                      probe_points.end(),
+		                                                                      stateful);
+		std::size_t i = 0;
+		for (const auto& rows : splitter) {
+			REQUIRE(i < ranges.size());
+			REQUIRE(rows == std::vector<Row>(probe_points.begin() + ranges[i].first,
+			                                 probe_points.begin() + ranges[i].beyond));
+			i++;
+		}
+		REQUIRE(i == ranges.size());
+
+		ranges.clear();
+		movetk::io::split_ranges(probe_points.begin(), probe_points.end(), split, std::back_inserter(ranges), 2);
+		REQUIRE(ranges == std::vector<movetk::io::IndexRange>{{1, 3}, {4, 6}});
+	}
+
 	SECTION("Split by distance threshold") {
 		using SplitByDist = movetk::io::SplitByDistanceThreshold<3, 5, Row>;
+		// A default constructed std::function is empty, so the distance function must be given
+		static_assert(!std::is_constructible_v<SplitByDist, float>);
 		std::function<double(float, float, float, float)> distancefn = movetk::geo::distance_exact;
 		SplitByDist split_by_dist(110000.0, distancefn);
 		using ProbeInputIterator = decltype(probe_points.begin());
@@ -134,4 +186,56 @@ TEST_CASE("Splitter", "[splitter]") {
 		}
 		//        REQUIRE( i == expected_split_count );
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("High frequency trajectory splitter", "[splitter]") {
+	using Row = std::tuple<std::string, long, float, float>;
+	using Trajectory = movetk::ds::TabularTrajectory<std::string, long, float, float>;
+	// Gaps of more than 10 s or about 1 km split the trajectories
+	std::vector<Trajectory> trajectories;
+	trajectories.emplace_back(std::vector<Row>{{"a", 0, 52.0f, 5.0f},
+	                                           {"a", 5, 52.0f, 5.001f},
+	                                           {"a", 10, 52.0f, 5.002f},
+	                                           {"a", 30, 52.0f, 5.003f},
+	                                           {"a", 35, 52.0f, 5.004f},
+	                                           {"a", 40, 52.1f, 5.004f},
+	                                           {"a", 45, 52.1f, 5.005f},
+	                                           {"a", 50, 52.1f, 5.006f}});
+	trajectories.emplace_back(std::vector<Row>{{"b", 0, 10.0f, 10.0f}});
+	trajectories.emplace_back(std::vector<Row>{{"c", 0, 10.0f, 10.0f}, {"c", 1, 10.0f, 10.0f}});
+	const std::vector<std::vector<long>> expected = {{0, 5, 10}, {30, 35}, {40, 45, 50}, {0, 1}};
+
+	using Iterator = decltype(trajectories.begin());
+	SECTION("Materialized") {
+		movetk::io::HighFrequencyTrajectorySplitter<Iterator, 1, 2, 3> splitter(trajectories.begin(),
+		                                                                        trajectories.end(),
+		                                                                        10.0f,
+		                                                                        1000.0f);
+		std::vector<std::vector<long>> timestamps;
+		for (const auto& trajectory : splitter) {
+			timestamps.push_back(trajectory.get<1>());
+		}
+		REQUIRE(timestamps == expected);
+		REQUIRE(splitter.split(trajectories[0]) ==
+		        std::vector<movetk::io::IndexRange>{{0, 3}, {3, 5}, {5, 8}});
+	}
+
+	SECTION("Views") {
+		movetk::io::HighFrequencyTrajectorySplitter<Iterator, 1, 2, 3, false> splitter(trajectories.begin(),
+		                                                                               trajectories.end(),
+		                                                                               10.0f,
+		                                                                               1000.0f);
+		std::vector<std::vector<long>> timestamps;
+		for (const auto& split : splitter) {
+			std::vector<long> split_timestamps;
+			for (const auto& point : split) {
+				split_timestamps.push_back(std::get<1>(point));
+			}
+			// Views point into the input trajectories
+			REQUIRE(&split.parent().data()[split.range().first] == &split[0]);
+			REQUIRE(split.materialize().template get<1>() == split_timestamps);
+			timestamps.push_back(split_timestamps);
+		}
+		REQUIRE(timestamps == expected);
+	}
+}
@@ -18,12 +18,14 @@
  */
 
 #include <array>
+#include <random>
 
 #include "catch2/catch.hpp"
 
 // Defines the geometry kernel
 #include <movetk/metric/Distances.h>
 #include <movetk/metric/Norm.h>
+#include <movetk/utils/ThreadPool.h>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -78,10 +80,9 @@ struct StrongFrechetTests {
 
 const char* SFR_TAG = "[strong_frechet]";
 
-TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
-                               "Check if polyline strong Frechet distance is correct",
-                               SFR_TAG,
-                               movetk::test::AvailableBackends) {
+MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
+                                      "Check if polyline strong Frechet distance is correct",
+                                      SFR_TAG) {
 	using Fixture = StrongFrechetTests<TestType>;
 	// Initialize algorithm.
 	typename Fixture::SFR sfr;
@@ -103,23 +104,26 @@ TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
 			// Compute expected distance
 			auto expectedDist = std::sqrt(sqDist(expectedDistLine[0], expectedDistLine[1]));
 
-			// Try strong frechet in both orders
-			{
-				auto dist = sfr(polyA.begin(), polyA.end(), polyB.begin(), polyB.end());
-				REQUIRE(dist == Approx(expectedDist).margin(sfr.tolerance()));
-			}
-			{
-				auto dist = sfr(polyB.begin(), polyB.end(), polyA.begin(), polyA.end());
-				REQUIRE(dist == Approx(expectedDist).margin(sfr.tolerance()));
+			// Both storage modes of the freespace diagram must give the same results
+			for (auto storage : {Fixture::SFR::FreespaceStorage::Precomputed, Fixture::SFR::FreespaceStorage::Streamed}) {
+				sfr.setFreespaceStorage(storage);
+				// Try strong frechet in both orders
+				{
+					auto dist = sfr(polyA.begin(), polyA.end(), polyB.begin(), polyB.end());
+					REQUIRE(dist == Approx(expectedDist).margin(sfr.tolerance()));
+				}
+				{
+					auto dist = sfr(polyB.begin(), polyB.end(), polyA.begin(), polyA.end());
+					REQUIRE(dist == Approx(expectedDist).margin(sfr.tolerance()));
+				}
 			}
 		}
 	}
 }
 
-TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
-                               "Check if polyline strong Frechet distance is correct with upperbounded search",
-                               SFR_TAG,
-                               movetk::test::AvailableBackends) {
+MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
+                                      "Check if polyline strong Frechet distance is correct with upperbounded search",
+                                      SFR_TAG) {
 	using Fixture = StrongFrechetTests<TestType>;
 	// Initialize algorithm.
 	typename Fixture::SFR sfr;
@@ -147,24 +151,27 @@ TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
 			// Compute expected distance
 			auto expectedDist = std::sqrt(sqDist(expectedDistLine[0], expectedDistLine[1]));
 
-			for (std::size_t i = 0; i < fractions.size(); ++i) {
-				sfr.setUpperbound(expectedDist * fractions[i]);
-				typename Fixture::NT epsilon = -1;
-				// Try algorithm with both polyA and polyB as first polyline
-				{
-					bool success = sfr(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), epsilon);
-					// Check whether we expect success or not.
-					REQUIRE(success == expectSuccess[i]);
-					if (success) {
-						REQUIRE_MESSAGE(epsilon == Approx(expectedDist).margin(sfr.tolerance()),
-						                (std::string("Failed at fraction ") + std::to_string(fractions[i])));
+			for (auto storage : {Fixture::SFR::FreespaceStorage::Precomputed, Fixture::SFR::FreespaceStorage::Streamed}) {
+				sfr.setFreespaceStorage(storage);
+				for (std::size_t i = 0; i < fractions.size(); ++i) {
+					sfr.setUpperbound(expectedDist * fractions[i]);
+					typename Fixture::NT epsilon = -1;
+					// Try algorithm with both polyA and polyB as first polyline
+					{
+						bool success = sfr(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), epsilon);
+						// Check whether we expect success or not.
+						REQUIRE(success == expectSuccess[i]);
+						if (success) {
+							REQUIRE_MESSAGE(epsilon == Approx(expectedDist).margin(sfr.tolerance()),
+							                (std::string("Failed at fraction ") + std::to_string(fractions[i])));
+						}
 					}
-				}
-				{
-					bool success = sfr(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), epsilon);
-					REQUIRE(success == expectSuccess[i]);
-					if (success) {
-						REQUIRE(epsilon == Approx(expectedDist).margin(sfr.tolerance()));
+					{
+						bool success = sfr(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), epsilon);
+						REQUIRE(success == expectSuccess[i]);
+						if (success) {
+							REQUIRE(epsilon == Approx(expectedDist).margin(sfr.tolerance()));
+						}
 					}
 				}
 			}
@@ -172,10 +179,9 @@ TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
 	}
 }
 
-TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
-                               "Check if decision strong Frechet distance is correct",
-                               "[strong_frechet]",
-                               movetk::test::AvailableBackends) {
+MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
+                                      "Check if decision strong Frechet distance is correct",
+                                      "[strong_frechet]") {
 	using Fixture = StrongFrechetTests<TestType>;
 	// Initialize algorithm.
 	typename Fixture::SFR sfr;
@@ -202,20 +208,62 @@ TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
 			// Compute expected distance
 			auto expectedDist = std::sqrt(sqDist(expectedDistLine[0], expectedDistLine[1]));
 
-			for (std::size_t i = 0; i < fractions.size(); ++i) {
-				// Try algorithm with both polyA and polyB as first polyline
-				{
-					bool success =
-					    sfr.decide(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), expectedDist * fractions[i]);
-					// Check whether we expect success or not.
-					REQUIRE(success == expectSuccess[i]);
-				}
-				{
-					bool success =
-					    sfr.decide(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), expectedDist * fractions[i]);
-					REQUIRE(success == expectSuccess[i]);
+			for (auto storage : {Fixture::SFR::FreespaceStorage::Precomputed, Fixture::SFR::FreespaceStorage::Streamed}) {
+				sfr.setFreespaceStorage(storage);
+				for (std::size_t i = 0; i < fractions.size(); ++i) {
+					// Try algorithm with both polyA and polyB as first polyline
+					{
+						bool success =
+						    sfr.decide(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), expectedDist * fractions[i]);
+						// Check whether we expect success or not.
+						REQUIRE(success == expectSuccess[i]);
+					}
+					{
+						bool success =
+						    sfr.decide(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), expectedDist * fractions[i]);
+						REQUIRE(success == expectSuccess[i]);
+					}
 				}
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE_METHOD(StrongFrechetTests,
+                                      "Check if parallel wavefront strong Frechet decision matches sequential decision",
+                                      "[strong_frechet]") {
+	using Fixture = StrongFrechetTests<TestType>;
+	movetk::geom::MakePoint<typename Fixture::MovetkGeometryKernel> make_point;
+	// Two noisy random walks along the same direction
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> noise(-1.0, 1.0);
+	typename Fixture::PointList polyA, polyB;
+	for (std::size_t i = 0; i < 53; ++i) {
+		polyA.push_back(
+		    make_point({static_cast<typename Fixture::NT>(i), static_cast<typename Fixture::NT>(noise(generator))}));
+	}
+	for (std::size_t i = 0; i < 41; ++i) {
+		polyB.push_back(make_point({static_cast<typename Fixture::NT>(i * 52.0 / 40.0),
+		                            static_cast<typename Fixture::NT>(noise(generator))}));
+	}
+
+	typename Fixture::SFR sequential;
+	sequential.setTolerance(0.0001);
+	movetk::utils::ThreadPool pool(4);
+	typename Fixture::SFR parallel;
+	parallel.setTolerance(0.0001);
+	parallel.setThreadPool(&pool);
+	parallel.setTileSize(4);
+
+	for (auto storage : {Fixture::SFR::FreespaceStorage::Precomputed, Fixture::SFR::FreespaceStorage::Streamed}) {
+		parallel.setFreespaceStorage(storage);
+		for (typename Fixture::NT epsilon = 0.25; epsilon < 4.0; epsilon += 0.25) {
+			REQUIRE(parallel.decide(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), epsilon) ==
+			        sequential.decide(polyA.begin(), polyA.end(), polyB.begin(), polyB.end(), epsilon));
+			REQUIRE(parallel.decide(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), epsilon) ==
+			        sequential.decide(polyB.begin(), polyB.end(), polyA.begin(), polyA.end(), epsilon));
+		}
+		REQUIRE(parallel(polyA.begin(), polyA.end(), polyB.begin(), polyB.end()) ==
+		        Approx(sequential(polyA.begin(), polyA.end(), polyB.begin(), polyB.end())).margin(0.0001));
+	}
+}
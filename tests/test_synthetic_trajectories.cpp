@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "movetk/io/ParseDate.h"
+#include "movetk/io/SyntheticTrajectoryGenerator.h"
+#include "movetk/io/csv/csv.h"
+#include "movetk/utils/Philox.h"
+#include "movetk/utils/ThreadPool.h"
+
+using movetk::io::SyntheticProbe;
+using movetk::io::SyntheticTrajectoryGenerator;
+using movetk::io::SyntheticTrajectoryOptions;
+
+namespace {
+std::vector<SyntheticProbe> generate(const SyntheticTrajectoryGenerator& generator, std::size_t trajectory) {
+	std::vector<SyntheticProbe> probes;
+	generator.generate(trajectory, std::back_inserter(probes));
+	return probes;
+}
+}  // namespace
+
+TEST_CASE("Philox known answers", "[philox]") {
+	using Philox = movetk::utils::Philox4x32;
+	// Known answer tests of the Random123 distribution
+	REQUIRE(Philox::bijection({0, 0, 0, 0}, {0, 0}) == Philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+	REQUIRE(Philox::bijection({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+	        Philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+	REQUIRE(Philox::bijection({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+	        Philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("Philox streams", "[philox]") {
+	using Philox = movetk::utils::Philox4x32;
+	Philox a(42, 7), b(42, 7), other_stream(42, 8), other_seed(43, 7);
+	std::vector<std::uint32_t> values;
+	bool differs_stream = false, differs_seed = false;
+	for (int i = 0; i < 100; ++i) {
+		const auto value = a();
+		values.push_back(value);
+		REQUIRE(value == b());
+		differs_stream |= value != other_stream();
+		differs_seed |= value != other_seed();
+	}
+	REQUIRE(differs_stream);
+	REQUIRE(differs_seed);
+
+	for (std::uint64_t skip : {0, 1, 3, 4, 5, 17, 64}) {
+		Philox c(42, 7);
+		c();
+		c.discard(skip);
+		REQUIRE(c() == values[skip + 1]);
+	}
+
+	Philox d(1);
+	double sum = 0, sum_of_squares = 0;
+	constexpr int N = 100000;
+	for (int i = 0; i < N; ++i) {
+		const auto u = d.uniform();
+		REQUIRE(u >= 0);
+		REQUIRE(u < 1);
+		const auto z = d.normal();
+		sum += z;
+		sum_of_squares += z * z;
+	}
+	REQUIRE(std::abs(sum / N) < 0.02);
+	REQUIRE(std::abs(sum_of_squares / N - 1) < 0.02);
+}
+
+TEST_CASE("Synthetic trajectories are reproducible", "[synthetic_trajectories]") {
+	SyntheticTrajectoryOptions options;
+	options.min_samples = 50;
+	options.max_samples = 200;
+	options.outlier_probability = 0.01;
+	options.gap_probability = 0.01;
+	options.duplicate_probability = 0.01;
+	SyntheticTrajectoryGenerator generator(options);
+
+	REQUIRE(generate(generator, 3) == generate(generator, 3));
+	REQUIRE_FALSE(generate(generator, 3) == generate(generator, 4));
+
+	movetk::utils::ThreadPool pool(4);
+	const auto sequential = generator.generate_columnar(10, 150);
+	const auto parallel = generator.generate_columnar(10, 150, &pool);
+	REQUIRE(sequential.size() == 140);
+	REQUIRE(parallel.size() == 140);
+	for (std::size_t i = 0; i < sequential.size(); ++i) {
+		REQUIRE(sequential[i].data() == parallel[i].data());
+		const auto probes = generate(generator, 10 + i);
+		REQUIRE(sequential[i].size() == probes.size());
+		REQUIRE(sequential[i].get<movetk::io::LAT>()[0] == probes[0].lat);
+	}
+
+	std::ostringstream sequential_csv, parallel_csv;
+	generator.write_csv(sequential_csv, 150);
+	generator.write_csv(parallel_csv, 150, &pool);
+	REQUIRE(sequential_csv.str() == parallel_csv.str());
+}
+
+TEST_CASE("Synthetic trajectory properties", "[synthetic_trajectories]") {
+	SyntheticTrajectoryOptions options;
+	options.min_samples = 100;
+	options.max_samples = 300;
+	options.sampling_interval = 5;
+	options.gps_noise = 0;
+	options.outlier_probability = 0;
+	options.gap_probability = 0;
+	options.duplicate_probability = 0;
+
+	constexpr double METERS_PER_DEGREE = 6371008.8 * 3.14159265358979 / 180;
+	for (auto profile : {movetk::io::SpeedProfile::Constant,
+	                     movetk::io::SpeedProfile::Urban,
+	                     movetk::io::SpeedProfile::Highway}) {
+		options.speed_profile = profile;
+		SyntheticTrajectoryGenerator generator(options);
+		for (std::size_t trajectory = 0; trajectory < 20; ++trajectory) {
+			const auto probes = generate(generator, trajectory);
+			REQUIRE(probes.size() >= options.min_samples);
+			REQUIRE(probes.size() <= options.max_samples);
+			REQUIRE(probes[0].timestamp >= options.start_time);
+			REQUIRE(probes[0].timestamp < options.start_time + options.start_time_spread);
+			REQUIRE(std::abs(probes[0].lat - options.center_lat) <= options.extent / 2);
+			REQUIRE(std::abs(probes[0].lon - options.center_lon) <= options.extent / 2);
+			for (std::size_t i = 1; i < probes.size(); ++i) {
+				REQUIRE(probes[i].timestamp - probes[i - 1].timestamp == options.sampling_interval);
+				REQUIRE(probes[i].heading >= 0);
+				REQUIRE(probes[i].heading < 360);
+				const auto dy = (probes[i].lat - probes[i - 1].lat) * METERS_PER_DEGREE;
+				const auto dx =
+				    (probes[i].lon - probes[i - 1].lon) * METERS_PER_DEGREE * std::cos(probes[0].lat * 3.14159265358979 / 180);
+				REQUIRE(std::hypot(dx, dy) <= options.max_speed * options.sampling_interval * 1.01);
+			}
+		}
+	}
+
+	SECTION("Defects") {
+		options.duplicate_probability = 1;
+		const auto duplicated = generate(SyntheticTrajectoryGenerator(options), 0);
+		REQUIRE(duplicated.size() % 2 == 0);
+		for (std::size_t i = 0; i < duplicated.size(); i += 2) {
+			REQUIRE(duplicated[i].timestamp == duplicated[i + 1].timestamp);
+		}
+
+		options.duplicate_probability = 0;
+		options.gap_probability = 1;
+		options.gap_duration = 60;
+		const auto gapped = generate(SyntheticTrajectoryGenerator(options), 0);
+		for (std::size_t i = 1; i < gapped.size(); ++i) {
+			REQUIRE(gapped[i].timestamp - gapped[i - 1].timestamp == 65);
+		}
+
+		options.gap_probability = 0;
+		options.outlier_probability = 1;
+		options.outlier_distance = 10000;
+		const auto displaced = generate(SyntheticTrajectoryGenerator(options), 0);
+		for (std::size_t i = 1; i < displaced.size(); ++i) {
+			const auto dy = (displaced[i].lat - displaced[i - 1].lat) * METERS_PER_DEGREE;
+			REQUIRE(std::abs(dy) <= 2 * options.outlier_distance + options.max_speed * options.sampling_interval);
+		}
+	}
+}
+
+TEST_CASE("Synthetic trajectory options are validated", "[synthetic_trajectories]") {
+	SyntheticTrajectoryOptions options;
+	options.min_samples = 10;
+	options.max_samples = 10;
+	REQUIRE_NOTHROW(SyntheticTrajectoryGenerator(options));
+	options.max_samples = 9;
+	REQUIRE_THROWS_AS(SyntheticTrajectoryGenerator(options), std::invalid_argument);
+	options.max_samples = 10;
+	options.sampling_interval = -1;
+	REQUIRE_THROWS_AS(SyntheticTrajectoryGenerator(options), std::invalid_argument);
+}
+
+TEST_CASE("Synthetic trajectories as csv", "[synthetic_trajectories]") {
+	SyntheticTrajectoryOptions options;
+	options.min_samples = 10;
+	options.max_samples = 40;
+	options.duplicate_probability = 0.05;
+	SyntheticTrajectoryGenerator generator(options);
+	constexpr std::size_t NUM_TRAJECTORIES = 200;
+
+	std::size_t expected_rows = 0;
+	for (std::size_t trajectory = 0; trajectory < NUM_TRAJECTORIES; ++trajectory) {
+		expected_rows += generate(generator, trajectory).size();
+	}
+
+	std::ostringstream csv_out;
+	generator.write_csv(csv_out, NUM_TRAJECTORIES);
+	const auto csv = csv_out.str();
+
+	using Row = std::tuple<std::string, movetk::io::ParseDate, double, double, double, double, std::string>;
+	std::istringstream in(csv);
+	movetk::io::csv::csv<Row, 0, 1, 2, 3, 4, 5, 6> table(in, ',', true);
+	std::size_t rows = 0;
+	for (const auto& row : table) {
+		if (rows == 0) {
+			const auto first = generate(generator, 0)[0];
+			REQUIRE(std::get<0>(row) == SyntheticTrajectoryGenerator::probe_id(0));
+			REQUIRE(std::get<2>(row) == Approx(first.lat).margin(1e-7));
+			REQUIRE(std::get<3>(row) == Approx(first.lon).margin(1e-7));
+		}
+		++rows;
+	}
+	REQUIRE(rows == expected_rows);
+
+	SECTION("Gzipped") {
+		movetk::utils::ThreadPool pool(3);
+		std::ostringstream gzip_out(std::ios_base::out | std::ios_base::binary);
+		generator.write_gzip_csv(gzip_out, NUM_TRAJECTORIES, &pool);
+		REQUIRE(gzip_out.str().size() < csv.size());
+
+		std::istringstream gzip_in(gzip_out.str(), std::ios_base::in | std::ios_base::binary);
+		boost::iostreams::filtering_istream decompressed;
+		decompressed.push(boost::iostreams::gzip_decompressor());
+		decompressed.push(gzip_in);
+		std::ostringstream restored;
+		boost::iostreams::copy(decompressed, restored);
+		REQUIRE(restored.str() == csv);
+	}
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "movetk/utils/ThreadPool.h"
+
+TEST_CASE("Thread pool visits every index exactly once", "[thread_pool]") {
+	movetk::utils::ThreadPool pool(4);
+	REQUIRE(pool.size() == 4);
+	for (std::size_t round = 0; round < 10; ++round) {
+		std::vector<std::atomic<int>> visits(1000);
+		pool.parallel_for(0, visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+		for (const auto& count : visits) {
+			REQUIRE(count == 1);
+		}
+	}
+}
+
+TEST_CASE("Thread pool rethrows exceptions of the loop body", "[thread_pool]") {
+	movetk::utils::ThreadPool pool(3);
+	REQUIRE_THROWS_AS(pool.parallel_for(0,
+	                                    100,
+	                                    [](std::size_t i) {
+		                                    if (i == 42) {
+			                                    throw std::runtime_error("failure");
+		                                    }
+	                                    }),
+	                  std::runtime_error);
+	// The pool remains usable
+	std::atomic<std::size_t> sum{0};
+	pool.parallel_for(0, 10, [&sum](std::size_t i) { sum += i; });
+	REQUIRE(sum == 45);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <catch2/catch.hpp>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "movetk/io/ParseDate.h"
+#include "movetk/io/TimestampParser.h"
+#include "movetk/io/csv/csv.h"
+
+using movetk::io::TimestampLayout;
+using movetk::io::TimestampParser;
+
+TEST_CASE("Timestamp layouts of formats", "[timestamp_parser]") {
+	REQUIRE(movetk::io::timestamp_layout("%Y-%m-%d") == TimestampLayout::Date);
+	REQUIRE(movetk::io::timestamp_layout("%Y-%m-%d %H:%M:%S") == TimestampLayout::DateTime);
+	REQUIRE(movetk::io::timestamp_layout("%FT%T%z") == TimestampLayout::DateTime);
+	REQUIRE(movetk::io::timestamp_layout("%s") == TimestampLayout::EpochSeconds);
+	REQUIRE(movetk::io::timestamp_layout("%Q") == TimestampLayout::EpochMilliseconds);
+	REQUIRE(movetk::io::timestamp_layout("%d/%m/%Y") == TimestampLayout::Other);
+}
+
+TEST_CASE("Days from civil dates", "[timestamp_parser]") {
+	REQUIRE(movetk::io::days_from_civil(1970, 1, 1) == 0);
+	REQUIRE(movetk::io::days_from_civil(1969, 12, 31) == -1);
+	REQUIRE(movetk::io::days_from_civil(2000, 3, 1) == 11017);
+	REQUIRE(movetk::io::days_from_civil(1600, 1, 1) == -135140);
+	// Agrees with timegm for every day of a few leap cycles
+	std::int64_t days = movetk::io::days_from_civil(1995, 1, 1);
+	for (int year = 1995; year < 2010; ++year) {
+		for (unsigned month = 1; month <= 12; ++month) {
+			std::tm tm = {};
+			tm.tm_year = year - 1900;
+			tm.tm_mon = static_cast<int>(month) - 1;
+			tm.tm_mday = 1;
+			REQUIRE(movetk::io::days_from_civil(year, month, 1) * 86400 == timegm(&tm));
+		}
+	}
+	REQUIRE(movetk::io::days_from_civil(2010, 1, 1) - days == 5479);
+}
+
+TEST_CASE("Timestamps in fixed layouts", "[timestamp_parser]") {
+	SECTION("Date and time") {
+		TimestampParser parser(TimestampLayout::DateTime);
+		REQUIRE(parser.parse("1970-01-01 00:00:00") == 0);
+		REQUIRE(parser.parse("2018-09-18 00:58:02") == 1537232282);
+		// The cached date is reused
+		REQUIRE(parser.parse("2018-09-18 00:58:12") == 1537232292);
+		REQUIRE(parser.parse("2018-09-18T00:58:12") == 1537232292);
+		REQUIRE(parser.parse("2018-09-18T00:58:12.999Z") == 1537232292);
+		REQUIRE(parser.parse("2018-09-18T02:58:12+02:00") == 1537232292);
+		REQUIRE(parser.parse("2018-09-17T22:58:12-0200") == 1537232292);
+		REQUIRE(parser.parse("2018-09-18T01:58:12+01") == 1537232292);
+		REQUIRE(parser.parse("2016-02-29 12:00:00") == 1456747200);
+		REQUIRE(parser.parse("1969-12-31 23:59:59") == -1);
+	}
+	SECTION("Date") {
+		TimestampParser parser(TimestampLayout::Date);
+		REQUIRE(parser.parse("2018-09-18") == 1537228800);
+		REQUIRE_FALSE(parser.parse("2018-09-18 00:58:02"));
+	}
+	SECTION("Epoch") {
+		TimestampParser seconds(TimestampLayout::EpochSeconds);
+		REQUIRE(seconds.parse("1537232282") == 1537232282);
+		REQUIRE(seconds.parse("1537232282.75") == 1537232282);
+		REQUIRE(seconds.parse("-1.5") == -2);
+		TimestampParser milliseconds(TimestampLayout::EpochMilliseconds);
+		REQUIRE(milliseconds.parse("1537232282750") == 1537232282);
+		REQUIRE(milliseconds.parse("-1500") == -2);
+		REQUIRE(milliseconds.parse("-1000") == -1);
+	}
+	SECTION("Invalid timestamps") {
+		TimestampParser parser(TimestampLayout::DateTime);
+		for (const auto text : {"",
+		                        "2018-09-18",
+		                        "2018/09/18 00:58:02",
+		                        "2018-13-18 00:58:02",
+		                        "2018-02-29 00:58:02",
+		                        "2018-09-00 00:58:02",
+		                        "2018-09-18 24:00:00",
+		                        "2018-09-18 00:60:00",
+		                        "2018-09-18 00:58:0x",
+		                        "2018-09-18x00:58:02",
+		                        "2018-09-18 00:58:02.",
+		                        "2018-09-18 00:58:02Z0",
+		                        "2018-09-18 00:58:02+2",
+		                        "2018-09-18 00:58:02 "}) {
+			INFO(text);
+			REQUIRE_FALSE(parser.parse(text));
+		}
+		TimestampParser seconds(TimestampLayout::EpochSeconds);
+		REQUIRE_FALSE(seconds.parse(""));
+		REQUIRE_FALSE(seconds.parse("-"));
+		REQUIRE_FALSE(seconds.parse("12a"));
+		REQUIRE_FALSE(seconds.parse("1234567890123456789"));
+	}
+}
+
+TEST_CASE("ParseDate reads fixed layouts as UTC", "[timestamp_parser]") {
+	auto read = [](const std::string& text, const std::string& format) {
+		movetk::io::ParseDate date(0, format);
+		std::istringstream stream(text);
+		stream >> date;
+		return std::make_pair(date.ts(), static_cast<bool>(stream));
+	};
+	REQUIRE(read("2018-09-18 00:58:02", "%Y-%m-%d %H:%M:%S") == std::make_pair(std::time_t(1537232282), true));
+	REQUIRE(read("  2018-09-18T00:58:02Z", "%FT%TZ") == std::make_pair(std::time_t(1537232282), true));
+	REQUIRE(read("1537232282750", "%Q") == std::make_pair(std::time_t(1537232282), true));
+	// Other formats are read with std::get_time, also as UTC
+	REQUIRE(read("18/09/2018 00:58:02", "%d/%m/%Y %H:%M:%S") == std::make_pair(std::time_t(1537232282), true));
+	// Errors are reported by the stream
+	REQUIRE_FALSE(read("2018-09-18 25:58:02", "%Y-%m-%d %H:%M:%S").second);
+	REQUIRE_FALSE(read("yesterday", "%d/%m/%Y %H:%M:%S").second);
+
+	SECTION("The rest of the stream is left") {
+		movetk::io::ParseDate date(0, "%Y-%m-%d");
+		std::istringstream stream("2018-09-18 00:58:02");
+		stream >> date;
+		std::string rest;
+		std::getline(stream, rest);
+		REQUIRE(date.ts() == 1537228800);
+		REQUIRE(rest == " 00:58:02");
+	}
+
+	SECTION("Round trip") {
+		for (const auto& format : {"%Y-%m-%d %H:%M:%S", "%s", "%Q"}) {
+			movetk::io::ParseDate date(1537232282, format);
+			std::ostringstream os;
+			os << date;
+			REQUIRE(read(os.str(), format).first == 1537232282);
+		}
+	}
+
+	SECTION("Field of a csv row") {
+		class ProbeDate : public movetk::io::ParseDate {
+		public:
+			explicit ProbeDate(std::time_t ts = 0, std::string date_format = "%Y-%m-%d %H:%M:%S")
+			    : ParseDate(ts, std::move(date_format)) {}
+		};
+		using Row = std::tuple<std::string, ProbeDate, double>;
+		std::istringstream stream("id,date,speed\na,2018-09-18 00:58:02,1.5\nb,2018-09-18 00:58:12,2.5\n");
+		movetk::io::csv::csv<Row, 0, 1, 2> table(stream, ',', true);
+		std::vector<std::time_t> timestamps;
+		for (const auto& row : table) {
+			timestamps.push_back(std::get<1>(row).ts());
+		}
+		REQUIRE(timestamps == std::vector<std::time_t>{1537232282, 1537232292});
+	}
+}
@@ -18,6 +18,7 @@
  */
 
 
+#include <algorithm>
 #include <array>
 #include <catch2/catch.hpp>
 #include <iostream>
@@ -30,7 +31,13 @@
 #include "movetk/geom/BoostGeometryTraits.h"
 #include "movetk/geom/BoostGeometryWrapper.h"
 #include "movetk/geom/GeometryInterface.h"
+#include "movetk/io/TrajectoryReader.h"
+#include "movetk/io/TrajectoryTraits.h"
 #include "movetk/io/TuplePrinter.h"
+#include "movetk/metric/Norm.h"
+#include "movetk/metric/distances/DiscreteFrechet.h"
+#include "movetk/segmentation/SegmentationTraits.h"
+#include "movetk/simplification/DouglasPeucker.h"
 
 struct BaseTrajectoryTests {
 	using ProbePoint = std::tuple<std::string, int, float>;
@@ -88,6 +95,99 @@ TEST_CASE_METHOD(BaseTrajectoryTests, "TabularTrajectory field iterator", "[tabu
 	REQUIRE(std::distance(first, last) == 2);
 }
 
+TEST_CASE_METHOD(BaseTrajectoryTests, "TabularTrajectory field views", "[tabulartrajectory_field_iterator]") {
+	static_assert(std::random_access_iterator<TabularTrajectory::FieldIterator<0>>);
+	static_assert(std::random_access_iterator<TabularTrajectory::ConstFieldIterator<2>>);
+	static_assert(std::ranges::random_access_range<TabularTrajectory::FieldView<1>>);
+	static_assert(std::ranges::sized_range<TabularTrajectory::ConstFieldView<1>>);
+
+	std::vector<ProbePoint> data;
+	for (int i = 0; i < 10; ++i) {
+		data.emplace_back(std::to_string(i), 3 * i, 0.5f * i);
+	}
+	TabularTrajectory t{data};
+	const TabularTrajectory& const_t = t;
+
+	auto timestamps = t.field<1>();
+	REQUIRE(timestamps.size() == 10);
+	REQUIRE(timestamps[4] == 12);
+	REQUIRE(*(timestamps.end() - 1) == 27);
+	REQUIRE(timestamps.end() - timestamps.begin() == 10);
+	REQUIRE(std::ranges::lower_bound(timestamps, 13) - timestamps.begin() == 5);
+	REQUIRE(*std::ranges::lower_bound(const_t.field<1>(), 13) == 15);
+
+	// Values are written through to the rows
+	std::ranges::fill(t.field<2>(), 1.5f);
+	REQUIRE(std::get<2>(*(t.begin() + 3)) == 1.5f);
+	REQUIRE(const_t.field<0>()[7] == "7");
+	TabularTrajectory::ConstFieldIterator<1> converted = t.begin<1>();
+	REQUIRE(*converted == 0);
+	REQUIRE(t.get<1>() == std::vector<int>(timestamps.begin(), timestamps.end()));
+}
+
+TEST_CASE("Algorithms on point views of a TabularTrajectory", "[tabulartrajectory_point_view]") {
+	using MovetkGeometryKernel = movetk::backends::boost::KernelFor<double, 2>;
+	using Point = MovetkGeometryKernel::MovetkPoint;
+	using Norm = movetk::metric::FiniteNorm<MovetkGeometryKernel, 2>;
+	using Trajectory = movetk::ds::TabularTrajectory<std::size_t, double, float>;
+	using PointIterator = Trajectory::PointIterator<MovetkGeometryKernel, 1, 2>;
+	static_assert(movetk::utils::RandomAccessPointIterator<PointIterator, MovetkGeometryKernel>);
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	std::vector<std::tuple<std::size_t, double, float>> rows_a, rows_b;
+	std::vector<Point> points_a, points_b;
+	for (std::size_t i = 0; i < 50; ++i) {
+		const double x = static_cast<double>(i);
+		const float y = static_cast<float>((i * 37) % 11);
+		rows_a.emplace_back(i, x, y);
+		points_a.push_back(make_point({x, static_cast<double>(y)}));
+		rows_b.emplace_back(i, x + 0.5, y - 1.0f);
+		points_b.push_back(make_point({x + 0.5, static_cast<double>(y - 1.0f)}));
+	}
+	const Trajectory a(rows_a), b(rows_b);
+	const auto view_a = a.points<MovetkGeometryKernel, 1, 2>();
+	const auto view_b = b.points<MovetkGeometryKernel, 1, 2>();
+	REQUIRE(view_a.size() == points_a.size());
+	const Point p = view_a[3];
+	REQUIRE(std::equal(p.begin(), p.end(), points_a[3].begin()));
+	REQUIRE(*((view_a.begin() + 7)->begin() + 1) == *(points_a[7].begin() + 1));
+
+	SECTION("Discrete Frechet") {
+		movetk::metric::Discrete_Frechet<MovetkGeometryKernel, Norm> frechet;
+		REQUIRE(frechet(view_a.begin(), view_a.end(), view_b.begin(), view_b.end()) ==
+		        Approx(frechet(points_a.begin(), points_a.end(), points_b.begin(), points_b.end())));
+	}
+
+	SECTION("Douglas-Peucker") {
+		using FindFarthest = movetk::simplification::FindFarthest<MovetkGeometryKernel, Norm>;
+		movetk::simplification::DouglasPeucker<MovetkGeometryKernel, FindFarthest> douglas_peucker(2);
+		std::vector<PointIterator> result;
+		douglas_peucker(view_a.begin(), view_a.end(), std::back_inserter(result));
+		std::vector<std::vector<Point>::const_iterator> expected;
+		douglas_peucker(points_a.cbegin(), points_a.cend(), std::back_inserter(expected));
+		REQUIRE(result.size() > 2);
+		REQUIRE(result.size() == expected.size());
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			REQUIRE(result[i] - view_a.begin() == expected[i] - points_a.cbegin());
+		}
+	}
+
+	SECTION("Monotone segmentation") {
+		using SegmentationTraits =
+		    movetk::segmentation::SegmentationTraits<double, MovetkGeometryKernel, 2>;
+		SegmentationTraits::LocationSegmentation segmentation(4);
+		std::vector<PointIterator> result;
+		segmentation(view_a.begin(), view_a.end(), std::back_inserter(result));
+		std::vector<std::vector<Point>::const_iterator> expected;
+		segmentation(points_a.cbegin(), points_a.cend(), std::back_inserter(expected));
+		REQUIRE(result.size() > 1);
+		REQUIRE(result.size() == expected.size());
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			REQUIRE(result[i] - view_a.begin() == expected[i] - points_a.cbegin());
+		}
+	}
+}
+
 TEST_CASE_METHOD(BaseTrajectoryTests, "Update field values of TabularTrajectory", "[update_tabulartrajectory]") {
 	ProbePoint p1 = {"abc", 1, 5.4};
 	ProbePoint p2 = {"def", 2, 4.5};
@@ -252,4 +352,44 @@ TEST_CASE("trajectory lookup by offset", "[lookupbyoffset]") {
 		REQUIRE(res_opt);
 		REQUIRE(*res_opt == Approx(80.).epsilon(0.00001));
 	}
-}
\ No newline at end of file
+}
+
+TEMPLATE_TEST_CASE("TrajectoryReader recycles trajectories",
+                   "[trajectory_reader]",
+                   (movetk::ds::TabularTrajectory<std::string, int, float>),
+                   (movetk::ds::ColumnarTrajectory<std::string, int, float>)) {
+	using ProbePoint = std::tuple<std::string, int, float>;
+	using Traits = movetk::io::_TrajectoryTraits<void, 0, 1, TestType>;
+	// Grouped by id, with unsorted and duplicate timestamps in some groups
+	std::vector<ProbePoint> probes;
+	for (int id = 0; id < 6; ++id) {
+		const std::string name = "a rather long probe id " + std::to_string(id);
+		for (int i = 0; i < 5; ++i) {
+			const int t = id % 2 == 0 ? i : 4 - i;
+			probes.emplace_back(name, t, static_cast<float>(t) / 2);
+		}
+		if (id == 3) {
+			probes.emplace_back(name, 2, 1.0f);
+		}
+	}
+	using Iterator = decltype(probes.begin());
+	movetk::io::TrajectoryReader<Traits, Iterator> reader(probes.begin(), probes.end());
+	std::vector<const void*> storage;
+	int id = 0;
+	for (auto it = reader.begin(); it != reader.end(); ++it, ++id) {
+		auto& trajectory = *it;
+		REQUIRE(trajectory.size() == 5);
+		REQUIRE(trajectory.template get<0>() == std::vector<std::string>(5, "a rather long probe id " + std::to_string(id)));
+		REQUIRE(trajectory.template get<1>() == std::vector<int>{0, 1, 2, 3, 4});
+		REQUIRE(trajectory.template get<2>() == std::vector<float>{0.0f, 0.5f, 1.0f, 1.5f, 2.0f});
+		if constexpr (TestType::storage_scheme() == movetk::io::StorageScheme::columnar) {
+			storage.push_back(std::get<1>(trajectory.data()).data());
+		} else {
+			storage.push_back(trajectory.data().data());
+		}
+		reader.recycle(std::move(trajectory));
+	}
+	REQUIRE(id == 6);
+	// The storage of a recycled trajectory is used again
+	REQUIRE(std::find(storage.begin() + 1, storage.end(), storage[0]) != storage.end());
+}
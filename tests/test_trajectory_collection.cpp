@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018-2022 TU Eindhoven
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * License-Filename: LICENSE
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "helpers/CustomCatchTemplate.h"
+#include "movetk/ds/TabularTrajectory.h"
+#include "movetk/ds/TrajectoryCollection.h"
+#include "movetk/geom/GeometryInterface.h"
+#include "movetk/metric/Norm.h"
+#include "movetk/metric/Distances.h"
+#include "movetk/utils/Requirements.h"
+#include "movetk/utils/ThreadPool.h"
+
+TEST_CASE("Trajectory collection storage", "[trajectory_collection]") {
+	using Probe = std::tuple<std::string, double, double, std::size_t>;
+	using Collection = movetk::ds::TrajectoryCollectionForProbeType<Probe>;
+	static_assert(std::is_same_v<Collection, movetk::ds::TrajectoryCollection<std::string, double, double, std::size_t>>);
+
+	Collection collection;
+	REQUIRE(collection.empty());
+	std::vector<std::vector<Probe>> trajectories;
+	for (std::size_t t = 0; t < 5; ++t) {
+		std::vector<Probe> trajectory;
+		for (std::size_t i = 0; i < t * 2; ++i) {
+			trajectory.emplace_back("id" + std::to_string(t), t + 0.5 * i, -static_cast<double>(i), 100 * t + i);
+		}
+		trajectories.push_back(trajectory);
+	}
+	collection.reserve(trajectories.size(), 20);
+	for (std::size_t t = 0; t + 1 < trajectories.size(); ++t) {
+		REQUIRE(collection.push_back(std::cbegin(trajectories[t]), std::cend(trajectories[t])) == t);
+	}
+	// Append the last one from columns
+	std::tuple<std::vector<std::string>, std::vector<double>, std::vector<double>, std::vector<std::size_t>> columns;
+	for (const auto& [id, x, y, ts] : trajectories.back()) {
+		std::get<0>(columns).push_back(id);
+		std::get<1>(columns).push_back(x);
+		std::get<2>(columns).push_back(y);
+		std::get<3>(columns).push_back(ts);
+	}
+	REQUIRE(collection.push_back(movetk::ds::ColumnarTrajectory<std::string, double, double, std::size_t>(columns)) == 4);
+
+	REQUIRE(collection.size() == 5);
+	REQUIRE(collection.num_points() == 20);
+	REQUIRE(collection.offsets().size() == 6);
+	REQUIRE(collection.column<3>().size() == 20);
+	for (std::size_t t = 0; t < trajectories.size(); ++t) {
+		const auto view = collection[t];
+		REQUIRE(view.size() == trajectories[t].size());
+		REQUIRE(view.empty() == (t == 0));
+		for (std::size_t i = 0; i < view.size(); ++i) {
+			REQUIRE(view[i] == trajectories[t][i]);
+			REQUIRE(view.get<0>()[i] == std::get<0>(trajectories[t][i]));
+			REQUIRE(view.get<3>()[i] == std::get<3>(trajectories[t][i]));
+		}
+	}
+
+	SECTION("Parallel for each") {
+		movetk::utils::ThreadPool pool(4);
+		for (movetk::utils::ThreadPool* thread_pool : {static_cast<movetk::utils::ThreadPool*>(nullptr), &pool}) {
+			std::vector<std::size_t> sums(collection.size(), 0), visits(collection.size(), 0);
+			collection.for_each(
+			    [&](std::size_t i, const auto& view) {
+				    ++visits[i];
+				    for (auto ts : view.template get<3>()) {
+					    sums[i] += ts;
+				    }
+			    },
+			    thread_pool);
+			for (std::size_t t = 0; t < trajectories.size(); ++t) {
+				std::size_t expected = 0;
+				for (const auto& probe : trajectories[t]) {
+					expected += std::get<3>(probe);
+				}
+				REQUIRE(visits[t] == 1);
+				REQUIRE(sums[t] == expected);
+			}
+
+			// Ranges are non-empty and cover every trajectory once
+			std::vector<std::size_t> range_visits(collection.size(), 0);
+			std::atomic<std::size_t> empty_ranges = 0;
+			collection.for_each_range(
+			    [&](std::size_t first, std::size_t beyond) {
+				    if (first >= beyond) {
+					    ++empty_ranges;
+				    }
+				    for (auto i = first; i < beyond; ++i) {
+					    ++range_visits[i];
+				    }
+			    },
+			    thread_pool);
+			REQUIRE(empty_ranges == 0);
+			REQUIRE(range_visits == std::vector<std::size_t>(collection.size(), 1));
+		}
+	}
+}
+
+MOVETK_TEMPLATE_LIST_TEST_CASE("Trajectory collection point views", "[trajectory_collection]") {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using NT = typename MovetkGeometryKernel::NT;
+	using Point = typename MovetkGeometryKernel::MovetkPoint;
+	using Norm = movetk::metric::FiniteNorm<MovetkGeometryKernel, 2>;
+	using SqDistance = movetk::metric::squared_distance_d<MovetkGeometryKernel, Norm>;
+	using Collection = movetk::ds::TrajectoryCollection<std::size_t, double, double>;
+	using PointIterator = movetk::ds::ColumnPointIterator<MovetkGeometryKernel, double>;
+	static_assert(movetk::utils::RandomAccessPointIterator<PointIterator, MovetkGeometryKernel>);
+	movetk::geom::MakePoint<MovetkGeometryKernel> make_point;
+
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> step(-1, 1);
+	Collection collection;
+	std::vector<std::vector<Point>> expected;
+	for (std::size_t t = 0; t < 20; ++t) {
+		std::vector<std::tuple<std::size_t, double, double>> probes;
+		std::vector<Point> points;
+		double x = 0, y = 0;
+		for (std::size_t i = 0; i < 2 + t; ++i) {
+			probes.emplace_back(i, x, y);
+			points.push_back(make_point({static_cast<NT>(x), static_cast<NT>(y)}));
+			x += step(generator);
+			y += step(generator);
+		}
+		movetk::ds::TabularTrajectory<std::size_t, double, double> trajectory(probes);
+		collection.push_back(trajectory.begin(), trajectory.end());
+		expected.push_back(points);
+	}
+
+	SqDistance sq_distance;
+	movetk::metric::StrongFrechet<MovetkGeometryKernel, SqDistance> frechet;
+	for (std::size_t t = 0; t < collection.size(); ++t) {
+		const auto view = collection[t];
+		auto first = view.template points_begin<MovetkGeometryKernel, 1, 2>();
+		auto beyond = view.template points_end<MovetkGeometryKernel, 1, 2>();
+		REQUIRE(static_cast<std::size_t>(beyond - first) == expected[t].size());
+		for (std::size_t i = 0; i < expected[t].size(); ++i) {
+			REQUIRE(sq_distance(first[i], expected[t][i]) == Approx(0));
+		}
+		REQUIRE(frechet(first, beyond, std::cbegin(expected[t]), std::cend(expected[t])) ==
+		        Approx(0).margin(frechet.tolerance()));
+	}
+}
@@ -24,16 +24,21 @@
 // Created by Custers, Bram on 2020-02-08.
 
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
 
 #include "helpers/CustomCatchTemplate.h"
 #include "movetk/Statistics.h"
 #include "movetk/ds/ColumnarTrajectory.h"
 #include "movetk/ds/TabularTrajectory.h"
+#include "movetk/ds/TrajectoryCollection.h"
 #include "movetk/geom/BoostGeometryTraits.h"
 #include "movetk/geom/BoostGeometryWrapper.h"
 #include "movetk/geom/GeometryInterface.h"
 #include "movetk/io/TuplePrinter.h"
 #include "movetk/metric/Norm.h"
+#include "movetk/utils/ThreadPool.h"
 
 struct TestTypes {
 	using Trajectory = movetk::ds::TabularTrajectory<std::string, double, double, std::time_t>;
@@ -268,6 +273,113 @@ TEMPLATE_LIST_TEST_CASE("Trajectory speed statistics",
 	}
 }
 
+TEST_CASE("Running statistics", "[running_statistics][trajectory_statistics]") {
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<double> distribution(-10, 10);
+	movetk::statistics::RunningStatistics<double> statistics;
+	REQUIRE(statistics.count() == 0);
+	REQUIRE(statistics.mean() == 0);
+	REQUIRE(statistics.variance() == 0);
+	for (std::size_t n : {1, 2, 7, 100, 101}) {
+		statistics.reset(true);
+		std::vector<double> values(n);
+		for (auto& value : values) {
+			value = distribution(generator);
+			statistics.push(value);
+		}
+		const auto mean = std::accumulate(values.begin(), values.end(), 0.0) / n;
+		double variance = 0;
+		for (const auto value : values) {
+			variance += (value - mean) * (value - mean) / n;
+		}
+		std::sort(values.begin(), values.end());
+		REQUIRE(statistics.count() == n);
+		REQUIRE(statistics.min() == values.front());
+		REQUIRE(statistics.max() == values.back());
+		REQUIRE(statistics.mean() == Approx(mean));
+		REQUIRE(statistics.variance() == Approx(variance).margin(1e-12));
+		const auto median = n % 2 == 1 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+		REQUIRE(statistics.median() == median);
+		REQUIRE(statistics.quantile(0) == values.front());
+		REQUIRE(statistics.quantile(1) == values.back());
+		if (n > 1) {
+			const auto position = 0.25 * (n - 1);
+			const auto rank = static_cast<std::size_t>(position);
+			const auto fraction = position - rank;
+			REQUIRE(statistics.quantile(0.25) ==
+			        Approx((1 - fraction) * values[rank] + fraction * values[std::min(rank + 1, n - 1)]));
+		}
+	}
+}
+
+TEMPLATE_LIST_TEST_CASE("Trajectory speed statistics of a collection",
+                        "[trajectory_speed_statistics][trajectory_statistics]",
+                        movetk::test::AvailableBackends) {
+	using MovetkGeometryKernel = typename TestType::MovetkGeometryKernel;
+	using SpeedStat = movetk::statistics::TrajectorySpeedStatistic<MovetkGeometryKernel>;
+	using Stat = typename SpeedStat::Statistic;
+	SpeedStat speedStat;
+	const std::vector<Stat> statistics = {Stat::Min, Stat::Median, Stat::Max, Stat::Mean, Stat::Variance};
+
+	// Random walks of various lengths, including trajectories without speeds and repeated timestamps
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> step(-5, 5);
+	std::uniform_int_distribution<std::time_t> interval(0, 10);
+	movetk::ds::TrajectoryCollection<double, double, std::time_t> collection;
+	std::vector<std::tuple<std::vector<double>, std::vector<double>, std::vector<std::time_t>>> trajectories;
+	for (std::size_t t = 0; t < 60; ++t) {
+		auto& [xs, ys, times] = trajectories.emplace_back();
+		double x = 0, y = 0;
+		std::time_t time = 0;
+		for (std::size_t i = 0; i < t % 13; ++i) {
+			xs.push_back(x += step(generator));
+			ys.push_back(y += step(generator));
+			times.push_back(time += interval(generator));
+		}
+		collection.push_back(movetk::ds::ColumnarTrajectory<double, double, std::time_t>(trajectories.back()));
+	}
+
+	movetk::utils::ThreadPool pool(4);
+	for (auto* thread_pool : {static_cast<movetk::utils::ThreadPool*>(nullptr), &pool}) {
+		const auto columns = speedStat.template for_collection<0, 1, 2>(collection, statistics, thread_pool);
+		REQUIRE(columns.size() == statistics.size());
+		for (std::size_t t = 0; t < trajectories.size(); ++t) {
+			const auto& [xs, ys, times] = trajectories[t];
+			auto xItPair = std::make_pair(xs.begin(), xs.end());
+			auto yItPair = std::make_pair(ys.begin(), ys.end());
+			auto pointItPair =
+			    movetk::utils::point_iterators_from_coordinates<MovetkGeometryKernel, decltype(xs.begin())>(
+			        std::array<decltype(xItPair), 2>{xItPair, yItPair});
+			// Naive statistics of the materialized speeds
+			std::vector<double> speeds;
+			for (std::size_t i = 1; i < xs.size(); ++i) {
+				const auto timeDiff = times[i] - times[i - 1];
+				speeds.push_back(timeDiff == 0 ? 0.0 : std::hypot(xs[i] - xs[i - 1], ys[i] - ys[i - 1]) / timeDiff);
+			}
+			std::vector<double> expected(statistics.size(), 0);
+			if (!speeds.empty()) {
+				std::sort(speeds.begin(), speeds.end());
+				const auto n = speeds.size();
+				const auto mean = std::accumulate(speeds.begin(), speeds.end(), 0.0) / n;
+				double variance = 0;
+				for (const auto speed : speeds) {
+					variance += (speed - mean) * (speed - mean) / n;
+				}
+				const auto median = n % 2 == 1 ? speeds[n / 2] : 0.5 * (speeds[n / 2 - 1] + speeds[n / 2]);
+				expected = {speeds.front(), median, speeds.back(), mean, variance};
+			}
+			const auto fused = speedStat(pointItPair.first, pointItPair.second, times.begin(), times.end(), statistics);
+			for (std::size_t k = 0; k < statistics.size(); ++k) {
+				REQUIRE(columns[k].size() == trajectories.size());
+				REQUIRE(fused[k] == Approx(expected[k]).margin(1e-12));
+				REQUIRE(speedStat(pointItPair.first, pointItPair.second, times.begin(), times.end(), statistics[k]) ==
+				        Approx(expected[k]).margin(1e-12));
+				REQUIRE(columns[k][t] == Approx(expected[k]).margin(1e-12));
+			}
+		}
+	}
+}
+
 TEST_CASE("Trajectory dominant time mode statistic", "[trajectory_time_mode_statistic][trajectory_statistics]") {
 	movetk::statistics::ComputeDominantDifference timeIntervalModeCalc;
 